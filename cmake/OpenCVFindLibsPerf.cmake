@@ -131,3 +131,10 @@ if(WITH_PTHREADS_PF AND HAVE_PTHREAD)
 else()
   set(HAVE_PTHREADS_PF 0)
 endif()
+
+ocv_clear_vars(HAVE_WORKSTEALING_PF)
+if(WITH_WORKSTEALING_PF AND HAVE_PTHREAD)
+  set(HAVE_WORKSTEALING_PF 1)
+else()
+  set(HAVE_WORKSTEALING_PF 0)
+endif()
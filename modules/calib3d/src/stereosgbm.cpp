@@ -53,6 +53,7 @@
 #include "precomp.hpp"
 #include <limits.h>
 #include "opencv2/core/hal/intrin.hpp"
+#include "opencv2/core/utils/buffer_pool.private.hpp"
 
 namespace cv
 {
@@ -2450,7 +2451,7 @@ void cv::validateDisparity( InputOutputArray _disp, InputArray _cost, int minDis
     int cols = disp.cols, rows = disp.rows;
     int minD = minDisparity, maxD = minDisparity + numberOfDisparities;
     int x, minX1 = std::max(maxD, 0), maxX1 = cols + std::min(minD, 0);
-    AutoBuffer<int> _disp2buf(cols*2);
+    utils::ScratchBuffer<int> _disp2buf(cols*2);
     int* disp2buf = _disp2buf;
     int* disp2cost = disp2buf + cols;
     const int DISP_SHIFT = 4, DISP_SCALE = 1 << DISP_SHIFT;
@@ -208,7 +208,18 @@ enum KmeansFlags {
         user-supplied labels instead of computing them from the initial centers. For the second and
         further attempts, use the random or semi-random centers. Use one of KMEANS_\*_CENTERS flag
         to specify the exact method.*/
-    KMEANS_USE_INITIAL_LABELS = 1
+    KMEANS_USE_INITIAL_LABELS = 1,
+    /** Skip the distance computations that can not change the labels using the triangle inequality,
+        with one upper and one lower bound per sample as proposed by Hamerly [Hamerly2010]. The
+        result is the same as the one of the standard Lloyd iterations, but the iterations that
+        move few samples are much cheaper. Takes 2 floats per sample of additional memory.*/
+    KMEANS_HAMERLY            = 4,
+    /** Update the centers from random mini-batches of samples, as proposed by Sculley
+        [Sculley2010], instead of the whole set. criteria.maxCount gives the number of mini-batches;
+        the batch size is max(1024, 4*K) samples. The labels and the compactness are computed on
+        the whole set once the centers are found. The result is an approximation of the Lloyd
+        iterations that takes a fraction of their time on large sets.*/
+    KMEANS_MINI_BATCH         = 8
 };
 
 //! type of line
@@ -542,6 +553,21 @@ The format of half precision floating point is defined in IEEE 754-2008.
 */
 CV_EXPORTS_W void convertFp16(InputArray src, OutputArray dst);
 
+/** @brief Converts an array to bfloat16 floating numbers.
+
+This function converts FP32 (single precision floating point) from/to bfloat16, the format that keeps
+the sign, the 8-bit exponent and the upper 7 bits of the significand of FP32. It has the range of FP32
+at the precision of about 3 decimal digits, so it suits the storage of large feature maps and descriptors.
+The bfloat16 values are stored in CV_16U arrays, so they can be copied, split, merged and written to
+FileStorage like any other 16-bit data. The conversion from FP32 rounds to nearest even; NaN values stay NaN.
+If the input array is neither CV_32F nor CV_16U, the function will raise an error.
+
+@param src input array.
+@param dst output array.
+@sa convertFp16
+*/
+CV_EXPORTS_W void convertBF16(InputArray src, OutputArray dst);
+
 /** @brief Performs a look-up table transform of an array.
 
 The function LUT fills the output array with values from the look-up table. Indices of the entries
@@ -935,6 +961,52 @@ CV_EXPORTS void split(const Mat& src, Mat* mvbegin);
 */
 CV_EXPORTS_W void split(InputArray m, OutputArrayOfArrays mv);
 
+/** @brief Splits a multi-channel array into single-channel arrays of another depth, reordering the channels.
+
+The function is equivalent to cv::split followed by Mat::convertTo for each plane, but it is done in
+one parallel pass over the data:
+\f[\texttt{dst} [j](I) = \texttt{saturate\_cast<ddepth>} ( \texttt{src} (I)_{\texttt{order}[j]} \cdot \texttt{scale} [j] + \texttt{shift} [j])\f]
+For example, the usual preprocessing of a BGR image for a neural network, conversion to planar
+RGB floats with the mean subtracted, is:
+@code
+    Mat blob(3, img.rows*img.cols, CV_32F); // the planes are stored one after another
+    std::vector<Mat> planes;
+    for( int i = 0; i < 3; i++ )
+        planes.push_back(blob.row(i).reshape(1, img.rows));
+    std::vector<int> order = { 2, 1, 0 };
+    splitConvert(img, planes, CV_32F, order, Scalar::all(1./255), Scalar(-0.485, -0.456, -0.406));
+@endcode
+@param src input multi-channel array.
+@param dst output vector of arrays; the arrays themselves are reallocated, if needed.
+@param ddepth depth of the output arrays; negative value means the depth of src.
+@param order indices of the source channels stored to dst[0], dst[1], ...; empty vector means
+all the channels in the original order. There can be at most 4 output arrays.
+@param scale scale factors of the output arrays.
+@param shift values added to the scaled output arrays.
+@sa split, mergeConvert, Mat::convertTo, mixChannels
+*/
+CV_EXPORTS_W void splitConvert(InputArray src, OutputArrayOfArrays dst, int ddepth,
+                               const std::vector<int>& order = std::vector<int>(),
+                               const Scalar& scale = Scalar::all(1), const Scalar& shift = Scalar::all(0));
+
+/** @brief Merges single-channel arrays into a multi-channel array of another depth, reordering the channels.
+
+The function is equivalent to Mat::convertTo for each plane followed by cv::merge, but it is done
+in one parallel pass over the data:
+\f[\texttt{dst} (I)_j = \texttt{saturate\_cast<ddepth>} ( \texttt{src} [\texttt{order}[j]](I) \cdot \texttt{scale} [j] + \texttt{shift} [j])\f]
+@param src input vector of single-channel arrays of the same size and depth.
+@param dst output array of the same size as src[0].
+@param ddepth depth of the output array; negative value means the depth of src.
+@param order indices of the source arrays stored to the channels 0, 1, ... of dst; empty vector
+means all the arrays in the original order. The output array can have at most 4 channels.
+@param scale scale factors of the output channels.
+@param shift values added to the scaled output channels.
+@sa merge, splitConvert, Mat::convertTo, mixChannels
+*/
+CV_EXPORTS_W void mergeConvert(InputArrayOfArrays src, OutputArray dst, int ddepth,
+                               const std::vector<int>& order = std::vector<int>(),
+                               const Scalar& scale = Scalar::all(1), const Scalar& shift = Scalar::all(0));
+
 /** @brief Copies specified channels from input arrays to the specified channels of
 output arrays.
 
@@ -1847,6 +1919,37 @@ will not do the work. Use SVD::solveZ instead.
 CV_EXPORTS_W bool solve(InputArray src1, InputArray src2,
                         OutputArray dst, int flags = DECOMP_LU);
 
+/** @brief Solves a batch of small linear systems.
+
+The function solves N independent systems \f$\texttt{A}_i \cdot \texttt{X}_i = \texttt{B}_i\f$ with
+n x n matrices \f$\texttt{A}_i\f$ and n x k matrices \f$\texttt{B}_i\f$, which is much faster than N
+calls of cv::solve for matrices up to 16x16. Each row of the arrays holds one matrix stored row by row,
+so n is found from the number of columns of src1. The systems are solved by the Gaussian elimination
+with partial pivoting (as with DECOMP_LU), several systems at once with SIMD instructions and in
+parallel. Solutions of singular systems are set to zero.
+
+@param src1 N x (n*n) array of the left-hand side matrices, CV_32FC1 or CV_64FC1, n <= 16.
+@param src2 N x (n*k) array of the right-hand side matrices of the same type, k <= 16.
+@param dst output N x (n*k) array of the solutions.
+@param mask optional output N x 1 CV_8UC1 array, 255 for the solved systems and 0 for the singular ones.
+@return number of singular systems.
+@sa solve, invertBatch
+*/
+CV_EXPORTS_W int solveBatch(InputArray src1, InputArray src2, OutputArray dst, OutputArray mask = noArray());
+
+/** @brief Inverts a batch of small matrices.
+
+Each row of src holds one n x n matrix (n <= 16) stored row by row. The matrices are inverted as
+with cv::invert(DECOMP_LU), several at once. Inverses of singular matrices are set to zero.
+
+@param src N x (n*n) array of the matrices, CV_32FC1 or CV_64FC1.
+@param dst output N x (n*n) array of the inverse matrices.
+@param mask optional output N x 1 CV_8UC1 array, 255 for the inverted matrices and 0 for the singular ones.
+@return number of singular matrices.
+@sa invert, solveBatch
+*/
+CV_EXPORTS_W int invertBatch(InputArray src, OutputArray dst, OutputArray mask = noArray());
+
 /** @brief Sorts each row or each column of a matrix.
 
 The function cv::sort sorts each matrix row or each matrix column in
@@ -1882,6 +1985,28 @@ stores the indices of sorted elements in the output array. For example:
 */
 CV_EXPORTS_W void sortIdx(InputArray src, OutputArray dst, int flags);
 
+/** @brief Finds the k largest or the k smallest elements of each row or each column of a matrix.
+
+The function cv::topK is equivalent to cv::sortIdx followed by taking the first k indices and the
+corresponding elements, but it does not sort the whole rows (columns). The selected elements are
+stored in the order defined by flags, equal elements are stored in the order of their indices.
+NaNs are considered worse than any other value. Rows (columns) are processed in parallel, long
+rows are additionally split into parallel chunks.
+@code
+    Mat A = (Mat_<float>(1, 5) << 3, 1, 4, 1, 5), V, I;
+    topK(A, V, I, 3, SORT_EVERY_ROW + SORT_DESCENDING);
+    // V = [5, 4, 3], I = [4, 2, 0]
+@endcode
+@param src input single-channel array.
+@param values output array of the same type as src, src.rows x k for SORT_EVERY_ROW and k x src.cols
+for SORT_EVERY_COLUMN.
+@param indices output CV_32SC1 array of the same size as values, the indices of the selected elements.
+@param k number of elements to select, 0 < k <= length of a row (column).
+@param flags operation flags, a combination of cv::SortFlags; SORT_DESCENDING selects the largest elements.
+@sa sortIdx, sort
+*/
+CV_EXPORTS_W void topK(InputArray src, OutputArray values, OutputArray indices, int k, int flags);
+
 /** @brief Finds the real roots of a cubic equation.
 
 The function solveCubic finds the real roots of a cubic equation:
@@ -1991,6 +2116,24 @@ CV_EXPORTS_W void PCABackProject(InputArray data, InputArray mean,
 /** wrap SVD::compute */
 CV_EXPORTS_W void SVDecomp( InputArray src, OutputArray w, OutputArray u, OutputArray vt, int flags = 0 );
 
+/** @brief Computes the singular value decompositions of a batch of small matrices.
+
+Each row of src holds one m x n matrix (n <= m <= 16) stored row by row. The decompositions
+\f$\texttt{A}_i = \texttt{U}_i \cdot diag(\texttt{w}_i) \cdot \texttt{Vt}_i\f$ are computed by the
+one-sided Jacobi method, several matrices at once. As with SVD::compute, the singular values are
+sorted in the descending order; U is the thin m x n matrix. Columns of U corresponding to zero
+singular values are set to zero. To decompose a wide matrix, pass its transposition.
+
+@param src N x (m*n) array of the matrices, CV_32FC1 or CV_64FC1.
+@param rows number of rows m of every matrix.
+@param w output N x n array of the singular values.
+@param u optional output N x (m*n) array of the left singular vectors.
+@param vt optional output N x (n*n) array of the transposed right singular vectors.
+@sa SVDecomp, SVD::compute
+*/
+CV_EXPORTS_W void SVDecompBatch( InputArray src, int rows, OutputArray w,
+                                 OutputArray u = noArray(), OutputArray vt = noArray() );
+
 /** wrap SVD::backSubst */
 CV_EXPORTS_W void SVBackSubst( InputArray w, InputArray u, InputArray vt,
                                InputArray rhs, OutputArray dst );
@@ -2376,7 +2519,12 @@ class CV_EXPORTS PCA
 public:
     enum Flags { DATA_AS_ROW = 0, //!< indicates that the input samples are stored as matrix rows
                  DATA_AS_COL = 1, //!< indicates that the input samples are stored as matrix columns
-                 USE_AVG     = 2  //!
+                 USE_AVG     = 2, //!
+                 /** compute the first maxComponents components with the randomized SVD of Halko et al.
+                     instead of the eigen decomposition of the full covariance matrix; the cost is
+                     linear in the data dimensionality, which pays off when maxComponents is much
+                     smaller than it. Requires maxComponents > 0. */
+                 RANDOMIZED  = 4
                };
 
     /** @brief default constructor
@@ -2444,6 +2592,26 @@ public:
      */
     PCA& operator()(InputArray data, InputArray mean, int flags, double retainedVariance);
 
+    /** @brief updates %PCA with a new batch of samples
+
+    The method implements the incremental %PCA of Ross et al. (Incremental Learning for Robust
+    Visual Tracking, 2008): the retained components, the mean and the new samples are combined into
+    a small matrix, whose SVD gives the components of all the samples seen so far. The data can thus
+    be streamed in batches that never have to be in memory at once. The result is exact when all
+    the components are retained and is a close approximation otherwise.
+
+    The number of samples the decomposition is computed from is kept by the caller. A call with
+    nsamples equal to 0 starts a new decomposition; the structure computed by operator()() can be
+    updated as well, nsamples is then the number of samples passed to operator()().
+    @param data batch of samples stored as the matrix rows or as the matrix columns.
+    @param flags operation flags; only the data layout is used (PCA::DATA_AS_ROW or PCA::DATA_AS_COL),
+    it must be the same for all the batches.
+    @param nsamples number of samples seen so far; it is increased by the number of samples in data.
+    @param maxComponents maximum number of components to retain; by default, all the components
+    are retained, which is only practical for low dimensional data.
+    */
+    PCA& update(InputArray data, int flags, int64& nsamples, int maxComponents = 0);
+
     /** @brief Projects vector(s) to the principal component subspace.
 
     The methods project one or more vectors to the principal component
@@ -2732,6 +2900,83 @@ public:
     Mat u, w, vt;
 };
 
+/** @brief Precomputed plan of a discrete Fourier transform
+
+The class keeps everything cv::dft computes before the transform itself: the factorization of
+the transform sizes, the twiddle factors, the permutation tables and the scratch buffers. It is
+meant for the applications that transform many arrays of the same size and type, for example
+the tiles of a phase correlation or a template matching pipeline:
+@code
+    DFTPlan plan(tileSize, CV_32FC1, DFT_COMPLEX_OUTPUT);
+    for(size_t i = 0; i < tiles.size(); i++)
+        plan.apply(tiles[i], spectrums[i]);
+    // or, processing the tiles in parallel:
+    plan.applyBatch(tiles, spectrums);
+@endcode
+The results are the same as the ones of cv::dft called with the same flags. A plan can be used
+from several threads at once: every concurrent call takes its own set of scratch buffers from a
+pool, so the buffers are allocated only once per thread. Copies of a plan share the pool.
+@sa dft, idft
+*/
+class CV_EXPORTS DFTPlan
+{
+public:
+    /** @brief default constructor
+
+    creates an empty plan, use create() to initialize it.
+    */
+    DFTPlan();
+
+    /** @overload
+    @param size size of the arrays to transform.
+    @param type type of the input arrays, CV_32FC1, CV_32FC2, CV_64FC1 or CV_64FC2.
+    @param flags transformation flags, see cv::dft; the same flags are used for every array.
+    */
+    DFTPlan(Size size, int type, int flags = 0);
+
+    /** @brief initializes the plan for the arrays of the given size and type
+
+    The parameters are the same as in the constructor.
+    */
+    void create(Size size, int type, int flags = 0);
+
+    //! returns true if the plan has not been created
+    bool empty() const;
+
+    //! size of the arrays the plan is created for
+    Size size() const;
+
+    //! type of the input arrays the plan is created for
+    int type() const;
+
+    //! type of the output arrays
+    int dstType() const;
+
+    //! transformation flags the plan is created for
+    int flags() const;
+
+    /** @brief transforms one array
+
+    @param src input array of size() and type().
+    @param dst output array of size() and dstType(); it can be the same as src.
+    @param nonzeroRows the same as in cv::dft: when it is not zero, only the first nonzeroRows
+    rows of the input (forward transform) or of the output (inverse transform) are processed in full.
+    */
+    void apply(InputArray src, OutputArray dst, int nonzeroRows = 0) const;
+
+    /** @brief transforms several independent arrays in parallel
+
+    @param src vector of the input arrays, each of size() and type().
+    @param dst vector of the output arrays; it is resized to the number of input arrays.
+    */
+    void applyBatch(InputArrayOfArrays src, OutputArrayOfArrays dst) const;
+
+    struct Impl;
+
+protected:
+    Ptr<Impl> p;
+};
+
 /** @brief Random Number Generator
 
 Random number generator. It encapsulates the state (currently, a 64-bit
@@ -2969,7 +3214,9 @@ centers moves by less than criteria.epsilon on some iteration, the algorithm sto
 @param attempts Flag to specify the number of times the algorithm is executed using different
 initial labellings. The algorithm returns the labels that yield the best compactness (see the last
 function parameter).
-@param flags Flag that can take values of cv::KmeansFlags
+@param flags Flag that can take values of cv::KmeansFlags. KMEANS_HAMERLY and KMEANS_MINI_BATCH can
+not be combined. In these modes the KMEANS_PP_CENTERS seeding runs on a random subset of
+min(N, 16\*K) samples, so its cost does not depend on the number of samples.
 @param centers Output matrix of the cluster centers, one row per each cluster center.
 @return The function returns the compactness measure that is computed as
 \f[\sum _i  \| \texttt{samples} _i -  \texttt{centers} _{ \texttt{labels} _i} \| ^2\f]
@@ -7,6 +7,8 @@
 #ifndef OPENCV_CORE_BUFFER_POOL_HPP
 #define OPENCV_CORE_BUFFER_POOL_HPP
 
+#include "opencv2/core/cvdef.h"
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable: 4265)
@@ -29,6 +31,16 @@ public:
     virtual void freeAllReservedBuffers() = 0;
 };
 
+/** @brief Returns the controller of the pool that serves temporary CPU buffers of OpenCV functions
+
+Each thread owns a stack-style arena. Arenas grow on demand and are kept for reuse while their
+total size, reported by getReservedSize(), does not exceed getMaxReservedSize() (8Mb by default,
+see the OPENCV_CPU_BUFFERPOOL_LIMIT configuration parameter); requests that do not fit are served
+by the heap. The arena of a thread is freed when the thread exits (except for WinRT builds).
+Setting the maximal size to 0 disables the pool.
+*/
+CV_EXPORTS BufferPoolController* getCPUBufferPoolController();
+
 //! @}
 
 }
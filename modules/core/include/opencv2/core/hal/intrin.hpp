@@ -329,6 +329,13 @@ CV_CPU_OPTIMIZATION_HAL_NAMESPACE_END
 
 #endif
 
+// AVX2 extends the SSE implementation with 256-bit types, 128-bit ones stay available
+#if CV_SSE2 && CV_AVX2
+
+#include "opencv2/core/hal/intrin_avx.hpp"
+
+#endif
+
 //! @addtogroup core_hal_intrin
 //! @{
 
@@ -342,6 +349,36 @@ CV_CPU_OPTIMIZATION_HAL_NAMESPACE_END
 #define CV_SIMD128_64F 0
 #endif
 
+#ifndef CV_SIMD256
+//! Set to 1 if current compiler supports 256-bit vector extensions (AVX2 is enabled)
+#define CV_SIMD256 0
+#endif
+
+#ifndef CV_SIMD256_64F
+//! Set to 1 if current intrinsics implementation supports 256-bit vectors of 64-bit floats
+#define CV_SIMD256_64F 0
+#endif
+
+/** @brief Widest available vector width
+
+CV_SIMD is 1 if either CV_SIMD128 or CV_SIMD256 is available. CV_SIMD_WIDTH is the width of the
+v_uint8, v_float32, ... types (and of the vx_ loaders) in bytes. Code written in terms of them
+is compiled for the widest vectors in every dispatched optimization mode.
+*/
+#if CV_SIMD256
+#define CV_SIMD 1
+#define CV_SIMD_64F CV_SIMD256_64F
+#define CV_SIMD_WIDTH 32
+#elif CV_SIMD128
+#define CV_SIMD 1
+#define CV_SIMD_64F CV_SIMD128_64F
+#define CV_SIMD_WIDTH 16
+#else
+#define CV_SIMD 0
+#define CV_SIMD_64F 0
+#define CV_SIMD_WIDTH 16
+#endif
+
 //! @}
 
 //==================================================================================================
@@ -438,6 +475,110 @@ template <> struct V_RegTrait128<double> {
 };
 #endif
 
+//! @name Width-agnostic types and loaders
+//! @{
+#if CV_SIMD256
+
+typedef v_uint8x32  v_uint8;
+typedef v_int8x32   v_int8;
+typedef v_uint16x16 v_uint16;
+typedef v_int16x16  v_int16;
+typedef v_uint32x8  v_uint32;
+typedef v_int32x8   v_int32;
+typedef v_uint64x4  v_uint64;
+typedef v_int64x4   v_int64;
+typedef v_float32x8 v_float32;
+#if CV_SIMD256_64F
+typedef v_float64x4 v_float64;
+#endif
+
+#define OPENCV_HAL_IMPL_VX_INIT(_Tpvec, _Tp, suffix) \
+    inline _Tpvec vx_setzero_##suffix() { return v256_setzero_##suffix(); } \
+    inline _Tpvec vx_setall_##suffix(_Tp v) { return v256_setall_##suffix(v); }
+
+#define OPENCV_HAL_IMPL_VX_LOAD(_Tpvec, _Tp) \
+    inline _Tpvec vx_load(const _Tp* ptr) { return v256_load(ptr); } \
+    inline _Tpvec vx_load_aligned(const _Tp* ptr) { return v256_load_aligned(ptr); } \
+    inline _Tpvec vx_load_low(const _Tp* ptr) { return v256_load_low(ptr); } \
+    inline _Tpvec vx_load_halves(const _Tp* ptr0, const _Tp* ptr1) { return v256_load_halves(ptr0, ptr1); }
+
+#define OPENCV_HAL_IMPL_VX_LOAD_EXPAND(_Tpwvec, _Tp) \
+    inline _Tpwvec vx_load_expand(const _Tp* ptr) { return v256_load_expand(ptr); }
+
+#define OPENCV_HAL_IMPL_VX_LOAD_EXPAND_Q(_Tpqvec, _Tp) \
+    inline _Tpqvec vx_load_expand_q(const _Tp* ptr) { return v256_load_expand_q(ptr); }
+
+#elif CV_SIMD128
+
+typedef v_uint8x16  v_uint8;
+typedef v_int8x16   v_int8;
+typedef v_uint16x8  v_uint16;
+typedef v_int16x8   v_int16;
+typedef v_uint32x4  v_uint32;
+typedef v_int32x4   v_int32;
+typedef v_uint64x2  v_uint64;
+typedef v_int64x2   v_int64;
+typedef v_float32x4 v_float32;
+#if CV_SIMD128_64F
+typedef v_float64x2 v_float64;
+#endif
+
+#define OPENCV_HAL_IMPL_VX_INIT(_Tpvec, _Tp, suffix) \
+    inline _Tpvec vx_setzero_##suffix() { return v_setzero_##suffix(); } \
+    inline _Tpvec vx_setall_##suffix(_Tp v) { return v_setall_##suffix(v); }
+
+#define OPENCV_HAL_IMPL_VX_LOAD(_Tpvec, _Tp) \
+    inline _Tpvec vx_load(const _Tp* ptr) { return v_load(ptr); } \
+    inline _Tpvec vx_load_aligned(const _Tp* ptr) { return v_load_aligned(ptr); } \
+    inline _Tpvec vx_load_low(const _Tp* ptr) { return v_load_low(ptr); } \
+    inline _Tpvec vx_load_halves(const _Tp* ptr0, const _Tp* ptr1) { return v_load_halves(ptr0, ptr1); }
+
+#define OPENCV_HAL_IMPL_VX_LOAD_EXPAND(_Tpwvec, _Tp) \
+    inline _Tpwvec vx_load_expand(const _Tp* ptr) { return v_load_expand(ptr); }
+
+#define OPENCV_HAL_IMPL_VX_LOAD_EXPAND_Q(_Tpqvec, _Tp) \
+    inline _Tpqvec vx_load_expand_q(const _Tp* ptr) { return v_load_expand_q(ptr); }
+
+#endif
+
+#if CV_SIMD
+OPENCV_HAL_IMPL_VX_INIT(v_uint8,   uchar,    u8)
+OPENCV_HAL_IMPL_VX_INIT(v_int8,    schar,    s8)
+OPENCV_HAL_IMPL_VX_INIT(v_uint16,  ushort,   u16)
+OPENCV_HAL_IMPL_VX_INIT(v_int16,   short,    s16)
+OPENCV_HAL_IMPL_VX_INIT(v_uint32,  unsigned, u32)
+OPENCV_HAL_IMPL_VX_INIT(v_int32,   int,      s32)
+OPENCV_HAL_IMPL_VX_INIT(v_uint64,  uint64,   u64)
+OPENCV_HAL_IMPL_VX_INIT(v_int64,   int64,    s64)
+OPENCV_HAL_IMPL_VX_INIT(v_float32, float,    f32)
+
+OPENCV_HAL_IMPL_VX_LOAD(v_uint8,   uchar)
+OPENCV_HAL_IMPL_VX_LOAD(v_int8,    schar)
+OPENCV_HAL_IMPL_VX_LOAD(v_uint16,  ushort)
+OPENCV_HAL_IMPL_VX_LOAD(v_int16,   short)
+OPENCV_HAL_IMPL_VX_LOAD(v_uint32,  unsigned)
+OPENCV_HAL_IMPL_VX_LOAD(v_int32,   int)
+OPENCV_HAL_IMPL_VX_LOAD(v_uint64,  uint64)
+OPENCV_HAL_IMPL_VX_LOAD(v_int64,   int64)
+OPENCV_HAL_IMPL_VX_LOAD(v_float32, float)
+
+#if CV_SIMD_64F
+OPENCV_HAL_IMPL_VX_INIT(v_float64, double, f64)
+OPENCV_HAL_IMPL_VX_LOAD(v_float64, double)
+#endif
+
+OPENCV_HAL_IMPL_VX_LOAD_EXPAND(v_uint16, uchar)
+OPENCV_HAL_IMPL_VX_LOAD_EXPAND(v_int16,  schar)
+OPENCV_HAL_IMPL_VX_LOAD_EXPAND(v_uint32, ushort)
+OPENCV_HAL_IMPL_VX_LOAD_EXPAND(v_int32,  short)
+OPENCV_HAL_IMPL_VX_LOAD_EXPAND(v_uint64, unsigned)
+OPENCV_HAL_IMPL_VX_LOAD_EXPAND(v_int64,  int)
+
+OPENCV_HAL_IMPL_VX_LOAD_EXPAND_Q(v_uint32, uchar)
+OPENCV_HAL_IMPL_VX_LOAD_EXPAND_Q(v_int32,  schar)
+#endif // CV_SIMD
+//! @}
+
 inline unsigned int trailingZeros32(unsigned int value) {
 #if defined(_MSC_VER)
 #if (_MSC_VER < 1700) || defined(_M_ARM)
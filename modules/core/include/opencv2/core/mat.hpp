@@ -3474,6 +3474,12 @@ real-valued scalar ( double )):
 @note Comma-separated initializers and probably some other operations may require additional
 explicit Mat() or Mat_<T>() constructor calls to resolve a possible ambiguity.
 
+@note Sums of scaled floating-point matrices are evaluated without temporary matrices when they have
+at most three terms of the same size and type, e.g. `A*alpha + B*beta + s` or `A*alpha + B*beta - C`.
+Longer chains are split into parts of up to three terms, the intermediate results are stored
+in temporary matrices. Integer matrices are always evaluated operator by operator, so every
+intermediate result is saturated, e.g. `A + B - C` gives 155 for 8-bit values 200, 200 and 100.
+
 Here are examples of matrix expressions:
 @code
     // compute pseudo-inverse of A, equivalent to A.inv(DECOMP_SVD)
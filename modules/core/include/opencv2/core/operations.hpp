@@ -221,6 +221,54 @@ Matx<_Tp, n, l> Matx<_Tp, m, n>::solve(const Matx<_Tp, m, l>& rhs, int method) c
     return ok ? x : Matx<_Tp, n, l>::zeros();
 }
 
+/** @brief Solves a batch of fixed-size systems, see cv::solveBatch
+
+@return number of singular systems, their solutions are set to zero
+*/
+template<typename _Tp, int m, int n> static inline
+int solveBatch(const std::vector< Matx<_Tp, m, m> >& src1, const std::vector< Matx<_Tp, m, n> >& src2,
+               std::vector< Matx<_Tp, m, n> >& dst, OutputArray mask = noArray())
+{
+    CV_Assert(src1.size() == src2.size());
+    dst.resize(src1.size());
+    if (src1.empty())
+        return 0;
+    const int type = traits::Type<_Tp>::value, count = (int)src1.size();
+    Mat x(count, m*n, type, &dst[0]);
+    return solveBatch(Mat(count, m*m, type, (void*)&src1[0]), Mat(count, m*n, type, (void*)&src2[0]), x, mask);
+}
+
+/** @brief Inverts a batch of fixed-size matrices, see cv::invertBatch
+
+@return number of singular matrices, their inverses are set to zero
+*/
+template<typename _Tp, int m> static inline
+int invertBatch(const std::vector< Matx<_Tp, m, m> >& src, std::vector< Matx<_Tp, m, m> >& dst, OutputArray mask = noArray())
+{
+    dst.resize(src.size());
+    if (src.empty())
+        return 0;
+    const int type = traits::Type<_Tp>::value, count = (int)src.size();
+    Mat inv(count, m*m, type, &dst[0]);
+    return invertBatch(Mat(count, m*m, type, (void*)&src[0]), inv, mask);
+}
+
+/** @brief Computes the SVD of a batch of fixed-size matrices, see cv::SVDecompBatch
+*/
+template<typename _Tp, int m, int n> static inline
+void SVDecompBatch(const std::vector< Matx<_Tp, m, n> >& src, std::vector< Vec<_Tp, n> >& w,
+                   std::vector< Matx<_Tp, m, n> >& u, std::vector< Matx<_Tp, n, n> >& vt)
+{
+    w.resize(src.size());
+    u.resize(src.size());
+    vt.resize(src.size());
+    if (src.empty())
+        return;
+    const int type = traits::Type<_Tp>::value, count = (int)src.size();
+    Mat _w(count, n, type, &w[0]), _u(count, m*n, type, &u[0]), _vt(count, n*n, type, &vt[0]);
+    SVDecompBatch(Mat(count, m*n, type, (void*)&src[0]), m, _w, _u, _vt);
+}
+
 
 
 ////////////////////////// Augmenting algebraic & logical operations //////////////////////////
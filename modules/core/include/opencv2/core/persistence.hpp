@@ -320,6 +320,7 @@ public:
         FORMAT_XML  = (1<<3), //!< flag, XML format
         FORMAT_YAML = (2<<3), //!< flag, YAML format
         FORMAT_JSON = (3<<3), //!< flag, JSON format
+        FORMAT_BINARY = (4<<3), //!< flag, binary format, matrix data are mapped from the file on reading
 
         BASE64      = 64,     //!< flag, write rawdata in Base64 by default. (consider using WRITE_BASE64)
         WRITE_BASE64 = BASE64 | WRITE, //!< flag, enable both WRITE and BASE64
@@ -360,7 +361,11 @@ public:
         FileStorage::WRITE and FileStorage::MEMORY flags are specified, source is used just to specify
         the output file format (e.g. mydata.xml, .yml etc.). A file name can also contain parameters.
         You can use this format, "*?base64" (e.g. "file.json?base64" (case sensitive)), as an alternative to
-        FileStorage::BASE64 flag.
+        FileStorage::BASE64 flag. Files with the .cvbin extension are written in the binary format (see
+        FileStorage::FORMAT_BINARY): the matrix data are aligned in the file, and the matrices read from it
+        refer to the memory-mapped file instead of being copied (every matrix gets its own copy-on-write
+        mapping; where memory mapping is not available and for the storages read from memory the data are
+        copied). The binary format does not support FileStorage::APPEND and compression.
     @param flags Mode of operation. One of FileStorage::Mode
     @param encoding Encoding of the file. Note that UTF-16 XML encoding is not supported currently and
     you should use 8-bit encoding instead of it.
@@ -685,6 +690,56 @@ public:
     size_t remaining;
 };
 
+/** @brief Callback interface of the streaming reader, see readFileStorage().
+
+The elements of the top-level collection of every stream are passed to select() in the order they
+appear in the file. Depending on the returned action the element is dropped, parsed completely and
+passed to visit(), or its own elements are streamed the same way. Only the element being visited is
+kept in memory, so the memory footprint is determined by the largest visited element rather than by
+the file size.
+ */
+class CV_EXPORTS FileNodeVisitor
+{
+public:
+    //! action to take on an element
+    enum Action
+    {
+        SKIP    = 0, //!< parse the element without keeping it; its nested elements are dropped one by one
+        VISIT   = 1, //!< parse the whole element and pass it to visit()
+        DESCEND = 2  //!< stream the elements of the collection and then call leave(); VISIT for a scalar
+    };
+
+    virtual ~FileNodeVisitor();
+
+    /** @brief Chooses the action for the element. Returns VISIT by default.
+    @param key Name of the element, empty for sequence elements.
+    @param index Index of the element in the enclosing collection.
+    @param depth Nesting level, 0 for the elements of the top-level collection.
+     */
+    virtual int select(const String& key, int index, int depth);
+
+    /** @brief Receives the parsed element.
+
+    The node and the nodes inside it are only valid within the call; matrices read from it remain valid.
+    @return false to stop reading the file.
+     */
+    virtual bool visit(const FileNode& node, const String& key, int index, int depth) = 0;
+
+    //! Is called after all the elements of the collection selected with DESCEND are passed
+    virtual void leave(const String& key, int index, int depth);
+};
+
+/** @brief Reads the file storage incrementally, without building the whole node tree.
+
+@param filename Name of the file or the text to read (with FileStorage::MEMORY), see FileStorage::open.
+@param visitor Receives the elements of the file storage.
+@param flags FileStorage::READ, optionally combined with FileStorage::MEMORY and a format flag.
+@param encoding See FileStorage::open.
+@return false if the file storage could not be opened.
+ */
+CV_EXPORTS bool readFileStorage(const String& filename, FileNodeVisitor& visitor,
+                                int flags = FileStorage::READ, const String& encoding = String());
+
 //! @} core_xml
 
 /////////////////// XML & YAML I/O implementation //////////////////
@@ -1670,6 +1670,7 @@ typedef struct CvFileStorage CvFileStorage;
 #define CV_STORAGE_FORMAT_XML    8
 #define CV_STORAGE_FORMAT_YAML  16
 #define CV_STORAGE_FORMAT_JSON  24
+#define CV_STORAGE_FORMAT_BINARY 32
 #define CV_STORAGE_BASE64       64
 #define CV_STORAGE_WRITE_BASE64  (CV_STORAGE_BASE64 | CV_STORAGE_WRITE)
 
@@ -513,6 +513,25 @@ public:
 */
 CV_EXPORTS void parallel_for_(const Range& range, const ParallelLoopBody& body, double nstripes=-1.);
 
+namespace details {
+//! parallel_for_() made on behalf of the code at the caller address (used by the wrappers that are not call sites themselves)
+CV_EXPORTS void parallel_for_from(const void* caller, const Range& range, const ParallelLoopBody& body, double nstripes);
+}
+
+// the return address of a parallel_for_() function identifies its call site in the statistics
+#if defined __GNUC__
+#  define CV__PARALLEL_FOR_NOINLINE __attribute__((noinline))
+#  define CV__PARALLEL_FOR_CALLER() __builtin_return_address(0)
+#elif defined _MSC_VER
+#  include <intrin.h>
+#  pragma intrinsic(_ReturnAddress)
+#  define CV__PARALLEL_FOR_NOINLINE __declspec(noinline)
+#  define CV__PARALLEL_FOR_CALLER() _ReturnAddress()
+#else
+#  define CV__PARALLEL_FOR_NOINLINE
+#  define CV__PARALLEL_FOR_CALLER() ((const void*)0)
+#endif
+
 #ifdef CV_CXX11
 class ParallelLoopBodyLambdaWrapper : public ParallelLoopBody
 {
@@ -529,9 +548,11 @@ public:
     }
 };
 
-inline void parallel_for_(const Range& range, std::function<void(const Range&)> functor, double nstripes=-1.)
+// the wrapper is never inlined, so that its return address tells apart the call sites of lambdas
+CV__PARALLEL_FOR_NOINLINE inline
+void parallel_for_(const Range& range, std::function<void(const Range&)> functor, double nstripes=-1.)
 {
-    parallel_for_(range, ParallelLoopBodyLambdaWrapper(functor), nstripes);
+    details::parallel_for_from(CV__PARALLEL_FOR_CALLER(), range, ParallelLoopBodyLambdaWrapper(functor), nstripes);
 }
 #endif
 
@@ -0,0 +1,75 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_BUFFER_POOL_PRIVATE_HPP
+#define OPENCV_CORE_UTILS_BUFFER_POOL_PRIVATE_HPP
+
+#include "opencv2/core/cvdef.h"
+
+namespace cv { namespace utils {
+
+//! Takes a block from the scratch arena of the calling thread (falls back to fastMalloc() if it is full)
+CV_EXPORTS void* allocateScratchBuffer(size_t size, void*& owner);
+//! Returns the block allocated by allocateScratchBuffer()
+CV_EXPORTS void releaseScratchBuffer(void* ptr, void* owner);
+
+/** @brief Temporary buffer served by the CPU buffer pool
+
+A replacement for AutoBuffer in hot code paths: the memory is taken from a stack-style arena
+owned by the calling thread, so that repeated calls do not hit the heap. Buffers are expected to
+be released in the reverse order of allocation (e.g. as local variables); other orders are
+supported but keep the arena space occupied until the newer blocks are released.
+The memory is aligned to CV_MALLOC_ALIGN. The pool is controlled by getCPUBufferPoolController().
+*/
+template<typename _Tp> class ScratchBuffer
+{
+public:
+    typedef _Tp value_type;
+
+    ScratchBuffer() : ptr(0), sz(0), owner(0) {}
+    explicit ScratchBuffer(size_t _size) : ptr(0), sz(0), owner(0) { allocate(_size); }
+    ~ScratchBuffer() { deallocate(); }
+
+    //! allocates the new buffer of _size elements, the previous content is not preserved
+    void allocate(size_t _size)
+    {
+        if( _size <= sz )
+        {
+            sz = _size;
+            return;
+        }
+        deallocate();
+        if( _size > 0 )
+        {
+            ptr = (_Tp*)allocateScratchBuffer(_size*sizeof(_Tp), owner);
+            sz = _size;
+        }
+    }
+    //! returns the buffer to the pool
+    void deallocate()
+    {
+        if( ptr )
+            releaseScratchBuffer(ptr, owner);
+        ptr = 0;
+        sz = 0;
+        owner = 0;
+    }
+    //! returns the current buffer size
+    size_t size() const { return sz; }
+    operator _Tp* () { return ptr; }
+    operator const _Tp* () const { return ptr; }
+
+protected:
+    _Tp* ptr;
+    size_t sz;
+    void* owner;
+
+private:
+    ScratchBuffer(const ScratchBuffer&); // disabled
+    ScratchBuffer& operator=(const ScratchBuffer&); // disabled
+};
+
+}} // namespace
+
+#endif // OPENCV_CORE_UTILS_BUFFER_POOL_PRIVATE_HPP
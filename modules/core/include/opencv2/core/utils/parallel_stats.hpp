@@ -0,0 +1,93 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_PARALLEL_STATS_HPP
+#define OPENCV_CORE_UTILS_PARALLEL_STATS_HPP
+
+#include "opencv2/core/utility.hpp"
+
+namespace cv { namespace utils {
+
+//! @addtogroup core_utils
+//! @{
+
+/** @brief Counters of the parallel_for_() calls made from one call site
+
+A call site is either named by ParallelForSiteName or identified by the type of the loop body and
+the code address parallel_for_() is called from. Nested calls that are executed serially are not
+counted. Times are measured in seconds.
+*/
+struct ParallelForStats
+{
+    String site;       //!< name of the call site, or the type name of the loop body and the caller address
+    int64 calls;       //!< number of calls
+    int64 stripes;     //!< total number of executed stripes
+    double wallTime;   //!< total time of the calls
+    double busyTime;   //!< total time spent in the loop body by all the threads
+    double imbalance;  //!< busiest thread time to mean thread time ratio averaged over calls (1 is ideal)
+    int maxThreads;    //!< max number of threads that have taken part in one call
+    int tunedStripes;  //!< stripe count chosen by the auto-tuning for the last call, 0 while it is not settled
+
+    ParallelForStats() : calls(0), stripes(0), wallTime(0), busyTime(0), imbalance(0), maxThreads(0), tunedStripes(0) {}
+
+    //! average number of threads busy with the loop body during the calls
+    double parallelism() const { return wallTime > 0 ? busyTime / wallTime : 0.; }
+};
+
+/** @brief Enables collection of parallel_for_() statistics
+
+Disabled by default, can also be enabled by the OPENCV_PARALLEL_FOR_STATS configuration parameter.
+The collection adds a lock and a timer call per stripe, so it is meant for profiling runs.
+*/
+CV_EXPORTS void setParallelForStatsEnabled(bool enabled);
+CV_EXPORTS bool isParallelForStatsEnabled();
+
+/** @brief Enables adaptive selection of the stripe count
+
+For every call site several stripe counts (the one requested by the caller and 1, 2, 4, 8, 16
+stripes per thread) are tried on consecutive calls, and the one with the least time per range
+element is used afterwards. Disabled by default, can also be enabled by the
+OPENCV_PARALLEL_FOR_AUTOTUNE configuration parameter. The choice is not revised if the workload
+of the call site changes later; resetParallelForStats() restarts the tuning.
+*/
+CV_EXPORTS void setParallelForAutoTuning(bool enabled);
+CV_EXPORTS bool isParallelForAutoTuning();
+
+/** @brief Names the call site of parallel_for_()
+
+The parallel_for_() calls made by the current thread while the object exists are accounted to
+the site with the given name, which must stay valid during the calls (e.g. a string literal).
+This keeps apart the loops that share a generic loop body type or a function wrapper, or merges
+the calls made from several places.
+@code
+    {
+        utils::ParallelForSiteName site("myFilter: rows");
+        parallel_for_(Range(0, rows), [&](const Range& r) { ... });
+    }
+@endcode
+*/
+class CV_EXPORTS ParallelForSiteName
+{
+public:
+    explicit ParallelForSiteName(const char* name);
+    ~ParallelForSiteName();
+
+private:
+    const char* prev;
+
+    ParallelForSiteName(const ParallelForSiteName&); // disabled
+    ParallelForSiteName& operator=(const ParallelForSiteName&); // disabled
+};
+
+//! Returns the statistics of all the call sites seen since the last reset
+CV_EXPORTS std::vector<ParallelForStats> getParallelForStats();
+
+//! Clears the statistics and the auto-tuning results
+CV_EXPORTS void resetParallelForStats();
+
+//! @}
+
+}} // namespace
+
+#endif // OPENCV_CORE_UTILS_PARALLEL_STATS_HPP
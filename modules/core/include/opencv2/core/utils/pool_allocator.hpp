@@ -0,0 +1,60 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_POOL_ALLOCATOR_HPP
+#define OPENCV_CORE_UTILS_POOL_ALLOCATOR_HPP
+
+#include "opencv2/core/mat.hpp"
+
+namespace cv { namespace utils {
+
+//! @addtogroup core_utils
+//! @{
+
+/** @brief Usage counters of the pooling Mat allocator
+
+All values are accumulated since the start of the process.
+*/
+struct PoolAllocatorStats
+{
+    uint64 requests;        //!< number of buffer requests served by the allocator
+    uint64 threadCacheHits; //!< requests served from the cache of the calling thread
+    uint64 globalPoolHits;  //!< requests served from the shared pool
+    size_t retainedBytes;   //!< bytes kept by the thread caches and the shared pool
+    size_t globalPoolBytes; //!< bytes kept by the shared pool
+
+    PoolAllocatorStats() : requests(0), threadCacheHits(0), globalPoolHits(0), retainedBytes(0), globalPoolBytes(0) {}
+
+    //! ratio of requests that have been served without calling fastMalloc()
+    double hitRate() const { return requests ? (double)(threadCacheHits + globalPoolHits) / requests : 0.; }
+};
+
+/** @brief Returns the pooling Mat allocator
+
+Released buffers are not returned to the system but kept in per-thread size-class caches and, once
+a thread cache is full, in a shared pool, so that repeated allocations of the same size are served
+without calling fastMalloc(). Every buffer is rounded up to its size class (at most 25% larger
+than the request).
+
+The allocator can be set per Mat (Mat::allocator) or as the default one via Mat::setDefaultAllocator().
+It is also made the default allocator when the OPENCV_MAT_POOL_ALLOCATOR configuration parameter
+is set. The following parameters control the amount of retained memory:
+- OPENCV_MAT_POOL_LIMIT - limit of the memory retained by the thread caches and the shared pool
+  together (256Mb by default);
+- OPENCV_MAT_POOL_THREAD_CACHE_LIMIT - limit of each thread cache size (16Mb by default).
+
+The cache of a thread is moved into the shared pool when the thread exits (except for WinRT builds).
+The limit can also be changed at runtime through getBufferPoolController(), whose
+getReservedSize() reports the memory retained by both the thread caches and the shared pool.
+*/
+CV_EXPORTS MatAllocator* getPoolMatAllocator();
+
+//! Returns the usage counters of the allocator returned by getPoolMatAllocator()
+CV_EXPORTS PoolAllocatorStats getPoolMatAllocatorStats();
+
+//! @}
+
+}} // namespace
+
+#endif // OPENCV_CORE_UTILS_POOL_ALLOCATOR_HPP
@@ -0,0 +1,106 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_SHARED_ALLOCATOR_HPP
+#define OPENCV_CORE_UTILS_SHARED_ALLOCATOR_HPP
+
+#include "opencv2/core/mat.hpp"
+
+namespace cv { namespace utils {
+
+//! @addtogroup core_utils
+//! @{
+
+/** @brief Returns the shared memory Mat allocator
+
+Every matrix created by the allocator is placed in its own named POSIX shared memory segment, so
+that it can be passed to another process without copying the data: the producer calls
+exportSharedMat() and sends the returned handle (e.g. through a socket or a pipe), the consumer
+calls importSharedMat() and gets a Mat referencing the same memory.
+
+The segments are reference counted across the processes: every mapping of a segment and every
+exported handle that has not been imported yet holds a reference. The segment is removed from
+the system when the last reference is released.
+
+The allocator is available on POSIX systems only, an exception is raised on the other platforms.
+*/
+CV_EXPORTS MatAllocator* getSharedMatAllocator();
+
+/** @brief Description of a matrix allocated by getSharedMatAllocator(), which can be passed to another process
+
+The structure does not contain pointers, so it can be sent as raw bytes.
+*/
+struct SharedMatHandle
+{
+    char name[48];          //!< name of the shared memory segment
+    uint64 offset;          //!< offset of the first matrix element from the beginning of the segment data
+    int dims;               //!< matrix dimensionality
+    int type;               //!< matrix type
+    int size[CV_MAX_DIM];   //!< matrix size
+    uint64 step[CV_MAX_DIM]; //!< matrix steps
+};
+
+/** @brief Makes a matrix available to another process
+
+The matrix (possibly a submatrix) must be allocated by getSharedMatAllocator(). The returned handle
+holds a reference to the segment, so the matrix can be released by the caller right away. The
+reference is passed to the Mat returned by importSharedMat(); a handle that is not going to be
+imported must be released with releaseSharedMatHandle(). Every handle can be imported once.
+*/
+CV_EXPORTS SharedMatHandle exportSharedMat(const Mat& m);
+
+/** @brief Creates a matrix header for the data described by a handle returned by exportSharedMat()
+
+The segment is mapped into the calling process (which may also be the exporting one), the data
+is not copied. The matrix keeps the reference held by the handle.
+*/
+CV_EXPORTS Mat importSharedMat(const SharedMatHandle& handle);
+
+//! Releases the reference held by a handle that is not going to be imported
+CV_EXPORTS void releaseSharedMatHandle(const SharedMatHandle& handle);
+
+/** @brief Ring of shared memory frames of the same size and type
+
+Allocating a new segment for every frame costs system calls and page faults, so frame streams
+should recycle a fixed number of frames: acquire() returns the next frame that is not used
+anymore, neither by the calling process nor by the processes it has been exported to.
+@code
+    utils::SharedMatRing ring(4, Size(1280, 720), CV_8UC3);
+    for(;;)
+    {
+        Mat frame = ring.acquire();
+        if( frame.empty() )
+            continue; // all the frames are still in use, the consumer is behind
+        cap >> frame;
+        utils::SharedMatHandle h = utils::exportSharedMat(frame);
+        send(sock, &h, sizeof(h), 0);
+    }
+@endcode
+*/
+class CV_EXPORTS SharedMatRing
+{
+public:
+    //! creates a ring of n frames of the given size and type
+    SharedMatRing(int n, Size size, int type);
+
+    /** @brief Returns the next free frame
+
+    The frames are checked in the ring order starting after the one returned last time.
+    An empty Mat is returned if all of them are in use.
+    */
+    Mat acquire();
+
+    //! number of frames in the ring
+    int frames() const;
+
+    struct Impl;
+protected:
+    Ptr<Impl> p;
+};
+
+//! @}
+
+}} // namespace
+
+#endif // OPENCV_CORE_UTILS_SHARED_ALLOCATOR_HPP
@@ -57,6 +57,8 @@ enum RegionFlag {
 
 
 class TraceMessage;
+class ChromeTraceStorage;
+class ChromeTraceBuffer;
 
 class TraceStorage {
 public:
@@ -264,6 +266,7 @@ struct TraceManagerThreadLocal
 
 
     mutable cv::Ptr<TraceStorage> storage;
+    mutable cv::Ptr<ChromeTraceBuffer> chrome_buffer;
 
     TraceManagerThreadLocal() :
         threadID(cv::utils::getThreadID()),
@@ -278,6 +281,7 @@ struct TraceManagerThreadLocal
     ~TraceManagerThreadLocal();
 
     TraceStorage* getStorage() const;
+    ChromeTraceBuffer* getChromeBuffer() const;
 
     void recordLocation(const Region::LocationStaticStorage& location);
     void recordRegionEnter(const Region& region);
@@ -335,6 +339,7 @@ public:
     TLSData<TraceManagerThreadLocal> tls;
 
     cv::Ptr<TraceStorage> trace_storage;
+    cv::Ptr<ChromeTraceStorage> chrome_storage;
 private:
     // disable copying
     TraceManager(const TraceManager&);
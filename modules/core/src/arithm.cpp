@@ -50,6 +50,9 @@
 #include "precomp.hpp"
 #include "opencl_kernels_core.hpp"
 
+#include "arithm.simd.hpp"
+#include "arithm.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
+
 namespace cv
 {
 
@@ -80,6 +83,82 @@ enum { OCL_OP_ADD=0, OCL_OP_SUB=1, OCL_OP_RSUB=2, OCL_OP_ABSDIFF=3, OCL_OP_MUL=4
        OCL_OP_AND=9, OCL_OP_OR=10, OCL_OP_XOR=11, OCL_OP_NOT=12, OCL_OP_MIN=13, OCL_OP_MAX=14,
        OCL_OP_RDIV_SCALE=15 };
 
+// Element-wise operations are memory bound, so they only scale with the number of threads
+// on large arrays. The thresholds are the destination sizes in bytes, as log2, at which the
+// single-threaded call takes about 8 times as long as starting a parallel loop (~15us).
+// Measured with one thread: 0.14-0.3ns per destination byte for the additions, the bitwise
+// operations and comparisons, 0.17-0.8ns for the multiplications, divisions and addWeighted.
+static int getArithmParallelThresholdShift( int oclop )
+{
+    switch( oclop )
+    {
+    case OCL_OP_MUL:
+    case OCL_OP_MUL_SCALE:
+    case OCL_OP_ADDW:
+    case OCL_OP_DIV_SCALE:
+    case OCL_OP_RDIV_SCALE:
+    case OCL_OP_RECIP_SCALE:
+        return 19;
+    default:
+        return 20;
+    }
+}
+
+class BinaryFuncInvoker : public ParallelLoopBody
+{
+public:
+    BinaryFuncInvoker(const Mat& src1, const Mat& src2, Mat& dst,
+                      BinaryFuncC func, int widthScale, void* usrdata)
+        : src1_(src1), src2_(src2), dst_(dst), func_(func),
+          widthScale_(widthScale), usrdata_(usrdata)
+    {
+    }
+
+    void operator()( const Range& range ) const
+    {
+        // the whole arrays are processed as is, they may be empty
+        if( range.start == 0 && range.end == dst_.rows )
+        {
+            run(src1_, src2_, dst_);
+            return;
+        }
+        Mat src1 = src1_.rowRange(range), src2 = src2_.rowRange(range), dst = dst_.rowRange(range);
+        run(src1, src2, dst);
+    }
+
+private:
+    void run( const Mat& src1, const Mat& src2, Mat& dst ) const
+    {
+        Size sz = getContinuousSize(src1, src2, dst, widthScale_);
+        func_(src1.ptr(), src1.step, src2.ptr(), src2.step, dst.ptr(), dst.step, sz.width, sz.height, usrdata_);
+    }
+
+    const Mat& src1_;
+    const Mat& src2_;
+    Mat& dst_;
+    BinaryFuncC func_;
+    int widthScale_;
+    void* usrdata_;
+
+    BinaryFuncInvoker(const BinaryFuncInvoker&);
+    BinaryFuncInvoker& operator=(const BinaryFuncInvoker&);
+};
+
+// Runs func over 2D arrays of the same size, splitting them into row stripes when the arrays are big enough.
+// widthScale is the number of scalars func processes per array element.
+static void runBinaryFunc( const Mat& src1, const Mat& src2, Mat& dst, BinaryFuncC func,
+                           int widthScale, void* usrdata, int oclop )
+{
+    BinaryFuncInvoker invoker(src1, src2, dst, func, widthScale, usrdata);
+    Range all(0, dst.rows);
+    size_t total = dst.total()*dst.elemSize();
+    int shift = getArithmParallelThresholdShift(oclop);
+    if( (total >> shift) != 0 && dst.rows > 1 )
+        parallel_for_(all, invoker, (double)std::max((size_t)1, total >> (shift - 2)));
+    else
+        invoker(all);
+}
+
 #ifdef HAVE_OPENCL
 
 static const char* oclop2str[] = { "OP_ADD", "OP_SUB", "OP_RSUB", "OP_ABSDIFF",
@@ -195,12 +274,10 @@ static void binary_op( InputArray _src1, InputArray _src2, OutputArray _dst,
             func = tab[depth1];
 
         Mat src1 = psrc1->getMat(), src2 = psrc2->getMat(), dst = _dst.getMat();
-        Size sz = getContinuousSize(src1, src2, dst);
-        size_t len = sz.width*(size_t)cn;
+        size_t len = dst.cols*(size_t)cn;
         if( len == (size_t)(int)len )
         {
-            sz.width = (int)len;
-            func(src1.ptr(), src1.step, src2.ptr(), src2.step, dst.ptr(), dst.step, sz.width, sz.height, 0);
+            runBinaryFunc(src1, src2, dst, func, cn, 0, oclop);
             return;
         }
     }
@@ -626,8 +703,7 @@ static void arithm_op(InputArray _src1, InputArray _src2, OutputArray _dst,
                           usrdata, oclop, false))
 
         Mat src1 = psrc1->getMat(), src2 = psrc2->getMat(), dst = _dst.getMat();
-        Size sz = getContinuousSize(src1, src2, dst, src1.channels());
-        tab[depth1](src1.ptr(), src1.step, src2.ptr(), src2.step, dst.ptr(), dst.step, sz.width, sz.height, usrdata);
+        runBinaryFunc(src1, src2, dst, tab[depth1], src1.channels(), usrdata, oclop);
         return;
     }
 
@@ -1268,8 +1344,7 @@ void cv::compare(InputArray _src1, InputArray _src2, OutputArray _dst, int op)
         int cn = src1.channels();
         _dst.create(src1.size(), CV_8UC(cn));
         Mat dst = _dst.getMat();
-        Size sz = getContinuousSize(src1, src2, dst, src1.channels());
-        getCmpFunc(src1.depth())(src1.ptr(), src1.step, src2.ptr(), src2.step, dst.ptr(), dst.step, sz.width, sz.height, &op);
+        runBinaryFunc(src1, src2, dst, getCmpFunc(src1.depth()), cn, &op, -1);
         return;
     }
 
@@ -2199,7 +2274,8 @@ void add8u( const uchar* src1, size_t step1,
 {
     CALL_HAL(add8u, cv_hal_add8u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_E_12(ippiAdd_8u_C1RSfs)
-    (vBinOp<uchar, cv::OpAdd<uchar>, IF_SIMD(VAdd<uchar>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(add8u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void add8s( const schar* src1, size_t step1,
@@ -2207,7 +2283,8 @@ void add8s( const schar* src1, size_t step1,
                    schar* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(add8s, cv_hal_add8s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp<schar, cv::OpAdd<schar>, IF_SIMD(VAdd<schar>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(add8s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void add16u( const ushort* src1, size_t step1,
@@ -2216,7 +2293,8 @@ void add16u( const ushort* src1, size_t step1,
 {
     CALL_HAL(add16u, cv_hal_add16u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_E_12(ippiAdd_16u_C1RSfs)
-    (vBinOp<ushort, cv::OpAdd<ushort>, IF_SIMD(VAdd<ushort>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(add16u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void add16s( const short* src1, size_t step1,
@@ -2225,7 +2303,8 @@ void add16s( const short* src1, size_t step1,
 {
     CALL_HAL(add16s, cv_hal_add16s, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_E_12(ippiAdd_16s_C1RSfs)
-    (vBinOp<short, cv::OpAdd<short>, IF_SIMD(VAdd<short>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(add16s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void add32s( const int* src1, size_t step1,
@@ -2233,7 +2312,8 @@ void add32s( const int* src1, size_t step1,
                     int* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(add32s, cv_hal_add32s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp32<int, cv::OpAdd<int>, IF_SIMD(VAdd<int>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(add32s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void add32f( const float* src1, size_t step1,
@@ -2242,7 +2322,8 @@ void add32f( const float* src1, size_t step1,
 {
     CALL_HAL(add32f, cv_hal_add32f, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_12(ippiAdd_32f_C1R)
-    (vBinOp32<float, cv::OpAdd<float>, IF_SIMD(VAdd<float>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(add32f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void add64f( const double* src1, size_t step1,
@@ -2250,7 +2331,8 @@ void add64f( const double* src1, size_t step1,
                     double* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(add64f, cv_hal_add64f, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp64<double, cv::OpAdd<double>, IF_SIMD(VAdd<double>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(add64f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 //=======================================
@@ -2263,7 +2345,8 @@ void sub8u( const uchar* src1, size_t step1,
 {
     CALL_HAL(sub8u, cv_hal_sub8u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_E_21(ippiSub_8u_C1RSfs)
-    (vBinOp<uchar, cv::OpSub<uchar>, IF_SIMD(VSub<uchar>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(sub8u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void sub8s( const schar* src1, size_t step1,
@@ -2271,7 +2354,8 @@ void sub8s( const schar* src1, size_t step1,
                    schar* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(sub8s, cv_hal_sub8s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp<schar, cv::OpSub<schar>, IF_SIMD(VSub<schar>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(sub8s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void sub16u( const ushort* src1, size_t step1,
@@ -2280,7 +2364,8 @@ void sub16u( const ushort* src1, size_t step1,
 {
     CALL_HAL(sub16u, cv_hal_sub16u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_E_21(ippiSub_16u_C1RSfs)
-    (vBinOp<ushort, cv::OpSub<ushort>, IF_SIMD(VSub<ushort>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(sub16u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void sub16s( const short* src1, size_t step1,
@@ -2289,7 +2374,8 @@ void sub16s( const short* src1, size_t step1,
 {
     CALL_HAL(sub16s, cv_hal_sub16s, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_E_21(ippiSub_16s_C1RSfs)
-    (vBinOp<short, cv::OpSub<short>, IF_SIMD(VSub<short>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(sub16s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void sub32s( const int* src1, size_t step1,
@@ -2297,7 +2383,8 @@ void sub32s( const int* src1, size_t step1,
                     int* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(sub32s, cv_hal_sub32s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp32<int, cv::OpSub<int>, IF_SIMD(VSub<int>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(sub32s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void sub32f( const float* src1, size_t step1,
@@ -2306,7 +2393,8 @@ void sub32f( const float* src1, size_t step1,
 {
     CALL_HAL(sub32f, cv_hal_sub32f, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_21(ippiSub_32f_C1R)
-    (vBinOp32<float, cv::OpSub<float>, IF_SIMD(VSub<float>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(sub32f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void sub64f( const double* src1, size_t step1,
@@ -2314,7 +2402,8 @@ void sub64f( const double* src1, size_t step1,
                     double* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(sub64f, cv_hal_sub64f, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp64<double, cv::OpSub<double>, IF_SIMD(VSub<double>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(sub64f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 //=======================================
@@ -2357,7 +2446,8 @@ void max8u( const uchar* src1, size_t step1,
 {
     CALL_HAL(max8u, cv_hal_max8u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_MIN_MAX(ippsMaxEvery_8u, uchar)
-    vBinOp<uchar, cv::OpMax<uchar>, IF_SIMD(VMax<uchar>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(max8u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void max8s( const schar* src1, size_t step1,
@@ -2365,7 +2455,8 @@ void max8s( const schar* src1, size_t step1,
                    schar* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(max8s, cv_hal_max8s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp<schar, cv::OpMax<schar>, IF_SIMD(VMax<schar>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(max8s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void max16u( const ushort* src1, size_t step1,
@@ -2374,7 +2465,8 @@ void max16u( const ushort* src1, size_t step1,
 {
     CALL_HAL(max16u, cv_hal_max16u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_MIN_MAX(ippsMaxEvery_16u, ushort)
-    vBinOp<ushort, cv::OpMax<ushort>, IF_SIMD(VMax<ushort>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(max16u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void max16s( const short* src1, size_t step1,
@@ -2382,7 +2474,8 @@ void max16s( const short* src1, size_t step1,
                     short* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(max16s, cv_hal_max16s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp<short, cv::OpMax<short>, IF_SIMD(VMax<short>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(max16s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void max32s( const int* src1, size_t step1,
@@ -2390,7 +2483,8 @@ void max32s( const int* src1, size_t step1,
                     int* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(max32s, cv_hal_max32s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp32<int, cv::OpMax<int>, IF_SIMD(VMax<int>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(max32s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void max32f( const float* src1, size_t step1,
@@ -2399,7 +2493,8 @@ void max32f( const float* src1, size_t step1,
 {
     CALL_HAL(max32f, cv_hal_max32f, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_MIN_MAX(ippsMaxEvery_32f, float)
-    vBinOp32<float, cv::OpMax<float>, IF_SIMD(VMax<float>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(max32f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void max64f( const double* src1, size_t step1,
@@ -2408,7 +2503,8 @@ void max64f( const double* src1, size_t step1,
 {
     CALL_HAL(max64f, cv_hal_max64f, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_MIN_MAX(ippsMaxEvery_64f, double)
-    vBinOp64<double, cv::OpMax<double>, IF_SIMD(VMax<double>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(max64f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 //=======================================
@@ -2421,7 +2517,8 @@ void min8u( const uchar* src1, size_t step1,
 {
     CALL_HAL(min8u, cv_hal_min8u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_MIN_MAX(ippsMinEvery_8u, uchar)
-    vBinOp<uchar, cv::OpMin<uchar>, IF_SIMD(VMin<uchar>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(min8u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void min8s( const schar* src1, size_t step1,
@@ -2429,7 +2526,8 @@ void min8s( const schar* src1, size_t step1,
                    schar* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(min8s, cv_hal_min8s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp<schar, cv::OpMin<schar>, IF_SIMD(VMin<schar>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(min8s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void min16u( const ushort* src1, size_t step1,
@@ -2438,7 +2536,8 @@ void min16u( const ushort* src1, size_t step1,
 {
     CALL_HAL(min16u, cv_hal_min16u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_MIN_MAX(ippsMinEvery_16u, ushort)
-    vBinOp<ushort, cv::OpMin<ushort>, IF_SIMD(VMin<ushort>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(min16u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void min16s( const short* src1, size_t step1,
@@ -2446,7 +2545,8 @@ void min16s( const short* src1, size_t step1,
                     short* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(min16s, cv_hal_min16s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp<short, cv::OpMin<short>, IF_SIMD(VMin<short>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(min16s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void min32s( const int* src1, size_t step1,
@@ -2454,7 +2554,8 @@ void min32s( const int* src1, size_t step1,
                     int* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(min32s, cv_hal_min32s, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp32<int, cv::OpMin<int>, IF_SIMD(VMin<int>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(min32s, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void min32f( const float* src1, size_t step1,
@@ -2463,7 +2564,8 @@ void min32f( const float* src1, size_t step1,
 {
     CALL_HAL(min32f, cv_hal_min32f, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_MIN_MAX(ippsMinEvery_32f, float)
-    vBinOp32<float, cv::OpMin<float>, IF_SIMD(VMin<float>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(min32f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void min64f( const double* src1, size_t step1,
@@ -2472,7 +2574,8 @@ void min64f( const double* src1, size_t step1,
 {
     CALL_HAL(min64f, cv_hal_min64f, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_MIN_MAX(ippsMinEvery_64f, double)
-    vBinOp64<double, cv::OpMin<double>, IF_SIMD(VMin<double>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(min64f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 //=======================================
@@ -2485,7 +2588,8 @@ void absdiff8u( const uchar* src1, size_t step1,
 {
     CALL_HAL(absdiff8u, cv_hal_absdiff8u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_12(ippiAbsDiff_8u_C1R)
-    (vBinOp<uchar, cv::OpAbsDiff<uchar>, IF_SIMD(VAbsDiff<uchar>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(absdiff8u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void absdiff8s( const schar* src1, size_t step1,
@@ -2502,7 +2606,8 @@ void absdiff16u( const ushort* src1, size_t step1,
 {
     CALL_HAL(absdiff16u, cv_hal_absdiff16u, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_12(ippiAbsDiff_16u_C1R)
-    (vBinOp<ushort, cv::OpAbsDiff<ushort>, IF_SIMD(VAbsDiff<ushort>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(absdiff16u, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void absdiff16s( const short* src1, size_t step1,
@@ -2527,7 +2632,8 @@ void absdiff32f( const float* src1, size_t step1,
 {
     CALL_HAL(absdiff32f, cv_hal_absdiff32f, src1, step1, src2, step2, dst, step, width, height)
     CALL_IPP_BIN_12(ippiAbsDiff_32f_C1R)
-    (vBinOp32<float, cv::OpAbsDiff<float>, IF_SIMD(VAbsDiff<float>)>(src1, step1, src2, step2, dst, step, width, height));
+    CV_CPU_DISPATCH(absdiff32f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 void absdiff64f( const double* src1, size_t step1,
@@ -2535,7 +2641,8 @@ void absdiff64f( const double* src1, size_t step1,
                         double* dst, size_t step, int width, int height, void* )
 {
     CALL_HAL(absdiff64f, cv_hal_absdiff64f, src1, step1, src2, step2, dst, step, width, height)
-    vBinOp64<double, cv::OpAbsDiff<double>, IF_SIMD(VAbsDiff<double>)>(src1, step1, src2, step2, dst, step, width, height);
+    CV_CPU_DISPATCH(absdiff64f, (src1, step1, src2, step2, dst, step, width, height),
+        CV_CPU_DISPATCH_MODES_ALL);
 }
 
 //=======================================
@@ -0,0 +1,156 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv { namespace hal {
+
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// forward declarations
+#define CV_ARITHM_SIMD_DECL(fun, T) \
+    void fun(const T* src1, size_t step1, const T* src2, size_t step2, T* dst, size_t step, int width, int height);
+
+CV_ARITHM_SIMD_DECL(add8u, uchar)
+CV_ARITHM_SIMD_DECL(add8s, schar)
+CV_ARITHM_SIMD_DECL(add16u, ushort)
+CV_ARITHM_SIMD_DECL(add16s, short)
+CV_ARITHM_SIMD_DECL(add32s, int)
+CV_ARITHM_SIMD_DECL(add32f, float)
+CV_ARITHM_SIMD_DECL(add64f, double)
+CV_ARITHM_SIMD_DECL(sub8u, uchar)
+CV_ARITHM_SIMD_DECL(sub8s, schar)
+CV_ARITHM_SIMD_DECL(sub16u, ushort)
+CV_ARITHM_SIMD_DECL(sub16s, short)
+CV_ARITHM_SIMD_DECL(sub32s, int)
+CV_ARITHM_SIMD_DECL(sub32f, float)
+CV_ARITHM_SIMD_DECL(sub64f, double)
+CV_ARITHM_SIMD_DECL(max8u, uchar)
+CV_ARITHM_SIMD_DECL(max8s, schar)
+CV_ARITHM_SIMD_DECL(max16u, ushort)
+CV_ARITHM_SIMD_DECL(max16s, short)
+CV_ARITHM_SIMD_DECL(max32s, int)
+CV_ARITHM_SIMD_DECL(max32f, float)
+CV_ARITHM_SIMD_DECL(max64f, double)
+CV_ARITHM_SIMD_DECL(min8u, uchar)
+CV_ARITHM_SIMD_DECL(min8s, schar)
+CV_ARITHM_SIMD_DECL(min16u, ushort)
+CV_ARITHM_SIMD_DECL(min16s, short)
+CV_ARITHM_SIMD_DECL(min32s, int)
+CV_ARITHM_SIMD_DECL(min32f, float)
+CV_ARITHM_SIMD_DECL(min64f, double)
+CV_ARITHM_SIMD_DECL(absdiff8u, uchar)
+CV_ARITHM_SIMD_DECL(absdiff16u, ushort)
+CV_ARITHM_SIMD_DECL(absdiff32f, float)
+CV_ARITHM_SIMD_DECL(absdiff64f, double)
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+namespace {
+
+// the widest vector type of the current optimization mode for the element type T
+template<typename T> struct VecArithm { typedef void vtype; };
+
+#if CV_SIMD
+template<> struct VecArithm<uchar>  { typedef v_uint8 vtype; };
+template<> struct VecArithm<schar>  { typedef v_int8 vtype; };
+template<> struct VecArithm<ushort> { typedef v_uint16 vtype; };
+template<> struct VecArithm<short>  { typedef v_int16 vtype; };
+template<> struct VecArithm<int>    { typedef v_int32 vtype; };
+template<> struct VecArithm<float>  { typedef v_float32 vtype; };
+#if CV_SIMD_64F
+template<> struct VecArithm<double> { typedef v_float64 vtype; };
+#endif
+#endif
+
+// the vector operations follow the saturation rules of the scalar ones from arithm_core.hpp
+struct VecOpAdd { template<typename V> V operator()(const V& a, const V& b) const { return a + b; } };
+struct VecOpSub { template<typename V> V operator()(const V& a, const V& b) const { return a - b; } };
+struct VecOpMin { template<typename V> V operator()(const V& a, const V& b) const { return v_min(a, b); } };
+struct VecOpMax { template<typename V> V operator()(const V& a, const V& b) const { return v_max(a, b); } };
+struct VecOpAbsDiff { template<typename V> V operator()(const V& a, const V& b) const { return v_absdiff(a, b); } };
+
+template<typename T, class VOp, typename V> struct BinOpRow
+{
+    static int run(const T* src1, const T* src2, T* dst, int width)
+    {
+        VOp vop;
+        int x = 0;
+        for( ; x <= width - 2*V::nlanes; x += 2*V::nlanes )
+        {
+            V a0 = vx_load(src1 + x), a1 = vx_load(src1 + x + V::nlanes);
+            V b0 = vx_load(src2 + x), b1 = vx_load(src2 + x + V::nlanes);
+            v_store(dst + x, vop(a0, b0));
+            v_store(dst + x + V::nlanes, vop(a1, b1));
+        }
+        return x;
+    }
+};
+
+// no vector type for T in this mode
+template<typename T, class VOp> struct BinOpRow<T, VOp, void>
+{
+    static int run(const T*, const T*, T*, int) { return 0; }
+};
+
+template<typename T, class Op, class VOp>
+static void binOp_(const T* src1, size_t step1, const T* src2, size_t step2,
+                   T* dst, size_t step, int width, int height)
+{
+    Op op;
+    for( ; height--; src1 = (const T*)((const uchar*)src1 + step1),
+                     src2 = (const T*)((const uchar*)src2 + step2),
+                     dst = (T*)((uchar*)dst + step) )
+    {
+        int x = BinOpRow<T, VOp, typename VecArithm<T>::vtype>::run(src1, src2, dst, width);
+        for( ; x < width; x++ )
+            dst[x] = op(src1[x], src2[x]);
+    }
+}
+
+} // namespace
+
+#define CV_ARITHM_SIMD_IMPL(fun, T, Op, VOp) \
+    void fun(const T* src1, size_t step1, const T* src2, size_t step2, T* dst, size_t step, int width, int height) \
+    { \
+        binOp_<T, Op, VOp>(src1, step1, src2, step2, dst, step, width, height); \
+    }
+
+CV_ARITHM_SIMD_IMPL(add8u, uchar, cv::OpAdd<uchar>, VecOpAdd)
+CV_ARITHM_SIMD_IMPL(add8s, schar, cv::OpAdd<schar>, VecOpAdd)
+CV_ARITHM_SIMD_IMPL(add16u, ushort, cv::OpAdd<ushort>, VecOpAdd)
+CV_ARITHM_SIMD_IMPL(add16s, short, cv::OpAdd<short>, VecOpAdd)
+CV_ARITHM_SIMD_IMPL(add32s, int, cv::OpAdd<int>, VecOpAdd)
+CV_ARITHM_SIMD_IMPL(add32f, float, cv::OpAdd<float>, VecOpAdd)
+CV_ARITHM_SIMD_IMPL(add64f, double, cv::OpAdd<double>, VecOpAdd)
+CV_ARITHM_SIMD_IMPL(sub8u, uchar, cv::OpSub<uchar>, VecOpSub)
+CV_ARITHM_SIMD_IMPL(sub8s, schar, cv::OpSub<schar>, VecOpSub)
+CV_ARITHM_SIMD_IMPL(sub16u, ushort, cv::OpSub<ushort>, VecOpSub)
+CV_ARITHM_SIMD_IMPL(sub16s, short, cv::OpSub<short>, VecOpSub)
+CV_ARITHM_SIMD_IMPL(sub32s, int, cv::OpSub<int>, VecOpSub)
+CV_ARITHM_SIMD_IMPL(sub32f, float, cv::OpSub<float>, VecOpSub)
+CV_ARITHM_SIMD_IMPL(sub64f, double, cv::OpSub<double>, VecOpSub)
+CV_ARITHM_SIMD_IMPL(max8u, uchar, cv::OpMax<uchar>, VecOpMax)
+CV_ARITHM_SIMD_IMPL(max8s, schar, cv::OpMax<schar>, VecOpMax)
+CV_ARITHM_SIMD_IMPL(max16u, ushort, cv::OpMax<ushort>, VecOpMax)
+CV_ARITHM_SIMD_IMPL(max16s, short, cv::OpMax<short>, VecOpMax)
+CV_ARITHM_SIMD_IMPL(max32s, int, cv::OpMax<int>, VecOpMax)
+CV_ARITHM_SIMD_IMPL(max32f, float, cv::OpMax<float>, VecOpMax)
+CV_ARITHM_SIMD_IMPL(max64f, double, cv::OpMax<double>, VecOpMax)
+CV_ARITHM_SIMD_IMPL(min8u, uchar, cv::OpMin<uchar>, VecOpMin)
+CV_ARITHM_SIMD_IMPL(min8s, schar, cv::OpMin<schar>, VecOpMin)
+CV_ARITHM_SIMD_IMPL(min16u, ushort, cv::OpMin<ushort>, VecOpMin)
+CV_ARITHM_SIMD_IMPL(min16s, short, cv::OpMin<short>, VecOpMin)
+CV_ARITHM_SIMD_IMPL(min32s, int, cv::OpMin<int>, VecOpMin)
+CV_ARITHM_SIMD_IMPL(min32f, float, cv::OpMin<float>, VecOpMin)
+CV_ARITHM_SIMD_IMPL(min64f, double, cv::OpMin<double>, VecOpMin)
+CV_ARITHM_SIMD_IMPL(absdiff8u, uchar, cv::OpAbsDiff<uchar>, VecOpAbsDiff)
+CV_ARITHM_SIMD_IMPL(absdiff16u, ushort, cv::OpAbsDiff<ushort>, VecOpAbsDiff)
+CV_ARITHM_SIMD_IMPL(absdiff32f, float, cv::OpAbsDiff<float>, VecOpAbsDiff)
+CV_ARITHM_SIMD_IMPL(absdiff64f, double, cv::OpAbsDiff<double>, VecOpAbsDiff)
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+}} // namespace
@@ -0,0 +1,259 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/bufferpool.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+#include "opencv2/core/utils/buffer_pool.private.hpp"
+
+#ifdef _WIN32
+#ifndef WINRT
+#include <windows.h>
+#endif
+#else
+#include <pthread.h>
+#endif
+
+namespace cv {
+
+namespace {
+
+struct ScratchBlock
+{
+    size_t ofs;
+    size_t size;
+    bool released;
+};
+
+// Stack-style arena of one thread. Blocks are taken from the top; a block released out of order
+// is only marked, its space is reclaimed once all the blocks above it are released too.
+// The arena memory is reallocated only while there are no live blocks.
+struct ScratchArena
+{
+    ScratchArena() : base(0), capacity(0), top(0), required(0), shrink(false), registered(false) {}
+    ~ScratchArena() { fastFree(base); }
+
+    Mutex mutex; // taken by the owner thread, the controller and the threads releasing foreign blocks
+    uchar* base;
+    size_t capacity;
+    size_t top;
+    size_t required; // the largest arena size requested since the last reallocation
+    bool shrink;     // free the memory once the arena is empty
+    bool registered; // the memory is freed on thread exit
+    std::vector<ScratchBlock> blocks;
+};
+
+class ScratchBufferPool : public BufferPoolController
+{
+public:
+    ScratchBufferPool() : reservedSize_(0)
+    {
+        maxReservedSize_ = utils::getConfigurationParameterSizeT("OPENCV_CPU_BUFFERPOOL_LIMIT", 8*1024*1024);
+#ifdef _WIN32
+#ifndef WINRT
+        exitKey_ = FlsAlloc(onThreadExit);
+        CV_Assert(exitKey_ != FLS_OUT_OF_INDEXES);
+#endif
+#else
+        CV_Assert(pthread_key_create(&exitKey_, onThreadExit) == 0);
+#endif
+    }
+    virtual ~ScratchBufferPool() {}
+
+    void* allocate(size_t size, void*& owner)
+    {
+        size_t asize = alignSize(std::max(size, (size_t)1), CV_MALLOC_ALIGN);
+        ScratchArena& a = getArena();
+        {
+            AutoLock lock(a.mutex);
+            if( a.blocks.empty() )
+                reserve(a);
+            if( a.top + asize <= a.capacity )
+            {
+                ScratchBlock b = { a.top, asize, false };
+                a.blocks.push_back(b);
+                a.top += asize;
+                owner = &a;
+                return a.base + b.ofs;
+            }
+            a.required = std::max(a.required, a.top + asize);
+        }
+        owner = 0;
+        return fastMalloc(size);
+    }
+
+    void release(void* ptr, void* owner)
+    {
+        if( !owner )
+        {
+            fastFree(ptr);
+            return;
+        }
+        ScratchArena& a = *(ScratchArena*)owner;
+        AutoLock lock(a.mutex);
+        size_t ofs = (uchar*)ptr - a.base;
+        size_t i = a.blocks.size();
+        while( i > 0 && a.blocks[i-1].ofs != ofs )
+            i--;
+        CV_Assert(i > 0 && !a.blocks[i-1].released);
+        a.blocks[i-1].released = true;
+        while( !a.blocks.empty() && a.blocks.back().released )
+            a.blocks.pop_back();
+        a.top = a.blocks.empty() ? 0 : a.blocks.back().ofs + a.blocks.back().size;
+        if( a.blocks.empty() && a.shrink )
+            freeMemory(a);
+    }
+
+    size_t getReservedSize() const
+    {
+        AutoLock lock(mutex_);
+        return reservedSize_;
+    }
+
+    size_t getMaxReservedSize() const
+    {
+        AutoLock lock(mutex_);
+        return maxReservedSize_;
+    }
+
+    void setMaxReservedSize(size_t size)
+    {
+        {
+            AutoLock lock(mutex_);
+            maxReservedSize_ = size;
+        }
+        // the arenas are released until their total size fits the new limit
+        std::vector<ScratchArena*> arenas;
+        tls_.gather(arenas);
+        for( size_t i = 0; i < arenas.size() && getReservedSize() > size; i++ )
+        {
+            ScratchArena& a = *arenas[i];
+            AutoLock lock(a.mutex);
+            if( a.blocks.empty() )
+                freeMemory(a);
+            else
+                a.shrink = true;
+        }
+    }
+
+    void freeAllReservedBuffers()
+    {
+        std::vector<ScratchArena*> arenas;
+        tls_.gather(arenas);
+        for( size_t i = 0; i < arenas.size(); i++ )
+        {
+            ScratchArena& a = *arenas[i];
+            AutoLock lock(a.mutex);
+            if( a.blocks.empty() )
+                freeMemory(a);
+            else
+                a.shrink = true;
+        }
+    }
+
+protected:
+    ScratchArena& getArena()
+    {
+        ScratchArena& a = tls_.getRef();
+        if( !a.registered )
+        {
+            a.registered = true;
+#ifdef _WIN32
+#ifndef WINRT
+            FlsSetValue(exitKey_, &a);
+#endif
+#else
+            pthread_setspecific(exitKey_, &a);
+#endif
+        }
+        return a;
+    }
+
+    // grows the empty arena up to the largest size requested so far, while all the arenas fit the limit
+    void reserve(ScratchArena& a)
+    {
+        if( a.required <= a.capacity )
+            return;
+        size_t newCapacity = alignSize(a.required, 4096);
+        a.required = 0;
+        {
+            AutoLock lock(mutex_);
+            size_t others = reservedSize_ - a.capacity;
+            newCapacity = std::min(newCapacity, maxReservedSize_ > others ? maxReservedSize_ - others : 0);
+            if( newCapacity <= a.capacity )
+                return;
+            reservedSize_ += newCapacity - a.capacity;
+        }
+        fastFree(a.base);
+        a.base = (uchar*)fastMalloc(newCapacity);
+        a.capacity = newCapacity;
+    }
+
+    // the caller holds the arena lock, the arena must be empty
+    void freeMemory(ScratchArena& a)
+    {
+        CV_DbgAssert(a.blocks.empty());
+        {
+            AutoLock lock(mutex_);
+            reservedSize_ -= a.capacity;
+        }
+        fastFree(a.base);
+        a.base = 0;
+        a.capacity = 0;
+        a.required = 0;
+        a.shrink = false;
+    }
+
+    static void CV_STDCALL onThreadExit(void* a);
+
+    // the arena objects stay in TLSData after thread exit, only their memory is freed (see onThreadExit)
+    TLSData<ScratchArena> tls_;
+#ifdef _WIN32
+#ifndef WINRT
+    DWORD exitKey_;
+#endif
+#else
+    pthread_key_t exitKey_;
+#endif
+
+    mutable Mutex mutex_;
+    size_t reservedSize_; // the total capacity of the arenas, bounded by maxReservedSize_
+    size_t maxReservedSize_;
+};
+
+static ScratchBufferPool& getScratchBufferPool()
+{
+    CV_SINGLETON_LAZY_INIT_REF(ScratchBufferPool, new ScratchBufferPool())
+}
+
+void CV_STDCALL ScratchBufferPool::onThreadExit(void* arena)
+{
+    ScratchArena& a = *(ScratchArena*)arena;
+    AutoLock lock(a.mutex);
+    // blocks still in use are returned by other threads, the memory is freed with the last one
+    if( a.blocks.empty() )
+        getScratchBufferPool().freeMemory(a);
+    else
+        a.shrink = true;
+    a.registered = false; // the thread may still allocate buffers from other TLS destructors
+}
+
+} // namespace
+
+void* utils::allocateScratchBuffer(size_t size, void*& owner)
+{
+    return getScratchBufferPool().allocate(size, owner);
+}
+
+void utils::releaseScratchBuffer(void* ptr, void* owner)
+{
+    getScratchBufferPool().release(ptr, owner);
+}
+
+BufferPoolController* getCPUBufferPoolController()
+{
+    return &getScratchBufferPool();
+}
+
+} // namespace cv
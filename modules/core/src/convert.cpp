@@ -3815,6 +3815,96 @@ static UnaryFunc getConvertFuncFp16(int ddepth)
     return cvtTab[CV_MAT_DEPTH(ddepth)];
 }
 
+// bfloat16 keeps the upper half of the FP32 representation; the conversion from FP32 rounds to nearest even
+static inline ushort cvtBF16SW(float x)
+{
+    Cv32suf u;
+    u.f = x;
+    if( (u.u & 0x7fffffff) > 0x7f800000 )
+        return (ushort)((u.u >> 16) | 0x40); // keep NaN quiet
+    return (ushort)((u.u + 0x7fff + ((u.u >> 16) & 1)) >> 16);
+}
+
+static inline float cvtBF16SW(ushort x)
+{
+    Cv32suf u;
+    u.u = (unsigned)x << 16;
+    return u.f;
+}
+
+static void cvtBF16_32f16u( const uchar* src_, size_t sstep, uchar* dst_, size_t dstep, Size size, void* )
+{
+    const float* src = (const float*)src_;
+    ushort* dst = (ushort*)dst_;
+    sstep /= sizeof(src[0]);
+    dstep /= sizeof(dst[0]);
+
+    for( ; size.height--; src += sstep, dst += dstep )
+    {
+        int x = 0;
+#if CV_SIMD128
+        if( hasSIMD128() )
+        {
+            v_uint32x4 v_mask = v_setall_u32(0x7fffffff), v_one = v_setall_u32(1), v_round = v_setall_u32(0x7fff);
+            v_uint32x4 v_quiet = v_setall_u32(0x40);
+            v_int32x4 v_inf = v_setall_s32(0x7f800000);
+            for( ; x <= size.width - 8; x += 8 )
+            {
+                v_uint32x4 v_src0 = v_reinterpret_as_u32(v_load(src + x));
+                v_uint32x4 v_src1 = v_reinterpret_as_u32(v_load(src + x + 4));
+                v_uint32x4 v_nan0 = v_reinterpret_as_u32(v_reinterpret_as_s32(v_src0 & v_mask) > v_inf);
+                v_uint32x4 v_nan1 = v_reinterpret_as_u32(v_reinterpret_as_s32(v_src1 & v_mask) > v_inf);
+                v_uint32x4 v_dst0 = (v_src0 + v_round + ((v_src0 >> 16) & v_one)) >> 16;
+                v_uint32x4 v_dst1 = (v_src1 + v_round + ((v_src1 >> 16) & v_one)) >> 16;
+                v_dst0 = v_select(v_nan0, (v_src0 >> 16) | v_quiet, v_dst0);
+                v_dst1 = v_select(v_nan1, (v_src1 >> 16) | v_quiet, v_dst1);
+                v_store(dst + x, v_pack(v_dst0, v_dst1));
+            }
+        }
+#endif
+        for( ; x < size.width; x++ )
+            dst[x] = cvtBF16SW(src[x]);
+    }
+}
+
+static void cvtBF16_16u32f( const uchar* src_, size_t sstep, uchar* dst_, size_t dstep, Size size, void* )
+{
+    const ushort* src = (const ushort*)src_;
+    float* dst = (float*)dst_;
+    sstep /= sizeof(src[0]);
+    dstep /= sizeof(dst[0]);
+
+    for( ; size.height--; src += sstep, dst += dstep )
+    {
+        int x = 0;
+#if CV_SIMD128
+        if( hasSIMD128() )
+        {
+            for( ; x <= size.width - 8; x += 8 )
+            {
+                v_uint32x4 v_dst0, v_dst1;
+                v_expand(v_load(src + x), v_dst0, v_dst1);
+                v_store(dst + x, v_reinterpret_as_f32(v_dst0 << 16));
+                v_store(dst + x + 4, v_reinterpret_as_f32(v_dst1 << 16));
+            }
+        }
+#endif
+        for( ; x < size.width; x++ )
+            dst[x] = cvtBF16SW(src[x]);
+    }
+}
+
+static UnaryFunc getConvertFuncBF16(int ddepth)
+{
+    static UnaryFunc cvtTab[] =
+    {
+        0, 0, cvtBF16_32f16u,
+        0, 0, cvtBF16_16u32f,
+        0, 0,
+    };
+    return cvtTab[CV_MAT_DEPTH(ddepth)];
+}
+
 BinaryFunc getConvertFunc(int sdepth, int ddepth)
 {
     static BinaryFunc cvtTab[][8] =
@@ -4029,6 +4119,36 @@ void cv::convertScaleAbs( InputArray _src, OutputArray _dst, double alpha, doubl
     }
 }
 
+namespace cv
+{
+
+static void convertPacked16( const Mat& src, OutputArray _dst, int ddepth, UnaryFunc func )
+{
+    int type = CV_MAKETYPE(ddepth, src.channels());
+    _dst.create( src.dims, src.size, type );
+    Mat dst = _dst.getMat();
+    int cn = src.channels();
+    CV_Assert( func != 0 );
+
+    if( src.dims <= 2 )
+    {
+        Size sz = getContinuousSize(src, dst, cn);
+        func( src.data, src.step, dst.data, dst.step, sz, 0);
+    }
+    else
+    {
+        const Mat* arrays[] = {&src, &dst, 0};
+        uchar* ptrs[2];
+        NAryMatIterator it(arrays, ptrs);
+        Size sz((int)(it.size*cn), 1);
+
+        for( size_t i = 0; i < it.nplanes; i++, ++it )
+            func(ptrs[0], 1, ptrs[1], 1, sz, 0);
+    }
+}
+
+}
+
 void cv::convertFp16( InputArray _src, OutputArray _dst)
 {
     CV_INSTRUMENT_REGION()
@@ -4051,29 +4171,29 @@ void cv::convertFp16( InputArray _src, OutputArray _dst)
                ocl_convertFp16(_src, _dst, ddepth))
 
     Mat src = _src.getMat();
+    convertPacked16(src, _dst, ddepth, getConvertFuncFp16(ddepth));
+}
 
-    int type = CV_MAKETYPE(ddepth, src.channels());
-    _dst.create( src.dims, src.size, type );
-    Mat dst = _dst.getMat();
-    UnaryFunc func = getConvertFuncFp16(ddepth);
-    int cn = src.channels();
-    CV_Assert( func != 0 );
+void cv::convertBF16( InputArray _src, OutputArray _dst)
+{
+    CV_INSTRUMENT_REGION()
 
-    if( src.dims <= 2 )
+    int ddepth = 0;
+    switch( _src.depth() )
     {
-        Size sz = getContinuousSize(src, dst, cn);
-        func( src.data, src.step, dst.data, dst.step, sz, 0);
+    case CV_32F:
+        ddepth = CV_16U;
+        break;
+    case CV_16U:
+        ddepth = CV_32F;
+        break;
+    default:
+        CV_Error(Error::StsUnsupportedFormat, "Unsupported input depth");
+        return;
     }
-    else
-    {
-        const Mat* arrays[] = {&src, &dst, 0};
-        uchar* ptrs[2];
-        NAryMatIterator it(arrays, ptrs);
-        Size sz((int)(it.size*cn), 1);
 
-        for( size_t i = 0; i < it.nplanes; i++, ++it )
-            func(ptrs[0], 1, ptrs[1], 1, sz, 0);
-    }
+    Mat src = _src.getMat();
+    convertPacked16(src, _dst, ddepth, getConvertFuncBF16(ddepth));
 }
 
 #ifdef HAVE_IPP
@@ -4192,6 +4312,220 @@ void cv::Mat::convertTo(OutputArray _dst, int _type, double alpha, double beta)
     }
 }
 
+/****************************************************************************************\
+*                          split & merge with channel reordering and conversion          *
+\****************************************************************************************/
+
+namespace cv
+{
+
+/*
+ The arrays are processed by blocks of BLOCK_SIZE pixels, several blocks per task of parallel_for_.
+ A block of the interleaved array is split into (or merged from) planes in a small buffer, and
+ the planes are converted from (or to) the single-channel arrays while they are in the cache.
+*/
+class SplitMergeConvert_Invoker : public ParallelLoopBody
+{
+public:
+    SplitMergeConvert_Invoker(const Mat& _inter, const Mat* _planes, int _nplanes, int _ncn, const int* _order,
+                              const Scalar& _scale, const Scalar& _shift, bool _split) :
+        inter(_inter), planes(_planes), nplanes(_nplanes), ncn(_ncn), order(_order), split(_split)
+    {
+        // the interleaved array has ncn channels in case of split and nplanes channels in case of merge
+        int sdepth = split ? inter.depth() : planes[0].depth();
+        int ddepth = split ? planes[0].depth() : inter.depth();
+        nblocks = (inter.cols + BLOCK_SIZE - 1)/BLOCK_SIZE;
+        for( int j = 0; j < nplanes; j++ )
+        {
+            coeffs[j][0] = _scale[j];
+            coeffs[j][1] = _shift[j];
+            bool noScale = fabs(coeffs[j][0] - 1) < DBL_EPSILON && fabs(coeffs[j][1]) < DBL_EPSILON;
+            copy[j] = noScale && sdepth == ddepth;
+            cvt[j] = copy[j] ? 0 : noScale ? getConvertFunc(sdepth, ddepth) : getConvertScaleFunc(sdepth, ddepth);
+            CV_Assert( copy[j] || cvt[j] != 0 );
+        }
+    }
+
+    void operator()(const Range& range) const
+    {
+        if( split )
+            splitBlocks(range);
+        else
+            mergeBlocks(range);
+    }
+
+private:
+    void splitBlocks(const Range& range) const
+    {
+        size_t esz1 = inter.elemSize1(), desz = planes[0].elemSize();
+        SplitFunc splitFunc = getSplitFunc(inter.depth());
+        AutoBuffer<uchar> _buf(BLOCK_SIZE*esz1*ncn);
+        uchar* tptrs[CV_CN_MAX];
+        for( int c = 0; c < ncn; c++ )
+            tptrs[c] = (uchar*)_buf + BLOCK_SIZE*esz1*c;
+
+        for( int t = range.start; t < range.end; t++ )
+        {
+            int i = t/nblocks, x = t%nblocks*BLOCK_SIZE, len = std::min((int)BLOCK_SIZE, inter.cols - x);
+            const uchar* sptr = inter.data + inter.step*i + x*esz1*ncn;
+            if( ncn > 1 )
+                splitFunc(sptr, tptrs, len, ncn);
+            for( int j = 0; j < nplanes; j++ )
+            {
+                const uchar* tptr = ncn > 1 ? tptrs[order[j]] : sptr;
+                uchar* dptr = planes[j].data + planes[j].step*i + x*desz;
+                if( copy[j] )
+                    memcpy(dptr, tptr, len*desz);
+                else
+                    cvt[j](tptr, 0, 0, 0, dptr, 0, Size(len, 1), (void*)coeffs[j]);
+            }
+        }
+    }
+
+    void mergeBlocks(const Range& range) const
+    {
+        size_t sesz = planes[0].elemSize(), esz1 = inter.elemSize1();
+        MergeFunc mergeFunc = getMergeFunc(inter.depth());
+        AutoBuffer<uchar> _buf(BLOCK_SIZE*esz1*nplanes);
+        const uchar* tptrs[4];
+
+        for( int t = range.start; t < range.end; t++ )
+        {
+            int i = t/nblocks, x = t%nblocks*BLOCK_SIZE, len = std::min((int)BLOCK_SIZE, inter.cols - x);
+            uchar* dptr = inter.data + inter.step*i + x*esz1*nplanes;
+            for( int j = 0; j < nplanes; j++ )
+            {
+                const uchar* sptr = planes[order[j]].data + planes[order[j]].step*i + x*sesz;
+                uchar* tptr = nplanes > 1 ? (uchar*)_buf + BLOCK_SIZE*esz1*j : dptr;
+                if( copy[j] )
+                {
+                    if( nplanes > 1 )
+                        tptr = (uchar*)sptr;
+                    else
+                        memcpy(tptr, sptr, len*sesz);
+                }
+                else
+                    cvt[j](sptr, 0, 0, 0, tptr, 0, Size(len, 1), (void*)coeffs[j]);
+                tptrs[j] = tptr;
+            }
+            if( nplanes > 1 )
+                mergeFunc(tptrs, dptr, len, nplanes);
+        }
+    }
+
+    const Mat& inter;
+    const Mat* planes;
+    int nplanes, ncn, nblocks;
+    const int* order;
+    bool split;
+    double coeffs[4][2];
+    bool copy[4];
+    BinaryFunc cvt[4];
+};
+
+// makes 2D headers of the arrays; continuous arrays are treated as a single row
+static void getSplitMergeHeaders(const Mat& inter, const std::vector<Mat>& planes, Mat& inter2d, std::vector<Mat>& planes2d)
+{
+    bool continuous = inter.isContinuous();
+    for( size_t j = 0; j < planes.size(); j++ )
+        continuous = continuous && planes[j].isContinuous();
+
+    if( continuous )
+    {
+        int total = (int)inter.total();
+        inter2d = Mat(1, total, inter.type(), inter.data);
+        planes2d.resize(planes.size());
+        for( size_t j = 0; j < planes.size(); j++ )
+            planes2d[j] = Mat(1, total, planes[j].type(), planes[j].data);
+    }
+    else
+    {
+        CV_Assert( inter.dims <= 2 );
+        inter2d = inter;
+        planes2d = planes;
+    }
+}
+
+}
+
+void cv::splitConvert(InputArray _src, OutputArrayOfArrays _dst, int ddepth,
+                      const std::vector<int>& _order, const Scalar& scale, const Scalar& shift)
+{
+    CV_INSTRUMENT_REGION()
+
+    Mat src = _src.getMat();
+    if( src.empty() )
+    {
+        _dst.release();
+        return;
+    }
+
+    int cn = src.channels();
+    if( ddepth < 0 )
+        ddepth = src.depth();
+    std::vector<int> order(_order);
+    if( order.empty() )
+        for( int c = 0; c < cn; c++ )
+            order.push_back(c);
+    int n = (int)order.size();
+    CV_Assert( n <= 4 && getConvertFunc(src.depth(), ddepth) != 0 );
+    for( int j = 0; j < n; j++ )
+        CV_Assert( 0 <= order[j] && order[j] < cn );
+
+    _dst.create(n, 1, ddepth);
+    for( int j = 0; j < n; j++ )
+        _dst.create(src.dims, src.size.p, ddepth, j);
+    std::vector<Mat> dst;
+    _dst.getMatVector(dst);
+
+    Mat src2d;
+    std::vector<Mat> dst2d;
+    getSplitMergeHeaders(src, dst, src2d, dst2d);
+
+    int nblocks = (src2d.cols + BLOCK_SIZE - 1)/BLOCK_SIZE;
+    parallel_for_(Range(0, src2d.rows*nblocks),
+                  SplitMergeConvert_Invoker(src2d, &dst2d[0], n, cn, &order[0], scale, shift, true),
+                  src.total()*cn/(double)(1 << 16));
+}
+
+void cv::mergeConvert(InputArrayOfArrays _src, OutputArray _dst, int ddepth,
+                      const std::vector<int>& _order, const Scalar& scale, const Scalar& shift)
+{
+    CV_INSTRUMENT_REGION()
+
+    std::vector<Mat> src;
+    _src.getMatVector(src);
+    CV_Assert( !src.empty() );
+    int nsrc = (int)src.size(), sdepth = src[0].depth();
+    for( int k = 0; k < nsrc; k++ )
+        CV_Assert( src[k].size == src[0].size && src[k].type() == sdepth );
+
+    if( ddepth < 0 )
+        ddepth = sdepth;
+    std::vector<int> order(_order);
+    if( order.empty() )
+        for( int k = 0; k < nsrc; k++ )
+            order.push_back(k);
+    int n = (int)order.size();
+    CV_Assert( 0 < n && n <= 4 && getConvertFunc(sdepth, ddepth) != 0 );
+    for( int j = 0; j < n; j++ )
+        CV_Assert( 0 <= order[j] && order[j] < nsrc );
+
+    _dst.create(src[0].dims, src[0].size.p, CV_MAKETYPE(ddepth, n));
+    Mat dst = _dst.getMat();
+    if( dst.empty() )
+        return;
+
+    Mat dst2d;
+    std::vector<Mat> src2d;
+    getSplitMergeHeaders(dst, src, dst2d, src2d);
+
+    int nblocks = (dst2d.cols + BLOCK_SIZE - 1)/BLOCK_SIZE;
+    parallel_for_(Range(0, dst2d.rows*nblocks),
+                  SplitMergeConvert_Invoker(dst2d, &src2d[0], n, nsrc, &order[0], scale, shift, false),
+                  dst.total()*n/(double)(1 << 16));
+}
+
 /****************************************************************************************\
 *                                    LUT Transform                                       *
 \****************************************************************************************/
@@ -3320,6 +3320,47 @@ Ptr<DFT2D> DFT2D::create(int width, int height, int depth,
 } // cv::
 
 
+namespace cv
+{
+
+static void dftCheckType(int type, int flags)
+{
+    CV_Assert( type == CV_32FC1 || type == CV_32FC2 || type == CV_64FC1 || type == CV_64FC2 );
+
+    // Fail if DFT_COMPLEX_INPUT is specified, but src is not 2 channels.
+    CV_Assert( !((flags & DFT_COMPLEX_INPUT) && CV_MAT_CN(type) != 2) );
+}
+
+static int dftDstType(int type, int flags)
+{
+    bool inv = (flags & DFT_INVERSE) != 0;
+    int depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+
+    if( !inv && cn == 1 && (flags & DFT_COMPLEX_OUTPUT) )
+        return CV_MAKETYPE(depth, 2);
+    if( inv && cn == 2 && (flags & DFT_REAL_OUTPUT) )
+        return depth;
+    return type;
+}
+
+static int dftHalFlags(int flags, bool isContinuous, bool isInplace)
+{
+    int f = 0;
+    if (isContinuous)
+        f |= CV_HAL_DFT_IS_CONTINUOUS;
+    if (flags & DFT_INVERSE)
+        f |= CV_HAL_DFT_INVERSE;
+    if (flags & DFT_ROWS)
+        f |= CV_HAL_DFT_ROWS;
+    if (flags & DFT_SCALE)
+        f |= CV_HAL_DFT_SCALE;
+    if (isInplace)
+        f |= CV_HAL_DFT_IS_INPLACE;
+    return f;
+}
+
+}
+
 void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
 {
     CV_INSTRUMENT_REGION()
@@ -3336,35 +3377,16 @@ void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
 #endif
 
     Mat src0 = _src0.getMat(), src = src0;
-    bool inv = (flags & DFT_INVERSE) != 0;
     int type = src.type();
     int depth = src.depth();
 
-    CV_Assert( type == CV_32FC1 || type == CV_32FC2 || type == CV_64FC1 || type == CV_64FC2 );
-
-    // Fail if DFT_COMPLEX_INPUT is specified, but src is not 2 channels.
-    CV_Assert( !((flags & DFT_COMPLEX_INPUT) && src.channels() != 2) );
+    dftCheckType(type, flags);
 
-    if( !inv && src.channels() == 1 && (flags & DFT_COMPLEX_OUTPUT) )
-        _dst.create( src.size(), CV_MAKETYPE(depth, 2) );
-    else if( inv && src.channels() == 2 && (flags & DFT_REAL_OUTPUT) )
-        _dst.create( src.size(), depth );
-    else
-        _dst.create( src.size(), type );
+    _dst.create( src.size(), dftDstType(type, flags) );
 
     Mat dst = _dst.getMat();
 
-    int f = 0;
-    if (src.isContinuous() && dst.isContinuous())
-        f |= CV_HAL_DFT_IS_CONTINUOUS;
-    if (inv)
-        f |= CV_HAL_DFT_INVERSE;
-    if (flags & DFT_ROWS)
-        f |= CV_HAL_DFT_ROWS;
-    if (flags & DFT_SCALE)
-        f |= CV_HAL_DFT_SCALE;
-    if (src.data == dst.data)
-        f |= CV_HAL_DFT_IS_INPLACE;
+    int f = dftHalFlags(flags, src.isContinuous() && dst.isContinuous(), src.data == dst.data);
     Ptr<hal::DFT2D> c = hal::DFT2D::create(src.cols, src.rows, depth, src.channels(), dst.channels(), f, nonzero_rows);
     c->apply(src.data, src.step, dst.data, dst.step);
 }
@@ -3377,6 +3399,181 @@ void cv::idft( InputArray src, OutputArray dst, int flags, int nonzero_rows )
     dft( src, dst, flags | DFT_INVERSE, nonzero_rows );
 }
 
+//================== DFT plan ======================
+
+namespace cv
+{
+
+// The contexts created by hal::DFT2D::create keep the scratch buffers, so they can not be shared
+// between threads. The plan keeps a pool of them, each call takes a context and returns it back.
+struct DFTPlan::Impl
+{
+    Impl(Size _size, int _type, int _flags) :
+        size(_size), type(_type), dstType(dftDstType(_type, _flags)), flags(_flags)
+    {
+    }
+
+    Ptr<hal::DFT2D> acquire(int f, int nonzeroRows = 0)
+    {
+        std::pair<int, int> key(f, nonzeroRows);
+        {
+            AutoLock lock(mutex);
+            for( size_t i = pool.size(); i > 0; i-- )
+            {
+                if( pool[i-1].first == key )
+                {
+                    Ptr<hal::DFT2D> c = pool[i-1].second;
+                    pool.erase(pool.begin() + (i-1));
+                    return c;
+                }
+            }
+        }
+        return hal::DFT2D::create(size.width, size.height, CV_MAT_DEPTH(type),
+                                  CV_MAT_CN(type), CV_MAT_CN(dstType), f, nonzeroRows);
+    }
+
+    void release(int f, const Ptr<hal::DFT2D>& c, int nonzeroRows = 0)
+    {
+        AutoLock lock(mutex);
+        pool.push_back(std::make_pair(std::make_pair(f, nonzeroRows), c));
+    }
+
+    void apply(const Mat& src, Mat& dst, int nonzeroRows = 0)
+    {
+        // the in-place and continuity flags depend on the arrays, so the pool may keep several kinds of contexts
+        int f = dftHalFlags(flags, src.isContinuous() && dst.isContinuous(), src.data == dst.data);
+        if( nonzeroRows >= size.height )
+            nonzeroRows = 0;
+        ContextHolder c(*this, f, nonzeroRows);
+        c.context->apply(src.data, src.step, dst.data, dst.step);
+    }
+
+    // returns the context into the pool when the call is finished, also if the transform throws
+    struct ContextHolder
+    {
+        ContextHolder(Impl& _plan, int _f, int _nonzeroRows) :
+            plan(_plan), f(_f), nonzeroRows(_nonzeroRows), context(_plan.acquire(_f, _nonzeroRows))
+        {
+        }
+        ~ContextHolder() { plan.release(f, context, nonzeroRows); }
+
+        Impl& plan;
+        int f, nonzeroRows;
+        Ptr<hal::DFT2D> context;
+
+    private:
+        ContextHolder(const ContextHolder&);
+        ContextHolder& operator=(const ContextHolder&);
+    };
+
+    Size size;
+    int type, dstType, flags;
+    Mutex mutex;
+    std::vector<std::pair<std::pair<int, int>, Ptr<hal::DFT2D> > > pool;
+};
+
+class DFTBatch_Invoker : public ParallelLoopBody
+{
+public:
+    DFTBatch_Invoker(DFTPlan::Impl& _plan, const std::vector<Mat>& _src, std::vector<Mat>& _dst) :
+        plan(_plan), src(_src), dst(_dst)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        for( int i = range.start; i < range.end; i++ )
+            plan.apply(src[i], dst[i]);
+    }
+
+private:
+    DFTPlan::Impl& plan;
+    const std::vector<Mat>& src;
+    std::vector<Mat>& dst;
+};
+
+}
+
+cv::DFTPlan::DFTPlan()
+{
+}
+
+cv::DFTPlan::DFTPlan(Size _size, int _type, int _flags)
+{
+    create(_size, _type, _flags);
+}
+
+void cv::DFTPlan::create(Size _size, int _type, int _flags)
+{
+    CV_Assert( _size.width > 0 && _size.height > 0 );
+    dftCheckType(_type, _flags);
+
+    p = makePtr<Impl>(_size, _type, _flags);
+    // creates the first context, so the tables are computed here rather than in the first apply()
+    int f = dftHalFlags(_flags, true, false);
+    p->release(f, p->acquire(f));
+}
+
+bool cv::DFTPlan::empty() const
+{
+    return p.empty();
+}
+
+cv::Size cv::DFTPlan::size() const
+{
+    return p ? p->size : Size();
+}
+
+int cv::DFTPlan::type() const
+{
+    return p ? p->type : -1;
+}
+
+int cv::DFTPlan::dstType() const
+{
+    return p ? p->dstType : -1;
+}
+
+int cv::DFTPlan::flags() const
+{
+    return p ? p->flags : 0;
+}
+
+void cv::DFTPlan::apply(InputArray _src, OutputArray _dst, int nonzeroRows) const
+{
+    CV_INSTRUMENT_REGION()
+
+    CV_Assert( !empty() && nonzeroRows >= 0 );
+    Mat src = _src.getMat();
+    CV_Assert( src.size() == p->size && src.type() == p->type );
+
+    _dst.create(p->size, p->dstType);
+    Mat dst = _dst.getMat();
+    p->apply(src, dst, nonzeroRows);
+}
+
+void cv::DFTPlan::applyBatch(InputArrayOfArrays _src, OutputArrayOfArrays _dst) const
+{
+    CV_INSTRUMENT_REGION()
+
+    CV_Assert( !empty() );
+    std::vector<Mat> src;
+    _src.getMatVector(src);
+    int i, n = (int)src.size();
+    for( i = 0; i < n; i++ )
+        CV_Assert( src[i].size() == p->size && src[i].type() == p->type );
+
+    _dst.create(n, 1, p->dstType, -1, true);
+    std::vector<Mat> dst(n);
+    for( i = 0; i < n; i++ )
+    {
+        _dst.create(p->size, p->dstType, i);
+        dst[i] = _dst.getMat(i);
+    }
+
+    parallel_for_(Range(0, n), DFTBatch_Invoker(*p, src, dst));
+}
+
 #ifdef HAVE_OPENCL
 
 namespace cv {
@@ -223,6 +223,211 @@ private:
     bool onlyDistance;
 };
 
+/*
+k-means++ seeding on a random subset of the samples, so that its cost does not grow with N.
+Used by the mini-batch and the Hamerly modes that target large sample sets.
+*/
+static void generateCentersPPSubset(const Mat& data, Mat& centers, int K, RNG& rng, int trials)
+{
+    const int SPP_SUBSET_SCALE = 16;
+    int N = data.rows, dims = data.cols;
+    if( N <= K*SPP_SUBSET_SCALE )
+    {
+        generateCentersPP(data, centers, K, rng, trials);
+        return;
+    }
+
+    Mat subset(K*SPP_SUBSET_SCALE, dims, CV_32F);
+    for( int i = 0; i < subset.rows; i++ )
+        memcpy(subset.ptr<float>(i), data.ptr<float>(rng.uniform(0, N)), dims*sizeof(float));
+    generateCentersPP(subset, centers, K, rng, trials);
+}
+
+// half of the distance from every center to the nearest other center
+class KMeansCenterDistanceComputer : public ParallelLoopBody
+{
+public:
+    KMeansCenterDistanceComputer( float* _halfDist, const Mat& _centers )
+        : halfDist(_halfDist), centers(_centers)
+    {
+    }
+
+    void operator()( const Range& range ) const
+    {
+        const int K = centers.rows;
+        const int dims = centers.cols;
+
+        for( int k = range.start; k < range.end; k++ )
+        {
+            const float* center = centers.ptr<float>(k);
+            float min_dist = FLT_MAX;
+            for( int k1 = 0; k1 < K; k1++ )
+            {
+                if( k1 != k )
+                    min_dist = std::min(min_dist, normL2Sqr(center, centers.ptr<float>(k1), dims));
+            }
+            halfDist[k] = min_dist < FLT_MAX ? std::sqrt(min_dist)*0.5f : FLT_MAX;
+        }
+    }
+
+private:
+    KMeansCenterDistanceComputer& operator=(const KMeansCenterDistanceComputer&); // to quiet MSVC
+
+    float* halfDist;
+    const Mat& centers;
+};
+
+/*
+Labels assignment with the bounds of Hamerly (2010) "Making k-means even faster":
+upper[i] bounds the distance to the assigned center, lower[i] the distance to any other center.
+The sample can not change its label while the upper bound does not exceed the lower one or
+the half distance from the assigned center to the nearest other center.
+*/
+class KMeansHamerlyDistanceComputer : public ParallelLoopBody
+{
+public:
+    KMeansHamerlyDistanceComputer( int *_labels,
+                                   float *_upper,
+                                   float *_lower,
+                                   const Mat& _data,
+                                   const Mat& _centers,
+                                   const float* _halfDist,
+                                   const float* _shift,
+                                   int _maxShiftIdx,
+                                   float _maxShift,
+                                   float _maxShift2,
+                                   bool _updateBounds )
+        : labels(_labels),
+          upper(_upper),
+          lower(_lower),
+          data(_data),
+          centers(_centers),
+          halfDist(_halfDist),
+          shift(_shift),
+          maxShiftIdx(_maxShiftIdx),
+          maxShift(_maxShift),
+          maxShift2(_maxShift2),
+          updateBounds(_updateBounds)
+    {
+    }
+
+    void operator()( const Range& range ) const
+    {
+        const int K = centers.rows;
+        const int dims = centers.cols;
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const float *sample = data.ptr<float>(i);
+            if( updateBounds )
+            {
+                int c = labels[i];
+                upper[i] += shift[c];
+                lower[i] -= c == maxShiftIdx ? maxShift2 : maxShift;
+
+                float bound = std::max(halfDist[c], lower[i]);
+                if( upper[i] <= bound )
+                    continue;
+                upper[i] = std::sqrt(normL2Sqr(sample, centers.ptr<float>(c), dims));
+                if( upper[i] <= bound )
+                    continue;
+            }
+
+            int k_best = 0;
+            float min_dist = FLT_MAX, min_dist2 = FLT_MAX;
+            for( int k = 0; k < K; k++ )
+            {
+                float dist = normL2Sqr(sample, centers.ptr<float>(k), dims);
+                if( dist < min_dist )
+                {
+                    min_dist2 = min_dist;
+                    min_dist = dist;
+                    k_best = k;
+                }
+                else if( dist < min_dist2 )
+                    min_dist2 = dist;
+            }
+
+            labels[i] = k_best;
+            upper[i] = std::sqrt(min_dist);
+            lower[i] = min_dist2 < FLT_MAX ? std::sqrt(min_dist2) : FLT_MAX;
+        }
+    }
+
+private:
+    KMeansHamerlyDistanceComputer& operator=(const KMeansHamerlyDistanceComputer&); // to quiet MSVC
+
+    int *labels;
+    float *upper;
+    float *lower;
+    const Mat& data;
+    const Mat& centers;
+    const float* halfDist;
+    const float* shift;
+    int maxShiftIdx;
+    float maxShift;
+    float maxShift2;
+    bool updateBounds;
+};
+
+/*
+Mini-batch k-means: Sculley (2010) "Web-scale k-means clustering".
+Each center moves to the mean of all the samples assigned to it so far, which is the same as
+the per-sample gradient step with the learning rate 1/count done for the whole batch at once.
+*/
+static void kmeansMiniBatch( const Mat& data, Mat& centers, const TermCriteria& criteria, RNG& rng )
+{
+    CV_TRACE_FUNCTION();
+    const int MIN_BATCH_SIZE = 1024;
+    int N = data.rows, K = centers.rows, dims = data.cols;
+    int batchSize = std::min(N, std::max(MIN_BATCH_SIZE, K*4));
+    Mat batch(batchSize, dims, CV_32F), sums(K, dims, CV_64F);
+    std::vector<int> batchLabels(batchSize), batchCounters(K), counters(K, 0);
+    std::vector<double> batchDists(batchSize);
+
+    for( int iter = 0; iter < criteria.maxCount; iter++ )
+    {
+        int i, j, k;
+        for( i = 0; i < batchSize; i++ )
+            memcpy(batch.ptr<float>(i), data.ptr<float>(rng.uniform(0, N)), dims*sizeof(float));
+
+        parallel_for_(Range(0, batchSize), KMeansDistanceComputer(&batchDists[0], &batchLabels[0], batch, centers));
+
+        sums = Scalar(0);
+        std::fill(batchCounters.begin(), batchCounters.end(), 0);
+        for( i = 0; i < batchSize; i++ )
+        {
+            const float* sample = batch.ptr<float>(i);
+            double* sum = sums.ptr<double>(batchLabels[i]);
+            for( j = 0; j < dims; j++ )
+                sum[j] += sample[j];
+            batchCounters[batchLabels[i]]++;
+        }
+
+        double max_center_shift = 0;
+        for( k = 0; k < K; k++ )
+        {
+            if( batchCounters[k] == 0 )
+                continue;
+            counters[k] += batchCounters[k];
+
+            float* center = centers.ptr<float>(k);
+            const double* sum = sums.ptr<double>(k);
+            double scale = 1./counters[k], dist = 0;
+            for( j = 0; j < dims; j++ )
+            {
+                double t = (sum[j] - batchCounters[k]*(double)center[j])*scale;
+                center[j] = (float)(center[j] + t);
+                dist += t*t;
+            }
+            max_center_shift = std::max(max_center_shift, dist);
+        }
+
+        if( max_center_shift <= criteria.epsilon )
+            break;
+    }
+}
+
 }
 
 double cv::kmeans( InputArray _data, int K,
@@ -239,9 +444,13 @@ double cv::kmeans( InputArray _data, int K,
     int dims = (isrow ? 1 : data0.cols)*data0.channels();
     int type = data0.depth();
 
+    bool miniBatch = (flags & KMEANS_MINI_BATCH) != 0;
+    bool hamerly = (flags & KMEANS_HAMERLY) != 0;
+
     attempts = std::max(attempts, 1);
     CV_Assert( data0.dims <= 2 && type == CV_32F && K > 0 );
     CV_Assert( N >= K );
+    CV_Assert( !(miniBatch && hamerly) );
 
     Mat data(N, dims, CV_32F, data0.ptr(), isrow ? dims * sizeof(float) : static_cast<size_t>(data0.step));
 
@@ -271,6 +480,14 @@ double cv::kmeans( InputArray _data, int K,
     std::vector<int> counters(K);
     std::vector<Vec2f> _box(dims);
     Mat dists(1, N, CV_64F);
+    std::vector<float> upper, lower, halfDist, shift;
+    if( hamerly )
+    {
+        upper.resize(N);
+        lower.resize(N);
+        halfDist.resize(K);
+        shift.resize(K);
+    }
     Vec2f* box = &_box[0];
     double best_compactness = DBL_MAX, compactness = 0;
     RNG& rng = theRNG();
@@ -283,7 +500,7 @@ double cv::kmeans( InputArray _data, int K,
     criteria.epsilon *= criteria.epsilon;
 
     if( criteria.type & TermCriteria::COUNT )
-        criteria.maxCount = std::min(std::max(criteria.maxCount, 2), 100);
+        criteria.maxCount = miniBatch ? std::max(criteria.maxCount, 1) : std::min(std::max(criteria.maxCount, 2), 100);
     else
         criteria.maxCount = 100;
 
@@ -311,13 +528,16 @@ double cv::kmeans( InputArray _data, int K,
     for( a = 0; a < attempts; a++ )
     {
         double max_center_shift = DBL_MAX;
+        bool boundsValid = false;
         for( iter = 0;; )
         {
             swap(centers, old_centers);
 
             if( iter == 0 && (a > 0 || !(flags & KMEANS_USE_INITIAL_LABELS)) )
             {
-                if( flags & KMEANS_PP_CENTERS )
+                if( (flags & KMEANS_PP_CENTERS) && (miniBatch || hamerly) )
+                    generateCentersPPSubset(data, centers, K, rng, SPP_TRIALS);
+                else if( flags & KMEANS_PP_CENTERS )
                     generateCentersPP(data, centers, K, rng, SPP_TRIALS);
                 else
                 {
@@ -410,6 +630,12 @@ double cv::kmeans( InputArray _data, int K,
                     counters[max_k]--;
                     counters[k]++;
                     labels[farthest_i] = k;
+                    if( hamerly )
+                    {
+                        // the bounds of the moved sample are not valid anymore
+                        upper[farthest_i] = FLT_MAX;
+                        lower[farthest_i] = 0;
+                    }
                     sample = data.ptr<float>(farthest_i);
 
                     for( j = 0; j < dims; j++ )
@@ -442,12 +668,42 @@ double cv::kmeans( InputArray _data, int K,
                 }
             }
 
-            bool isLastIter = (++iter == MAX(criteria.maxCount, 2) || max_center_shift <= criteria.epsilon);
+            if( miniBatch )
+                kmeansMiniBatch(data, centers, criteria, rng);
+
+            // the mini-batch iterations are done at once, the labels are computed for the final centers
+            bool isLastIter = miniBatch || (++iter == MAX(criteria.maxCount, 2) || max_center_shift <= criteria.epsilon);
 
             // assign labels
             dists = 0;
             double* dist = dists.ptr<double>(0);
-            parallel_for_(Range(0, N), KMeansDistanceComputer(dist, labels, data, centers, isLastIter));
+            if( hamerly && !isLastIter )
+            {
+                int maxShiftIdx = -1;
+                float maxShift = 0, maxShift2 = 0;
+                if( boundsValid )
+                {
+                    for( k = 0; k < K; k++ )
+                    {
+                        shift[k] = std::sqrt(normL2Sqr(centers.ptr<float>(k), old_centers.ptr<float>(k), dims));
+                        if( shift[k] > maxShift )
+                        {
+                            maxShift2 = maxShift;
+                            maxShift = shift[k];
+                            maxShiftIdx = k;
+                        }
+                        else
+                            maxShift2 = std::max(maxShift2, shift[k]);
+                    }
+                    parallel_for_(Range(0, K), KMeansCenterDistanceComputer(&halfDist[0], centers));
+                }
+                parallel_for_(Range(0, N), KMeansHamerlyDistanceComputer(labels, &upper[0], &lower[0], data, centers,
+                                                                         &halfDist[0], &shift[0], maxShiftIdx,
+                                                                         maxShift, maxShift2, boundsValid));
+                boundsValid = true;
+            }
+            else
+                parallel_for_(Range(0, N), KMeansDistanceComputer(dist, labels, data, centers, isLastIter && !miniBatch));
             compactness = sum(dists)[0];
 
             if (isLastIter)
@@ -1607,6 +1607,477 @@ void cv::SVBackSubst(InputArray w, InputArray u, InputArray vt, InputArray rhs,
     SVD::backSubst(w, u, vt, rhs, dst);
 }
 
+/****************************************************************************************\
+*                              Batched small-matrix solvers                              *
+\****************************************************************************************/
+
+namespace cv
+{
+
+// The batched solvers process several matrices at once, one matrix per SIMD lane:
+// every matrix element is a vector holding this element of all the matrices of a group.
+
+enum { BATCH_MAX_SIZE = 16 };
+
+// one-lane substitute of the universal intrinsics used when SIMD is not available
+template<typename T> struct BatchScalar
+{
+    BatchScalar() : val(0) {}
+    explicit BatchScalar(T v) : val(v) {}
+    T val;
+};
+
+template<typename T> static inline BatchScalar<T> operator + (const BatchScalar<T>& a, const BatchScalar<T>& b) { return BatchScalar<T>(a.val + b.val); }
+template<typename T> static inline BatchScalar<T> operator - (const BatchScalar<T>& a, const BatchScalar<T>& b) { return BatchScalar<T>(a.val - b.val); }
+template<typename T> static inline BatchScalar<T> operator * (const BatchScalar<T>& a, const BatchScalar<T>& b) { return BatchScalar<T>(a.val * b.val); }
+template<typename T> static inline BatchScalar<T> operator / (const BatchScalar<T>& a, const BatchScalar<T>& b) { return BatchScalar<T>(a.val / b.val); }
+template<typename T> static inline BatchScalar<T> operator < (const BatchScalar<T>& a, const BatchScalar<T>& b) { return BatchScalar<T>((T)(a.val < b.val)); }
+template<typename T> static inline BatchScalar<T> operator > (const BatchScalar<T>& a, const BatchScalar<T>& b) { return BatchScalar<T>((T)(a.val > b.val)); }
+template<typename T> static inline BatchScalar<T> operator == (const BatchScalar<T>& a, const BatchScalar<T>& b) { return BatchScalar<T>((T)(a.val == b.val)); }
+template<typename T> static inline BatchScalar<T> operator & (const BatchScalar<T>& a, const BatchScalar<T>& b) { return BatchScalar<T>((T)(a.val != 0 && b.val != 0)); }
+template<typename T> static inline BatchScalar<T> v_select(const BatchScalar<T>& m, const BatchScalar<T>& a, const BatchScalar<T>& b) { return m.val != 0 ? a : b; }
+template<typename T> static inline BatchScalar<T> v_abs(const BatchScalar<T>& a) { return BatchScalar<T>(std::abs(a.val)); }
+template<typename T> static inline BatchScalar<T> v_sqrt(const BatchScalar<T>& a) { return BatchScalar<T>(std::sqrt(a.val)); }
+template<typename T> static inline int v_signmask(const BatchScalar<T>& m) { return m.val != 0; }
+
+template<typename T> struct BatchScalarOps
+{
+    typedef BatchScalar<T> V;
+    enum { nlanes = 1 };
+    static V load(const T* p) { return V(p[0]); }
+    static void store(T* p, const V& v) { p[0] = v.val; }
+    static V setall(T x) { return V(x); }
+};
+
+template<typename T> struct BatchOps : BatchScalarOps<T> {};
+
+#if CV_SIMD
+template<> struct BatchOps<float>
+{
+    typedef v_float32 V;
+    enum { nlanes = v_float32::nlanes };
+    static V load(const float* p) { return vx_load(p); }
+    static void store(float* p, const V& v) { v_store(p, v); }
+    static V setall(float x) { return vx_setall_f32(x); }
+};
+#endif
+
+#if CV_SIMD_64F
+template<> struct BatchOps<double>
+{
+    typedef v_float64 V;
+    enum { nlanes = v_float64::nlanes };
+    static V load(const double* p) { return vx_load(p); }
+    static void store(double* p, const V& v) { v_store(p, v); }
+    static V setall(double x) { return vx_setall_f64(x); }
+};
+#endif
+
+// loads the elements [0, len) of the matrices stored in the rows [i0, i0 + count) of src,
+// the missing lanes are filled with the padding matrix
+template<typename T> static void
+batchLoad( const Mat& src, int i0, int count, int len, const T* pad, typename BatchOps<T>::V* dst )
+{
+    typedef BatchOps<T> Ops;
+    T buf[Ops::nlanes];
+    for( int e = 0; e < len; e++ )
+    {
+        for( int l = 0; l < Ops::nlanes; l++ )
+            buf[l] = l < count ? src.ptr<T>(i0 + l)[e] : pad[e];
+        dst[e] = Ops::load(buf);
+    }
+}
+
+// stores the elements of the lanes [0, count) into the rows [i0, i0 + count) of dst,
+// the element e is taken from src[e*stride]; the lanes where ok is not set get zeros
+template<typename T> static void
+batchStore( const typename BatchOps<T>::V* src, int stride, const typename BatchOps<T>::V& ok,
+            int len, Mat& dst, int i0, int count )
+{
+    typedef BatchOps<T> Ops;
+    T buf[Ops::nlanes];
+    typename Ops::V zero = Ops::setall(0);
+    for( int e = 0; e < len; e++ )
+    {
+        Ops::store(buf, v_select(ok, src[e*stride], zero));
+        for( int l = 0; l < count; l++ )
+            dst.ptr<T>(i0 + l)[e] = buf[l];
+    }
+}
+
+// Gaussian elimination with partial pivoting of the n x (n + k) augmented matrices [A|B],
+// B is replaced with the solution. Returns the mask of the non-singular lanes.
+template<typename T> static typename BatchOps<T>::V
+batchLU( typename BatchOps<T>::V* a, int n, int k )
+{
+    typedef BatchOps<T> Ops;
+    typedef typename Ops::V V;
+    const int w = n + k;
+    const V one = Ops::setall(1), eps = Ops::setall(std::numeric_limits<T>::epsilon()*(sizeof(T) == 4 ? 10 : 100));
+    V ok = one == one;
+
+    for( int c = 0; c < n; c++ )
+    {
+        V best = v_abs(a[c*w + c]), piv = Ops::setall((T)c);
+        for( int r = c + 1; r < n; r++ )
+        {
+            V v = v_abs(a[r*w + c]), m = v > best;
+            best = v_select(m, v, best);
+            piv = v_select(m, Ops::setall((T)r), piv);
+        }
+        ok = ok & (best > eps);
+
+        for( int r = c + 1; r < n; r++ )
+        {
+            V m = piv == Ops::setall((T)r);
+            if( !v_signmask(m) )
+                continue;
+            for( int j = c; j < w; j++ )
+            {
+                V t = a[c*w + j];
+                a[c*w + j] = v_select(m, a[r*w + j], t);
+                a[r*w + j] = v_select(m, t, a[r*w + j]);
+            }
+        }
+
+        V d = one / a[c*w + c];
+        for( int r = c + 1; r < n; r++ )
+        {
+            V f = a[r*w + c]*d;
+            for( int j = c + 1; j < w; j++ )
+                a[r*w + j] = a[r*w + j] - f*a[c*w + j];
+        }
+    }
+
+    for( int j = n; j < w; j++ )
+    {
+        for( int i = n - 1; i >= 0; i-- )
+        {
+            V s = a[i*w + j];
+            for( int p = i + 1; p < n; p++ )
+                s = s - a[i*w + p]*a[p*w + j];
+            a[i*w + j] = s / a[i*w + i];
+        }
+    }
+    return ok;
+}
+
+template<typename T> class SolveBatch_Invoker : public ParallelLoopBody
+{
+public:
+    // src2 is empty for the inversion
+    SolveBatch_Invoker(const Mat& _src1, const Mat& _src2, Mat& _dst, Mat& _mask, int _n, int _k, int* _nsingular) :
+        src1(_src1), src2(_src2), dst(_dst), mask(_mask), n(_n), k(_k), nsingular(_nsingular)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        typedef BatchOps<T> Ops;
+        typedef typename Ops::V V;
+        const int w = n + k, N = src1.rows;
+        V a[BATCH_MAX_SIZE*BATCH_MAX_SIZE*2], b[BATCH_MAX_SIZE*BATCH_MAX_SIZE];
+        // the lanes past the end of the batch hold identity matrices and zero right-hand sides
+        T pad[BATCH_MAX_SIZE*BATCH_MAX_SIZE], zeroPad[BATCH_MAX_SIZE*BATCH_MAX_SIZE];
+        T lanes[Ops::nlanes];
+        int singular = 0;
+
+        for( int i = 0; i < n*n; i++ )
+            pad[i] = (T)(i % (n + 1) == 0);
+        for( int i = 0; i < n*k; i++ )
+            zeroPad[i] = (T)0;
+
+        for( int g = range.start; g < range.end; g++ )
+        {
+            int i0 = g*Ops::nlanes, count = std::min((int)Ops::nlanes, N - i0);
+
+            batchLoad<T>(src1, i0, count, n*n, pad, b);
+            for( int i = 0; i < n; i++ )
+                for( int j = 0; j < n; j++ )
+                    a[i*w + j] = b[i*n + j];
+            if( src2.empty() )
+            {
+                for( int i = 0; i < n; i++ )
+                    for( int j = 0; j < k; j++ )
+                        a[i*w + n + j] = Ops::setall((T)(i == j));
+            }
+            else
+            {
+                batchLoad<T>(src2, i0, count, n*k, zeroPad, b);
+                for( int i = 0; i < n; i++ )
+                    for( int j = 0; j < k; j++ )
+                        a[i*w + n + j] = b[i*k + j];
+            }
+
+            V ok = batchLU<T>(a, n, k);
+
+            for( int i = 0; i < n; i++ )
+                for( int j = 0; j < k; j++ )
+                    b[i*k + j] = a[i*w + n + j];
+            batchStore<T>(b, 1, ok, n*k, dst, i0, count);
+
+            Ops::store(lanes, v_select(ok, Ops::setall(1), Ops::setall(0)));
+            for( int l = 0; l < count; l++ )
+            {
+                singular += lanes[l] == 0;
+                if( !mask.empty() )
+                    mask.at<uchar>(i0 + l) = lanes[l] != 0 ? (uchar)255 : (uchar)0;
+            }
+        }
+        CV_XADD(nsingular, singular);
+    }
+
+private:
+    const Mat& src1;
+    const Mat& src2;
+    Mat& dst;
+    Mat& mask;
+    int n, k;
+    int* nsingular;
+};
+
+static int solveBatch_( const Mat& src1, const Mat& src2, OutputArray _dst, OutputArray _mask, int n, int k )
+{
+    int type = src1.type(), N = src1.rows;
+    _dst.create(N, n*k, type);
+    Mat dst = _dst.getMat(), mask;
+    if( _mask.needed() )
+    {
+        _mask.create(N, 1, CV_8U);
+        mask = _mask.getMat();
+    }
+    if( N == 0 )
+        return 0;
+
+    int nsingular = 0;
+    if( type == CV_32F )
+    {
+        int ngroups = (N + BatchOps<float>::nlanes - 1)/BatchOps<float>::nlanes;
+        parallel_for_(Range(0, ngroups), SolveBatch_Invoker<float>(src1, src2, dst, mask, n, k, &nsingular), ngroups/16.);
+    }
+    else
+    {
+        int ngroups = (N + BatchOps<double>::nlanes - 1)/BatchOps<double>::nlanes;
+        parallel_for_(Range(0, ngroups), SolveBatch_Invoker<double>(src1, src2, dst, mask, n, k, &nsingular), ngroups/16.);
+    }
+    return nsingular;
+}
+
+static int batchMatrixSize( const Mat& src )
+{
+    int n = cvRound(std::sqrt((double)src.cols));
+    CV_Assert( n*n == src.cols && 1 <= n && n <= BATCH_MAX_SIZE );
+    return n;
+}
+
+// One-sided Jacobi SVD of the m x n matrices a, v gets the right singular vectors, w the singular values
+template<typename T> static void
+batchJacobiSVD( typename BatchOps<T>::V* a, typename BatchOps<T>::V* w, typename BatchOps<T>::V* v, int m, int n )
+{
+    typedef BatchOps<T> Ops;
+    typedef typename Ops::V V;
+    const V zero = Ops::setall(0), one = Ops::setall(1);
+    const V eps = Ops::setall(std::numeric_limits<T>::epsilon()*(sizeof(T) == 4 ? 2 : 10));
+    const V minval = Ops::setall(std::numeric_limits<T>::min());
+    int i, j, p, q, iter, max_iter = std::max(m, 30);
+
+    for( i = 0; i < n; i++ )
+        for( j = 0; j < n; j++ )
+            v[i*n + j] = i == j ? one : zero;
+
+    for( iter = 0; iter < max_iter; iter++ )
+    {
+        bool changed = false;
+
+        for( p = 0; p < n - 1; p++ )
+            for( q = p + 1; q < n; q++ )
+            {
+                V alpha = zero, beta = zero, gamma = zero;
+                for( i = 0; i < m; i++ )
+                {
+                    V ap = a[i*n + p], aq = a[i*n + q];
+                    alpha = alpha + ap*ap;
+                    beta = beta + aq*aq;
+                    gamma = gamma + ap*aq;
+                }
+
+                V rot = v_abs(gamma) > eps*v_sqrt(alpha*beta);
+                if( !v_signmask(rot) )
+                    continue;
+                changed = true;
+
+                V g = v_select(rot, gamma, one);
+                V zeta = (beta - alpha)/(g + g);
+                V t = one/(v_abs(zeta) + v_sqrt(one + zeta*zeta));
+                t = v_select(zeta < zero, zero - t, t);
+                t = v_select(rot, t, zero);
+                V c = one/v_sqrt(one + t*t), s = c*t;
+
+                for( i = 0; i < m; i++ )
+                {
+                    V ap = a[i*n + p], aq = a[i*n + q];
+                    a[i*n + p] = c*ap - s*aq;
+                    a[i*n + q] = s*ap + c*aq;
+                }
+                for( i = 0; i < n; i++ )
+                {
+                    V vp = v[i*n + p], vq = v[i*n + q];
+                    v[i*n + p] = c*vp - s*vq;
+                    v[i*n + q] = s*vp + c*vq;
+                }
+            }
+
+        if( !changed )
+            break;
+    }
+
+    for( j = 0; j < n; j++ )
+    {
+        V sd = zero;
+        for( i = 0; i < m; i++ )
+            sd = sd + a[i*n + j]*a[i*n + j];
+        sd = v_sqrt(sd);
+        V nz = sd > minval, scale = v_select(nz, one/v_select(nz, sd, one), zero);
+        for( i = 0; i < m; i++ )
+            a[i*n + j] = a[i*n + j]*scale;
+        w[j] = sd;
+    }
+
+    // sort in the descending order
+    for( i = 0; i < n - 1; i++ )
+        for( j = i + 1; j < n; j++ )
+        {
+            V sw = w[j] > w[i];
+            if( !v_signmask(sw) )
+                continue;
+            V t = w[i];
+            w[i] = v_select(sw, w[j], t);
+            w[j] = v_select(sw, t, w[j]);
+            for( p = 0; p < m; p++ )
+            {
+                t = a[p*n + i];
+                a[p*n + i] = v_select(sw, a[p*n + j], t);
+                a[p*n + j] = v_select(sw, t, a[p*n + j]);
+            }
+            for( p = 0; p < n; p++ )
+            {
+                t = v[p*n + i];
+                v[p*n + i] = v_select(sw, v[p*n + j], t);
+                v[p*n + j] = v_select(sw, t, v[p*n + j]);
+            }
+        }
+}
+
+template<typename T> class SVDBatch_Invoker : public ParallelLoopBody
+{
+public:
+    SVDBatch_Invoker(const Mat& _src, Mat& _w, Mat& _u, Mat& _vt, int _m, int _n) :
+        src(_src), w(_w), u(_u), vt(_vt), m(_m), n(_n)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        typedef BatchOps<T> Ops;
+        typedef typename Ops::V V;
+        const int N = src.rows;
+        V a[BATCH_MAX_SIZE*BATCH_MAX_SIZE], sv[BATCH_MAX_SIZE], v[BATCH_MAX_SIZE*BATCH_MAX_SIZE];
+        T pad[BATCH_MAX_SIZE*BATCH_MAX_SIZE] = {};
+        V ok = Ops::setall(0) == Ops::setall(0);
+
+        for( int g = range.start; g < range.end; g++ )
+        {
+            int i0 = g*Ops::nlanes, count = std::min((int)Ops::nlanes, N - i0);
+
+            batchLoad<T>(src, i0, count, m*n, pad, a);
+            batchJacobiSVD<T>(a, sv, v, m, n);
+
+            batchStore<T>(sv, 1, ok, n, w, i0, count);
+            if( !u.empty() )
+                batchStore<T>(a, 1, ok, m*n, u, i0, count);
+            if( !vt.empty() )
+            {
+                for( int i = 0; i < n; i++ )
+                    for( int j = 0; j < n; j++ )
+                        a[i*n + j] = v[j*n + i];
+                batchStore<T>(a, 1, ok, n*n, vt, i0, count);
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& w;
+    Mat& u;
+    Mat& vt;
+    int m, n;
+};
+
+}
+
+int cv::solveBatch( InputArray _src1, InputArray _src2, OutputArray _dst, OutputArray _mask )
+{
+    CV_INSTRUMENT_REGION()
+
+    Mat src1 = _src1.getMat(), src2 = _src2.getMat();
+    int type = src1.type();
+    CV_Assert( (type == CV_32FC1 || type == CV_64FC1) && src2.type() == type && src1.rows == src2.rows );
+
+    int n = batchMatrixSize(src1), k = src2.cols/n;
+    CV_Assert( k*n == src2.cols && 1 <= k && k <= BATCH_MAX_SIZE );
+
+    return solveBatch_(src1, src2, _dst, _mask, n, k);
+}
+
+int cv::invertBatch( InputArray _src, OutputArray _dst, OutputArray _mask )
+{
+    CV_INSTRUMENT_REGION()
+
+    Mat src = _src.getMat();
+    int type = src.type();
+    CV_Assert( type == CV_32FC1 || type == CV_64FC1 );
+
+    int n = batchMatrixSize(src);
+    return solveBatch_(src, Mat(), _dst, _mask, n, n);
+}
+
+void cv::SVDecompBatch( InputArray _src, int m, OutputArray _w, OutputArray _u, OutputArray _vt )
+{
+    CV_INSTRUMENT_REGION()
+
+    Mat src = _src.getMat();
+    int type = src.type(), N = src.rows;
+    CV_Assert( (type == CV_32FC1 || type == CV_64FC1) && 1 <= m && m <= BATCH_MAX_SIZE && src.cols % m == 0 );
+    int n = src.cols/m;
+    CV_Assert( 1 <= n && n <= m );
+
+    _w.create(N, n, type);
+    Mat w = _w.getMat(), u, vt;
+    if( _u.needed() )
+    {
+        _u.create(N, m*n, type);
+        u = _u.getMat();
+    }
+    if( _vt.needed() )
+    {
+        _vt.create(N, n*n, type);
+        vt = _vt.getMat();
+    }
+    if( N == 0 )
+        return;
+
+    if( type == CV_32F )
+    {
+        int ngroups = (N + BatchOps<float>::nlanes - 1)/BatchOps<float>::nlanes;
+        parallel_for_(Range(0, ngroups), SVDBatch_Invoker<float>(src, w, u, vt, m, n), ngroups/16.);
+    }
+    else
+    {
+        int ngroups = (N + BatchOps<double>::nlanes - 1)/BatchOps<double>::nlanes;
+        parallel_for_(Range(0, ngroups), SVDBatch_Invoker<double>(src, w, u, vt, m, n), ngroups/16.);
+    }
+}
+
 
 CV_IMPL double
 cvDet( const CvArr* arr )
@@ -1227,6 +1227,38 @@ static void gemmImpl( Mat A, Mat B, double alpha,
         flags |= GEMM_2_T;
     }
 
+    // large real matrices are multiplied by the packed parallel GEMM
+    if( (type == CV_32FC1 || type == CV_64FC1) &&
+        std::min(std::min(d_size.width, d_size.height), len) >= 32 &&
+        (double)d_size.width*d_size.height*len >= 128.*128*128 &&
+        !((flags & GEMM_3_T) && Cdata == matD->data) )
+    {
+        bool accumulate = false;
+        if( Cdata )
+        {
+            if( flags & GEMM_3_T )
+                transpose(C, *matD);
+            else if( Cdata != matD->data )
+                C.copyTo(*matD);
+            if( beta != 1 )
+                matD->convertTo(*matD, -1, beta);
+            accumulate = true;
+        }
+
+        size_t esz = CV_ELEM_SIZE(type);
+        if( type == CV_32FC1 )
+            gemmPacked32f(A.ptr<float>(), A.step/esz, (flags & GEMM_1_T) != 0,
+                          B.ptr<float>(), b_step/esz, (flags & GEMM_2_T) != 0,
+                          matD->ptr<float>(), matD->step/esz, d_size.height, d_size.width, len,
+                          (float)alpha, accumulate);
+        else
+            gemmPacked64f(A.ptr<double>(), A.step/esz, (flags & GEMM_1_T) != 0,
+                          B.ptr<double>(), b_step/esz, (flags & GEMM_2_T) != 0,
+                          matD->ptr<double>(), matD->step/esz, d_size.height, d_size.width, len,
+                          alpha, accumulate);
+        return;
+    }
+
     /*if( (d_size.width | d_size.height | len) >= 16 && icvBLAS_GEMM_32f_p != 0 )
     {
         blas_func = type == CV_32FC1 ? (icvBLAS_GEMM_32f_t)icvBLAS_GEMM_32f_p :
@@ -0,0 +1,30 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "matmul.simd.hpp"
+#include "matmul.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
+
+namespace cv {
+
+void gemmPacked32f(const float* a, size_t a_step, bool a_t, const float* b, size_t b_step, bool b_t,
+                   float* d, size_t d_step, int m, int n, int k, float alpha, bool accumulate)
+{
+    CV_INSTRUMENT_REGION()
+
+    CV_CPU_DISPATCH(gemmPacked32f, (a, a_step, a_t, b, b_step, b_t, d, d_step, m, n, k, alpha, accumulate),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+void gemmPacked64f(const double* a, size_t a_step, bool a_t, const double* b, size_t b_step, bool b_t,
+                   double* d, size_t d_step, int m, int n, int k, double alpha, bool accumulate)
+{
+    CV_INSTRUMENT_REGION()
+
+    CV_CPU_DISPATCH(gemmPacked64f, (a, a_step, a_t, b, b_step, b_t, d, d_step, m, n, k, alpha, accumulate),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+} // namespace
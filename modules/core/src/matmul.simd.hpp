@@ -0,0 +1,276 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv {
+
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// forward declarations
+void gemmPacked32f(const float* a, size_t a_step, bool a_t, const float* b, size_t b_step, bool b_t,
+                   float* d, size_t d_step, int m, int n, int k, float alpha, bool accumulate);
+void gemmPacked64f(const double* a, size_t a_step, bool a_t, const double* b, size_t b_step, bool b_t,
+                   double* d, size_t d_step, int m, int n, int k, double alpha, bool accumulate);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+namespace {
+
+/*
+ Micro-kernels compute a MR x NR tile of D from a panel of op(A) packed by MR rows
+ and a panel of op(B) packed by NR columns:
+
+   D = alpha*A_panel*B_panel (+ D if accumulate)
+*/
+template<typename T> struct GemmScalarKernel
+{
+    enum { MR = 4, NR = 4 };
+
+    static void run(int kc, const T* pa, const T* pb, T* d, size_t d_step, T alpha, bool accumulate)
+    {
+        T s[MR][NR] = {};
+        for( int p = 0; p < kc; p++, pa += MR, pb += NR )
+        {
+            for( int i = 0; i < MR; i++ )
+                for( int j = 0; j < NR; j++ )
+                    s[i][j] += pa[i]*pb[j];
+        }
+        for( int i = 0; i < MR; i++, d += d_step )
+            for( int j = 0; j < NR; j++ )
+                d[j] = (accumulate ? d[j] : 0) + alpha*s[i][j];
+    }
+};
+
+#if CV_SIMD
+static inline v_float32 gemm_setall(float x) { return vx_setall_f32(x); }
+#if CV_SIMD_64F
+static inline v_float64 gemm_setall(double x) { return vx_setall_f64(x); }
+#endif
+
+template<typename T, typename V> struct GemmSimdKernel
+{
+    enum { MR = 4, NR = V::nlanes*2 };
+
+    static inline void storeRow(T* d, const V& s0, const V& s1, const V& va, bool accumulate)
+    {
+        V r0 = s0*va, r1 = s1*va;
+        if( accumulate )
+        {
+            r0 += vx_load(d);
+            r1 += vx_load(d + V::nlanes);
+        }
+        v_store(d, r0);
+        v_store(d + V::nlanes, r1);
+    }
+
+    static void run(int kc, const T* pa, const T* pb, T* d, size_t d_step, T alpha, bool accumulate)
+    {
+        V s00 = gemm_setall((T)0), s01 = s00, s10 = s00, s11 = s00;
+        V s20 = s00, s21 = s00, s30 = s00, s31 = s00;
+
+        for( int p = 0; p < kc; p++, pa += MR, pb += NR )
+        {
+            V b0 = vx_load(pb), b1 = vx_load(pb + V::nlanes), a;
+            a = gemm_setall(pa[0]); s00 = v_muladd(a, b0, s00); s01 = v_muladd(a, b1, s01);
+            a = gemm_setall(pa[1]); s10 = v_muladd(a, b0, s10); s11 = v_muladd(a, b1, s11);
+            a = gemm_setall(pa[2]); s20 = v_muladd(a, b0, s20); s21 = v_muladd(a, b1, s21);
+            a = gemm_setall(pa[3]); s30 = v_muladd(a, b0, s30); s31 = v_muladd(a, b1, s31);
+        }
+
+        V va = gemm_setall(alpha);
+        storeRow(d, s00, s01, va, accumulate);
+        storeRow(d + d_step, s10, s11, va, accumulate);
+        storeRow(d + d_step*2, s20, s21, va, accumulate);
+        storeRow(d + d_step*3, s30, s31, va, accumulate);
+    }
+};
+#endif
+
+template<typename T> struct GemmKernel : GemmScalarKernel<T> {};
+#if CV_SIMD
+template<> struct GemmKernel<float> : GemmSimdKernel<float, v_float32> {};
+#endif
+#if CV_SIMD_64F
+template<> struct GemmKernel<double> : GemmSimdKernel<double, v_float64> {};
+#endif
+
+// Block sizes: the packed A block (MC x KC) stays in L2, a packed B micro-panel (KC x NR) in L1
+template<typename T> struct GemmBlocking
+{
+    enum { MC = 128, KC = sizeof(T) == 4 ? 256 : 128, NC = 512 };
+};
+
+// packs rows [i0, i0 + mc) and columns [k0, k0 + kc) of op(A) by MR rows, zero padded
+template<typename T, int MR> static void
+gemmPackA( const T* a, size_t a_step, bool a_t, int i0, int mc, int k0, int kc, T* buf )
+{
+    for( int i = 0; i < mc; i += MR )
+    {
+        int r, mr = std::min(mc - i, (int)MR);
+        if( !a_t )
+        {
+            const T* src = a + (i0 + i)*a_step + k0;
+            for( int p = 0; p < kc; p++, buf += MR )
+            {
+                for( r = 0; r < mr; r++ )
+                    buf[r] = src[r*a_step + p];
+                for( ; r < MR; r++ )
+                    buf[r] = 0;
+            }
+        }
+        else
+        {
+            const T* src = a + k0*a_step + i0 + i;
+            for( int p = 0; p < kc; p++, buf += MR, src += a_step )
+            {
+                for( r = 0; r < mr; r++ )
+                    buf[r] = src[r];
+                for( ; r < MR; r++ )
+                    buf[r] = 0;
+            }
+        }
+    }
+}
+
+// packs rows [k0, k0 + kc) and columns [j0, j0 + nc) of op(B) by NR columns, zero padded
+template<typename T, int NR> static void
+gemmPackB( const T* b, size_t b_step, bool b_t, int k0, int kc, int j0, int nc, T* buf )
+{
+    for( int j = 0; j < nc; j += NR )
+    {
+        int c, nr = std::min(nc - j, (int)NR);
+        if( !b_t )
+        {
+            const T* src = b + k0*b_step + j0 + j;
+            for( int p = 0; p < kc; p++, buf += NR, src += b_step )
+            {
+                for( c = 0; c < nr; c++ )
+                    buf[c] = src[c];
+                for( ; c < NR; c++ )
+                    buf[c] = 0;
+            }
+        }
+        else
+        {
+            const T* src = b + (j0 + j)*b_step + k0;
+            for( int p = 0; p < kc; p++, buf += NR )
+            {
+                for( c = 0; c < nr; c++ )
+                    buf[c] = src[c*b_step + p];
+                for( ; c < NR; c++ )
+                    buf[c] = 0;
+            }
+        }
+    }
+}
+
+// D is split into MC x NC blocks processed in parallel, so no reduction between the threads is needed
+template<typename T> class GemmPacked_Invoker : public ParallelLoopBody
+{
+public:
+    typedef GemmKernel<T> Kernel;
+    typedef GemmBlocking<T> Blocking;
+
+    GemmPacked_Invoker(const T* _a, size_t _a_step, bool _a_t, const T* _b, size_t _b_step, bool _b_t,
+                       T* _d, size_t _d_step, int _m, int _n, int _k, T _alpha, bool _accumulate) :
+        a(_a), b(_b), d(_d), a_step(_a_step), b_step(_b_step), d_step(_d_step), a_t(_a_t), b_t(_b_t),
+        m(_m), n(_n), k(_k), alpha(_alpha), accumulate(_accumulate)
+    {
+        nblocks_n = (n + Blocking::NC - 1)/Blocking::NC;
+    }
+
+    int blocks() const
+    {
+        return (m + Blocking::MC - 1)/Blocking::MC*nblocks_n;
+    }
+
+    void operator()(const Range& range) const
+    {
+        const int MR = Kernel::MR, NR = Kernel::NR;
+        const int MC = Blocking::MC, NC = Blocking::NC, KC = Blocking::KC;
+        AutoBuffer<T> _buf(MC*KC + KC*((NC + NR - 1)/NR*NR) + MR*NR);
+        T* abuf = _buf;
+        T* bbuf = abuf + MC*KC;
+        T* tile = bbuf + KC*((NC + NR - 1)/NR*NR);
+
+        for( int t = range.start; t < range.end; t++ )
+        {
+            int i0 = t/nblocks_n*MC, j0 = t%nblocks_n*NC;
+            int mc = std::min(MC, m - i0), nc = std::min(NC, n - j0);
+
+            for( int k0 = 0; k0 < k; k0 += KC )
+            {
+                int kc = std::min(KC, k - k0);
+                bool acc = accumulate || k0 > 0;
+
+                gemmPackA<T, MR>(a, a_step, a_t, i0, mc, k0, kc, abuf);
+                gemmPackB<T, NR>(b, b_step, b_t, k0, kc, j0, nc, bbuf);
+
+                for( int j = 0; j < nc; j += NR )
+                {
+                    int nr = std::min(NR, nc - j);
+                    const T* pb = bbuf + j*kc;
+                    for( int i = 0; i < mc; i += MR )
+                    {
+                        int mr = std::min(MR, mc - i);
+                        const T* pa = abuf + i*kc;
+                        T* dptr = d + (i0 + i)*d_step + j0 + j;
+                        if( mr == MR && nr == NR )
+                            Kernel::run(kc, pa, pb, dptr, d_step, alpha, acc);
+                        else
+                        {
+                            Kernel::run(kc, pa, pb, tile, NR, alpha, false);
+                            for( int r = 0; r < mr; r++, dptr += d_step )
+                                for( int c = 0; c < nr; c++ )
+                                    dptr[c] = (acc ? dptr[c] : 0) + tile[r*NR + c];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const T* a;
+    const T* b;
+    T* d;
+    size_t a_step, b_step, d_step;
+    bool a_t, b_t;
+    int m, n, k;
+    T alpha;
+    bool accumulate;
+    int nblocks_n;
+};
+
+template<typename T> static void
+gemmPacked_( const T* a, size_t a_step, bool a_t, const T* b, size_t b_step, bool b_t,
+             T* d, size_t d_step, int m, int n, int k, T alpha, bool accumulate )
+{
+    CV_AVX_GUARD;
+
+    GemmPacked_Invoker<T> invoker(a, a_step, a_t, b, b_step, b_t, d, d_step, m, n, k, alpha, accumulate);
+    int nblocks = invoker.blocks();
+    parallel_for_(Range(0, nblocks), invoker, nblocks);
+}
+
+} // namespace
+
+void gemmPacked32f(const float* a, size_t a_step, bool a_t, const float* b, size_t b_step, bool b_t,
+                   float* d, size_t d_step, int m, int n, int k, float alpha, bool accumulate)
+{
+    gemmPacked_(a, a_step, a_t, b, b_step, b_t, d, d_step, m, n, k, alpha, accumulate);
+}
+
+void gemmPacked64f(const double* a, size_t a_step, bool a_t, const double* b, size_t b_step, bool b_t,
+                   double* d, size_t d_step, int m, int n, int k, double alpha, bool accumulate)
+{
+    gemmPacked_(a, a_step, a_t, b, b_step, b_t, d, d_step, m, n, k, alpha, accumulate);
+}
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+
+} // namespace
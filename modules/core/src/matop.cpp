@@ -87,6 +87,28 @@ public:
 
 static MatOp_AddEx g_MatOp_AddEx;
 
+// Linear combination of three floating-point arrays of the same size and type, evaluated in a single
+// pass: dst = a*alpha + b*beta + c*s[1] + s[0]. It is produced when element-wise additions and
+// subtractions are chained (e.g. a*0.5 + b*0.25 - c), so that no temporary arrays are created.
+// Integer arrays are not fused: every operator saturates its result, and that must not change.
+class MatOp_LinComb : public MatOp
+{
+public:
+    MatOp_LinComb() {}
+    virtual ~MatOp_LinComb() {}
+
+    bool elementWise(const MatExpr& /*expr*/) const { return true; }
+    void assign(const MatExpr& expr, Mat& m, int type=-1) const;
+
+    void add(const MatExpr& e1, const Scalar& s, MatExpr& res) const;
+    void subtract(const Scalar& s, const MatExpr& expr, MatExpr& res) const;
+    void multiply(const MatExpr& e1, double s, MatExpr& res) const;
+
+    static bool makeExpr(MatExpr& res, const MatExpr& e1, const MatExpr& e2, double scale2);
+};
+
+static MatOp_LinComb g_MatOp_LinComb;
+
 class MatOp_Bin : public MatOp
 {
 public:
@@ -210,6 +232,7 @@ static MatOp_Initializer* getGlobalMatOpInitializer()
 
 static inline bool isIdentity(const MatExpr& e) { return e.op == &g_MatOp_Identity; }
 static inline bool isAddEx(const MatExpr& e) { return e.op == &g_MatOp_AddEx; }
+static inline bool isLinComb(const MatExpr& e) { return e.op == &g_MatOp_LinComb; }
 static inline bool isScaled(const MatExpr& e) { return isAddEx(e) && (!e.b.data || e.beta == 0) && e.s == Scalar(); }
 static inline bool isBin(const MatExpr& e, char c) { return e.op == &g_MatOp_Bin && e.flags == c; }
 static inline bool isCmp(const MatExpr& e) { return e.op == &g_MatOp_Cmp; }
@@ -337,6 +360,9 @@ void MatOp::add(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 
     if( this == e2.op )
     {
+        if( MatOp_LinComb::makeExpr(res, e1, e2, 1) )
+            return;
+
         double alpha = 1, beta = 1;
         Scalar s;
         Mat m1, m2;
@@ -380,6 +406,9 @@ void MatOp::subtract(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 
     if( this == e2.op )
     {
+        if( MatOp_LinComb::makeExpr(res, e1, e2, -1) )
+            return;
+
         double alpha = 1, beta = -1;
         Scalar s;
         Mat m1, m2;
@@ -1368,6 +1397,181 @@ inline void MatOp_AddEx::makeExpr(MatExpr& res, const Mat& a, const Mat& b, doub
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template<typename T, typename WT> struct LinCombRow
+{
+    void operator()(const T* a, const T* b, const T* c, T* dst, int len,
+                    WT alpha, WT beta, WT gamma, WT delta) const
+    {
+        for( int i = 0; i < len; i++ )
+            dst[i] = saturate_cast<T>(a[i]*alpha + b[i]*beta + c[i]*gamma + delta);
+    }
+};
+
+template<> struct LinCombRow<float, float>
+{
+    void operator()(const float* a, const float* b, const float* c, float* dst, int len,
+                    float alpha, float beta, float gamma, float delta) const
+    {
+        int i = 0;
+#if CV_SIMD
+        v_float32 valpha = vx_setall_f32(alpha), vbeta = vx_setall_f32(beta);
+        v_float32 vgamma = vx_setall_f32(gamma), vdelta = vx_setall_f32(delta);
+        for( ; i <= len - v_float32::nlanes; i += v_float32::nlanes )
+        {
+            v_float32 r = v_muladd(vx_load(a + i), valpha,
+                          v_muladd(vx_load(b + i), vbeta,
+                          v_muladd(vx_load(c + i), vgamma, vdelta)));
+            v_store(dst + i, r);
+        }
+#endif
+        for( ; i < len; i++ )
+            dst[i] = a[i]*alpha + b[i]*beta + c[i]*gamma + delta;
+    }
+};
+
+template<typename T, typename WT> class LinCombInvoker : public ParallelLoopBody
+{
+public:
+    LinCombInvoker(const MatExpr& e, Mat& dst) : e_(e), dst_(dst) {}
+
+    void operator()(const Range& range) const
+    {
+        Mat a = e_.a.rowRange(range), b = e_.b.rowRange(range), c = e_.c.rowRange(range);
+        Mat dst = dst_.rowRange(range);
+        Size sz = getContinuousSize(a, b, c, dst, dst.channels());
+        WT alpha = (WT)e_.alpha, beta = (WT)e_.beta, gamma = (WT)e_.s[1], delta = (WT)e_.s[0];
+        LinCombRow<T, WT> op;
+
+        for( int y = 0; y < sz.height; y++ )
+            op(a.ptr<T>(y), b.ptr<T>(y), c.ptr<T>(y), dst.ptr<T>(y), sz.width, alpha, beta, gamma, delta);
+    }
+
+private:
+    const MatExpr& e_;
+    Mat& dst_;
+
+    LinCombInvoker(const LinCombInvoker&);
+    LinCombInvoker& operator=(const LinCombInvoker&);
+};
+
+template<typename T, typename WT> static void linComb_(const MatExpr& e, Mat& dst)
+{
+    LinCombInvoker<T, WT> invoker(e, dst);
+    Range all(0, dst.rows);
+    size_t total = dst.total()*dst.channels();
+    if( (total >> 17) != 0 && dst.rows > 1 )
+        parallel_for_(all, invoker, (double)std::max((size_t)1, total >> 15));
+    else
+        invoker(all);
+}
+
+typedef void (*LinCombFunc)(const MatExpr& e, Mat& dst);
+
+void MatOp_LinComb::assign(const MatExpr& e, Mat& m, int _type) const
+{
+    Mat temp, &dst = _type == -1 || e.a.type() == _type ? m : temp;
+    dst.create(e.a.size(), e.a.type());
+    LinCombFunc func = e.a.depth() == CV_32F ? linComb_<float, float> : linComb_<double, double>;
+    func(e, dst);
+
+    if( dst.data != m.data )
+        dst.convertTo(m, _type);
+}
+
+void MatOp_LinComb::add(const MatExpr& e, const Scalar& s, MatExpr& res) const
+{
+    CV_INSTRUMENT_REGION()
+
+    // single-channel arrays use only the first component of the scalar
+    if( e.a.channels() == 1 || s == Scalar() )
+    {
+        res = e;
+        res.s[0] += s[0];
+    }
+    else
+        MatOp::add(e, s, res);
+}
+
+void MatOp_LinComb::subtract(const Scalar& s, const MatExpr& e, MatExpr& res) const
+{
+    CV_INSTRUMENT_REGION()
+
+    if( e.a.channels() == 1 || s == Scalar() )
+    {
+        res = e;
+        res.alpha = -res.alpha;
+        res.beta = -res.beta;
+        res.s = Scalar(s[0] - res.s[0], -res.s[1]);
+    }
+    else
+        MatOp::subtract(s, e, res);
+}
+
+void MatOp_LinComb::multiply(const MatExpr& e, double s, MatExpr& res) const
+{
+    CV_INSTRUMENT_REGION()
+
+    res = e;
+    res.alpha *= s;
+    res.beta *= s;
+    res.s *= s;
+}
+
+// Collects the terms of e = sum(m[i]*w[i]) + s, returns the number of terms or 0 if e is not a linear combination
+static int getLinCombTerms(const MatExpr& e, double scale, Mat* m, double* w, Scalar& s)
+{
+    int n = 0;
+    if( isIdentity(e) )
+    {
+        m[n] = e.a; w[n++] = scale;
+    }
+    else if( isAddEx(e) )
+    {
+        m[n] = e.a; w[n++] = e.alpha*scale;
+        if( e.b.data && e.beta != 0 )
+        {
+            m[n] = e.b; w[n++] = e.beta*scale;
+        }
+        s += e.s*scale;
+    }
+    else if( isLinComb(e) )
+    {
+        m[n] = e.a; w[n++] = e.alpha*scale;
+        m[n] = e.b; w[n++] = e.beta*scale;
+        m[n] = e.c; w[n++] = e.s[1]*scale;
+        s[0] += e.s[0]*scale;
+    }
+    return n;
+}
+
+bool MatOp_LinComb::makeExpr(MatExpr& res, const MatExpr& e1, const MatExpr& e2, double scale2)
+{
+    Mat m[6];
+    double w[6];
+    Scalar s;
+    int n1 = getLinCombTerms(e1, 1, m, w, s);
+    if( n1 == 0 )
+        return false;
+    int n2 = getLinCombTerms(e2, scale2, m + n1, w + n1, s);
+    // two terms are handled by MatOp_AddEx; the node keeps three arrays at most (MatExpr has no room
+    // for more), longer chains are evaluated by parts
+    if( n2 == 0 || n1 + n2 != 3 )
+        return false;
+
+    // integer results of every operator are saturated, fusing would skip the intermediate saturation
+    int type = m[0].type();
+    if( CV_MAT_DEPTH(type) < CV_32F || m[0].dims > 2 || (CV_MAT_CN(type) > 1 && s != Scalar()) )
+        return false;
+    for( int i = 1; i < 3; i++ )
+        if( m[i].type() != type || m[i].size() != m[0].size() )
+            return false;
+
+    res = MatExpr(&g_MatOp_LinComb, 0, m[0], m[1], m[2], w[0], w[1], Scalar(s[0], w[2]));
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void MatOp_Bin::assign(const MatExpr& e, Mat& m, int _type) const
 {
     Mat temp, &dst = _type == -1 || e.a.type() == _type ? m : temp;
@@ -44,6 +44,8 @@
 #include "opencl_kernels_core.hpp"
 
 #include "bufferpool.impl.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+#include "opencv2/core/utils/pool_allocator.hpp"
 
 /****************************************************************************************\
 *                           [scaled] Identity matrix initialization                      *
@@ -232,7 +234,10 @@ MatAllocator* Mat::getDefaultAllocator()
         cv::AutoLock lock(cv::getInitializationMutex());
         if (g_matAllocator == NULL)
         {
-            g_matAllocator = getStdAllocator();
+            if (utils::getConfigurationParameterBool("OPENCV_MAT_POOL_ALLOCATOR", false))
+                g_matAllocator = utils::getPoolMatAllocator();
+            else
+                g_matAllocator = getStdAllocator();
         }
     }
     return g_matAllocator;
@@ -4215,25 +4220,157 @@ void cv::reduce(InputArray _src, OutputArray _dst, int dim, int op, int dtype)
 namespace cv
 {
 
-template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
+// maps the keys to unsigned integers of the same order, so they can be sorted digit by digit
+template<typename T> struct RadixKey { enum { enabled = 0 }; typedef unsigned type; static unsigned get(T) { return 0; } };
+template<> struct RadixKey<uchar>  { enum { enabled = 1 }; typedef uchar type;    static uchar get(uchar v) { return v; } };
+template<> struct RadixKey<schar>  { enum { enabled = 1 }; typedef uchar type;    static uchar get(schar v) { return (uchar)(v ^ 0x80); } };
+template<> struct RadixKey<ushort> { enum { enabled = 1 }; typedef ushort type;   static ushort get(ushort v) { return v; } };
+template<> struct RadixKey<short>  { enum { enabled = 1 }; typedef ushort type;   static ushort get(short v) { return (ushort)(v ^ 0x8000); } };
+template<> struct RadixKey<int>    { enum { enabled = 1 }; typedef unsigned type; static unsigned get(int v) { return (unsigned)v ^ 0x80000000u; } };
+template<> struct RadixKey<float>
 {
-    AutoBuffer<T> buf;
+    enum { enabled = 1 };
+    typedef unsigned type;
+    static unsigned get(float v) { Cv32suf u; u.f = v; return u.i < 0 ? ~u.u : u.u ^ 0x80000000u; }
+};
+
+// rows shorter than this are sorted with std::sort
+enum { RADIX_SORT_MIN_LEN = 1 << 10, RADIX_SORT_CHUNK_SIZE = 1 << 16 };
+
+// One pass of the LSD radix sort: the array is split into chunks, every chunk counts its digits
+// and then moves its elements to the offsets computed from all the counters.
+template<typename T> class RadixSortPass_Invoker : public ParallelLoopBody
+{
+public:
+    RadixSortPass_Invoker(const T* _src, const int* _isrc, T* _dst, int* _idst, int _len, int _shift,
+                          int* _offsets, bool _scatter) :
+        src(_src), isrc(_isrc), dst(_dst), idst(_idst), len(_len), shift(_shift), offsets(_offsets), scatter(_scatter)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        for( int c = range.start; c < range.end; c++ )
+        {
+            int j = c*RADIX_SORT_CHUNK_SIZE, end = std::min(j + (int)RADIX_SORT_CHUNK_SIZE, len);
+            int* ofs = offsets + c*256;
+            if( !scatter )
+            {
+                memset(ofs, 0, 256*sizeof(ofs[0]));
+                for( ; j < end; j++ )
+                    ofs[(RadixKey<T>::get(src[j]) >> shift) & 255]++;
+            }
+            else if( isrc )
+            {
+                for( ; j < end; j++ )
+                {
+                    int k = ofs[(RadixKey<T>::get(src[j]) >> shift) & 255]++;
+                    dst[k] = src[j];
+                    idst[k] = isrc[j];
+                }
+            }
+            else
+            {
+                for( ; j < end; j++ )
+                    dst[ofs[(RadixKey<T>::get(src[j]) >> shift) & 255]++] = src[j];
+            }
+        }
+    }
+
+private:
+    const T* src;
+    const int* isrc;
+    T* dst;
+    int* idst;
+    int len, shift;
+    int* offsets;
+    bool scatter;
+};
+
+// stable ascending sort of data (and the accompanying indices, if idx is not NULL)
+template<typename T> static void radixSort( T* data, int* idx, int len, T* tbuf, int* ibuf )
+{
+    int nchunks = (len + RADIX_SORT_CHUNK_SIZE - 1)/RADIX_SORT_CHUNK_SIZE;
+    AutoBuffer<int> _offsets(nchunks*256);
+    int* offsets = _offsets;
+    T *src = data, *dst = tbuf;
+    int *isrc = idx, *idst = idx ? ibuf : 0;
+
+    for( int shift = 0; shift < (int)sizeof(typename RadixKey<T>::type)*8; shift += 8 )
+    {
+        RadixSortPass_Invoker<T> hist(src, isrc, dst, idst, len, shift, offsets, false);
+        if( nchunks > 1 )
+            parallel_for_(Range(0, nchunks), hist);
+        else
+            hist(Range(0, 1));
+
+        // the pass does not change the order if all the keys have the same digit
+        bool skip = false;
+        for( int b = 0; b < 256 && !skip; b++ )
+        {
+            int total = 0;
+            for( int c = 0; c < nchunks; c++ )
+                total += offsets[c*256 + b];
+            skip = total == len;
+        }
+        if( skip )
+            continue;
+
+        for( int sum = 0, b = 0; b < 256; b++ )
+            for( int c = 0; c < nchunks; c++ )
+            {
+                int t = offsets[c*256 + b];
+                offsets[c*256 + b] = sum;
+                sum += t;
+            }
+
+        RadixSortPass_Invoker<T> scatter(src, isrc, dst, idst, len, shift, offsets, true);
+        if( nchunks > 1 )
+            parallel_for_(Range(0, nchunks), scatter);
+        else
+            scatter(Range(0, 1));
+        std::swap(src, dst);
+        std::swap(isrc, idst);
+    }
+
+    if( src != data )
+    {
+        memcpy(data, src, len*sizeof(data[0]));
+        if( idx )
+            memcpy(idx, isrc, len*sizeof(idx[0]));
+    }
+}
+
+template<typename _Tp> class LessThanIdx
+{
+public:
+    LessThanIdx( const _Tp* _arr ) : arr(_arr) {}
+    bool operator()(int a, int b) const { return arr[a] < arr[b]; }
+    const _Tp* arr;
+};
+
+template<typename T> static void sortRange_( const Mat& src, Mat& dst, int flags, const Range& range )
+{
+    AutoBuffer<T> buf, tbuf;
     T* bptr;
-    int n, len;
+    int len;
     bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
     bool inplace = src.data == dst.data;
     bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
+    bool useRadix = RadixKey<T>::enabled != 0 && (sortRows ? src.cols : src.rows) >= RADIX_SORT_MIN_LEN;
 
     if( sortRows )
-        n = src.rows, len = src.cols;
+        len = src.cols;
     else
     {
-        n = src.cols, len = src.rows;
+        len = src.rows;
         buf.allocate(len);
     }
     bptr = (T*)buf;
+    if( useRadix )
+        tbuf.allocate(len);
 
-    for( int i = 0; i < n; i++ )
+    for( int i = range.start; i < range.end; i++ )
     {
         T* ptr = bptr;
         if( sortRows )
@@ -4252,7 +4389,10 @@ template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
                 ptr[j] = src.ptr<T>(j)[i];
         }
 
-        std::sort( ptr, ptr + len );
+        if( useRadix )
+            radixSort<T>(ptr, 0, len, tbuf, 0);
+        else
+            std::sort( ptr, ptr + len );
         if( sortDescending )
         {
             for( int j = 0; j < len/2; j++ )
@@ -4265,6 +4405,106 @@ template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
     }
 }
 
+template<typename T> static void sortIdxRange_( const Mat& src, Mat& dst, int flags, const Range& range )
+{
+    AutoBuffer<T> buf, tbuf;
+    AutoBuffer<int> ibuf, itbuf;
+    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
+    bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
+
+    int len = sortRows ? src.cols : src.rows;
+    bool useRadix = RadixKey<T>::enabled != 0 && len >= RADIX_SORT_MIN_LEN;
+    if( !sortRows || useRadix )
+    {
+        // the radix sort moves the keys together with the indices, so it needs a copy of the keys
+        buf.allocate(len);
+        ibuf.allocate(len);
+    }
+    if( useRadix )
+    {
+        tbuf.allocate(len);
+        itbuf.allocate(len);
+    }
+    T* bptr = (T*)buf;
+    int* _iptr = (int*)ibuf;
+
+    for( int i = range.start; i < range.end; i++ )
+    {
+        T* ptr = bptr;
+        int* iptr = _iptr;
+
+        if( sortRows )
+        {
+            if( useRadix )
+                memcpy(ptr, src.ptr<T>(i), len*sizeof(T));
+            else
+                ptr = (T*)(src.data + src.step*i);
+            iptr = dst.ptr<int>(i);
+        }
+        else
+        {
+            for( int j = 0; j < len; j++ )
+                ptr[j] = src.ptr<T>(j)[i];
+        }
+        for( int j = 0; j < len; j++ )
+            iptr[j] = j;
+
+        if( useRadix )
+            radixSort<T>(ptr, iptr, len, tbuf, itbuf);
+        else
+            std::sort( iptr, iptr + len, LessThanIdx<T>(ptr) );
+        if( sortDescending )
+        {
+            for( int j = 0; j < len/2; j++ )
+                std::swap(iptr[j], iptr[len-1-j]);
+        }
+
+        if( !sortRows )
+            for( int j = 0; j < len; j++ )
+                dst.ptr<int>(j)[i] = iptr[j];
+    }
+}
+
+// rows (or columns) are sorted in parallel
+template<typename T> class Sort_Invoker : public ParallelLoopBody
+{
+public:
+    Sort_Invoker(const Mat& _src, Mat& _dst, int _flags, bool _sortIdx) :
+        src(_src), dst(_dst), flags(_flags), sortIdx(_sortIdx)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        if( sortIdx )
+            sortIdxRange_<T>(src, dst, flags, range);
+        else
+            sortRange_<T>(src, dst, flags, range);
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    int flags;
+    bool sortIdx;
+};
+
+template<typename T> static void sortLines_( const Mat& src, Mat& dst, int flags, bool sortIdx )
+{
+    int n = (flags & 1) == CV_SORT_EVERY_ROW ? src.rows : src.cols;
+    Sort_Invoker<T> body(src, dst, flags, sortIdx);
+    // a few lines are sorted one by one, so that the radix sort can process the chunks of each line in parallel
+    if( n < getNumThreads() )
+        body(Range(0, n));
+    else
+        parallel_for_(Range(0, n), body, src.total()/(double)(1 << 16));
+}
+
+template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
+{
+    sortLines_<T>(src, dst, flags, false);
+}
+
 #ifdef HAVE_IPP
 typedef IppStatus (CV_STDCALL *IppSortFunc)(void  *pSrcDst, int    len, Ipp8u *pBuffer);
 
@@ -4353,64 +4593,11 @@ static bool ipp_sort(const Mat& src, Mat& dst, int flags)
 }
 #endif
 
-template<typename _Tp> class LessThanIdx
-{
-public:
-    LessThanIdx( const _Tp* _arr ) : arr(_arr) {}
-    bool operator()(int a, int b) const { return arr[a] < arr[b]; }
-    const _Tp* arr;
-};
-
 template<typename T> static void sortIdx_( const Mat& src, Mat& dst, int flags )
 {
-    AutoBuffer<T> buf;
-    AutoBuffer<int> ibuf;
-    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
-    bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
-
     CV_Assert( src.data != dst.data );
 
-    int n, len;
-    if( sortRows )
-        n = src.rows, len = src.cols;
-    else
-    {
-        n = src.cols, len = src.rows;
-        buf.allocate(len);
-        ibuf.allocate(len);
-    }
-    T* bptr = (T*)buf;
-    int* _iptr = (int*)ibuf;
-
-    for( int i = 0; i < n; i++ )
-    {
-        T* ptr = bptr;
-        int* iptr = _iptr;
-
-        if( sortRows )
-        {
-            ptr = (T*)(src.data + src.step*i);
-            iptr = dst.ptr<int>(i);
-        }
-        else
-        {
-            for( int j = 0; j < len; j++ )
-                ptr[j] = src.ptr<T>(j)[i];
-        }
-        for( int j = 0; j < len; j++ )
-            iptr[j] = j;
-
-        std::sort( iptr, iptr + len, LessThanIdx<T>(ptr) );
-        if( sortDescending )
-        {
-            for( int j = 0; j < len/2; j++ )
-                std::swap(iptr[j], iptr[len-1-j]);
-        }
-
-        if( !sortRows )
-            for( int j = 0; j < len; j++ )
-                dst.ptr<int>(j)[i] = iptr[j];
-    }
+    sortLines_<T>(src, dst, flags, true);
 }
 
 #ifdef HAVE_IPP
@@ -4542,6 +4729,269 @@ void cv::sortIdx( InputArray _src, OutputArray _dst, int flags )
 }
 
 
+namespace cv
+{
+
+template<typename T> struct TopKElem
+{
+    T val;
+    int idx;
+};
+
+// orders the elements from the best to the worst one; NaNs go last, ties are resolved by the index
+template<typename T> struct TopKBetter
+{
+    TopKBetter(bool _descending) : descending(_descending) {}
+    bool operator()(const TopKElem<T>& a, const TopKElem<T>& b) const
+    {
+        if( a.val != a.val || b.val != b.val )
+            return b.val != b.val && (a.val == a.val || a.idx < b.idx);
+        if( a.val != b.val )
+            return descending ? a.val > b.val : a.val < b.val;
+        return a.idx < b.idx;
+    }
+    bool descending;
+};
+
+// returns the position of the first block of elements that may contain an element better than thr
+template<typename T> static inline int topKSkip( const T*, int j, int, T, bool )
+{
+    return j;
+}
+
+#if CV_SIMD
+template<> inline int topKSkip<float>( const float* ptr, int j, int len, float thr, bool descending )
+{
+    v_float32 vthr = vx_setall_f32(thr);
+    if( descending )
+    {
+        for( ; j <= len - v_float32::nlanes; j += v_float32::nlanes )
+            if( v_check_any(vx_load(ptr + j) > vthr) )
+                break;
+    }
+    else
+    {
+        for( ; j <= len - v_float32::nlanes; j += v_float32::nlanes )
+            if( v_check_any(vx_load(ptr + j) < vthr) )
+                break;
+    }
+    return j;
+}
+
+template<> inline int topKSkip<int>( const int* ptr, int j, int len, int thr, bool descending )
+{
+    v_int32 vthr = vx_setall_s32(thr);
+    if( descending )
+    {
+        for( ; j <= len - v_int32::nlanes; j += v_int32::nlanes )
+            if( v_check_any(vx_load(ptr + j) > vthr) )
+                break;
+    }
+    else
+    {
+        for( ; j <= len - v_int32::nlanes; j += v_int32::nlanes )
+            if( v_check_any(vx_load(ptr + j) < vthr) )
+                break;
+    }
+    return j;
+}
+#endif
+
+/*
+ Selects the k best elements of ptr[0..len) into res (unordered), returns their number (min(k, len)).
+ The candidates are collected into buf of 2*k elements; when it is full, the k best ones are kept and
+ the worst of them becomes the threshold, so the rest of the array is mostly skipped by topKSkip.
+*/
+template<typename T> static int
+topKSelect( const T* ptr, int ofs, int len, int k, bool descending, TopKElem<T>* buf, TopKElem<T>* res )
+{
+    TopKBetter<T> better(descending);
+    int cap = k*2, n = 0;
+    bool hasThr = false;
+    T thr = 0;
+
+    for( int j = 0; j < len; j++ )
+    {
+        if( hasThr )
+        {
+            j = topKSkip<T>(ptr, j, len, thr, descending);
+            if( j >= len )
+                break;
+        }
+        T v = ptr[j];
+        if( v != v || (hasThr && !(descending ? v > thr : v < thr)) )
+            continue;
+        buf[n].val = v;
+        buf[n].idx = ofs + j;
+        if( ++n == cap )
+        {
+            std::nth_element(buf, buf + k - 1, buf + n, better);
+            n = k;
+            thr = buf[k-1].val;
+            hasThr = true;
+        }
+    }
+
+    if( n > k )
+    {
+        std::nth_element(buf, buf + k - 1, buf + n, better);
+        n = k;
+    }
+    memcpy(res, buf, n*sizeof(res[0]));
+
+    // NaNs are selected only when there are not enough other elements
+    for( int j = 0; j < len && n < k; j++ )
+        if( ptr[j] != ptr[j] )
+        {
+            res[n].val = ptr[j];
+            res[n].idx = ofs + j;
+            n++;
+        }
+    return n;
+}
+
+enum { TOPK_CHUNK_SIZE = 1 << 16 };
+
+// the first pass selects the candidates from every chunk of every row (column),
+// the second one merges the candidates of each row (column) and stores the result
+template<typename T> class TopK_Invoker : public ParallelLoopBody
+{
+public:
+    TopK_Invoker(const Mat& _src, Mat& _values, Mat& _indices, int _k, int _flags, int _nchunks,
+                 TopKElem<T>* _cand, int* _ncand, bool _merge) :
+        src(_src), values(_values), indices(_indices), k(_k), nchunks(_nchunks), cand(_cand), ncand(_ncand), merge(_merge)
+    {
+        sortRows = (_flags & 1) == SORT_EVERY_ROW;
+        descending = (_flags & SORT_DESCENDING) != 0;
+        len = sortRows ? src.cols : src.rows;
+        chunkSize = (len + nchunks - 1)/nchunks;
+    }
+
+    void operator()(const Range& range) const
+    {
+        if( merge )
+            mergeCandidates(range);
+        else
+            selectCandidates(range);
+    }
+
+private:
+    void selectCandidates(const Range& range) const
+    {
+        AutoBuffer<TopKElem<T> > _buf(k*2);
+        AutoBuffer<T> col(sortRows ? 0 : chunkSize);
+        for( int t = range.start; t < range.end; t++ )
+        {
+            int i = t/nchunks, j0 = t%nchunks*chunkSize, n = std::min(chunkSize, len - j0);
+            const T* ptr;
+            if( sortRows )
+                ptr = src.ptr<T>(i) + j0;
+            else
+            {
+                for( int j = 0; j < n; j++ )
+                    col[j] = src.ptr<T>(j0 + j)[i];
+                ptr = col;
+            }
+            ncand[t] = topKSelect<T>(ptr, j0, n, k, descending, _buf, cand + (size_t)t*k);
+        }
+    }
+
+    void mergeCandidates(const Range& range) const
+    {
+        TopKBetter<T> better(descending);
+        for( int i = range.start; i < range.end; i++ )
+        {
+            // the candidates of all the chunks are packed together in place
+            TopKElem<T>* c = cand + (size_t)i*nchunks*k;
+            int n = 0;
+            for( int t = 0; t < nchunks; t++ )
+            {
+                memmove(c + n, c + t*k, ncand[i*nchunks + t]*sizeof(c[0]));
+                n += ncand[i*nchunks + t];
+            }
+            if( n > k )
+                std::nth_element(c, c + k - 1, c + n, better);
+            std::sort(c, c + k, better);
+
+            for( int j = 0; j < k; j++ )
+            {
+                if( sortRows )
+                {
+                    values.ptr<T>(i)[j] = c[j].val;
+                    indices.ptr<int>(i)[j] = c[j].idx;
+                }
+                else
+                {
+                    values.ptr<T>(j)[i] = c[j].val;
+                    indices.ptr<int>(j)[i] = c[j].idx;
+                }
+            }
+        }
+    }
+
+    const Mat& src;
+    Mat& values;
+    Mat& indices;
+    int k, len, nchunks, chunkSize;
+    bool sortRows, descending;
+    TopKElem<T>* cand;
+    int* ncand;
+    bool merge;
+};
+
+template<typename T> static void topK_( const Mat& src, Mat& values, Mat& indices, int k, int flags )
+{
+    bool sortRows = (flags & 1) == SORT_EVERY_ROW;
+    int nlines = sortRows ? src.rows : src.cols, len = sortRows ? src.cols : src.rows;
+
+    // long rows (columns) are split into chunks when there are too few of them to load all the threads
+    int nchunks = 1, nthreads = getNumThreads();
+    if( nlines < nthreads && len >= TOPK_CHUNK_SIZE*2 )
+        nchunks = std::max(std::min(len/TOPK_CHUNK_SIZE, (nthreads + nlines - 1)/nlines), 1);
+    // every chunk must contain at least k elements, so the merged candidates are never too few
+    nchunks = std::max(std::min(nchunks, len/k), 1);
+
+    AutoBuffer<TopKElem<T> > cand((size_t)nlines*nchunks*k);
+    AutoBuffer<int> ncand(nlines*nchunks);
+    double nstripes = src.total()/(double)(1 << 16);
+
+    parallel_for_(Range(0, nlines*nchunks),
+                  TopK_Invoker<T>(src, values, indices, k, flags, nchunks, cand, ncand, false), nstripes);
+    parallel_for_(Range(0, nlines),
+                  TopK_Invoker<T>(src, values, indices, k, flags, nchunks, cand, ncand, true), nstripes);
+}
+
+typedef void (*TopKFunc)(const Mat& src, Mat& values, Mat& indices, int k, int flags);
+
+}
+
+void cv::topK( InputArray _src, OutputArray _values, OutputArray _indices, int k, int flags )
+{
+    CV_INSTRUMENT_REGION()
+
+    Mat src = _src.getMat();
+    CV_Assert( src.dims <= 2 && src.channels() == 1 );
+    bool sortRows = (flags & 1) == SORT_EVERY_ROW;
+    CV_Assert( 0 < k && k <= (sortRows ? src.cols : src.rows) );
+
+    Size dsize = sortRows ? Size(k, src.rows) : Size(src.cols, k);
+    if( _values.getObj() == _src.getObj() )
+        _values.release();
+    _values.create( dsize, src.type() );
+    _indices.create( dsize, CV_32S );
+    Mat values = _values.getMat(), indices = _indices.getMat();
+
+    static TopKFunc tab[] =
+    {
+        topK_<uchar>, topK_<schar>, topK_<ushort>, topK_<short>,
+        topK_<int>, topK_<float>, topK_<double>, 0
+    };
+    TopKFunc func = tab[src.depth()];
+    CV_Assert( func != 0 );
+    func( src, values, indices, k, flags );
+}
+
+
 CV_IMPL void cvSetIdentity( CvArr* arr, CvScalar value )
 {
     cv::Mat m = cv::cvarrToMat(arr);
@@ -43,6 +43,21 @@
 #include "precomp.hpp"
 
 #include <opencv2/core/utils/trace.private.hpp>
+#include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/parallel_stats.hpp>
+
+#include <map>
+#ifdef CV_CXX11
+#include <exception>
+#endif
+
+#ifdef __GNUC__
+    #include <cxxabi.h>
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
 
 #if defined _WIN32 || defined WINCE
     #include <windows.h>
@@ -82,7 +97,8 @@
    4. HAVE_GCD         - system wide, used automatically        (APPLE only)
    5. WINRT            - system wide, used automatically        (Windows RT only)
    6. HAVE_CONCURRENCY - part of runtime, used automatically    (Windows only - MSVS 10, MSVS 11)
-   7. HAVE_PTHREADS_PF - pthreads if available
+   7. HAVE_WORKSTEALING_PF - work-stealing pool over pthreads, should be explicitly enabled
+   8. HAVE_PTHREADS_PF - pthreads if available
 */
 
 #if defined HAVE_TBB
@@ -121,6 +137,8 @@
 #  define CV_PARALLEL_FRAMEWORK "winrt-concurrency"
 #elif defined HAVE_CONCURRENCY
 #  define CV_PARALLEL_FRAMEWORK "ms-concurrency"
+#elif defined HAVE_WORKSTEALING_PF
+#  define CV_PARALLEL_FRAMEWORK "workstealing"
 #elif defined HAVE_PTHREADS_PF
 #  define CV_PARALLEL_FRAMEWORK "pthreads"
 #endif
@@ -135,6 +153,12 @@ namespace cv
     size_t parallel_pthreads_get_threads_num();
     void parallel_pthreads_set_threads_num(int num);
 #endif
+#ifdef HAVE_WORKSTEALING_PF
+    void parallel_for_workstealing(const cv::Range& stripes, const cv::ParallelLoopBody& body);
+    size_t parallel_workstealing_get_threads_num();
+    void parallel_workstealing_set_threads_num(int num);
+    int parallel_workstealing_get_thread_num();
+#endif
 }
 
 
@@ -167,11 +191,179 @@ namespace
     }
 #endif
 
+    static bool& parallelForStatsFlag()
+    {
+        static bool value = cv::utils::getConfigurationParameterBool("OPENCV_PARALLEL_FOR_STATS", false);
+        return value;
+    }
+
+    static bool& parallelForAutoTuneFlag()
+    {
+        static bool value = cv::utils::getConfigurationParameterBool("OPENCV_PARALLEL_FOR_AUTOTUNE", false);
+        return value;
+    }
+
+    // busy time of the threads taking part in one parallel_for_() call
+    class ParallelForCallStats
+    {
+    public:
+        ParallelForCallStats() : busy(0), stripes(0) {}
+
+        void add(int threadID, int64 ticks, int nstripes)
+        {
+            cv::AutoLock lock(mutex);
+            busy += ticks;
+            stripes += nstripes;
+            for (size_t i = 0; i < threads.size(); i++)
+            {
+                if (threads[i].first == threadID)
+                {
+                    threads[i].second += ticks;
+                    return;
+                }
+            }
+            threads.push_back(std::make_pair(threadID, ticks));
+        }
+
+        cv::Mutex mutex;
+        std::vector<std::pair<int, int64> > threads;
+        int64 busy;
+        int stripes;
+    };
+
+    // stripes per thread tried by the auto-tuning, 0 stands for the count requested by the caller
+    static const int autoTuneStripesPerThread[] = { 0, 1, 2, 4, 8, 16 };
+    enum { AUTOTUNE_CANDIDATES = 6, AUTOTUNE_SAMPLES = 3 };
+
+    class ParallelForSite
+    {
+    public:
+        ParallelForSite() : imbalanceSum(0), candidate(0), samples(0), best(-1)
+        {
+            for (int i = 0; i < AUTOTUNE_CANDIDATES; i++)
+                cost[i] = DBL_MAX;
+        }
+
+        // returns the candidate to be used by the next call
+        int selectStripes(double& nstripes, int nthreads) const
+        {
+            int c = best >= 0 ? best : candidate;
+            if (autoTuneStripesPerThread[c] > 0)
+                nstripes = (double)autoTuneStripesPerThread[c]*std::max(nthreads, 1);
+            return c;
+        }
+
+        void update(int len, int64 wallTicks, const ParallelForCallStats& callStats,
+                    bool collect, int usedCandidate, int nstripes)
+        {
+            double freq = cv::getTickFrequency();
+            if (collect)
+            {
+                stats.calls++;
+                stats.stripes += callStats.stripes;
+                stats.wallTime += wallTicks/freq;
+                stats.busyTime += callStats.busy/freq;
+                int nthreads = (int)callStats.threads.size();
+                stats.maxThreads = std::max(stats.maxThreads, nthreads);
+                int64 maxBusy = 0;
+                for (int i = 0; i < nthreads; i++)
+                    maxBusy = std::max(maxBusy, callStats.threads[i].second);
+                imbalanceSum += callStats.busy > 0 ? (double)maxBusy*nthreads/callStats.busy : 1.;
+                stats.imbalance = imbalanceSum/stats.calls;
+            }
+            if (usedCandidate < 0)
+                return;
+            if (best < 0 && usedCandidate == candidate)
+            {
+                cost[candidate] = std::min(cost[candidate], (double)wallTicks/len);
+                if (++samples >= AUTOTUNE_SAMPLES)
+                {
+                    samples = 0;
+                    if (++candidate == AUTOTUNE_CANDIDATES)
+                    {
+                        best = 0;
+                        for (int i = 1; i < AUTOTUNE_CANDIDATES; i++)
+                            if (cost[i] < cost[best])
+                                best = i;
+                        candidate = best;
+                    }
+                }
+            }
+            if (usedCandidate == best)
+                stats.tunedStripes = nstripes;
+        }
+
+        cv::utils::ParallelForStats stats;
+        double imbalanceSum;
+        int candidate;  // candidate being measured
+        int samples;    // calls measured with the candidate
+        int best;       // chosen candidate, -1 while tuning
+        double cost[AUTOTUNE_CANDIDATES]; // min time per range element
+    };
+
+    static cv::String demangleTypeName(const char* name)
+    {
+#ifdef __GNUC__
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(name, 0, 0, &status);
+        if (demangled)
+        {
+            cv::String result(demangled);
+            free(demangled);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+    struct ParallelForSiteNameTLS
+    {
+        ParallelForSiteNameTLS() : name(0) {}
+        const char* name;
+    };
+
+    class ParallelForRegistry
+    {
+    public:
+        // sites are never removed, so the pointers stay valid
+        ParallelForSite* getSite(const cv::ParallelLoopBody& body, const void* caller)
+        {
+            const char* name = siteName.getRef().name;
+            cv::String key = name ? cv::String("#") + name : cv::format("%s@%p", typeid(body).name(), caller);
+            cv::AutoLock lock(mutex);
+            std::map<cv::String, ParallelForSite>::iterator it = sites.find(key);
+            if (it == sites.end())
+            {
+                it = sites.insert(std::make_pair(key, ParallelForSite())).first;
+                it->second.stats.site = name ? cv::String(name) :
+                    demangleTypeName(typeid(body).name()) + cv::format(" (called from %p)", caller);
+            }
+            return &it->second;
+        }
+
+        cv::Mutex mutex;
+        std::map<cv::String, ParallelForSite> sites;
+        cv::TLSData<ParallelForSiteNameTLS> siteName; // set by utils::ParallelForSiteName
+    };
+
+    static ParallelForRegistry& getParallelForRegistry()
+    {
+        CV_SINGLETON_LAZY_INIT_REF(ParallelForRegistry, new ParallelForRegistry())
+    }
+
+    static void updateParallelForSite(ParallelForSite& site, const cv::Range& range, int64 startTicks,
+                                      const ParallelForCallStats& callStats, bool collect, int candidate, int nstripes)
+    {
+        int64 wallTicks = cv::getTickCount() - startTicks;
+        cv::AutoLock lock(getParallelForRegistry().mutex);
+        site.update(range.end - range.start, wallTicks, callStats, collect, candidate, nstripes);
+    }
+
     class ParallelLoopBodyWrapperContext
     {
     public:
         ParallelLoopBodyWrapperContext(const cv::ParallelLoopBody& _body, const cv::Range& _r, double _nstripes) :
-            is_rng_used(false)
+            is_rng_used(false), callStats(0), hasException(0)
         {
 
             body = &_body;
@@ -213,11 +405,58 @@ namespace
 #endif
         }
 
+        // called from a catch block: keeps the first exception thrown by the loop body
+        void recordException()
+        {
+            if (CV_XADD(&hasException, 1) != 0)
+                return;
+#ifdef CV_CXX11
+            exception = std::current_exception();
+#else
+            try
+            {
+                throw;
+            }
+            catch (const cv::Exception& e)
+            {
+                exception = e;
+            }
+            catch (const std::exception& e)
+            {
+                exception = cv::Exception(cv::Error::StsError, e.what(), "parallel_for_", __FILE__, __LINE__);
+            }
+            catch (...)
+            {
+                exception = cv::Exception(cv::Error::StsError, "Unknown exception in the body of parallel_for_",
+                                          "parallel_for_", __FILE__, __LINE__);
+            }
+#endif
+        }
+
+        // rethrows the exception of the loop body in the calling thread
+        void rethrowException() const
+        {
+            if (!hasException)
+                return;
+#ifdef CV_CXX11
+            std::rethrow_exception(exception);
+#else
+            throw exception;
+#endif
+        }
+
         const cv::ParallelLoopBody* body;
         cv::Range wholeRange;
         int nstripes;
         cv::RNG rng;
         mutable bool is_rng_used;
+        ParallelForCallStats* callStats; // filled if the statistics are collected
+        volatile int hasException;
+#ifdef CV_CXX11
+        std::exception_ptr exception;
+#else
+        cv::Exception exception;
+#endif
 #ifdef OPENCV_TRACE
         CV_TRACE_NS::details::Region* traceRootRegion;
         CV_TRACE_NS::details::TraceManagerThreadLocal* traceRootContext;
@@ -275,7 +514,25 @@ namespace
             CV_TRACE_ARG_VALUE(range_end, "range.end", (int64)r.end);
 #endif
 
-            (*ctx.body)(r);
+            // the remaining stripes are skipped after an exception
+            if (ctx.hasException)
+                return;
+            try
+            {
+                if (ctx.callStats)
+                {
+                    int64 t = cv::getTickCount();
+                    (*ctx.body)(r);
+                    ctx.callStats->add(cv::utils::getThreadID(), cv::getTickCount() - t, sr.end - sr.start);
+                }
+                else
+                    (*ctx.body)(r);
+            }
+            catch (...)
+            {
+                // the exceptions must not escape the worker threads
+                ctx.recordException();
+            }
 
             if (!ctx.is_rng_used && !(cv::theRNG() == ctx.rng))
                 ctx.is_rng_used = true;
@@ -366,10 +623,18 @@ static SchedPtr pplScheduler;
 /* ================================   parallel_for_  ================================ */
 
 #ifdef CV_PARALLEL_FRAMEWORK
-static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes); // forward declaration
+static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes,
+                              const void* caller); // forward declaration
 #endif
 
+// the return address of parallel_for_() tells apart the call sites of the same loop body type
 void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
+{
+    cv::details::parallel_for_from(CV__PARALLEL_FOR_CALLER(), range, body, nstripes);
+}
+
+void cv::details::parallel_for_from(const void* caller, const cv::Range& range, const cv::ParallelLoopBody& body,
+                                    double nstripes)
 {
 #ifdef OPENCV_TRACE
     CV__TRACE_OPENCV_FUNCTION_NAME_("parallel_for", 0);
@@ -382,6 +647,10 @@ void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body,
     if (range.empty())
         return;
 
+#if defined HAVE_WORKSTEALING_PF
+    // nested and concurrent calls are balanced by the work-stealing pool itself
+    parallel_for_impl(range, body, nstripes, caller);
+#else
 #ifdef CV_PARALLEL_FRAMEWORK
     static volatile int flagNestedParallelFor = 0;
     bool isNotNestedRegion = flagNestedParallelFor == 0;
@@ -391,7 +660,7 @@ void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body,
     {
         try
         {
-            parallel_for_impl(range, body, nstripes);
+            parallel_for_impl(range, body, nstripes, caller);
             flagNestedParallelFor = 0;
         }
         catch (...)
@@ -404,21 +673,50 @@ void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body,
 #endif // CV_PARALLEL_FRAMEWORK
     {
         (void)nstripes;
+        (void)caller;
         body(range);
     }
+#endif // HAVE_WORKSTEALING_PF
 }
 
 #ifdef CV_PARALLEL_FRAMEWORK
-static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
+static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes,
+                              const void* caller)
 {
     if ((numThreads < 0 || numThreads > 1) && range.end - range.start > 1)
     {
+        bool collectStats = parallelForStatsFlag(), autoTune = parallelForAutoTuneFlag();
+        ParallelForSite* site = 0;
+        ParallelForCallStats callStats;
+        int candidate = -1;
+        int64 startTicks = 0;
+        if (collectStats || autoTune)
+        {
+            ParallelForRegistry& registry = getParallelForRegistry();
+            site = registry.getSite(body, caller);
+            if (autoTune)
+            {
+                cv::AutoLock lock(registry.mutex);
+                candidate = site->selectStripes(nstripes, cv::getNumThreads());
+            }
+            startTicks = cv::getTickCount();
+        }
+
         ParallelLoopBodyWrapperContext ctx(body, range, nstripes);
+        if (collectStats)
+            ctx.callStats = &callStats;
         ProxyLoopBody pbody(ctx);
         cv::Range stripeRange = pbody.stripeRange();
         if( stripeRange.end - stripeRange.start == 1 )
         {
+            int64 t = site ? cv::getTickCount() : 0;
             body(range);
+            if (site)
+            {
+                if (collectStats)
+                    callStats.add(cv::utils::getThreadID(), cv::getTickCount() - t, 1);
+                updateParallelForSite(*site, range, startTicks, callStats, collectStats, candidate, 1);
+            }
             return;
         }
 
@@ -465,6 +763,10 @@ static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody
             Concurrency::CurrentScheduler::Detach();
         }
 
+#elif defined HAVE_WORKSTEALING_PF
+
+        parallel_for_workstealing(pbody.stripeRange(), pbody);
+
 #elif defined HAVE_PTHREADS_PF
 
         parallel_for_pthreads(pbody.stripeRange(), pbody, pbody.stripeRange().size());
@@ -474,6 +776,10 @@ static void parallel_for_impl(const cv::Range& range, const cv::ParallelLoopBody
 #error You have hacked and compiling with unsupported parallel framework
 
 #endif
+
+        if (site)
+            updateParallelForSite(*site, range, startTicks, callStats, collectStats, candidate, ctx.nstripes);
+        ctx.rethrowException();
     }
     else
     {
@@ -525,6 +831,10 @@ int cv::getNumThreads(void)
         ? Concurrency::CurrentScheduler::Get()->GetNumberOfVirtualProcessors()
         : pplScheduler->GetNumberOfVirtualProcessors());
 
+#elif defined HAVE_WORKSTEALING_PF
+
+        return (int)parallel_workstealing_get_threads_num();
+
 #elif defined HAVE_PTHREADS_PF
 
         return parallel_pthreads_get_threads_num();
@@ -583,6 +893,10 @@ void cv::setNumThreads( int threads )
                        Concurrency::MaxConcurrency, threads-1));
     }
 
+#elif defined HAVE_WORKSTEALING_PF
+
+    parallel_workstealing_set_threads_num(threads);
+
 #elif defined HAVE_PTHREADS_PF
 
     parallel_pthreads_set_threads_num(threads);
@@ -611,6 +925,8 @@ int cv::getThreadNum(void)
     return 0;
 #elif defined HAVE_CONCURRENCY
     return std::max(0, (int)Concurrency::Context::VirtualProcessorId()); // zero for master thread, unique number for others but not necessary 1,2,3,...
+#elif defined HAVE_WORKSTEALING_PF
+    return parallel_workstealing_get_thread_num();
 #elif defined HAVE_PTHREADS_PF
     return (int)(size_t)(void*)pthread_self(); // no zero-based indexing
 #else
@@ -709,6 +1025,89 @@ const char* cv::currentParallelFramework() {
 #endif
 }
 
+void cv::utils::setParallelForStatsEnabled(bool enabled)
+{
+#ifdef CV_PARALLEL_FRAMEWORK
+    parallelForStatsFlag() = enabled;
+#else
+    (void)enabled;
+#endif
+}
+
+bool cv::utils::isParallelForStatsEnabled()
+{
+#ifdef CV_PARALLEL_FRAMEWORK
+    return parallelForStatsFlag();
+#else
+    return false;
+#endif
+}
+
+void cv::utils::setParallelForAutoTuning(bool enabled)
+{
+#ifdef CV_PARALLEL_FRAMEWORK
+    parallelForAutoTuneFlag() = enabled;
+#else
+    (void)enabled;
+#endif
+}
+
+bool cv::utils::isParallelForAutoTuning()
+{
+#ifdef CV_PARALLEL_FRAMEWORK
+    return parallelForAutoTuneFlag();
+#else
+    return false;
+#endif
+}
+
+std::vector<cv::utils::ParallelForStats> cv::utils::getParallelForStats()
+{
+    std::vector<ParallelForStats> result;
+#ifdef CV_PARALLEL_FRAMEWORK
+    ParallelForRegistry& registry = getParallelForRegistry();
+    cv::AutoLock lock(registry.mutex);
+    for (std::map<cv::String, ParallelForSite>::const_iterator it = registry.sites.begin(); it != registry.sites.end(); ++it)
+    {
+        if (it->second.stats.calls > 0 || it->second.stats.tunedStripes > 0)
+            result.push_back(it->second.stats);
+    }
+#endif
+    return result;
+}
+
+cv::utils::ParallelForSiteName::ParallelForSiteName(const char* name) : prev(0)
+{
+#ifdef CV_PARALLEL_FRAMEWORK
+    const char*& current = getParallelForRegistry().siteName.getRef().name;
+    prev = current;
+    current = name;
+#else
+    (void)name;
+#endif
+}
+
+cv::utils::ParallelForSiteName::~ParallelForSiteName()
+{
+#ifdef CV_PARALLEL_FRAMEWORK
+    getParallelForRegistry().siteName.getRef().name = prev;
+#endif
+}
+
+void cv::utils::resetParallelForStats()
+{
+#ifdef CV_PARALLEL_FRAMEWORK
+    ParallelForRegistry& registry = getParallelForRegistry();
+    cv::AutoLock lock(registry.mutex);
+    for (std::map<cv::String, ParallelForSite>::iterator it = registry.sites.begin(); it != registry.sites.end(); ++it)
+    {
+        cv::String site = it->second.stats.site;
+        it->second = ParallelForSite();
+        it->second.stats.site = site;
+    }
+#endif
+}
+
 CV_IMPL void cvSetNumThreads(int nt)
 {
     cv::setNumThreads(nt);
@@ -0,0 +1,598 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#ifdef HAVE_WORKSTEALING_PF
+
+#include <deque>
+#ifdef CV_CXX11
+#include <exception>
+#endif
+#include <pthread.h>
+#include <sched.h>
+
+/*
+   Work-stealing backend of parallel_for_().
+
+   Every worker thread owns a deque of tasks, where a task is a range of stripes of one
+   parallel_for_() call (a job). A thread takes tasks from the back of its own deque and splits
+   them in halves, leaving the second half in the deque, until the task is small enough to be
+   processed. Idle workers steal tasks from the front of other deques, i.e. the largest ones.
+
+   The thread that calls parallel_for_() pushes the whole range into its own deque (external
+   threads borrow one for the duration of the call) and processes the job together with the
+   workers. It keeps processing tasks of the same job until all stripes are done, so nested
+   parallel_for_() calls made from the loop bodies are parallelized too. When no task of the job
+   is left to take, it sleeps until the job is finished or new tasks are pushed.
+*/
+
+namespace cv
+{
+
+namespace {
+
+enum
+{
+    WS_MAX_WORKERS = 256,
+    WS_MAX_EXTERNAL = 64, // max number of non-worker threads calling parallel_for_() simultaneously
+    WS_SPIN_COUNT = 64    // number of unsuccessful steal attempts before an idle thread falls asleep
+};
+
+struct WSJob
+{
+    WSJob(const ParallelLoopBody& _body, int _nstripes, int _grain)
+        : body(&_body), pending(_nstripes), grain(_grain), failed(0) {}
+
+    const ParallelLoopBody* body;
+    volatile int pending; // stripes not processed yet
+    int grain;            // tasks of at most this number of stripes are not split
+    volatile int failed;
+#ifdef CV_CXX11
+    std::exception_ptr exception;
+#else
+    cv::Exception exception;
+#endif
+};
+
+struct WSTask
+{
+    WSJob* job;
+    int begin;
+    int end;
+};
+
+class WSDeque
+{
+public:
+    void push(const WSTask& task)
+    {
+        AutoLock lock(mutex_);
+        tasks_.push_back(task);
+    }
+
+    // takes the newest task if it belongs to the job (any job if it is NULL)
+    bool pop(WSTask& task, const WSJob* job)
+    {
+        AutoLock lock(mutex_);
+        if( tasks_.empty() || (job && tasks_.back().job != job) )
+            return false;
+        task = tasks_.back();
+        tasks_.pop_back();
+        return true;
+    }
+
+    // takes the oldest task of the job (any job if it is NULL)
+    bool steal(WSTask& task, const WSJob* job)
+    {
+        AutoLock lock(mutex_);
+        for( std::deque<WSTask>::iterator it = tasks_.begin(); it != tasks_.end(); ++it )
+        {
+            if( !job || it->job == job )
+            {
+                task = *it;
+                tasks_.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    Mutex mutex_;
+    std::deque<WSTask> tasks_;
+};
+
+struct WSThreadData
+{
+    WSThreadData() : deque(0), id(0), depth(0), seed(0) {}
+
+    WSDeque* deque; // the deque of a worker or the borrowed one of an external thread
+    int id;         // 0 for external threads, 1..N-1 for workers
+    int depth;      // nesting level of parallel_for_() calls of an external thread
+    unsigned seed;  // victim selection
+};
+
+class WorkStealingPool
+{
+public:
+    static WorkStealingPool& instance()
+    {
+        CV_SINGLETON_LAZY_INIT_REF(WorkStealingPool, new WorkStealingPool())
+    }
+
+    void run(const Range& stripes, const ParallelLoopBody& body);
+
+    size_t getNumOfThreads() const { return pendingNumThreads_ > 0 ? (size_t)pendingNumThreads_ : numThreads_; }
+    void setNumOfThreads(size_t n);
+    int getThreadNum() { return tls_.get()->id; }
+
+private:
+    // the pool is never destroyed, the workers are terminated with the process
+    WorkStealingPool();
+
+    static void* workerLoopWrapper(void* arg);
+    void workerLoop(int id);
+
+    void startWorkers();
+    void stopWorkers();
+    size_t defaultNumberOfThreads();
+
+    WSDeque* acquireExternalDeque();
+    void releaseExternalDeque(WSDeque* deque);
+
+    void processTask(WSTask task, WSDeque& own);
+    bool findTask(WSTask& task, WSThreadData& data, const WSJob* job);
+    void notifyWorkers();
+    void waitJob(WSJob& job, WSThreadData& data);
+    void applyNumOfThreads(size_t n);
+
+    size_t numThreads_;
+    volatile int pendingNumThreads_; // requested from a loop body, applied by the next outermost call
+    bool started_;
+    Mutex mutex_; // protects starting and stopping of the workers
+
+    std::vector<pthread_t> threads_;
+    WSDeque* workerDeques_[WS_MAX_WORKERS];
+    volatile int numWorkers_;
+
+    WSDeque* externalDeques_[WS_MAX_EXTERNAL];
+    volatile int externalBusy_[WS_MAX_EXTERNAL];
+    volatile int numExternal_;
+
+    pthread_mutex_t idleMutex_;
+    pthread_cond_t idleCond_;
+    volatile int idle_;
+    volatile unsigned version_;
+    volatile bool stop_;
+
+    // the callers waiting for their jobs, woken when a job is finished or a task is pushed
+    pthread_mutex_t waitMutex_;
+    pthread_cond_t waitCond_;
+    volatile int waiting_;
+
+    TLSData<WSThreadData> tls_;
+};
+
+struct WSWorkerArg
+{
+    WorkStealingPool* pool;
+    int id;
+};
+
+WorkStealingPool::WorkStealingPool()
+    : pendingNumThreads_(0), started_(false), numWorkers_(0), numExternal_(0), idle_(0), version_(0), stop_(false),
+      waiting_(0)
+{
+    for( int i = 0; i < WS_MAX_WORKERS; i++ )
+        workerDeques_[i] = 0;
+    for( int i = 0; i < WS_MAX_EXTERNAL; i++ )
+    {
+        externalDeques_[i] = 0;
+        externalBusy_[i] = 0;
+    }
+    pthread_mutex_init(&idleMutex_, NULL);
+    pthread_cond_init(&idleCond_, NULL);
+    pthread_mutex_init(&waitMutex_, NULL);
+    pthread_cond_init(&waitCond_, NULL);
+    numThreads_ = defaultNumberOfThreads();
+}
+
+size_t WorkStealingPool::defaultNumberOfThreads()
+{
+    unsigned int result = (unsigned int)std::max(1, cv::getNumberOfCPUs());
+    const char* env = getenv("OPENCV_FOR_THREADS_NUM");
+    if( env != NULL )
+    {
+        sscanf(env, "%u", &result);
+        result = std::max(1u, result);
+    }
+    return std::min((size_t)result, (size_t)WS_MAX_WORKERS);
+}
+
+void WorkStealingPool::setNumOfThreads(size_t n)
+{
+    if( n == 0 )
+        n = defaultNumberOfThreads();
+    n = std::min(n, (size_t)WS_MAX_WORKERS);
+
+    // the workers can't be stopped from a loop body: they may be busy with the same job
+    // or the calling thread may be one of them
+    WSThreadData& data = tls_.getRef();
+    if( data.id > 0 || data.depth > 0 )
+    {
+        pendingNumThreads_ = (int)n;
+        return;
+    }
+    AutoLock lock(mutex_);
+    pendingNumThreads_ = 0;
+    applyNumOfThreads(n);
+}
+
+void WorkStealingPool::applyNumOfThreads(size_t n)
+{
+    if( n != numThreads_ )
+    {
+        // deques of the stopped workers stay registered, so their tasks are still reachable
+        stopWorkers();
+        numThreads_ = n;
+    }
+}
+
+void WorkStealingPool::startWorkers()
+{
+    AutoLock lock(mutex_);
+    if( started_ )
+        return;
+    int n = (int)numThreads_ - 1;
+    for( int i = 0; i < n; i++ )
+    {
+        if( !workerDeques_[i] )
+            workerDeques_[i] = new WSDeque();
+    }
+    if( numWorkers_ < n )
+        numWorkers_ = n;
+    threads_.clear();
+    for( int i = 0; i < n; i++ )
+    {
+        WSWorkerArg* arg = new WSWorkerArg;
+        arg->pool = this;
+        arg->id = i + 1;
+        pthread_t thread;
+        if( pthread_create(&thread, NULL, workerLoopWrapper, arg) != 0 )
+        {
+            delete arg;
+            break;
+        }
+        threads_.push_back(thread);
+    }
+    started_ = true;
+}
+
+void WorkStealingPool::stopWorkers()
+{
+    if( !started_ )
+        return;
+    pthread_mutex_lock(&idleMutex_);
+    stop_ = true;
+    version_++;
+    pthread_cond_broadcast(&idleCond_);
+    pthread_mutex_unlock(&idleMutex_);
+
+    for( size_t i = 0; i < threads_.size(); i++ )
+        pthread_join(threads_[i], NULL);
+    threads_.clear();
+
+    pthread_mutex_lock(&idleMutex_);
+    stop_ = false;
+    pthread_mutex_unlock(&idleMutex_);
+    started_ = false;
+}
+
+void* WorkStealingPool::workerLoopWrapper(void* arg)
+{
+    WSWorkerArg* warg = (WSWorkerArg*)arg;
+    WorkStealingPool* pool = warg->pool;
+    int id = warg->id;
+    delete warg;
+    pool->workerLoop(id);
+    return 0;
+}
+
+void WorkStealingPool::workerLoop(int id)
+{
+    (void)cv::utils::getThreadID(); // notify OpenCV about new thread
+
+    WSThreadData& data = tls_.getRef();
+    data.id = id;
+    data.deque = workerDeques_[id - 1];
+    data.seed = (unsigned)id*2654435761u;
+
+    WSTask task;
+    for(;;)
+    {
+        bool found = false;
+        for( int i = 0; i < WS_SPIN_COUNT && !found && !stop_; i++ )
+        {
+            found = findTask(task, data, NULL);
+            if( !found )
+                sched_yield();
+        }
+        if( found )
+        {
+            processTask(task, *data.deque);
+            continue;
+        }
+
+        // announce the intention to sleep before the last check, see notifyWorkers()
+        CV_XADD(&idle_, 1);
+        unsigned version = version_;
+        if( findTask(task, data, NULL) )
+        {
+            CV_XADD(&idle_, -1);
+            processTask(task, *data.deque);
+            continue;
+        }
+        pthread_mutex_lock(&idleMutex_);
+        while( version == version_ && !stop_ )
+            pthread_cond_wait(&idleCond_, &idleMutex_);
+        bool stop = stop_;
+        pthread_mutex_unlock(&idleMutex_);
+        CV_XADD(&idle_, -1);
+        if( stop )
+            break;
+    }
+
+    data.deque = 0;
+}
+
+void WorkStealingPool::notifyWorkers()
+{
+    if( idle_ > 0 )
+    {
+        pthread_mutex_lock(&idleMutex_);
+        version_++;
+        pthread_cond_signal(&idleCond_);
+        pthread_mutex_unlock(&idleMutex_);
+    }
+    if( waiting_ > 0 )
+    {
+        pthread_mutex_lock(&waitMutex_);
+        pthread_cond_broadcast(&waitCond_);
+        pthread_mutex_unlock(&waitMutex_);
+    }
+}
+
+void WorkStealingPool::waitJob(WSJob& job, WSThreadData& data)
+{
+    WSTask task;
+    int spins = 0;
+    while( job.pending > 0 )
+    {
+        if( findTask(task, data, &job) )
+        {
+            processTask(task, *data.deque);
+            spins = 0;
+        }
+        else if( ++spins < WS_SPIN_COUNT )
+            sched_yield();
+        else
+        {
+            // the remaining stripes are processed by the other threads
+            pthread_mutex_lock(&waitMutex_);
+            CV_XADD(&waiting_, 1);
+            if( job.pending > 0 )
+                pthread_cond_wait(&waitCond_, &waitMutex_);
+            CV_XADD(&waiting_, -1);
+            pthread_mutex_unlock(&waitMutex_);
+            spins = 0;
+        }
+    }
+}
+
+WSDeque* WorkStealingPool::acquireExternalDeque()
+{
+    for( int i = 0; i < WS_MAX_EXTERNAL; i++ )
+    {
+        if( externalBusy_[i] == 0 && CV_XADD(&externalBusy_[i], 1) == 0 )
+        {
+            if( !externalDeques_[i] )
+            {
+                AutoLock lock(mutex_);
+                externalDeques_[i] = new WSDeque();
+                if( numExternal_ <= i )
+                    numExternal_ = i + 1;
+            }
+            return externalDeques_[i];
+        }
+    }
+    return 0;
+}
+
+void WorkStealingPool::releaseExternalDeque(WSDeque* deque)
+{
+    for( int i = 0; i < numExternal_; i++ )
+    {
+        if( externalDeques_[i] == deque )
+        {
+            externalBusy_[i] = 0;
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::findTask(WSTask& task, WSThreadData& data, const WSJob* job)
+{
+    if( data.deque && data.deque->pop(task, job) )
+        return true;
+
+    int nworkers = numWorkers_, nexternal = numExternal_;
+    int total = nworkers + nexternal;
+    if( total == 0 )
+        return false;
+    data.seed = data.seed*1664525u + 1013904223u;
+    int start = (int)((data.seed >> 8) % (unsigned)total);
+    for( int i = 0; i < total; i++ )
+    {
+        int idx = start + i < total ? start + i : start + i - total;
+        WSDeque* victim = idx < nworkers ? workerDeques_[idx] : externalDeques_[idx - nworkers];
+        if( victim && victim != data.deque && victim->steal(task, job) )
+            return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::processTask(WSTask task, WSDeque& own)
+{
+    WSJob& job = *task.job;
+
+    // keep the first half, leave the second one to the thieves
+    while( task.end - task.begin > job.grain )
+    {
+        WSTask rest = task;
+        rest.begin = task.begin + (task.end - task.begin)/2;
+        task.end = rest.begin;
+        own.push(rest);
+        notifyWorkers();
+    }
+
+    if( job.failed == 0 )
+    {
+        try
+        {
+            (*job.body)(Range(task.begin, task.end));
+        }
+        catch (...)
+        {
+            if( CV_XADD(&job.failed, 1) == 0 )
+            {
+#ifdef CV_CXX11
+                job.exception = std::current_exception();
+#else
+                try
+                {
+                    throw;
+                }
+                catch (const cv::Exception& e)
+                {
+                    job.exception = e;
+                }
+                catch (const std::exception& e)
+                {
+                    job.exception = cv::Exception(Error::StsError, e.what(), "parallel_for_", __FILE__, __LINE__);
+                }
+                catch (...)
+                {
+                    job.exception = cv::Exception(Error::StsError, "Unknown exception in the body of parallel_for_",
+                                                  "parallel_for_", __FILE__, __LINE__);
+                }
+#endif
+            }
+        }
+    }
+
+    // the job may be destroyed by its caller as soon as the counter reaches zero
+    if( CV_XADD(&job.pending, -(task.end - task.begin)) == task.end - task.begin && waiting_ > 0 )
+    {
+        pthread_mutex_lock(&waitMutex_);
+        pthread_cond_broadcast(&waitCond_);
+        pthread_mutex_unlock(&waitMutex_);
+    }
+}
+
+void WorkStealingPool::run(const Range& stripes, const ParallelLoopBody& body)
+{
+    int nstripes = stripes.end - stripes.start;
+    if( numThreads_ <= 1 || nstripes <= 1 )
+    {
+        body(stripes);
+        return;
+    }
+    WSThreadData& data = tls_.getRef();
+    if( pendingNumThreads_ > 0 && data.id == 0 && data.depth == 0 )
+    {
+        AutoLock lock(mutex_);
+        if( pendingNumThreads_ > 0 )
+        {
+            applyNumOfThreads((size_t)pendingNumThreads_);
+            pendingNumThreads_ = 0;
+        }
+    }
+    if( !started_ )
+        startWorkers();
+
+    bool borrowed = false;
+    if( !data.deque )
+    {
+        data.deque = acquireExternalDeque();
+        if( !data.deque )
+        {
+            body(stripes);
+            return;
+        }
+        data.seed = (unsigned)(size_t)&data;
+        borrowed = true;
+    }
+    data.depth++;
+
+    // at most ~4 tasks per thread are executed, the rest are split on demand
+    int grain = std::max(1, nstripes/(int)(4*numThreads_));
+    WSJob job(body, nstripes, grain);
+    WSTask root = { &job, stripes.start, stripes.end };
+    data.deque->push(root);
+    pthread_mutex_lock(&idleMutex_);
+    version_++;
+    pthread_cond_broadcast(&idleCond_);
+    pthread_mutex_unlock(&idleMutex_);
+
+    // cooperative wait: process the tasks of this job until all stripes are done
+    waitJob(job, data);
+
+    data.depth--;
+    if( borrowed && data.depth == 0 )
+    {
+        releaseExternalDeque(data.deque);
+        data.deque = 0;
+    }
+
+    if( job.failed )
+    {
+#ifdef CV_CXX11
+        std::rethrow_exception(job.exception);
+#else
+        throw job.exception;
+#endif
+    }
+}
+
+} // namespace
+
+void parallel_for_workstealing(const Range& stripes, const ParallelLoopBody& body);
+size_t parallel_workstealing_get_threads_num();
+void parallel_workstealing_set_threads_num(int num);
+int parallel_workstealing_get_thread_num();
+
+void parallel_for_workstealing(const Range& stripes, const ParallelLoopBody& body)
+{
+    WorkStealingPool::instance().run(stripes, body);
+}
+
+size_t parallel_workstealing_get_threads_num()
+{
+    return WorkStealingPool::instance().getNumOfThreads();
+}
+
+void parallel_workstealing_set_threads_num(int num)
+{
+    WorkStealingPool::instance().setNumOfThreads(num < 0 ? 0 : (size_t)num);
+}
+
+int parallel_workstealing_get_thread_num()
+{
+    return WorkStealingPool::instance().getThreadNum();
+}
+
+}
+
+#endif
@@ -50,6 +50,107 @@
 namespace cv
 {
 
+// Thin SVD of a: a = u*diag(w)*vt. The components with zero singular values are dropped.
+static void thinSVD(const Mat& a, Mat& w, Mat& u, Mat& vt)
+{
+    SVD::compute(a, w, u, vt);
+    Mat w64;
+    w.convertTo(w64, CV_64F);
+
+    double tol = std::max(w64.at<double>(0), 0.)*std::max(a.rows, a.cols)*
+                 (a.depth() == CV_32F ? FLT_EPSILON : DBL_EPSILON);
+    int r = 0;
+    while( r < w64.rows && w64.at<double>(r) > tol )
+        r++;
+
+    w = w.rowRange(0, r);
+    u = u.colRange(0, r);
+    vt = vt.rowRange(0, r);
+}
+
+// replaces the columns of y with an orthonormal basis of their span
+static void orthonormalizeColumns(Mat& y)
+{
+    Mat w, u, vt;
+    thinSVD(y, w, u, vt);
+    y = u;
+}
+
+// dst = (x - 1*mean)*b, without forming the centered copy of x
+static void mulCentered(const Mat& x, const Mat& mean, const Mat& b, Mat& dst)
+{
+    Mat mb = mean*b;
+    gemm(x, b, 1, noArray(), 0, dst);
+    gemm(Mat::ones(x.rows, 1, x.type()), mb, -1, dst, 1, dst);
+}
+
+// dst = (x - 1*mean)'*y
+static void mulCenteredTransposed(const Mat& x, const Mat& mean, const Mat& y, Mat& dst)
+{
+    Mat ysum;
+    reduce(y, ysum, 0, REDUCE_SUM);
+    gemm(x, y, 1, noArray(), 0, dst, GEMM_1_T);
+    gemm(mean, ysum, -1, dst, 1, dst, GEMM_1_T);
+}
+
+/*
+Randomized SVD of the centered data: Halko, Martinsson, Tropp (2011) "Finding structure with
+randomness: probabilistic algorithms for constructing approximate matrix decompositions".
+The range of the data is sampled by a random projection refined with a few power iterations,
+then the data is projected to this range and the small projected matrix is decomposed.
+*/
+static void randomizedPCA(const Mat& data0, const Mat& _mean, int flags, int maxComponents,
+                          Mat& mean, Mat& eigenvalues, Mat& eigenvectors)
+{
+    const int OVERSAMPLES = 10, POWER_ITERS = 2;
+    int ctype = std::max(CV_32F, data0.depth());
+    bool asCol = (flags & CV_PCA_DATA_AS_COL) != 0;
+
+    Mat data;
+    if( asCol )
+        transpose(data0, data);
+    else
+        data = data0;
+    if( data.type() != ctype )
+        data.convertTo(data, ctype);
+
+    int N = data.rows, len = data.cols;
+    int count = std::min(maxComponents, std::min(N, len));
+    int l = std::min(count + OVERSAMPLES, std::min(N, len));
+
+    Mat m;
+    if( !_mean.empty() )
+    {
+        CV_Assert( _mean.total() == (size_t)len );
+        _mean.reshape(1, 1).convertTo(m, ctype);
+    }
+    else
+        reduce(data, m, 0, REDUCE_AVG, ctype);
+
+    Mat omega(len, l, ctype), y, z;
+    randn(omega, Scalar::all(0), Scalar::all(1));
+    mulCentered(data, m, omega, y);
+    for( int i = 0; i < POWER_ITERS; i++ )
+    {
+        orthonormalizeColumns(y);
+        mulCenteredTransposed(data, m, y, z);
+        orthonormalizeColumns(z);
+        mulCentered(data, m, z, y);
+    }
+    orthonormalizeColumns(y);
+
+    // b = y'*(x - 1*mean) has the same right singular vectors and singular values as the centered data
+    Mat b, w, u, vt;
+    mulCenteredTransposed(data, m, y, b);
+    thinSVD(b.t(), w, u, vt);
+
+    count = std::min(count, w.rows);
+    w = w.rowRange(0, count);
+    multiply(w, w, eigenvalues, 1./N);
+    eigenvectors = vt.rowRange(0, count).clone();
+    mean = asCol ? m.t() : m;
+}
+
 PCA::PCA() {}
 
 PCA::PCA(InputArray data, InputArray _mean, int flags, int maxComponents)
@@ -84,6 +185,12 @@ PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, int maxComp
         covar_flags |= CV_COVAR_ROWS;
         mean_sz = Size(len, 1);
     }
+    if( flags & RANDOMIZED )
+    {
+        CV_Assert( maxComponents > 0 );
+        randomizedPCA(data, _mean, flags, maxComponents, mean, eigenvalues, eigenvectors);
+        return *this;
+    }
 
     int count = std::min(len, in_count), out_count = count;
     if( maxComponents > 0 )
@@ -148,6 +255,66 @@ PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, int maxComp
     return *this;
 }
 
+PCA& PCA::update(InputArray _data, int flags, int64& samples, int maxComponents)
+{
+    CV_INSTRUMENT_REGION()
+
+    Mat data0 = _data.getMat(), data;
+    CV_Assert( data0.channels() == 1 && !data0.empty() );
+    bool asCol = (flags & CV_PCA_DATA_AS_COL) != 0;
+    if( asCol )
+        transpose(data0, data);
+    else
+        data = data0;
+
+    int n = data.rows, len = data.cols;
+    int ctype = samples > 0 ? mean.type() : std::max(CV_32F, data.depth());
+    if( data.type() != ctype )
+        data.convertTo(data, ctype);
+
+    Mat batchMean, oldMean;
+    reduce(data, batchMean, 0, REDUCE_AVG, ctype);
+    if( samples > 0 )
+    {
+        CV_Assert( mean.total() == (size_t)len && eigenvectors.cols == len &&
+                   eigenvectors.type() == ctype && eigenvalues.total() == (size_t)eigenvectors.rows );
+        oldMean = mean.reshape(1, 1);
+    }
+
+    // the retained components scaled by their singular values, the centered batch and the mean shift
+    // span the centered data seen so far
+    int k0 = samples > 0 ? eigenvectors.rows : 0;
+    Mat stack(k0 + n + (samples > 0), len, ctype);
+    for( int i = 0; i < k0; i++ )
+    {
+        Mat row = stack.row(i);
+        double ev = eigenvalues.depth() == CV_32F ? eigenvalues.at<float>(i) : eigenvalues.at<double>(i);
+        eigenvectors.row(i).convertTo(row, ctype, std::sqrt(std::max(ev, 0.)*samples));
+    }
+    Mat centered = stack.rowRange(k0, k0 + n);
+    subtract(data, repeat(batchMean, n, 1), centered);
+
+    double total = (double)samples + n;
+    if( samples > 0 )
+    {
+        Mat row = stack.row(k0 + n);
+        subtract(oldMean, batchMean, row);
+        row *= std::sqrt(samples*(double)n/total);
+        addWeighted(oldMean, samples/total, batchMean, n/total, 0, batchMean);
+    }
+
+    Mat w, u, vt;
+    thinSVD(stack, w, u, vt);
+    int count = maxComponents > 0 ? std::min(maxComponents, w.rows) : w.rows;
+
+    w = w.rowRange(0, count);
+    multiply(w, w, eigenvalues, 1./total);
+    eigenvectors = vt.rowRange(0, count).clone();
+    mean = asCol ? batchMean.t() : batchMean;
+    samples += n;
+    return *this;
+}
+
 void PCA::write(FileStorage& fs ) const
 {
     CV_Assert( fs.isOpened() );
@@ -222,6 +389,7 @@ PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, double reta
     }
 
     CV_Assert( retainedVariance > 0 && retainedVariance <= 1 );
+    CV_Assert( !(flags & RANDOMIZED) );
 
     int count = std::min(len, in_count);
 
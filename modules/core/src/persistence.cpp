@@ -44,10 +44,19 @@
 
 #include <ctype.h>
 #include <deque>
+#include <map>
 #include <sstream>
 #include <string>
 #include <iterator>
 
+#if defined __unix__ || defined __APPLE__
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define CV_FS_HAVE_MMAP 1
+#endif
+
 #define USE_ZLIB 1
 
 #if USE_ZLIB
@@ -236,6 +245,36 @@ typedef void (*CvWriteString)( struct CvFileStorage* fs, const char* key,
 typedef void (*CvWriteComment)( struct CvFileStorage* fs, const char* comment, int eol_comment );
 typedef void (*CvStartNextStream)( struct CvFileStorage* fs );
 
+namespace binfs
+{
+    /* binary storage image or a part of it mapped for a matrix, shared by the owners */
+    struct Mapping
+    {
+        int refcount;
+        uchar* data;
+        size_t size;
+        bool mapped; /* the file is mapped, otherwise the data is allocated with fastMalloc() */
+        int fd;      /* the file the matrices are mapped from, -1 if the matrices can't be mapped */
+    };
+
+    /* matrix payload stored in the image */
+    struct Blob
+    {
+        const uchar* data;
+        size_t size;
+        int depth;
+    };
+
+    typedef std::map<const CvFileNode*, Blob> BlobMap;
+
+    static Mapping* mapFile( const char* filename );
+    static Mapping* mapRange( const Mapping* image, const uchar* data, size_t size, uchar** ptr );
+    static Mapping* copyBuffer( const char* buf, size_t size );
+    static void release( Mapping* mapping );
+}
+
+struct CvFileStorageStream;
+
 typedef struct CvFileStorage
 {
     int flags;
@@ -285,6 +324,15 @@ typedef struct CvFileStorage
     int   delayed_struct_flags;
     char* delayed_type_name;
 
+    binfs::Mapping* bin_mapping;  /**< image of the binary storage being read */
+    binfs::BlobMap* bin_blobs;    /**< matrix payloads of the binary storage being read */
+    size_t bin_pos;               /**< number of bytes written to the binary storage */
+    size_t bin_blob_pos;          /**< position of the size of the last written blob, 0 if the last record is not a blob */
+    size_t bin_blob_size;
+    char bin_blob_dt[16];
+
+    CvFileStorageStream* stream;  /**< state of the streaming reader, 0 if the whole tree is built */
+
     bool is_opened;
 }
 CvFileStorage;
@@ -478,6 +526,7 @@ static void icvRewind( CvFileStorage* fs )
 #define CV_XML_INDENT  2
 #define CV_YML_INDENT_FLOW  1
 #define CV_FS_MAX_LEN 4096
+#define CV_FS_MAX_FMT_PAIRS  128
 
 #define CV_FILE_STORAGE ('Y' + ('A' << 8) + ('M' << 16) + ('L' << 24))
 #define CV_IS_FILE_STORAGE(fs) ((fs) != 0 && (fs)->flags == CV_FILE_STORAGE)
@@ -578,6 +627,118 @@ icvFSCreateCollection( CvFileStorage* fs, int tag, CvFileNode* collection )
 }
 
 
+/* state of the streaming reader, see cv::readFileStorage() */
+struct CvFileStorageStream
+{
+    struct Frame
+    {
+        CvFileNode* node;              /* the element */
+        int action;                    /* cv::FileNodeVisitor::Action */
+        int index;                     /* index of the element in the enclosing collection */
+        int count;                     /* number of the nested elements passed so far */
+        cv::String key;
+        CvMemStorage* storage;         /* keeps the data of the element, released when it is passed */
+        CvMemStorage* parent_storage;
+    };
+
+    /* thrown to stop parsing when the visitor asks for it */
+    struct Stop {};
+
+    cv::FileNodeVisitor* visitor;
+    std::vector<Frame> frames;        /* the first frame is the top-level collection of the current stream */
+};
+
+
+/* called by the parsers when a new element is added to the collection, before its value is parsed */
+static void
+icvFSStreamBeginElement( CvFileStorage* fs, CvFileNode* collection, CvFileNode* elem )
+{
+    CvFileStorageStream* stream = fs->stream;
+    if( !stream )
+        return;
+
+    std::vector<CvFileStorageStream::Frame>& frames = stream->frames;
+    if( frames.empty() || frames.back().node != collection )
+    {
+        if( frames.size() > 1 || collection != (CvFileNode*)cvGetSeqElem( fs->roots, -1 ) )
+            return;
+        CvFileStorageStream::Frame root = { collection, cv::FileNodeVisitor::DESCEND, 0, 0, cv::String(), 0, 0 };
+        frames.assign( 1, root );
+    }
+
+    CvFileStorageStream::Frame& parent = frames.back();
+    if( parent.action == cv::FileNodeVisitor::VISIT )
+        return;
+
+    CvFileStorageStream::Frame frame;
+    frame.node = elem;
+    frame.index = parent.count++;
+    frame.count = 0;
+    if( CV_NODE_IS_MAP(collection->tag) )
+        frame.key = ((CvFileMapNode*)elem)->key->str.ptr;
+    frame.action = parent.action == cv::FileNodeVisitor::SKIP ? (int)cv::FileNodeVisitor::SKIP :
+                   stream->visitor->select( frame.key, frame.index, (int)frames.size() - 1 );
+    frame.parent_storage = fs->memstorage;
+    frame.storage = cvCreateChildMemStorage( fs->memstorage );
+    fs->memstorage = frame.storage;
+    frames.push_back( frame );
+}
+
+
+/* called by the parsers when the element value is parsed. The element is passed to the visitor,
+   then its data are released and the element is removed from the collection */
+static void
+icvFSStreamEndElement( CvFileStorage* fs, CvFileNode* collection, CvFileNode* elem )
+{
+    CvFileStorageStream* stream = fs->stream;
+    if( !stream || stream->frames.size() < 2 || stream->frames.back().node != elem )
+        return;
+
+    std::vector<CvFileStorageStream::Frame>& frames = stream->frames;
+    const CvFileStorageStream::Frame& frame = frames.back();
+    int depth = (int)frames.size() - 2;
+    bool proceed = true;
+    if( frame.action == cv::FileNodeVisitor::VISIT ||
+        (frame.action == cv::FileNodeVisitor::DESCEND && !CV_NODE_IS_COLLECTION(elem->tag)) )
+        proceed = stream->visitor->visit( cv::FileNode( fs, elem ), frame.key, frame.index, depth );
+    else if( frame.action == cv::FileNodeVisitor::DESCEND )
+        stream->visitor->leave( frame.key, frame.index, depth );
+
+    fs->memstorage = frame.parent_storage;
+    CvMemStorage* storage = frame.storage;
+    cvReleaseMemStorage( &storage );
+    frames.pop_back();
+    if( fs->bin_blobs )
+        fs->bin_blobs->clear();
+
+    // the seq keeps one (empty) element, so that the parsers can tell the first element from the others
+    memset( elem, 0, sizeof(*elem) );
+    if( CV_NODE_IS_SEQ(collection->tag) && collection->data.seq->total > 1 )
+        cvSeqPop( collection->data.seq, 0 );
+
+    if( !proceed )
+        CV_THROW( CvFileStorageStream::Stop() );
+}
+
+
+/* releases the data of the elements being parsed, e.g. after a parsing error */
+static void
+icvFSStreamAbort( CvFileStorage* fs )
+{
+    std::vector<CvFileStorageStream::Frame>& frames = fs->stream->frames;
+    while( !frames.empty() )
+    {
+        if( frames.back().storage )
+        {
+            fs->memstorage = frames.back().parent_storage;
+            cvReleaseMemStorage( &frames.back().storage );
+        }
+        frames.pop_back();
+    }
+    fs->stream = 0;
+}
+
+
 /*static void
 icvFSReleaseCollection( CvSeq* seq )
 {
@@ -657,6 +818,8 @@ icvFSFlush( CvFileStorage* fs )
 }
 
 
+static void icvBinFinish( CvFileStorage* fs );
+
 static void
 icvClose( CvFileStorage* fs, cv::String* out )
 {
@@ -675,7 +838,10 @@ icvClose( CvFileStorage* fs, cv::String* out )
                 while( fs->write_stack->total > 0 )
                     cvEndWriteStruct(fs);
             }
-            icvFSFlush(fs);
+            if( fs->fmt == CV_STORAGE_FORMAT_BINARY )
+                icvBinFinish( fs );
+            else
+                icvFSFlush(fs);
             if( fs->fmt == CV_STORAGE_FORMAT_XML )
                 icvPuts( fs, "</opencv_storage>\n" );
             else if ( fs->fmt == CV_STORAGE_FORMAT_JSON )
@@ -705,6 +871,8 @@ cvReleaseFileStorage( CvFileStorage** p_fs )
         *p_fs = 0;
 
         icvClose(fs, 0);
+        if( fs->stream )
+            icvFSStreamAbort( fs );
 
         cvReleaseMemStorage( &fs->strstorage );
         cvFree( &fs->buffer_start );
@@ -714,6 +882,8 @@ cvReleaseFileStorage( CvFileStorage** p_fs )
         delete fs->base64_writer;
         delete[] fs->delayed_struct_key;
         delete[] fs->delayed_type_name;
+        binfs::release( fs->bin_mapping );
+        delete fs->bin_blobs;
 
         memset( fs, 0, sizeof(*fs) );
         cvFree( &fs );
@@ -1713,10 +1883,12 @@ force_int:
                 elem = (CvFileNode*)cvSeqPush( node->data.seq, 0 );
             }
             CV_Assert(elem);
+            icvFSStreamBeginElement( fs, node, elem );
             ptr = icvYMLParseValue( fs, ptr, elem, struct_flags, new_min_indent );
             if( CV_NODE_IS_MAP(struct_flags) )
                 elem->tag |= CV_NODE_NAMED;
             is_simple = is_simple && !CV_NODE_IS_COLLECTION(elem->tag);
+            icvFSStreamEndElement( fs, node, elem );
         }
         node->data.seq->flags |= is_simple ? CV_NODE_SEQ_SIMPLE : 0;
     }
@@ -1787,11 +1959,13 @@ force_string:
                 elem = (CvFileNode*)cvSeqPush( node->data.seq, 0 );
             }
             CV_Assert(elem);
+            icvFSStreamBeginElement( fs, node, elem );
             ptr = icvYMLSkipSpaces( fs, ptr, indent + 1, INT_MAX );
             ptr = icvYMLParseValue( fs, ptr, elem, struct_flags, indent + 1 );
             if( CV_NODE_IS_MAP(struct_flags) )
                 elem->tag |= CV_NODE_NAMED;
             is_simple = is_simple && !CV_NODE_IS_COLLECTION(elem->tag);
+            icvFSStreamEndElement( fs, node, elem );
 
             ptr = icvYMLSkipSpaces( fs, ptr, 0, INT_MAX );
             if( ptr - fs->buffer_start != indent )
@@ -2492,6 +2666,7 @@ icvXMLParseValue( CvFileStorage* fs, char* ptr, CvFileNode* node,
             else
                 elem = cvGetFileNode( fs, node, key, 1 );
             CV_Assert(elem);
+            icvFSStreamBeginElement( fs, node, elem );
             if (!is_binary_string)
                 ptr = icvXMLParseValue( fs, ptr, elem, elem_type);
             else {
@@ -2507,6 +2682,7 @@ icvXMLParseValue( CvFileStorage* fs, char* ptr, CvFileNode* node,
             ptr = icvXMLParseTag( fs, ptr, &key2, &list, &tag_type );
             if( tag_type != CV_XML_CLOSING_TAG || key2 != key )
                 CV_PARSE_ERROR( "Mismatched closing tag" );
+            icvFSStreamEndElement( fs, node, elem );
             have_space = true;
         }
         else
@@ -3695,6 +3871,7 @@ static char* icvJSONParseSeq( CvFileStorage* fs, char* ptr, CvFileNode* node )
         if ( *ptr != ']' )
         {
             CvFileNode* child = (CvFileNode*)cvSeqPush( node->data.seq, 0 );
+            icvFSStreamBeginElement( fs, node, child );
 
             if ( *ptr == '[' )
                 ptr = icvJSONParseSeq( fs, ptr, child );
@@ -3702,6 +3879,7 @@ static char* icvJSONParseSeq( CvFileStorage* fs, char* ptr, CvFileNode* node )
                 ptr = icvJSONParseMap( fs, ptr, child );
             else
                 ptr = icvJSONParseValue( fs, ptr, child );
+            icvFSStreamEndElement( fs, node, child );
         }
 
         ptr = icvJSONSkipSpaces( fs, ptr );
@@ -3774,6 +3952,7 @@ static char* icvJSONParseMap( CvFileStorage* fs, char* ptr, CvFileNode* node )
             }
             else
             {   /* normal */
+                icvFSStreamBeginElement( fs, node, child );
                 if ( *ptr == '[' )
                     ptr = icvJSONParseSeq( fs, ptr, child );
                 else if ( *ptr == '{' )
@@ -3781,6 +3960,7 @@ static char* icvJSONParseMap( CvFileStorage* fs, char* ptr, CvFileNode* node )
                 else
                     ptr = icvJSONParseValue( fs, ptr, child );
                 child->tag |= CV_NODE_NAMED;
+                icvFSStreamEndElement( fs, node, child );
             }
         }
 
@@ -4164,12 +4344,701 @@ icvJSONWriteComment( CvFileStorage* fs, const char* comment, int eol_comment )
 }
 
 
+/****************************************************************************************\
+*                                     Binary Format                                      *
+\****************************************************************************************/
+
+/*
+   The binary storage starts with a header:
+     - CV_FS_BINARY_SIGNATURE padded with zeros to 16 bytes,
+     - the total size of the storage (uint64),
+     - 0x01020304 (uint32) to detect the byte order, the data is stored in the native one,
+     - 4 reserved bytes.
+   It is followed by a sequence of records. Every record, except 'E' and 'N', starts with
+   the record tag (1 byte) and the key (uint32 length and the characters, zero length if there is no key):
+     - 'S' - start of a collection: flags (1 byte) and the type name (uint32 length and the characters),
+     - 'E' - end of a collection,
+     - 'N' - start of the next stream,
+     - 'I' - int32 value,
+     - 'R' - double value,
+     - 'T' - string (uint32 length and the characters),
+     - 'B' - raw data: format (uint32 length and the characters), uint64 size in bytes,
+             zero padding to CV_FS_BINARY_ALIGN bytes from the start of the storage and the data.
+   On reading the storage is mapped into memory, and the data of matrices are used in place
+   (if they are of a single type and written in one cvWriteRawData call or in consecutive ones).
+*/
+
+#define CV_FS_BINARY_SIGNATURE "%CVBINARY:1.0\n"
+#define CV_FS_BINARY_HEADER_SIZE 32
+#define CV_FS_BINARY_ALIGN 64
+#define CV_FS_BINARY_BYTE_ORDER 0x01020304
+
+static int icvDecodeFormat( const char* dt, int* fmt_pairs, int max_len );
+static int icvDecodeSimpleFormat( const char* dt );
+static char* icvEncodeFormat( int elem_type, char* dt );
+
+namespace binfs
+{
+
+static Mapping* mapFile( const char* filename )
+{
+    Mapping* mapping = 0;
+#ifdef CV_FS_HAVE_MMAP
+    int fd = ::open( filename, O_RDONLY );
+    if( fd < 0 )
+        return 0;
+    struct stat st;
+    if( fstat( fd, &st ) == 0 && st.st_size > 0 )
+    {
+        // the image is only parsed, the matrices are mapped separately (see mapRange)
+        void* ptr = mmap( 0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( ptr != MAP_FAILED )
+        {
+            mapping = new Mapping;
+            mapping->refcount = 1;
+            mapping->data = (uchar*)ptr;
+            mapping->size = (size_t)st.st_size;
+            mapping->mapped = true;
+            mapping->fd = fd;
+            return mapping;
+        }
+    }
+    ::close( fd );
+#else
+    FILE* f = fopen( filename, "rb" );
+    if( !f )
+        return 0;
+    fseek( f, 0, SEEK_END );
+    long size = ftell( f );
+    fseek( f, 0, SEEK_SET );
+    if( size > 0 )
+    {
+        mapping = new Mapping;
+        mapping->refcount = 1;
+        mapping->data = (uchar*)cv::fastMalloc( (size_t)size );
+        mapping->size = (size_t)size;
+        mapping->mapped = false;
+        mapping->fd = -1;
+        if( fread( mapping->data, 1, (size_t)size, f ) != (size_t)size )
+        {
+            release( mapping );
+            mapping = 0;
+        }
+    }
+    fclose( f );
+#endif
+    return mapping;
+}
+
+/* private writable mapping of the data, so that each matrix can be modified without affecting the file and the other matrices */
+static Mapping* mapRange( const Mapping* image, const uchar* data, size_t size, uchar** ptr )
+{
+#ifdef CV_FS_HAVE_MMAP
+    if( image->fd < 0 || size == 0 )
+        return 0;
+    size_t ofs = (size_t)(data - image->data);
+    size_t start = ofs - ofs % (size_t)sysconf( _SC_PAGESIZE );
+    void* p = mmap( 0, ofs - start + size, PROT_READ | PROT_WRITE, MAP_PRIVATE, image->fd, (off_t)start );
+    if( p == MAP_FAILED )
+        return 0;
+    Mapping* mapping = new Mapping;
+    mapping->refcount = 1;
+    mapping->data = (uchar*)p;
+    mapping->size = ofs - start + size;
+    mapping->mapped = true;
+    mapping->fd = -1;
+    *ptr = (uchar*)p + (ofs - start);
+    return mapping;
+#else
+    CV_UNUSED(image); CV_UNUSED(data); CV_UNUSED(size); CV_UNUSED(ptr);
+    return 0;
+#endif
+}
+
+static Mapping* copyBuffer( const char* buf, size_t size )
+{
+    Mapping* mapping = new Mapping;
+    mapping->refcount = 1;
+    mapping->data = (uchar*)cv::fastMalloc( size );
+    mapping->size = size;
+    mapping->mapped = false;
+    mapping->fd = -1;
+    memcpy( mapping->data, buf, size );
+    return mapping;
+}
+
+static void release( Mapping* mapping )
+{
+    if( !mapping || CV_XADD( &mapping->refcount, -1 ) != 1 )
+        return;
+#ifdef CV_FS_HAVE_MMAP
+    if( mapping->fd >= 0 )
+        ::close( mapping->fd );
+    if( mapping->mapped )
+        munmap( mapping->data, mapping->size );
+    else
+#endif
+        cv::fastFree( mapping->data );
+    delete mapping;
+}
+
+/* owns the matrices that refer to the data of a binary storage, keeps the image alive */
+class MappedMatAllocator : public cv::MatAllocator
+{
+public:
+    cv::UMatData* allocate( int, const int*, int, void*, size_t*, int, cv::UMatUsageFlags ) const
+    {
+        CV_Error( CV_StsNotImplemented, "The allocator only holds the data of binary file storages" );
+        return 0;
+    }
+
+    bool allocate( cv::UMatData*, int, cv::UMatUsageFlags ) const
+    {
+        return false;
+    }
+
+    void deallocate( cv::UMatData* u ) const
+    {
+        if( !u )
+            return;
+        CV_Assert( u->urefcount == 0 && u->refcount == 0 );
+        release( (Mapping*)u->userdata );
+        delete u;
+    }
+};
+
+static cv::MatAllocator* getMappedMatAllocator()
+{
+    CV_SINGLETON_LAZY_INIT(cv::MatAllocator, new MappedMatAllocator())
+}
+
+struct ParseFrame
+{
+    CvFileNode* node;
+    bool is_data;   /* the collection is the "data" element */
+    bool is_matrix; /* the collection is a dense matrix */
+};
+
+} // namespace binfs
+
+
+static void
+icvBinMap( CvFileStorage* fs, const char* membuf, size_t buflen )
+{
+    if( membuf )
+    {
+        uint64 size = 0;
+        if( buflen < CV_FS_BINARY_HEADER_SIZE )
+            CV_Error( CV_StsParseError, "Invalid binary file storage header" );
+        memcpy( &size, membuf + 16, sizeof(size) );
+        if( size < CV_FS_BINARY_HEADER_SIZE )
+            CV_Error( CV_StsParseError, "Invalid binary file storage header" );
+        if( size > buflen )
+            CV_Error( CV_StsParseError, "The binary file storage is truncated" );
+        fs->bin_mapping = binfs::copyBuffer( membuf, (size_t)size );
+    }
+    else
+    {
+        fs->bin_mapping = binfs::mapFile( fs->filename );
+        if( !fs->bin_mapping )
+            CV_Error_( CV_StsError, ("Could not map the file storage %s", fs->filename) );
+    }
+    fs->bin_blobs = new binfs::BlobMap;
+}
+
+
+static const uchar*
+icvBinReadBytes( CvFileStorage* fs, const uchar* ptr, void* value, size_t size )
+{
+    if( (size_t)(fs->bin_mapping->data + fs->bin_mapping->size - ptr) < size )
+        CV_PARSE_ERROR( "Unexpected end of file" );
+    memcpy( value, ptr, size );
+    return ptr + size;
+}
+
+
+static const uchar*
+icvBinReadString( CvFileStorage* fs, const uchar* ptr, const char** str, int* len )
+{
+    unsigned n = 0;
+    ptr = icvBinReadBytes( fs, ptr, &n, sizeof(n) );
+    if( (size_t)(fs->bin_mapping->data + fs->bin_mapping->size - ptr) < n || n > INT_MAX )
+        CV_PARSE_ERROR( "Unexpected end of file" );
+    *str = (const char*)ptr;
+    *len = (int)n;
+    return ptr + n;
+}
+
+
+static CvFileNode*
+icvBinAddNode( CvFileStorage* fs, CvFileNode* collection, const char* key, int keylen )
+{
+    CvFileNode* node;
+    if( CV_NODE_IS_MAP(collection->tag) )
+    {
+        if( keylen == 0 )
+            CV_PARSE_ERROR( "Map element should have a name" );
+        node = cvGetFileNode( fs, collection, cvGetHashedKey( fs, key, keylen, 1 ), 1 );
+    }
+    else
+    {
+        if( keylen != 0 )
+            CV_PARSE_ERROR( "Sequence element should not have a name" );
+        node = (CvFileNode*)cvSeqPush( collection->data.seq, 0 );
+    }
+    memset( node, 0, sizeof(*node) );
+    return node;
+}
+
+
+static void
+icvBinParse( CvFileStorage* fs )
+{
+    const uchar* base = fs->bin_mapping->data;
+    size_t size = fs->bin_mapping->size;
+    uint64 total_size = 0;
+    unsigned byte_order = 0;
+
+    if( size < CV_FS_BINARY_HEADER_SIZE ||
+        memcmp( base, CV_FS_BINARY_SIGNATURE, sizeof(CV_FS_BINARY_SIGNATURE) - 1 ) != 0 )
+        CV_PARSE_ERROR( "Invalid binary file storage header" );
+    memcpy( &total_size, base + 16, sizeof(total_size) );
+    memcpy( &byte_order, base + 24, sizeof(byte_order) );
+    if( byte_order != CV_FS_BINARY_BYTE_ORDER )
+        CV_PARSE_ERROR( "The binary file storage has been written on a machine with different byte order" );
+    if( total_size != size )
+        CV_PARSE_ERROR( "The binary file storage is truncated or has not been closed properly" );
+
+    const uchar* ptr = base + CV_FS_BINARY_HEADER_SIZE;
+    const uchar* end = base + size;
+    std::vector<binfs::ParseFrame> stack;
+
+    for(;;)
+    {
+        if( stack.empty() )
+        {
+            binfs::ParseFrame root = { (CvFileNode*)cvSeqPush( fs->roots, 0 ), false, false };
+            memset( root.node, 0, sizeof(*root.node) );
+            icvFSCreateCollection( fs, CV_NODE_MAP, root.node );
+            stack.push_back( root );
+        }
+        if( ptr >= end )
+            break;
+
+        char tag = (char)*ptr++;
+        binfs::ParseFrame top = stack.back();
+
+        if( tag == 'E' )
+        {
+            if( stack.size() == 1 )
+                CV_PARSE_ERROR( "Closing a structure that has not been opened" );
+            stack.pop_back();
+            icvFSStreamEndElement( fs, stack.back().node, top.node );
+            continue;
+        }
+        if( tag == 'N' )
+        {
+            if( stack.size() != 1 )
+                CV_PARSE_ERROR( "The previous stream has not been completed" );
+            stack.clear();
+            continue;
+        }
+
+        const char* key = 0;
+        int keylen = 0;
+        ptr = icvBinReadString( fs, ptr, &key, &keylen );
+        int named = keylen > 0 ? CV_NODE_NAMED : 0;
+
+        if( tag == 'S' )
+        {
+            uchar flags = 0;
+            const char* type_name = 0;
+            int type_len = 0;
+            ptr = icvBinReadBytes( fs, ptr, &flags, 1 );
+            ptr = icvBinReadString( fs, ptr, &type_name, &type_len );
+
+            CvFileNode* node = icvBinAddNode( fs, top.node, key, keylen );
+            icvFSStreamBeginElement( fs, top.node, node );
+            icvFSCreateCollection( fs, (CV_NODE_IS_MAP(flags) ? CV_NODE_MAP : CV_NODE_SEQ) |
+                                   (flags & CV_NODE_FLOW), node );
+            node->tag |= named;
+
+            binfs::ParseFrame frame = { node, keylen == 4 && memcmp( key, "data", 4 ) == 0, false };
+            if( type_len > 0 )
+            {
+                std::string type_str( type_name, type_len );
+                node->info = cvFindType( type_str.c_str() );
+                if( node->info )
+                    node->tag |= CV_NODE_USER;
+                frame.is_matrix = type_str == CV_TYPE_NAME_MAT || type_str == CV_TYPE_NAME_MATND;
+            }
+            stack.push_back( frame );
+        }
+        else if( tag == 'I' )
+        {
+            int value = 0;
+            ptr = icvBinReadBytes( fs, ptr, &value, sizeof(value) );
+            CvFileNode* node = icvBinAddNode( fs, top.node, key, keylen );
+            icvFSStreamBeginElement( fs, top.node, node );
+            node->tag = CV_NODE_INT | named;
+            node->data.i = value;
+            icvFSStreamEndElement( fs, top.node, node );
+        }
+        else if( tag == 'R' )
+        {
+            double value = 0;
+            ptr = icvBinReadBytes( fs, ptr, &value, sizeof(value) );
+            CvFileNode* node = icvBinAddNode( fs, top.node, key, keylen );
+            icvFSStreamBeginElement( fs, top.node, node );
+            node->tag = CV_NODE_REAL | named;
+            node->data.f = value;
+            icvFSStreamEndElement( fs, top.node, node );
+        }
+        else if( tag == 'T' )
+        {
+            const char* str = 0;
+            int len = 0;
+            ptr = icvBinReadString( fs, ptr, &str, &len );
+            CvFileNode* node = icvBinAddNode( fs, top.node, key, keylen );
+            icvFSStreamBeginElement( fs, top.node, node );
+            node->tag = CV_NODE_STRING | named;
+            node->data.str = cvMemStorageAllocString( fs->memstorage, str, len );
+            icvFSStreamEndElement( fs, top.node, node );
+        }
+        else if( tag == 'B' )
+        {
+            const char* dt_ptr = 0;
+            int dt_len = 0;
+            uint64 data_size = 0;
+            ptr = icvBinReadString( fs, ptr, &dt_ptr, &dt_len );
+            ptr = icvBinReadBytes( fs, ptr, &data_size, sizeof(data_size) );
+            ptr = base + cv::alignSize( (size_t)(ptr - base), CV_FS_BINARY_ALIGN );
+            if( ptr > end || (uint64)(end - ptr) < data_size )
+                CV_PARSE_ERROR( "Unexpected end of file" );
+            if( !CV_NODE_IS_SEQ(top.node->tag) )
+                CV_PARSE_ERROR( "Raw data should be stored in a sequence" );
+
+            std::string dt( dt_ptr, dt_len );
+            int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2];
+            int fmt_pair_count = icvDecodeFormat( dt.c_str(), fmt_pairs, CV_FS_MAX_FMT_PAIRS );
+            size_t elem_size = icvCalcStructSize( dt.c_str(), 0 );
+            if( data_size % elem_size != 0 )
+                CV_PARSE_ERROR( "Raw data size does not match the element size" );
+
+            if( fmt_pair_count == 1 && stack.size() >= 2 && top.is_data && stack[stack.size()-2].is_matrix &&
+                top.node->data.seq->total == 0 && fs->bin_blobs->count( top.node ) == 0 )
+            {
+                // the matrix data are not converted to the file nodes, they are used in place
+                binfs::Blob blob = { ptr, (size_t)data_size, fmt_pairs[1] };
+                (*fs->bin_blobs)[top.node] = blob;
+            }
+            else
+            {
+                // every field of every element becomes a node of the sequence
+                int fields = 0;
+                for( int i = 0; i < fmt_pair_count; i++ )
+                    fields += fmt_pairs[i*2];
+                if( data_size / elem_size > (uint64)(INT_MAX / std::max(fields, 1)) )
+                    CV_PARSE_ERROR( "Too many elements in the raw data block" );
+                base64::make_seq( (void*)ptr, (int)(data_size / elem_size), dt.c_str(), *top.node->data.seq );
+            }
+            ptr += data_size;
+        }
+        else
+            CV_PARSE_ERROR( "Unknown record type" );
+    }
+
+    if( stack.size() != 1 )
+        CV_PARSE_ERROR( "Unexpected end of file" );
+}
+
+
+/* returns the matrix payload if the node is backed by it */
+static binfs::Blob*
+icvBinFindBlob( const CvFileStorage* fs, const CvFileNode* node )
+{
+    if( !fs || !fs->bin_blobs || !node )
+        return 0;
+    binfs::BlobMap::iterator it = fs->bin_blobs->find( node );
+    return it != fs->bin_blobs->end() ? &it->second : 0;
+}
+
+
+/* converts the matrix payload to the file nodes, when the node is accessed as a regular sequence */
+static void
+icvBinExpandBlob( const CvFileStorage* fs, const CvFileNode* node )
+{
+    const binfs::Blob* blob = icvBinFindBlob( fs, node );
+    if( !blob )
+        return;
+    char dt[16];
+    icvEncodeFormat( blob->depth, dt );
+    size_t count = blob->size / CV_ELEM_SIZE1(blob->depth);
+    if( count > (size_t)INT_MAX )
+        CV_Error( CV_StsOutOfRange, "The matrix data are too large to be read as a sequence" );
+    void* data = (void*)blob->data;
+    fs->bin_blobs->erase( node );
+    base64::make_seq( data, (int)count, dt, *node->data.seq );
+}
+
+
+/* maps the matrix data from the binary storage file, returns false if the data can't be mapped */
+static bool
+icvBinReadMat( CvFileStorage* fs, CvFileNode* node, cv::Mat& m )
+{
+    if( !fs || fs->fmt != CV_STORAGE_FORMAT_BINARY || !node || !CV_NODE_IS_MAP(node->tag) || !node->info )
+        return false;
+    bool is_nd = strcmp( node->info->type_name, CV_TYPE_NAME_MATND ) == 0;
+    if( !is_nd && strcmp( node->info->type_name, CV_TYPE_NAME_MAT ) != 0 )
+        return false;
+    const binfs::Blob* blob = icvBinFindBlob( fs, cvGetFileNodeByName( fs, node, "data" ) );
+    const char* dt = cvReadStringByName( fs, node, "dt", 0 );
+    if( !blob || !dt || fs->bin_mapping->fd < 0 )
+        return false;
+
+    int elem_type = icvDecodeSimpleFormat( dt );
+    int dims = 2, sizes[CV_MAX_DIM] = {0};
+    if( is_nd )
+    {
+        CvFileNode* sizes_node = cvGetFileNodeByName( fs, node, "sizes" );
+        dims = !sizes_node ? -1 : CV_NODE_IS_SEQ(sizes_node->tag) ? sizes_node->data.seq->total :
+               CV_NODE_IS_INT(sizes_node->tag) ? 1 : -1;
+        if( dims <= 0 || dims > CV_MAX_DIM )
+            CV_Error( CV_StsParseError, "Could not determine the matrix dimensionality" );
+        cvReadRawData( fs, sizes_node, sizes, "i" );
+    }
+    else
+    {
+        sizes[0] = cvReadIntByName( fs, node, "rows", -1 );
+        sizes[1] = cvReadIntByName( fs, node, "cols", -1 );
+    }
+    size_t total = CV_ELEM_SIZE(elem_type);
+    for( int i = 0; i < dims; i++ )
+    {
+        if( sizes[i] < 0 )
+            CV_Error( CV_StsError, "Some of essential matrix attributes are absent" );
+        total *= sizes[i];
+    }
+    if( blob->depth != CV_MAT_DEPTH(elem_type) || total != blob->size )
+        CV_Error( CV_StsUnmatchedSizes, "The matrix size does not match to the number of stored elements" );
+
+    // every matrix gets its own mapping, so the matrices read from the same node don't share the data
+    uchar* data = 0;
+    binfs::Mapping* mapping = binfs::mapRange( fs->bin_mapping, blob->data, blob->size, &data );
+    if( !mapping )
+        return false;
+    cv::Mat header( dims, sizes, elem_type, data );
+    cv::UMatData* u = new cv::UMatData( binfs::getMappedMatAllocator() );
+    u->data = u->origdata = data;
+    u->size = blob->size;
+    u->userdata = mapping;
+    u->refcount = 1;
+    header.u = u;
+    m = header;
+    return true;
+}
+
+
+static void
+icvBinPut( CvFileStorage* fs, const void* data, size_t size )
+{
+    const char* ptr = (const char*)data;
+    if( fs->outbuf )
+        std::copy( ptr, ptr + size, std::back_inserter(*fs->outbuf) );
+    else if( fs->file )
+    {
+        if( fwrite( ptr, 1, size, fs->file ) != size )
+            CV_Error( CV_StsError, "Could not write to the file storage" );
+    }
+    else
+        CV_Error( CV_StsError, "The storage is not opened" );
+    fs->bin_pos += size;
+}
+
+
+/* overwrites the bytes written before */
+static void
+icvBinPatch( CvFileStorage* fs, size_t pos, const void* data, size_t size )
+{
+    const char* ptr = (const char*)data;
+    if( fs->outbuf )
+        std::copy( ptr, ptr + size, fs->outbuf->begin() + pos );
+    else if( fs->file )
+    {
+#ifdef _WIN32
+        _fseeki64( fs->file, (__int64)pos, SEEK_SET );
+#else
+        fseeko( fs->file, (off_t)pos, SEEK_SET );
+#endif
+        if( fwrite( ptr, 1, size, fs->file ) != size )
+            CV_Error( CV_StsError, "Could not write to the file storage" );
+        fseek( fs->file, 0, SEEK_END );
+    }
+}
+
+
+static void
+icvBinPutString( CvFileStorage* fs, const char* str, size_t len )
+{
+    unsigned n = (unsigned)len;
+    icvBinPut( fs, &n, sizeof(n) );
+    icvBinPut( fs, str, len );
+}
+
+
+static void
+icvBinStartRecord( CvFileStorage* fs, char tag, const char* key )
+{
+    if( CV_NODE_IS_COLLECTION(fs->struct_flags) )
+    {
+        if( (CV_NODE_IS_MAP(fs->struct_flags) ^ (key != 0)) )
+            CV_Error( CV_StsBadArg, "An attempt to add element without a key to a map, "
+                                    "or add element with key to sequence" );
+    }
+    if( key && !key[0] )
+        CV_Error( CV_StsBadArg, "The key is an empty" );
+    fs->bin_blob_pos = 0;
+    icvBinPut( fs, &tag, 1 );
+    icvBinPutString( fs, key, key ? strlen(key) : 0 );
+}
+
+
+static void
+icvBinStartWriteStruct( CvFileStorage* fs, const char* key, int struct_flags,
+                        const char* type_name CV_DEFAULT(0))
+{
+    if( !CV_NODE_IS_COLLECTION(struct_flags))
+        CV_Error( CV_StsBadArg,
+        "Some collection type - CV_NODE_SEQ or CV_NODE_MAP, must be specified" );
+
+    icvBinStartRecord( fs, 'S', key );
+    uchar flags = (uchar)(struct_flags & (CV_NODE_TYPE_MASK|CV_NODE_FLOW));
+    icvBinPut( fs, &flags, 1 );
+    icvBinPutString( fs, type_name, type_name ? strlen(type_name) : 0 );
+
+    cvSeqPush( fs->write_stack, &fs->struct_flags );
+    fs->struct_flags = flags;
+}
+
+
+static void
+icvBinEndWriteStruct( CvFileStorage* fs )
+{
+    if( fs->write_stack->total == 0 )
+        CV_Error( CV_StsError, "EndWriteStruct w/o matching StartWriteStruct" );
+
+    char tag = 'E';
+    fs->bin_blob_pos = 0;
+    icvBinPut( fs, &tag, 1 );
+    cvSeqPop( fs->write_stack, &fs->struct_flags );
+}
+
+
+static void
+icvBinStartNextStream( CvFileStorage* fs )
+{
+    while( fs->write_stack->total > 0 )
+        icvBinEndWriteStruct( fs );
+    char tag = 'N';
+    fs->bin_blob_pos = 0;
+    icvBinPut( fs, &tag, 1 );
+}
+
+
+static void
+icvBinWriteInt( CvFileStorage* fs, const char* key, int value )
+{
+    icvBinStartRecord( fs, 'I', key );
+    icvBinPut( fs, &value, sizeof(value) );
+}
+
+
+static void
+icvBinWriteReal( CvFileStorage* fs, const char* key, double value )
+{
+    icvBinStartRecord( fs, 'R', key );
+    icvBinPut( fs, &value, sizeof(value) );
+}
+
+
+static void
+icvBinWriteString( CvFileStorage* fs, const char* key, const char* str, int /*quote*/ )
+{
+    if( !str )
+        CV_Error( CV_StsNullPtr, "Null string pointer" );
+    icvBinStartRecord( fs, 'T', key );
+    icvBinPutString( fs, str, strlen(str) );
+}
+
+
+static void
+icvBinWriteComment( CvFileStorage* /*fs*/, const char* comment, int /*eol_comment*/ )
+{
+    // comments are not stored in the binary format
+    if( !comment )
+        CV_Error( CV_StsNullPtr, "Null comment" );
+}
+
+
+/* writes the elements of a single type as one aligned block, consecutive calls extend the block */
+static void
+icvBinWriteRawData( CvFileStorage* fs, const void* data, int len, const char* dt )
+{
+    size_t size = (size_t)len*icvCalcStructSize( dt, 0 );
+    if( fs->bin_blob_pos && strcmp( fs->bin_blob_dt, dt ) == 0 )
+    {
+        uint64 blob_size = fs->bin_blob_size + size;
+        icvBinPatch( fs, fs->bin_blob_pos, &blob_size, sizeof(blob_size) );
+        icvBinPut( fs, data, size );
+        fs->bin_blob_size = (size_t)blob_size;
+        return;
+    }
+
+    static const char zeros[CV_FS_BINARY_ALIGN] = {0};
+    icvBinStartRecord( fs, 'B', 0 );
+    icvBinPutString( fs, dt, strlen(dt) );
+    size_t size_pos = fs->bin_pos;
+    uint64 blob_size = size;
+    icvBinPut( fs, &blob_size, sizeof(blob_size) );
+    icvBinPut( fs, zeros, cv::alignSize( fs->bin_pos, CV_FS_BINARY_ALIGN ) - fs->bin_pos );
+    icvBinPut( fs, data, size );
+
+    if( strlen(dt) < sizeof(fs->bin_blob_dt) )
+    {
+        strcpy( fs->bin_blob_dt, dt );
+        fs->bin_blob_pos = size_pos;
+        fs->bin_blob_size = size;
+    }
+}
+
+
+static void
+icvBinStart( CvFileStorage* fs )
+{
+    char header[CV_FS_BINARY_HEADER_SIZE] = {0};
+    unsigned byte_order = CV_FS_BINARY_BYTE_ORDER;
+    memcpy( header, CV_FS_BINARY_SIGNATURE, sizeof(CV_FS_BINARY_SIGNATURE) - 1 );
+    memcpy( header + 24, &byte_order, sizeof(byte_order) );
+    icvBinPut( fs, header, sizeof(header) );
+}
+
+
+static void
+icvBinFinish( CvFileStorage* fs )
+{
+    uint64 total_size = fs->bin_pos;
+    icvBinPatch( fs, 16, &total_size, sizeof(total_size) );
+}
+
+
 /****************************************************************************************\
 *                              Common High-Level Functions                               *
 \****************************************************************************************/
 
-CV_IMPL CvFileStorage*
-cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const char* encoding )
+/* buflen is the size of the memory buffer, 0 if unknown (the binary storages contain zeros, so strlen() does not work for them) */
+static CvFileStorage*
+icvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const char* encoding,
+                    CvFileStorageStream* stream, size_t buflen )
 {
     CvFileStorage* fs = 0;
     int default_block_size = 1 << 18;
@@ -4204,6 +5073,15 @@ cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const
     if( mem && append )
         CV_Error( CV_StsBadFlag, "CV_STORAGE_APPEND and CV_STORAGE_MEMORY are not currently compatible" );
 
+    bool binary = (flags & CV_STORAGE_FORMAT_MASK) == CV_STORAGE_FORMAT_BINARY;
+    if( write_mode && (flags & CV_STORAGE_FORMAT_MASK) == CV_STORAGE_FORMAT_AUTO && filename )
+    {
+        const char* dot_pos = strrchr( filename, '.' );
+        binary = dot_pos && cv_strcasecmp( dot_pos, ".cvbin" );
+    }
+    if( binary && append )
+        CV_Error( CV_StsNotImplemented, "Appending data to binary file storage is not implemented" );
+
     fs = (CvFileStorage*)cvAlloc( sizeof(*fs) );
     CV_Assert(fs);
     memset( fs, 0, sizeof(*fs));
@@ -4213,6 +5091,7 @@ cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const
 
     fs->flags = CV_FILE_STORAGE;
     fs->write_mode = write_mode;
+    fs->stream = stream;
 
     if( !mem )
     {
@@ -4236,9 +5115,15 @@ cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const
                 dot_pos[3] = '\0', fnamelen--;
         }
 
+        if( isGZ && binary )
+        {
+            cvReleaseFileStorage( &fs );
+            CV_Error(CV_StsNotImplemented, "Compressed binary file storage is not supported" );
+        }
+
         if( !isGZ )
         {
-            fs->file = fopen(fs->filename, !fs->write_mode ? "rt" : !append ? "wt" : "a+t" );
+            fs->file = fopen(fs->filename, !fs->write_mode ? "rt" : binary ? "wb" : !append ? "wt" : "a+t" );
             if( !fs->file )
                 goto _exit_;
         }
@@ -4268,7 +5153,12 @@ cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const
         if( mem )
             fs->outbuf = new std::deque<char>;
 
-        if( fmt == CV_STORAGE_FORMAT_AUTO && filename )
+        if( binary )
+        {
+            fs->fmt = CV_STORAGE_FORMAT_BINARY;
+            write_base64 = false;
+        }
+        else if( fmt == CV_STORAGE_FORMAT_AUTO && filename )
         {
             const char* dot_pos = NULL;
             const char* dot_pos2 = NULL;
@@ -4399,6 +5289,18 @@ cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const
             fs->write_comment = icvXMLWriteComment;
             fs->start_next_stream = icvXMLStartNextStream;
         }
+        else if( fs->fmt == CV_STORAGE_FORMAT_BINARY )
+        {
+            fs->struct_flags = CV_NODE_MAP;
+            icvBinStart( fs );
+            fs->start_write_struct = icvBinStartWriteStruct;
+            fs->end_write_struct = icvBinEndWriteStruct;
+            fs->write_int = icvBinWriteInt;
+            fs->write_real = icvBinWriteReal;
+            fs->write_string = icvBinWriteString;
+            fs->write_comment = icvBinWriteComment;
+            fs->start_next_stream = icvBinStartNextStream;
+        }
         else if( fs->fmt == CV_STORAGE_FORMAT_YAML )
         {
             if( !append )
@@ -4469,6 +5371,7 @@ cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const
         const char* yaml_signature = "%YAML";
         const char* json_signature = "{";
         const char* xml_signature  = "<?xml";
+        const char* binary_signature = CV_FS_BINARY_SIGNATURE;
         char buf[16];
         icvGets( fs, buf, sizeof(buf)-2 );
         char* bufPtr = cv_skip_BOM(buf);
@@ -4480,6 +5383,8 @@ cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const
             fs->fmt = CV_STORAGE_FORMAT_JSON;
         else if(strncmp( bufPtr, xml_signature, strlen(xml_signature) ) == 0)
             fs->fmt = CV_STORAGE_FORMAT_XML;
+        else if(bufOffset == 0 && strncmp( bufPtr, binary_signature, strlen(binary_signature) - 1 ) == 0)
+            fs->fmt = CV_STORAGE_FORMAT_BINARY;
         else if(fs->strbufsize  == bufOffset)
             CV_Error(CV_BADARG_ERR, "Input file is empty");
         else
@@ -4520,6 +5425,10 @@ cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const
             case CV_STORAGE_FORMAT_XML : { icvXMLParse ( fs ); break; }
             case CV_STORAGE_FORMAT_YAML: { icvYMLParse ( fs ); break; }
             case CV_STORAGE_FORMAT_JSON: { icvJSONParse( fs ); break; }
+            case CV_STORAGE_FORMAT_BINARY:
+                icvBinMap( fs, mem ? filename : 0, buflen > 0 ? buflen : fs->strbufsize );
+                icvBinParse( fs );
+                break;
             default: break;
             }
         }
@@ -4557,6 +5466,13 @@ _exit_:
 }
 
 
+CV_IMPL CvFileStorage*
+cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const char* encoding )
+{
+    return icvOpenFileStorage( query, dststorage, flags, encoding, 0, 0 );
+}
+
+
 CV_IMPL void
 cvStartWriteStruct( CvFileStorage* fs, const char* key, int struct_flags,
                     const char* type_name, CvAttrList /*attributes*/ )
@@ -4578,7 +5494,7 @@ cvStartWriteStruct( CvFileStorage* fs, const char* key, int struct_flags,
         /* Uncertain whether output Base64 data */
         make_write_struct_delayed( fs, key, struct_flags, type_name );
     }
-    else if ( type_name && memcmp(type_name, "binary", 6) == 0 )
+    else if ( type_name && memcmp(type_name, "binary", 6) == 0 && fs->fmt != CV_STORAGE_FORMAT_BINARY )
     {
         /* Must output Base64 data */
         if ( !CV_NODE_IS_SEQ(struct_flags) )
@@ -4661,7 +5577,6 @@ cvStartNextStream( CvFileStorage* fs )
 
 
 static const char icvTypeSymbol[] = "ucwsifdr";
-#define CV_FS_MAX_FMT_PAIRS  128
 
 static char*
 icvEncodeFormat( int elem_type, char* dt )
@@ -4793,6 +5708,19 @@ icvDecodeSimpleFormat( const char* dt )
 CV_IMPL void
 cvWriteRawData( CvFileStorage* fs, const void* _data, int len, const char* dt )
 {
+    if( fs && fs->fmt == CV_STORAGE_FORMAT_BINARY )
+    {
+        CV_CHECK_OUTPUT_FILE_STORAGE( fs );
+        if( len < 0 )
+            CV_Error( CV_StsOutOfRange, "Negative number of elements" );
+        if( !len )
+            return;
+        if( !_data )
+            CV_Error( CV_StsNullPtr, "Null data pointer" );
+        icvBinWriteRawData( fs, _data, len, dt );
+        return;
+    }
+
     if (fs->is_default_using_base64 ||
         fs->state_of_writing_base64 == base64::fs::InUse )
     {
@@ -4922,6 +5850,7 @@ cvStartReadRawData( const CvFileStorage* fs, const CvFileNode* src, CvSeqReader*
     if( !src || !reader )
         CV_Error( CV_StsNullPtr, "Null pointer to source file node or reader" );
 
+    icvBinExpandBlob( fs, src );
     node_type = CV_NODE_TYPE(src->tag);
     if( node_type == CV_NODE_INT || node_type == CV_NODE_REAL )
     {
@@ -5105,6 +6034,15 @@ cvReadRawData( const CvFileStorage* fs, const CvFileNode* src,
     if( !src || !data )
         CV_Error( CV_StsNullPtr, "Null pointers to source file node or destination array" );
 
+    const binfs::Blob* blob = icvBinFindBlob( fs, src );
+    if( blob )
+    {
+        if( CV_MAT_DEPTH(icvDecodeSimpleFormat( dt )) != blob->depth )
+            CV_Error( CV_StsUnsupportedFormat, "The mapped matrix data can only be read with the format they were written" );
+        memcpy( data, blob->data, blob->size );
+        return;
+    }
+
     cvStartReadRawData( fs, src, &reader );
     cvReadRawDataSlice( fs, &reader, CV_NODE_IS_SEQ(src->tag) ?
                         src->data.seq->total : 1, data, dt );
@@ -5262,8 +6200,11 @@ icvWriteMat( CvFileStorage* fs, const char* name,
 
 
 static int
-icvFileNodeSeqLen( CvFileNode* node )
+icvFileNodeSeqLen( const CvFileStorage* fs, CvFileNode* node )
 {
+    const binfs::Blob* blob = icvBinFindBlob( fs, node );
+    if( blob )
+        return (int)(blob->size / CV_ELEM_SIZE1(blob->depth));
     return CV_NODE_IS_COLLECTION(node->tag) ? node->data.seq->total :
         CV_NODE_TYPE(node->tag) != CV_NODE_NONE;
 }
@@ -5291,7 +6232,7 @@ icvReadMat( CvFileStorage* fs, CvFileNode* node )
     if( !data )
         CV_Error( CV_StsError, "The matrix data is not found in file storage" );
 
-    int nelems = icvFileNodeSeqLen( data );
+    int nelems = icvFileNodeSeqLen( fs, data );
     if( nelems > 0 && nelems != rows*cols*CV_MAT_CN(elem_type) )
         CV_Error( CV_StsUnmatchedSizes,
                  "The matrix size does not match to the number of stored elements" );
@@ -5389,7 +6330,7 @@ icvReadMatND( CvFileStorage* fs, CvFileNode* node )
         total_size *= sizes[i];
     }
 
-    int nelems = icvFileNodeSeqLen( data );
+    int nelems = icvFileNodeSeqLen( fs, data );
 
     if( nelems > 0 && nelems != total_size )
         CV_Error( CV_StsUnmatchedSizes,
@@ -5674,7 +6615,7 @@ icvReadImage( CvFileStorage* fs, CvFileNode* node )
     if( !data )
         CV_Error( CV_StsError, "The image data is not found in file storage" );
 
-    if( icvFileNodeSeqLen( data ) != width*height*CV_MAT_CN(elem_type) )
+    if( icvFileNodeSeqLen( fs, data ) != width*height*CV_MAT_CN(elem_type) )
         CV_Error( CV_StsUnmatchedSizes,
         "The matrix size does not match to the number of stored elements" );
 
@@ -6052,7 +6993,7 @@ icvReadSeq( CvFileStorage* fs, CvFileNode* node )
     if( !data )
         CV_Error( CV_StsError, "The image data is not found in file storage" );
 
-    if( icvFileNodeSeqLen( data ) != total*items_per_elem )
+    if( icvFileNodeSeqLen( fs, data ) != total*items_per_elem )
         CV_Error( CV_StsError, "The number of stored elements does not match to \"count\"" );
 
     cvStartReadRawData( fs, data, &reader );
@@ -6901,8 +7842,8 @@ bool FileStorage::open(const String& filename, int flags, const String& encoding
     CV_INSTRUMENT_REGION()
 
     release();
-    fs.reset(cvOpenFileStorage( filename.c_str(), 0, flags,
-                                !encoding.empty() ? encoding.c_str() : 0));
+    fs.reset(icvOpenFileStorage( filename.c_str(), 0, flags,
+                                 !encoding.empty() ? encoding.c_str() : 0, 0, filename.size() ));
     bool ok = isOpened();
     state = ok ? NAME_EXPECTED + INSIDE_MAP : UNDEFINED;
     return ok;
@@ -7062,6 +8003,7 @@ FileNode FileNode::operator[](const char* nodename) const
 
 FileNode FileNode::operator[](int i) const
 {
+    icvBinExpandBlob( fs, node );
     return isSeq() ? FileNode(fs, (CvFileNode*)cvGetSeqElem(node->data.seq, i)) :
         i == 0 ? *this : FileNode();
 }
@@ -7100,6 +8042,7 @@ FileNodeIterator::FileNodeIterator(const CvFileStorage* _fs,
         container = _node;
         if( !(_node->tag & FileNode::USER) && (node_type == FileNode::SEQ || node_type == FileNode::MAP) )
         {
+            icvBinExpandBlob( _fs, _node );
             cvStartReadSeq( _node->data.seq, (CvSeqReader*)&reader );
             remaining = FileNode(_fs, _node).size();
         }
@@ -7220,6 +8163,42 @@ FileNodeIterator& FileNodeIterator::readRaw( const String& fmt, uchar* vec, size
 }
 
 
+FileNodeVisitor::~FileNodeVisitor() {}
+
+int FileNodeVisitor::select(const String&, int, int)
+{
+    return VISIT;
+}
+
+void FileNodeVisitor::leave(const String&, int, int) {}
+
+bool readFileStorage(const String& filename, FileNodeVisitor& visitor, int flags, const String& encoding)
+{
+    CV_INSTRUMENT_REGION()
+
+    if( (flags & 3) != FileStorage::READ )
+        CV_Error( CV_StsBadFlag, "The streaming reader does not support writing" );
+
+    CvFileStorageStream stream;
+    stream.visitor = &visitor;
+    CvFileStorage* fs = 0;
+    CV_TRY
+    {
+        fs = icvOpenFileStorage( filename.c_str(), 0, flags,
+                                 !encoding.empty() ? encoding.c_str() : 0, &stream, filename.size() );
+    }
+    CV_CATCH(CvFileStorageStream::Stop, stop)
+    {
+        // the storage has been released by icvOpenFileStorage
+        CV_UNUSED(stop);
+        return true;
+    }
+    bool ok = fs != 0;
+    cvReleaseFileStorage( &fs );
+    return ok;
+}
+
+
 void write( FileStorage& fs, const String& name, int value )
 { cvWriteInt( *fs, name.size() ? name.c_str() : 0, value ); }
 
@@ -7303,6 +8282,8 @@ void read( const FileNode& node, Mat& mat, const Mat& default_mat )
         default_mat.copyTo(mat);
         return;
     }
+    if( icvBinReadMat((CvFileStorage*)node.fs, (CvFileNode*)*node, mat) )
+        return;
     void* obj = cvRead((CvFileStorage*)node.fs, (CvFileNode*)*node);
     if(CV_IS_MAT_HDR_Z(obj))
     {
@@ -7436,7 +8417,7 @@ size_t FileNode::size() const
 {
     int t = type();
     return t == MAP ? (size_t)((CvSet*)node->data.map)->active_count :
-        t == SEQ ? (size_t)node->data.seq->total : (size_t)!isNone();
+        t == SEQ ? (size_t)icvFileNodeSeqLen( fs, (CvFileNode*)node ) : (size_t)!isNone();
 }
 
 void read(const FileNode& node, int& value, int default_value)
@@ -0,0 +1,420 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/bufferpool.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+#include "opencv2/core/utils/pool_allocator.hpp"
+
+#ifdef _WIN32
+#ifndef WINRT
+#include <windows.h>
+#endif
+#else
+#include <pthread.h>
+#endif
+
+namespace cv {
+
+namespace {
+
+// Buffers are pooled in size classes: multiples of 64 bytes up to 1Kb, then 4 classes per power of two.
+// Requests of 2^40 bytes and more are passed to fastMalloc() directly.
+enum
+{
+    POOL_SMALL_CLASSES = 16,
+    POOL_MAX_LOG2 = 40,
+    POOL_NUM_CLASSES = POOL_SMALL_CLASSES + (POOL_MAX_LOG2 - 10)*4,
+    POOL_THREAD_CACHE_DEPTH = 4 // max number of buffers of the same class in a thread cache
+};
+
+static int getSizeClass(size_t size, size_t& classSize)
+{
+    CV_DbgAssert(size > 0);
+    if( size <= 1024 )
+    {
+        int idx = (int)((size + 63) >> 6) - 1;
+        classSize = (size_t)(idx + 1) << 6;
+        return idx;
+    }
+    int k = 10;
+    while( ((size - 1) >> (k + 1)) != 0 )
+    {
+        if( ++k >= POOL_MAX_LOG2 )
+            return -1;
+    }
+    size_t n = (size - 1) >> (k - 2); // 4..7
+    classSize = (n + 1) << (k - 2);
+    return POOL_SMALL_CLASSES + (k - 10)*4 + (int)(n - 4);
+}
+
+struct PoolThreadCache
+{
+    PoolThreadCache() : bytes(0), requests(0), hits(0), registered(false) {}
+
+    // the lock is taken by the owner thread only, except for freeAllReservedBuffers() and statistics
+    Mutex mutex;
+    std::vector<void*> buckets[POOL_NUM_CLASSES];
+    size_t bytes;
+    uint64 requests;
+    uint64 hits;
+    bool registered; // the cache is drained into the shared pool on thread exit
+};
+
+class PoolMatAllocator : public MatAllocator, public BufferPoolController
+{
+public:
+    PoolMatAllocator()
+        : reservedSize_(0), globalHits_(0), maxReservedUnits_(0), retainedUnits_(0)
+    {
+        setMaxReservedSize(utils::getConfigurationParameterSizeT("OPENCV_MAT_POOL_LIMIT", 256*1024*1024));
+        threadCacheLimit_ = utils::getConfigurationParameterSizeT("OPENCV_MAT_POOL_THREAD_CACHE_LIMIT", 16*1024*1024);
+#ifdef _WIN32
+#ifndef WINRT
+        exitKey_ = FlsAlloc(onThreadExit);
+        CV_Assert(exitKey_ != FLS_OUT_OF_INDEXES);
+#endif
+#else
+        CV_Assert(pthread_key_create(&exitKey_, onThreadExit) == 0);
+#endif
+    }
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, int /*flags*/, UMatUsageFlags /*usageFlags*/) const
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            if( step )
+            {
+                if( data0 && step[i] != CV_AUTOSTEP )
+                {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        uchar* data = data0 ? (uchar*)data0 : (uchar*)allocateBuffer(total);
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = data;
+        u->size = total;
+        if(data0)
+            u->flags |= UMatData::USER_ALLOCATED;
+
+        return u;
+    }
+
+    bool allocate(UMatData* u, int /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+            releaseBuffer(u->origdata, u->size);
+            u->origdata = 0;
+        }
+        delete u;
+    }
+
+    BufferPoolController* getBufferPoolController(const char* /*id*/) const
+    {
+        return const_cast<PoolMatAllocator*>(this);
+    }
+
+    size_t getReservedSize() const
+    {
+        std::vector<PoolThreadCache*> caches;
+        tls_.gather(caches);
+        size_t bytes = 0;
+        for( size_t i = 0; i < caches.size(); i++ )
+        {
+            AutoLock lock(caches[i]->mutex);
+            bytes += caches[i]->bytes;
+        }
+        AutoLock lock(mutex_);
+        return bytes + reservedSize_;
+    }
+
+    size_t getMaxReservedSize() const
+    {
+        AutoLock lock(mutex_);
+        return maxReservedSize_;
+    }
+
+    void setMaxReservedSize(size_t size)
+    {
+        {
+            AutoLock lock(mutex_);
+            maxReservedSize_ = size;
+            // the writes are serialized by the lock, releaseBuffer() reads the value without it
+            int units = (int)std::min(size/64, (size_t)INT_MAX);
+            CV_XADD(&maxReservedUnits_, units - CV_XADD(&maxReservedUnits_, 0));
+            for( int cls = POOL_NUM_CLASSES - 1; cls >= 0 && retainedBytes() > size; cls-- )
+                trimBucket(reserved_[cls], cls, size, reservedSize_);
+        }
+        // the largest buffers of the thread caches are freed next
+        std::vector<PoolThreadCache*> caches;
+        tls_.gather(caches);
+        for( size_t i = 0; i < caches.size() && retainedBytes() > size; i++ )
+        {
+            AutoLock lock(caches[i]->mutex);
+            for( int cls = POOL_NUM_CLASSES - 1; cls >= 0 && retainedBytes() > size; cls-- )
+                trimBucket(caches[i]->buckets[cls], cls, size, caches[i]->bytes);
+        }
+    }
+
+    void freeAllReservedBuffers()
+    {
+        std::vector<PoolThreadCache*> caches;
+        tls_.gather(caches);
+        for( size_t i = 0; i < caches.size(); i++ )
+        {
+            AutoLock lock(caches[i]->mutex);
+            for( int cls = 0; cls < POOL_NUM_CLASSES; cls++ )
+                freeBucket(caches[i]->buckets[cls]);
+            addRetained(-(ptrdiff_t)caches[i]->bytes);
+            caches[i]->bytes = 0;
+        }
+        AutoLock lock(mutex_);
+        for( int cls = 0; cls < POOL_NUM_CLASSES; cls++ )
+            freeBucket(reserved_[cls]);
+        addRetained(-(ptrdiff_t)reservedSize_);
+        reservedSize_ = 0;
+    }
+
+    utils::PoolAllocatorStats getStats() const
+    {
+        utils::PoolAllocatorStats stats;
+        std::vector<PoolThreadCache*> caches;
+        tls_.gather(caches);
+        for( size_t i = 0; i < caches.size(); i++ )
+        {
+            AutoLock lock(caches[i]->mutex);
+            stats.requests += caches[i]->requests;
+            stats.threadCacheHits += caches[i]->hits;
+            stats.retainedBytes += caches[i]->bytes;
+        }
+        AutoLock lock(mutex_);
+        stats.globalPoolHits = globalHits_;
+        stats.globalPoolBytes = reservedSize_;
+        stats.retainedBytes += reservedSize_;
+        return stats;
+    }
+
+protected:
+    void* allocateBuffer(size_t size) const
+    {
+        size_t classSize = 0;
+        int cls = getSizeClass(size, classSize);
+        if( cls < 0 )
+            return fastMalloc(size);
+
+        PoolThreadCache& tc = getThreadCache();
+        {
+            AutoLock lock(tc.mutex);
+            tc.requests++;
+            std::vector<void*>& bucket = tc.buckets[cls];
+            if( !bucket.empty() )
+            {
+                void* ptr = bucket.back();
+                bucket.pop_back();
+                tc.bytes -= classSize;
+                addRetained(-(ptrdiff_t)classSize);
+                tc.hits++;
+                return ptr;
+            }
+        }
+        {
+            AutoLock lock(mutex_);
+            std::vector<void*>& bucket = reserved_[cls];
+            if( !bucket.empty() )
+            {
+                void* ptr = bucket.back();
+                bucket.pop_back();
+                reservedSize_ -= classSize;
+                addRetained(-(ptrdiff_t)classSize);
+                globalHits_++;
+                return ptr;
+            }
+        }
+        return fastMalloc(classSize);
+    }
+
+    void releaseBuffer(void* ptr, size_t size) const
+    {
+        size_t classSize = 0;
+        int cls = getSizeClass(size, classSize);
+        if( cls < 0 )
+        {
+            fastFree(ptr);
+            return;
+        }
+
+        // the buffer is counted before it is retained, so that the thread caches and the shared pool
+        // together never exceed the limit
+        if( addRetained(classSize) > (size_t)CV_XADD(&maxReservedUnits_, 0)*64 )
+        {
+            addRetained(-(ptrdiff_t)classSize);
+            fastFree(ptr);
+            return;
+        }
+
+        PoolThreadCache& tc = getThreadCache();
+        {
+            AutoLock lock(tc.mutex);
+            std::vector<void*>& bucket = tc.buckets[cls];
+            if( bucket.size() < POOL_THREAD_CACHE_DEPTH && tc.bytes + classSize <= threadCacheLimit_ )
+            {
+                bucket.push_back(ptr);
+                tc.bytes += classSize;
+                return;
+            }
+        }
+        AutoLock lock(mutex_);
+        reserved_[cls].push_back(ptr);
+        reservedSize_ += classSize;
+    }
+
+    PoolThreadCache& getThreadCache() const
+    {
+        PoolThreadCache& tc = tls_.getRef();
+        if( !tc.registered )
+        {
+            tc.registered = true;
+#ifdef _WIN32
+#ifndef WINRT
+            FlsSetValue(exitKey_, &tc);
+#endif
+#else
+            pthread_setspecific(exitKey_, &tc);
+#endif
+        }
+        return tc;
+    }
+
+    // moves the buffers of an exited thread into the shared pool
+    void drainThreadCache(PoolThreadCache& tc) const
+    {
+        AutoLock lock(tc.mutex);
+        AutoLock poolLock(mutex_);
+        for( int cls = 0; cls < POOL_NUM_CLASSES; cls++ )
+        {
+            std::vector<void*>& bucket = tc.buckets[cls];
+            size_t classSize = getClassSize(cls);
+            // the buffers are already counted as retained, they are freed only if the limit has been lowered
+            for( size_t i = 0; i < bucket.size(); i++ )
+            {
+                if( retainedBytes() <= maxReservedSize_ )
+                {
+                    reserved_[cls].push_back(bucket[i]);
+                    reservedSize_ += classSize;
+                }
+                else
+                {
+                    addRetained(-(ptrdiff_t)classSize);
+                    fastFree(bucket[i]);
+                }
+            }
+            std::vector<void*>().swap(bucket);
+        }
+        tc.bytes = 0;
+        tc.registered = false; // the thread may still release buffers from other TLS destructors
+    }
+
+    static void CV_STDCALL onThreadExit(void* tc);
+
+    // the size of all the retained buffers is kept in 64-byte units (all the size classes are multiples of 64)
+    size_t addRetained(ptrdiff_t delta) const
+    {
+        int units = (int)(delta / 64);
+        return (size_t)(CV_XADD(&retainedUnits_, units) + units) * 64;
+    }
+
+    size_t retainedBytes() const { return addRetained(0); }
+
+    // frees the buffers of the bucket, the largest first, while the retained memory exceeds the limit
+    void trimBucket(std::vector<void*>& bucket, int cls, size_t limit, size_t& bytes) const
+    {
+        size_t classSize = getClassSize(cls);
+        while( !bucket.empty() && retainedBytes() > limit )
+        {
+            fastFree(bucket.back());
+            bucket.pop_back();
+            bytes -= classSize;
+            addRetained(-(ptrdiff_t)classSize);
+        }
+    }
+
+    static size_t getClassSize(int cls)
+    {
+        if( cls < POOL_SMALL_CLASSES )
+            return (size_t)(cls + 1) << 6;
+        int k = 10 + (cls - POOL_SMALL_CLASSES)/4;
+        size_t n = 4 + (cls - POOL_SMALL_CLASSES)%4;
+        return (n + 1) << (k - 2);
+    }
+
+    static void freeBucket(std::vector<void*>& bucket)
+    {
+        for( size_t i = 0; i < bucket.size(); i++ )
+            fastFree(bucket[i]);
+        bucket.clear();
+    }
+
+    // the cache objects stay in TLSData after thread exit, only their buffers are returned (see onThreadExit)
+    TLSData<PoolThreadCache> tls_;
+#ifdef _WIN32
+#ifndef WINRT
+    DWORD exitKey_;
+#endif
+#else
+    pthread_key_t exitKey_;
+#endif
+
+    mutable Mutex mutex_;
+    mutable std::vector<void*> reserved_[POOL_NUM_CLASSES];
+    mutable size_t reservedSize_;
+    mutable uint64 globalHits_;
+    size_t maxReservedSize_;
+    size_t threadCacheLimit_;
+    // the limit and the size of the thread caches and the shared pool together, in 64-byte units
+    mutable int maxReservedUnits_;
+    mutable int retainedUnits_;
+};
+
+static PoolMatAllocator& getPoolMatAllocatorImpl()
+{
+    CV_SINGLETON_LAZY_INIT_REF(PoolMatAllocator, new PoolMatAllocator())
+}
+
+void CV_STDCALL PoolMatAllocator::onThreadExit(void* tc)
+{
+    getPoolMatAllocatorImpl().drainThreadCache(*(PoolThreadCache*)tc);
+}
+
+} // namespace
+
+MatAllocator* utils::getPoolMatAllocator()
+{
+    return &getPoolMatAllocatorImpl();
+}
+
+utils::PoolAllocatorStats utils::getPoolMatAllocatorStats()
+{
+    return getPoolMatAllocatorImpl().getStats();
+}
+
+} // namespace cv
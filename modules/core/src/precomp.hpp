@@ -139,6 +139,12 @@ typedef void (*BinaryFuncC)(const uchar* src1, size_t step1,
 BinaryFunc getConvertFunc(int sdepth, int ddepth);
 BinaryFunc getCopyMaskFunc(size_t esz);
 
+// cache-blocked multi-threaded D = alpha*op(A)*op(B) (+ D if accumulate), the steps are in elements
+void gemmPacked32f(const float* a, size_t a_step, bool a_t, const float* b, size_t b_step, bool b_t,
+                   float* d, size_t d_step, int m, int n, int k, float alpha, bool accumulate);
+void gemmPacked64f(const double* a, size_t a_step, bool a_t, const double* b, size_t b_step, bool b_t,
+                   double* d, size_t d_step, int m, int n, int k, double alpha, bool accumulate);
+
 /* default memory block for sparse array elements */
 #define  CV_SPARSE_MAT_BLOCK     (1<<12)
 
@@ -0,0 +1,343 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/utils/shared_allocator.hpp"
+
+#if (defined __unix__ || defined __APPLE__) && !defined __ANDROID__ && !defined __EMSCRIPTEN__
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define CV_HAVE_SHARED_MAT_ALLOCATOR 1
+#endif
+
+namespace cv {
+
+#ifdef CV_HAVE_SHARED_MAT_ALLOCATOR
+
+namespace {
+
+/*
+ A segment starts with the header, the matrix data follows it.
+ The reference counter is shared by all the processes, it counts the mappings of the segment
+ and the exported handles that have not been imported yet.
+*/
+struct SharedSegmentHeader
+{
+    unsigned magic;
+    int refcount;
+    uint64 size; // size of the data
+    char name[48];
+};
+
+enum { SHARED_SEGMENT_MAGIC = 0x5348434d, SHARED_HEADER_SIZE = 64 };
+
+static SharedSegmentHeader* mapSegment( int fd, size_t mapsize )
+{
+    void* ptr = mmap( 0, mapsize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    return ptr != MAP_FAILED ? (SharedSegmentHeader*)ptr : 0;
+}
+
+static SharedSegmentHeader* createSegment( size_t size )
+{
+    static int counter = 0;
+    size_t mapsize = SHARED_HEADER_SIZE + size;
+
+    for( int attempt = 0; ; attempt++ )
+    {
+        String name = format("/cvmat.%d.%d", (int)getpid(), CV_XADD(&counter, 1));
+        int fd = shm_open( name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600 );
+        if( fd < 0 )
+        {
+            // the name may be left by a crashed process with the same pid
+            if( errno == EEXIST && attempt < 16 )
+                continue;
+            CV_Error_(Error::StsError, ("Can not create shared memory segment %s: %s", name.c_str(), strerror(errno)));
+        }
+
+        SharedSegmentHeader* hdr = 0;
+        if( ftruncate( fd, (off_t)mapsize ) == 0 )
+            hdr = mapSegment( fd, mapsize );
+        int err = errno;
+        ::close( fd );
+        if( !hdr )
+        {
+            shm_unlink( name.c_str() );
+            CV_Error_(Error::StsNoMem, ("Can not allocate %llu bytes of shared memory: %s",
+                                        (unsigned long long)size, strerror(err)));
+        }
+
+        hdr->magic = SHARED_SEGMENT_MAGIC;
+        hdr->refcount = 1;
+        hdr->size = size;
+        memset( hdr->name, 0, sizeof(hdr->name) );
+        strncpy( hdr->name, name.c_str(), sizeof(hdr->name) - 1 );
+        return hdr;
+    }
+}
+
+static SharedSegmentHeader* openSegment( const char* name )
+{
+    int fd = shm_open( name, O_RDWR, 0 );
+    if( fd < 0 )
+        CV_Error_(Error::StsObjectNotFound, ("Can not open shared memory segment %s: %s", name, strerror(errno)));
+
+    struct stat st;
+    SharedSegmentHeader* hdr = 0;
+    if( fstat( fd, &st ) == 0 && (size_t)st.st_size >= (size_t)SHARED_HEADER_SIZE )
+        hdr = mapSegment( fd, (size_t)st.st_size );
+    ::close( fd );
+    if( !hdr )
+        CV_Error_(Error::StsError, ("Can not map shared memory segment %s", name));
+    if( hdr->magic != SHARED_SEGMENT_MAGIC || hdr->size + SHARED_HEADER_SIZE > (uint64)st.st_size )
+    {
+        munmap( hdr, (size_t)st.st_size );
+        CV_Error_(Error::StsBadArg, ("%s is not a shared memory segment of a matrix", name));
+    }
+    return hdr;
+}
+
+// drops the reference held by the mapping and unmaps the segment; the last reference removes it
+static void releaseSegment( SharedSegmentHeader* hdr )
+{
+    char name[sizeof(hdr->name)];
+    memcpy( name, hdr->name, sizeof(name) );
+    size_t mapsize = SHARED_HEADER_SIZE + (size_t)hdr->size;
+    if( CV_XADD(&hdr->refcount, -1) == 1 )
+        shm_unlink( name );
+    munmap( hdr, mapsize );
+}
+
+class SharedMatAllocator : public MatAllocator
+{
+public:
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, int /*flags*/, UMatUsageFlags /*usageFlags*/) const
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            if( step )
+            {
+                if( data0 && step[i] != CV_AUTOSTEP )
+                {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        if( data0 )
+        {
+            UMatData* u = new UMatData(this);
+            u->data = u->origdata = (uchar*)data0;
+            u->size = total;
+            u->flags |= UMatData::USER_ALLOCATED;
+            return u;
+        }
+        return wrap(createSegment(total));
+    }
+
+    bool allocate(UMatData* u, int /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+            releaseSegment((SharedSegmentHeader*)u->origdata);
+            u->origdata = 0;
+        }
+        delete u;
+    }
+
+    UMatData* wrap(SharedSegmentHeader* hdr) const
+    {
+        UMatData* u = new UMatData(this);
+        u->origdata = (uchar*)hdr;
+        u->data = u->origdata + SHARED_HEADER_SIZE;
+        u->size = (size_t)hdr->size;
+        return u;
+    }
+
+    // returns the header of the segment holding the matrix data
+    SharedSegmentHeader* header(const Mat& m) const
+    {
+        CV_Assert( m.u && m.u->currAllocator == this && !(m.u->flags & UMatData::USER_ALLOCATED) );
+        return (SharedSegmentHeader*)m.u->origdata;
+    }
+};
+
+static SharedMatAllocator& getSharedMatAllocatorImpl()
+{
+    CV_SINGLETON_LAZY_INIT_REF(SharedMatAllocator, new SharedMatAllocator())
+}
+
+} // namespace
+
+MatAllocator* utils::getSharedMatAllocator()
+{
+    return &getSharedMatAllocatorImpl();
+}
+
+utils::SharedMatHandle utils::exportSharedMat(const Mat& m)
+{
+    SharedMatAllocator& allocator = getSharedMatAllocatorImpl();
+    SharedSegmentHeader* hdr = allocator.header(m);
+    CV_Assert( m.dims <= CV_MAX_DIM );
+
+    SharedMatHandle h;
+    memset( &h, 0, sizeof(h) );
+    memcpy( h.name, hdr->name, sizeof(h.name) );
+    h.offset = (uint64)(m.data - m.u->data);
+    h.dims = m.dims;
+    h.type = m.type();
+    for( int i = 0; i < m.dims; i++ )
+    {
+        h.size[i] = m.size.p[i];
+        h.step[i] = m.step.p[i];
+    }
+    CV_XADD(&hdr->refcount, 1);
+    return h;
+}
+
+Mat utils::importSharedMat(const SharedMatHandle& h)
+{
+    CV_Assert( 0 < h.dims && h.dims <= CV_MAX_DIM && memchr(h.name, 0, sizeof(h.name)) != 0 );
+
+    SharedMatAllocator& allocator = getSharedMatAllocatorImpl();
+    SharedSegmentHeader* hdr = openSegment( h.name );
+
+    size_t steps[CV_MAX_DIM];
+    uint64 end = h.offset + CV_ELEM_SIZE(h.type);
+    bool valid = true;
+    for( int i = 0; i < h.dims; i++ )
+    {
+        valid = valid && h.size[i] >= 0;
+        steps[i] = (size_t)h.step[i];
+        if( h.size[i] > 0 )
+            end += (uint64)(h.size[i] - 1)*h.step[i];
+    }
+    if( !valid || end > hdr->size )
+    {
+        // the reference of the handle is kept, the handle is corrupted
+        munmap( hdr, SHARED_HEADER_SIZE + (size_t)hdr->size );
+        CV_Error(Error::StsBadArg, "The handle does not match the shared memory segment");
+    }
+
+    UMatData* u = allocator.wrap(hdr);
+    Mat m(h.dims, h.size, h.type, u->data + h.offset, steps);
+    m.allocator = &allocator;
+    m.u = u;
+    u->refcount = 1;
+    return m;
+}
+
+void utils::releaseSharedMatHandle(const SharedMatHandle& h)
+{
+    CV_Assert( memchr(h.name, 0, sizeof(h.name)) != 0 );
+    releaseSegment( openSegment(h.name) );
+}
+
+struct utils::SharedMatRing::Impl
+{
+    Mutex mutex;
+    std::vector<Mat> frames;
+    int next;
+};
+
+utils::SharedMatRing::SharedMatRing(int n, Size size, int type)
+{
+    CV_Assert( n > 0 );
+    p = makePtr<Impl>();
+    p->frames.resize(n);
+    p->next = 0;
+    for( int i = 0; i < n; i++ )
+    {
+        p->frames[i].allocator = getSharedMatAllocator();
+        p->frames[i].create(size, type);
+    }
+}
+
+Mat utils::SharedMatRing::acquire()
+{
+    SharedMatAllocator& allocator = getSharedMatAllocatorImpl();
+    AutoLock lock(p->mutex);
+    int n = (int)p->frames.size();
+    for( int i = 0; i < n; i++ )
+    {
+        int idx = (p->next + i) % n;
+        const Mat& frame = p->frames[idx];
+        // the frame is free if it is referenced only by the ring and only from this process
+        if( CV_XADD(&frame.u->refcount, 0) == 1 && CV_XADD(&allocator.header(frame)->refcount, 0) == 1 )
+        {
+            p->next = (idx + 1) % n;
+            return frame;
+        }
+    }
+    return Mat();
+}
+
+int utils::SharedMatRing::frames() const
+{
+    return (int)p->frames.size();
+}
+
+#else
+
+MatAllocator* utils::getSharedMatAllocator()
+{
+    CV_Error(Error::StsNotImplemented, "Shared memory allocator is not available on this platform");
+    return NULL;
+}
+
+utils::SharedMatHandle utils::exportSharedMat(const Mat&)
+{
+    CV_Error(Error::StsNotImplemented, "Shared memory allocator is not available on this platform");
+    return SharedMatHandle();
+}
+
+Mat utils::importSharedMat(const SharedMatHandle&)
+{
+    CV_Error(Error::StsNotImplemented, "Shared memory allocator is not available on this platform");
+    return Mat();
+}
+
+void utils::releaseSharedMatHandle(const SharedMatHandle&)
+{
+    CV_Error(Error::StsNotImplemented, "Shared memory allocator is not available on this platform");
+}
+
+struct utils::SharedMatRing::Impl {};
+
+utils::SharedMatRing::SharedMatRing(int, Size, int)
+{
+    CV_Error(Error::StsNotImplemented, "Shared memory allocator is not available on this platform");
+}
+
+Mat utils::SharedMatRing::acquire()
+{
+    return Mat();
+}
+
+int utils::SharedMatRing::frames() const
+{
+    return 0;
+}
+
+#endif
+
+} // namespace cv
@@ -1008,6 +1008,260 @@ static SumSqrFunc getSumSqrTab(int depth)
     return sumSqrTab[depth];
 }
 
+/****************************************************************************************\
+*                                   parallel reduction                                   *
+\****************************************************************************************/
+
+// Arrays of at least REDUCE_MIN_PARALLEL_SIZE elements (channels included) are reduced by
+// chunks of about REDUCE_CHUNK_SIZE elements
+enum { REDUCE_CHUNK_SIZE = 1 << 16, REDUCE_MIN_PARALLEL_SIZE = 1 << 18 };
+
+static bool isReduceParallel(const Mat& src)
+{
+    return src.dims <= 2 && src.rows > 1 && src.total()*src.channels() >= (size_t)REDUCE_MIN_PARALLEL_SIZE;
+}
+
+/*
+ A reducer provides:
+   typedef ... Result;                                              // default constructible
+   Result operator()(const Mat& src, const Mat& mask, int startRow) const; // serial reduction
+   void merge(Result& a, const Result& b) const;                    // b is computed for the rows after a
+ src and mask passed to the reducer are row ranges of the original arrays starting at startRow.
+*/
+template<typename Reducer>
+class ReduceRows_Invoker : public ParallelLoopBody
+{
+public:
+    typedef typename Reducer::Result Result;
+
+    ReduceRows_Invoker(const Reducer& _reducer, const Mat& _src, const Mat& _mask, int _rowsPerChunk, Result* _results) :
+        reducer(_reducer), src(_src), mask(_mask), rowsPerChunk(_rowsPerChunk), results(_results)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int y0 = i*rowsPerChunk, y1 = std::min(y0 + rowsPerChunk, src.rows);
+            results[i] = reducer(src.rowRange(y0, y1), mask.empty() ? mask : mask.rowRange(y0, y1), y0);
+        }
+    }
+
+private:
+    const Reducer& reducer;
+    const Mat& src;
+    const Mat& mask;
+    int rowsPerChunk;
+    Result* results;
+};
+
+// The chunks depend only on the array size and are merged in their order, so the result
+// does not depend on the number of threads. Small arrays are reduced serially as a whole.
+template<typename Reducer> static typename Reducer::Result
+reduceMat(const Reducer& reducer, const Mat& src, const Mat& mask)
+{
+    typedef typename Reducer::Result Result;
+
+    if( !isReduceParallel(src) )
+        return reducer(src, mask, 0);
+
+    size_t rowSize = (size_t)src.cols*src.channels();
+    int rowsPerChunk = (int)std::max(REDUCE_CHUNK_SIZE/rowSize, (size_t)1);
+    int nchunks = (src.rows + rowsPerChunk - 1)/rowsPerChunk;
+    std::vector<Result> results(nchunks);
+    parallel_for_(Range(0, nchunks), ReduceRows_Invoker<Reducer>(reducer, src, mask, rowsPerChunk, &results[0]));
+
+    Result result = results[0];
+    for( int i = 1; i < nchunks; i++ )
+        reducer.merge(result, results[i]);
+    return result;
+}
+
+struct SumReducer
+{
+    struct Result
+    {
+        Result() : nz(0) {}
+        Scalar s;
+        size_t nz;
+    };
+
+    SumReducer(SumFunc _func) : func(_func) {}
+
+    Result operator()(const Mat& src, const Mat& mask, int) const
+    {
+        int depth = src.depth(), cn = src.channels();
+        const Mat* arrays[] = {&src, &mask, 0};
+        uchar* ptrs[2];
+        NAryMatIterator it(arrays, ptrs);
+        Result res;
+        Scalar& s = res.s;
+        int k, j, total = (int)it.size, blockSize = total, intSumBlockSize = 0;
+        int count = 0;
+        AutoBuffer<int> _buf;
+        int* buf = (int*)&s[0];
+        bool blockSum = depth <= CV_16S;
+        size_t esz = 0;
+
+        if( blockSum )
+        {
+            intSumBlockSize = depth <= CV_8S ? (1 << 23) : (1 << 15);
+            blockSize = std::min(blockSize, intSumBlockSize);
+            _buf.allocate(cn);
+            buf = _buf;
+
+            for( k = 0; k < cn; k++ )
+                buf[k] = 0;
+            esz = src.elemSize();
+        }
+
+        for( size_t i = 0; i < it.nplanes; i++, ++it )
+        {
+            for( j = 0; j < total; j += blockSize )
+            {
+                int bsz = std::min(total - j, blockSize);
+                int nz = func( ptrs[0], ptrs[1], (uchar*)buf, bsz, cn );
+                count += nz;
+                res.nz += nz;
+                if( blockSum && (count + blockSize >= intSumBlockSize || (i+1 >= it.nplanes && j+bsz >= total)) )
+                {
+                    for( k = 0; k < cn; k++ )
+                    {
+                        s[k] += buf[k];
+                        buf[k] = 0;
+                    }
+                    count = 0;
+                }
+                ptrs[0] += bsz*esz;
+                if( ptrs[1] )
+                    ptrs[1] += bsz;
+            }
+        }
+        return res;
+    }
+
+    void merge(Result& a, const Result& b) const
+    {
+        a.s += b.s;
+        a.nz += b.nz;
+    }
+
+    SumFunc func;
+};
+
+struct SumSqrReducer
+{
+    struct Result
+    {
+        Result() : nz(0) {}
+        std::vector<double> s, sq;
+        int nz;
+    };
+
+    SumSqrReducer(SumSqrFunc _func) : func(_func) {}
+
+    Result operator()(const Mat& src, const Mat& mask, int) const
+    {
+        int k, depth = src.depth(), cn = src.channels();
+        const Mat* arrays[] = {&src, &mask, 0};
+        uchar* ptrs[2];
+        NAryMatIterator it(arrays, ptrs);
+        int total = (int)it.size, blockSize = total, intSumBlockSize = 0;
+        int j, count = 0;
+        Result res;
+        res.s.assign(cn, 0.);
+        res.sq.assign(cn, 0.);
+        AutoBuffer<double> _buf(cn*2);
+        double *s = &res.s[0], *sq = &res.sq[0];
+        int *sbuf = (int*)s, *sqbuf = (int*)sq;
+        bool blockSum = depth <= CV_16S, blockSqSum = depth <= CV_8S;
+        size_t esz = 0;
+
+        if( blockSum )
+        {
+            intSumBlockSize = 1 << 15;
+            blockSize = std::min(blockSize, intSumBlockSize);
+            sbuf = (int*)(double*)_buf;
+            if( blockSqSum )
+                sqbuf = sbuf + cn;
+            for( k = 0; k < cn; k++ )
+                sbuf[k] = sqbuf[k] = 0;
+            esz = src.elemSize();
+        }
+
+        for( size_t i = 0; i < it.nplanes; i++, ++it )
+        {
+            for( j = 0; j < total; j += blockSize )
+            {
+                int bsz = std::min(total - j, blockSize);
+                int nz = func( ptrs[0], ptrs[1], (uchar*)sbuf, (uchar*)sqbuf, bsz, cn );
+                count += nz;
+                res.nz += nz;
+                if( blockSum && (count + blockSize >= intSumBlockSize || (i+1 >= it.nplanes && j+bsz >= total)) )
+                {
+                    for( k = 0; k < cn; k++ )
+                    {
+                        s[k] += sbuf[k];
+                        sbuf[k] = 0;
+                    }
+                    if( blockSqSum )
+                    {
+                        for( k = 0; k < cn; k++ )
+                        {
+                            sq[k] += sqbuf[k];
+                            sqbuf[k] = 0;
+                        }
+                    }
+                    count = 0;
+                }
+                ptrs[0] += bsz*esz;
+                if( ptrs[1] )
+                    ptrs[1] += bsz;
+            }
+        }
+        return res;
+    }
+
+    void merge(Result& a, const Result& b) const
+    {
+        for( size_t k = 0; k < a.s.size(); k++ )
+        {
+            a.s[k] += b.s[k];
+            a.sq[k] += b.sq[k];
+        }
+        a.nz += b.nz;
+    }
+
+    SumSqrFunc func;
+};
+
+struct CountNonZeroReducer
+{
+    typedef int Result;
+
+    CountNonZeroReducer(CountNonZeroFunc _func) : func(_func) {}
+
+    Result operator()(const Mat& src, const Mat&, int) const
+    {
+        const Mat* arrays[] = {&src, 0};
+        uchar* ptrs[1];
+        NAryMatIterator it(arrays, ptrs);
+        int total = (int)it.size, nz = 0;
+
+        for( size_t i = 0; i < it.nplanes; i++, ++it )
+            nz += func( ptrs[0], total );
+        return nz;
+    }
+
+    void merge(Result& a, const Result& b) const
+    {
+        a += b;
+    }
+
+    CountNonZeroFunc func;
+};
+
 #ifdef HAVE_OPENCL
 
 template <typename T> Scalar ocl_part_sum(Mat m)
@@ -1194,53 +1448,11 @@ cv::Scalar cv::sum( InputArray _src )
     Mat src = _src.getMat();
     CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_sum(src, _res), _res);
 
-    int k, cn = src.channels(), depth = src.depth();
+    int cn = src.channels(), depth = src.depth();
     SumFunc func = getSumFunc(depth);
     CV_Assert( cn <= 4 && func != 0 );
 
-    const Mat* arrays[] = {&src, 0};
-    uchar* ptrs[1];
-    NAryMatIterator it(arrays, ptrs);
-    Scalar s;
-    int total = (int)it.size, blockSize = total, intSumBlockSize = 0;
-    int j, count = 0;
-    AutoBuffer<int> _buf;
-    int* buf = (int*)&s[0];
-    size_t esz = 0;
-    bool blockSum = depth < CV_32S;
-
-    if( blockSum )
-    {
-        intSumBlockSize = depth <= CV_8S ? (1 << 23) : (1 << 15);
-        blockSize = std::min(blockSize, intSumBlockSize);
-        _buf.allocate(cn);
-        buf = _buf;
-
-        for( k = 0; k < cn; k++ )
-            buf[k] = 0;
-        esz = src.elemSize();
-    }
-
-    for( size_t i = 0; i < it.nplanes; i++, ++it )
-    {
-        for( j = 0; j < total; j += blockSize )
-        {
-            int bsz = std::min(total - j, blockSize);
-            func( ptrs[0], 0, (uchar*)buf, bsz, cn );
-            count += bsz;
-            if( blockSum && (count + blockSize >= intSumBlockSize || (i+1 >= it.nplanes && j+bsz >= total)) )
-            {
-                for( k = 0; k < cn; k++ )
-                {
-                    s[k] += buf[k];
-                    buf[k] = 0;
-                }
-                count = 0;
-            }
-            ptrs[0] += bsz*esz;
-        }
-    }
-    return s;
+    return reduceMat(SumReducer(func), src, Mat()).s;
 }
 
 #ifdef HAVE_OPENCL
@@ -1373,15 +1585,7 @@ int cv::countNonZero( InputArray _src )
     CountNonZeroFunc func = getCountNonZeroTab(src.depth());
     CV_Assert( func != 0 );
 
-    const Mat* arrays[] = {&src, 0};
-    uchar* ptrs[1];
-    NAryMatIterator it(arrays, ptrs);
-    int total = (int)it.size, nz = 0;
-
-    for( size_t i = 0; i < it.nplanes; i++, ++it )
-        nz += func( ptrs[0], total );
-
-    return nz;
+    return reduceMat(CountNonZeroReducer(func), src, Mat());
 }
 
 #if defined HAVE_IPP
@@ -1487,7 +1691,7 @@ cv::Scalar cv::mean( InputArray _src, InputArray _mask )
     Mat src = _src.getMat(), mask = _mask.getMat();
     CV_Assert( mask.empty() || mask.type() == CV_8U );
 
-    int k, cn = src.channels(), depth = src.depth();
+    int cn = src.channels(), depth = src.depth();
     Scalar s;
 
     CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_mean(src, mask, s), s)
@@ -1496,51 +1700,8 @@ cv::Scalar cv::mean( InputArray _src, InputArray _mask )
 
     CV_Assert( cn <= 4 && func != 0 );
 
-    const Mat* arrays[] = {&src, &mask, 0};
-    uchar* ptrs[2];
-    NAryMatIterator it(arrays, ptrs);
-    int total = (int)it.size, blockSize = total, intSumBlockSize = 0;
-    int j, count = 0;
-    AutoBuffer<int> _buf;
-    int* buf = (int*)&s[0];
-    bool blockSum = depth <= CV_16S;
-    size_t esz = 0, nz0 = 0;
-
-    if( blockSum )
-    {
-        intSumBlockSize = depth <= CV_8S ? (1 << 23) : (1 << 15);
-        blockSize = std::min(blockSize, intSumBlockSize);
-        _buf.allocate(cn);
-        buf = _buf;
-
-        for( k = 0; k < cn; k++ )
-            buf[k] = 0;
-        esz = src.elemSize();
-    }
-
-    for( size_t i = 0; i < it.nplanes; i++, ++it )
-    {
-        for( j = 0; j < total; j += blockSize )
-        {
-            int bsz = std::min(total - j, blockSize);
-            int nz = func( ptrs[0], ptrs[1], (uchar*)buf, bsz, cn );
-            count += nz;
-            nz0 += nz;
-            if( blockSum && (count + blockSize >= intSumBlockSize || (i+1 >= it.nplanes && j+bsz >= total)) )
-            {
-                for( k = 0; k < cn; k++ )
-                {
-                    s[k] += buf[k];
-                    buf[k] = 0;
-                }
-                count = 0;
-            }
-            ptrs[0] += bsz*esz;
-            if( ptrs[1] )
-                ptrs[1] += bsz;
-        }
-    }
-    return s*(nz0 ? 1./nz0 : 0);
+    SumReducer::Result res = reduceMat(SumReducer(func), src, mask);
+    return res.s*(res.nz ? 1./res.nz : 0);
 }
 
 #ifdef HAVE_OPENCL
@@ -1879,64 +2040,11 @@ void cv::meanStdDev( InputArray _src, OutputArray _mean, OutputArray _sdv, Input
 
     CV_Assert( func != 0 );
 
-    const Mat* arrays[] = {&src, &mask, 0};
-    uchar* ptrs[2];
-    NAryMatIterator it(arrays, ptrs);
-    int total = (int)it.size, blockSize = total, intSumBlockSize = 0;
-    int j, count = 0, nz0 = 0;
-    AutoBuffer<double> _buf(cn*4);
-    double *s = (double*)_buf, *sq = s + cn;
-    int *sbuf = (int*)s, *sqbuf = (int*)sq;
-    bool blockSum = depth <= CV_16S, blockSqSum = depth <= CV_8S;
-    size_t esz = 0;
+    SumSqrReducer::Result res = reduceMat(SumSqrReducer(func), src, mask);
+    double *s = &res.s[0], *sq = &res.sq[0];
+    int j;
 
-    for( k = 0; k < cn; k++ )
-        s[k] = sq[k] = 0;
-
-    if( blockSum )
-    {
-        intSumBlockSize = 1 << 15;
-        blockSize = std::min(blockSize, intSumBlockSize);
-        sbuf = (int*)(sq + cn);
-        if( blockSqSum )
-            sqbuf = sbuf + cn;
-        for( k = 0; k < cn; k++ )
-            sbuf[k] = sqbuf[k] = 0;
-        esz = src.elemSize();
-    }
-
-    for( size_t i = 0; i < it.nplanes; i++, ++it )
-    {
-        for( j = 0; j < total; j += blockSize )
-        {
-            int bsz = std::min(total - j, blockSize);
-            int nz = func( ptrs[0], ptrs[1], (uchar*)sbuf, (uchar*)sqbuf, bsz, cn );
-            count += nz;
-            nz0 += nz;
-            if( blockSum && (count + blockSize >= intSumBlockSize || (i+1 >= it.nplanes && j+bsz >= total)) )
-            {
-                for( k = 0; k < cn; k++ )
-                {
-                    s[k] += sbuf[k];
-                    sbuf[k] = 0;
-                }
-                if( blockSqSum )
-                {
-                    for( k = 0; k < cn; k++ )
-                    {
-                        sq[k] += sqbuf[k];
-                        sqbuf[k] = 0;
-                    }
-                }
-                count = 0;
-            }
-            ptrs[0] += bsz*esz;
-            if( ptrs[1] )
-                ptrs[1] += bsz;
-        }
-    }
-
-    double scale = nz0 ? 1./nz0 : 0.;
+    double scale = res.nz ? 1./res.nz : 0.;
     for( k = 0; k < cn; k++ )
     {
         s[k] *= scale;
@@ -2083,6 +2191,65 @@ static void ofs2idx(const Mat& a, size_t ofs, int* idx)
     }
 }
 
+struct MinMaxIdxReducer
+{
+    // the extremums are stored in the type used by the MinMaxIdxFunc, the index is 0 if not found
+    struct Result
+    {
+        Result() : minidx(0), maxidx(0),
+            iminval(INT_MAX), imaxval(INT_MIN),
+            fminval(std::numeric_limits<float>::infinity()), fmaxval(-fminval),
+            dminval(std::numeric_limits<double>::infinity()), dmaxval(-dminval) {}
+        size_t minidx, maxidx;
+        int iminval, imaxval;
+        float fminval, fmaxval;
+        double dminval, dmaxval;
+
+        double minVal(int depth) const { return depth == CV_64F ? dminval : depth == CV_32F ? fminval : iminval; }
+        double maxVal(int depth) const { return depth == CV_64F ? dmaxval : depth == CV_32F ? fmaxval : imaxval; }
+    };
+
+    MinMaxIdxReducer(MinMaxIdxFunc _func, int _depth) : func(_func), depth(_depth) {}
+
+    Result operator()(const Mat& src, const Mat& mask, int startRow) const
+    {
+        const Mat* arrays[] = {&src, &mask, 0};
+        uchar* ptrs[2];
+        NAryMatIterator it(arrays, ptrs);
+        Result res;
+        int *minval = &res.iminval, *maxval = &res.imaxval;
+        int planeSize = (int)it.size*src.channels();
+        size_t startidx = (size_t)startRow*src.cols*src.channels() + 1;
+
+        if( depth == CV_32F )
+            minval = (int*)&res.fminval, maxval = (int*)&res.fmaxval;
+        else if( depth == CV_64F )
+            minval = (int*)&res.dminval, maxval = (int*)&res.dmaxval;
+
+        for( size_t i = 0; i < it.nplanes; i++, ++it, startidx += planeSize )
+            func( ptrs[0], ptrs[1], minval, maxval, &res.minidx, &res.maxidx, planeSize, startidx );
+        return res;
+    }
+
+    // the first occurrence of the extremum is kept as in the serial scan
+    void merge(Result& a, const Result& b) const
+    {
+        if( b.minidx != 0 && (a.minidx == 0 || b.minVal(depth) < a.minVal(depth)) )
+        {
+            a.minidx = b.minidx;
+            a.iminval = b.iminval; a.fminval = b.fminval; a.dminval = b.dminval;
+        }
+        if( b.maxidx != 0 && (a.maxidx == 0 || b.maxVal(depth) > a.maxVal(depth)) )
+        {
+            a.maxidx = b.maxidx;
+            a.imaxval = b.imaxval; a.fmaxval = b.fmaxval; a.dmaxval = b.dmaxval;
+        }
+    }
+
+    MinMaxIdxFunc func;
+    int depth;
+};
+
 #ifdef HAVE_OPENCL
 
 #define MINMAX_STRUCT_ALIGNMENT 8 // sizeof double
@@ -2721,25 +2888,9 @@ void cv::minMaxIdx(InputArray _src, double* minVal,
     MinMaxIdxFunc func = getMinmaxTab(depth);
     CV_Assert( func != 0 );
 
-    const Mat* arrays[] = {&src, &mask, 0};
-    uchar* ptrs[2];
-    NAryMatIterator it(arrays, ptrs);
-
-    size_t minidx = 0, maxidx = 0;
-    int iminval = INT_MAX, imaxval = INT_MIN;
-    float  fminval = std::numeric_limits<float>::infinity(),  fmaxval = -fminval;
-    double dminval = std::numeric_limits<double>::infinity(), dmaxval = -dminval;
-    size_t startidx = 1;
-    int *minval = &iminval, *maxval = &imaxval;
-    int planeSize = (int)it.size*cn;
-
-    if( depth == CV_32F )
-        minval = (int*)&fminval, maxval = (int*)&fmaxval;
-    else if( depth == CV_64F )
-        minval = (int*)&dminval, maxval = (int*)&dmaxval;
-
-    for( size_t i = 0; i < it.nplanes; i++, ++it, startidx += planeSize )
-        func( ptrs[0], ptrs[1], minval, maxval, &minidx, &maxidx, planeSize, startidx );
+    MinMaxIdxReducer::Result res = reduceMat(MinMaxIdxReducer(func, depth), src, mask);
+    size_t minidx = res.minidx, maxidx = res.maxidx;
+    double dminval = res.dminval, dmaxval = res.dmaxval;
 
     if (!src.empty() && mask.empty())
     {
@@ -2752,9 +2903,9 @@ void cv::minMaxIdx(InputArray _src, double* minVal,
     if( minidx == 0 )
         dminval = dmaxval = 0;
     else if( depth == CV_32F )
-        dminval = fminval, dmaxval = fmaxval;
+        dminval = res.fminval, dmaxval = res.fmaxval;
     else if( depth <= CV_32S )
-        dminval = iminval, dmaxval = imaxval;
+        dminval = res.iminval, dmaxval = res.imaxval;
 
     if( minVal )
         *minVal = dminval;
@@ -2997,6 +3148,114 @@ static NormDiffFunc getNormDiffFunc(int normType, int depth)
     return normDiffTab[normType][depth];
 }
 
+struct NormReducer
+{
+    typedef double Result;
+
+    NormReducer(NormFunc _func, int _normType) : func(_func), normType(_normType) {}
+
+    // returns the squared norm for NORM_L2
+    Result operator()(const Mat& src, const Mat& mask, int) const
+    {
+        int depth = src.depth(), cn = src.channels();
+        const Mat* arrays[] = {&src, &mask, 0};
+        uchar* ptrs[2];
+        union
+        {
+            double d;
+            int i;
+            float f;
+        }
+        result;
+        result.d = 0;
+        NAryMatIterator it(arrays, ptrs);
+        int j, total = (int)it.size, blockSize = total, intSumBlockSize = 0, count = 0;
+        bool blockSum = (normType == NORM_L1 && depth <= CV_16S) ||
+                ((normType == NORM_L2 || normType == NORM_L2SQR) && depth <= CV_8S);
+        int isum = 0;
+        int *ibuf = &result.i;
+        size_t esz = 0;
+
+        if( blockSum )
+        {
+            intSumBlockSize = (normType == NORM_L1 && depth <= CV_8S ? (1 << 23) : (1 << 15))/cn;
+            blockSize = std::min(blockSize, intSumBlockSize);
+            ibuf = &isum;
+            esz = src.elemSize();
+        }
+
+        for( size_t i = 0; i < it.nplanes; i++, ++it )
+        {
+            for( j = 0; j < total; j += blockSize )
+            {
+                int bsz = std::min(total - j, blockSize);
+                func( ptrs[0], ptrs[1], (uchar*)ibuf, bsz, cn );
+                count += bsz;
+                if( blockSum && (count + blockSize >= intSumBlockSize || (i+1 >= it.nplanes && j+bsz >= total)) )
+                {
+                    result.d += isum;
+                    isum = 0;
+                    count = 0;
+                }
+                ptrs[0] += bsz*esz;
+                if( ptrs[1] )
+                    ptrs[1] += bsz;
+            }
+        }
+
+        if( normType == NORM_INF )
+        {
+            if( depth == CV_64F )
+                ;
+            else if( depth == CV_32F )
+                result.d = result.f;
+            else
+                result.d = result.i;
+        }
+        return result.d;
+    }
+
+    void merge(Result& a, const Result& b) const
+    {
+        if( normType == NORM_INF )
+            a = std::max(a, b);
+        else
+            a += b;
+    }
+
+    NormFunc func;
+    int normType;
+};
+
+struct NormHammingReducer
+{
+    typedef int Result;
+
+    NormHammingReducer(int _cellSize) : cellSize(_cellSize) {}
+
+    Result operator()(const Mat& src, const Mat&, int) const
+    {
+        const Mat* arrays[] = {&src, 0};
+        uchar* ptrs[1];
+        NAryMatIterator it(arrays, ptrs);
+        int total = (int)it.size;
+        int result = 0;
+
+        for( size_t i = 0; i < it.nplanes; i++, ++it )
+        {
+            result += hal::normHamming(ptrs[0], total, cellSize);
+        }
+        return result;
+    }
+
+    void merge(Result& a, const Result& b) const
+    {
+        a += b;
+    }
+
+    int cellSize;
+};
+
 #ifdef HAVE_OPENCL
 
 static bool ocl_norm( InputArray _src, int normType, InputArray _mask, double & result )
@@ -3199,7 +3458,7 @@ double cv::norm( InputArray _src, int normType, InputArray _mask )
     CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_norm(src, normType, mask, _result), _result);
 
     int depth = src.depth(), cn = src.channels();
-    if( src.isContinuous() && mask.empty() )
+    if( src.isContinuous() && mask.empty() && !isReduceParallel(src) )
     {
         size_t len = src.total()*cn;
         if( len == (size_t)(int)len )
@@ -3262,81 +3521,16 @@ double cv::norm( InputArray _src, int normType, InputArray _mask )
         }
         int cellSize = normType == NORM_HAMMING ? 1 : 2;
 
-        const Mat* arrays[] = {&src, 0};
-        uchar* ptrs[1];
-        NAryMatIterator it(arrays, ptrs);
-        int total = (int)it.size;
-        int result = 0;
-
-        for( size_t i = 0; i < it.nplanes; i++, ++it )
-        {
-            result += hal::normHamming(ptrs[0], total, cellSize);
-        }
-
-        return result;
+        return reduceMat(NormHammingReducer(cellSize), src, Mat());
     }
 
     NormFunc func = getNormFunc(normType >> 1, depth);
     CV_Assert( func != 0 );
 
-    const Mat* arrays[] = {&src, &mask, 0};
-    uchar* ptrs[2];
-    union
-    {
-        double d;
-        int i;
-        float f;
-    }
-    result;
-    result.d = 0;
-    NAryMatIterator it(arrays, ptrs);
-    int j, total = (int)it.size, blockSize = total, intSumBlockSize = 0, count = 0;
-    bool blockSum = (normType == NORM_L1 && depth <= CV_16S) ||
-            ((normType == NORM_L2 || normType == NORM_L2SQR) && depth <= CV_8S);
-    int isum = 0;
-    int *ibuf = &result.i;
-    size_t esz = 0;
-
-    if( blockSum )
-    {
-        intSumBlockSize = (normType == NORM_L1 && depth <= CV_8S ? (1 << 23) : (1 << 15))/cn;
-        blockSize = std::min(blockSize, intSumBlockSize);
-        ibuf = &isum;
-        esz = src.elemSize();
-    }
-
-    for( size_t i = 0; i < it.nplanes; i++, ++it )
-    {
-        for( j = 0; j < total; j += blockSize )
-        {
-            int bsz = std::min(total - j, blockSize);
-            func( ptrs[0], ptrs[1], (uchar*)ibuf, bsz, cn );
-            count += bsz;
-            if( blockSum && (count + blockSize >= intSumBlockSize || (i+1 >= it.nplanes && j+bsz >= total)) )
-            {
-                result.d += isum;
-                isum = 0;
-                count = 0;
-            }
-            ptrs[0] += bsz*esz;
-            if( ptrs[1] )
-                ptrs[1] += bsz;
-        }
-    }
-
-    if( normType == NORM_INF )
-    {
-        if( depth == CV_64F )
-            ;
-        else if( depth == CV_32F )
-            result.d = result.f;
-        else
-            result.d = result.i;
-    }
-    else if( normType == NORM_L2 )
-        result.d = std::sqrt(result.d);
-
-    return result.d;
+    double result = reduceMat(NormReducer(func, normType), src, mask);
+    if( normType == NORM_L2 )
+        result = std::sqrt(result);
+    return result;
 }
 
 #ifdef HAVE_OPENCL
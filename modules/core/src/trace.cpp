@@ -79,6 +79,7 @@ static int param_maxRegionDepthOpenCV = (int)utils::getConfigurationParameterSiz
 static int param_maxRegionChildrenOpenCV = (int)utils::getConfigurationParameterSizeT("OPENCV_TRACE_MAX_CHILDREN_OPENCV", 1000);
 static int param_maxRegionChildren = (int)utils::getConfigurationParameterSizeT("OPENCV_TRACE_MAX_CHILDREN", 10000);
 static cv::String param_traceLocation = utils::getConfigurationParameterString("OPENCV_TRACE_LOCATION", "OpenCVTrace");
+static cv::String param_traceFormat = utils::getConfigurationParameterString("OPENCV_TRACE_FORMAT", "txt"); // "txt" or "chrome"
 
 #ifdef HAVE_OPENCL
 static bool param_synchronizeOpenCL = utils::getConfigurationParameterBool("OPENCV_TRACE_SYNC_OPENCL", false);
@@ -191,6 +192,229 @@ public:
 };
 
 
+/**
+ * Trace in Chrome trace event format (JSON), can be opened by chrome://tracing or Perfetto UI
+ */
+class ChromeTraceStorage
+{
+    std::ofstream out;
+    cv::Mutex mutex;
+    bool empty;
+    bool closed;
+public:
+    const std::string name;
+
+    ChromeTraceStorage(const std::string& filename) :
+        out(filename.c_str(), std::ios::trunc),
+        empty(true),
+        closed(false),
+        name(filename)
+    {
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    }
+    ~ChromeTraceStorage()
+    {
+        close();
+    }
+
+    //! appends comma-separated events
+    void put(const std::string& events)
+    {
+        if (events.empty())
+            return;
+        cv::AutoLock l(mutex);
+        if (closed)
+            return;
+        out << (empty ? "\n" : ",\n") << events;
+        empty = false;
+    }
+
+    //! completes the file, events put after that are dropped
+    void close()
+    {
+        cv::AutoLock l(mutex);
+        if (closed)
+            return;
+        out << "\n]}" << std::endl;
+        out.close();
+        closed = true;
+    }
+};
+
+/**
+ * Events of one thread, passed to the storage in batches.
+ * The buffer is filled by its thread, the lock allows TraceManager to flush it from other threads.
+ */
+class ChromeTraceBuffer
+{
+public:
+    const int threadID;
+
+    ChromeTraceBuffer(const cv::Ptr<ChromeTraceStorage>& storage_, int threadID_) :
+        threadID(threadID_),
+        storage(storage_)
+    {
+        appendf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                threadID, threadID);
+    }
+    ~ChromeTraceBuffer()
+    {
+        flush();
+    }
+
+    void flush()
+    {
+        cv::AutoLock l(mutex);
+        flush_();
+    }
+
+    void regionEnter(const Region& region)
+    {
+        cv::AutoLock l(mutex);
+        const Region::Impl& impl = *region.pImpl;
+        const int flags = impl.location.flags;
+        const char* category = (flags & REGION_FLAG_APP_CODE) ? "app" : "opencv";
+        switch (flags & REGION_FLAG_IMPL_MASK)
+        {
+        case REGION_FLAG_IMPL_IPP: category = "ipp"; break;
+        case REGION_FLAG_IMPL_OPENCL: category = "opencl"; break;
+        case REGION_FLAG_IMPL_OPENVX: category = "openvx"; break;
+        default: break;
+        }
+        separate();
+        events += "{\"name\":";
+        putString(impl.location.name);
+        appendf(",\"cat\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"file\":",
+                category, impl.beginTimestamp * 1e-3, threadID);
+        putString(cv::format("%s:%d", impl.location.filename, impl.location.line).c_str());
+        events += "}}";
+
+        // parallel_for_ stripes executed by other threads are bound to the parent region with flow events
+        const Region* parent = impl.parentRegion;
+        if (parent && parent->pImpl && parent->pImpl->threadID != threadID)
+        {
+            static int g_flow_id_counter = 0;
+            int id = CV_XADD(&g_flow_id_counter, 1) + 1;
+            separate();
+            appendf("{\"name\":\"stripe\",\"cat\":\"parallel_for\",\"ph\":\"s\",\"id\":%d,\"ts\":%.3f,\"pid\":1,\"tid\":%d},"
+                   "{\"name\":\"stripe\",\"cat\":\"parallel_for\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%d,\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                    id, impl.beginTimestamp * 1e-3, parent->pImpl->threadID,
+                    id, impl.beginTimestamp * 1e-3, threadID);
+        }
+
+        args.push_back(std::make_pair(impl.global_region_id, std::string()));
+    }
+
+    void regionArg(const Region& region, const TraceArg& arg, const char* value, bool quote)
+    {
+        cv::AutoLock l(mutex);
+        for (size_t i = args.size(); i > 0; i--)
+        {
+            if (args[i - 1].first == region.pImpl->global_region_id)
+            {
+                std::string& members = args[i - 1].second;
+                if (!members.empty())
+                    members += ",";
+                std::swap(members, events);
+                putString(arg.name);
+                events += ":";
+                if (quote)
+                    putString(value);
+                else
+                    events += value;
+                std::swap(members, events);
+                break;
+            }
+        }
+    }
+
+    void regionLeave(const Region& region, const RegionStatistics& result)
+    {
+        cv::AutoLock l(mutex);
+        const Region::Impl& impl = *region.pImpl;
+        std::string members;
+        while (!args.empty())
+        {
+            bool found = args.back().first == impl.global_region_id;
+            if (found)
+                members.swap(args.back().second);
+            args.pop_back();
+            if (found)
+                break;
+        }
+        if (result.currentSkippedRegions)
+            members += cv::format("%s\"skipped\":%d", members.empty() ? "" : ",", (int)result.currentSkippedRegions);
+#ifdef HAVE_IPP
+        if (result.durationImplIPP)
+            members += cv::format("%s\"tIPP\":%lld", members.empty() ? "" : ",", (long long int)result.durationImplIPP);
+#endif
+#ifdef HAVE_OPENCL
+        if (result.durationImplOpenCL)
+            members += cv::format("%s\"tOCL\":%lld", members.empty() ? "" : ",", (long long int)result.durationImplOpenCL);
+#endif
+#ifdef HAVE_OPENVX
+        if (result.durationImplOpenVX)
+            members += cv::format("%s\"tOVX\":%lld", members.empty() ? "" : ",", (long long int)result.durationImplOpenVX);
+#endif
+        separate();
+        appendf("{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{", impl.endTimestamp * 1e-3, threadID);
+        events += members;
+        events += "}}";
+
+        if (events.size() >= (1 << 16))
+            flush_();
+    }
+
+protected:
+    cv::Ptr<ChromeTraceStorage> storage;
+    cv::Mutex mutex;
+    std::string events;
+    std::vector<std::pair<int, std::string> > args; // arguments of the open regions (region id, JSON members)
+
+    void flush_()
+    {
+        storage->put(events);
+        events.clear();
+    }
+
+    void separate()
+    {
+        if (!events.empty())
+            events += ",\n";
+    }
+
+    void appendf(const char* format, ...)
+    {
+        char buf[512];
+        va_list ap;
+        va_start(ap, format);
+        int n = cv_vsnprintf(buf, (int)sizeof(buf), format, ap);
+        va_end(ap);
+        if (n > 0)
+            events.append(buf, std::min((size_t)n, sizeof(buf) - 1));
+    }
+
+    void putString(const char* str)
+    {
+        events += '"';
+        for (; *str; str++)
+        {
+            char c = *str;
+            if (c == '"' || c == '\\')
+            {
+                events += '\\';
+                events += c;
+            }
+            else if ((uchar)c < 0x20)
+                appendf("\\u%04x", (int)(uchar)c);
+            else
+                events += c;
+        }
+        events += '"';
+    }
+};
+
+
 #ifdef OPENCV_WITH_ITT
 static __itt_domain* domain = NULL;
 
@@ -314,6 +538,9 @@ void Region::Impl::enterRegion(TraceManagerThreadLocal& ctx)
         msg.formatRegionEnter(region);
         s->put(msg);
     }
+    ChromeTraceBuffer* chrome = ctx.getChromeBuffer();
+    if (chrome)
+        chrome->regionEnter(region);
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
@@ -361,6 +588,9 @@ void Region::Impl::leaveRegion(TraceManagerThreadLocal& ctx)
         msg.formatRegionLeave(region, result);
         s->put(msg);
     }
+    ChromeTraceBuffer* chrome = ctx.getChromeBuffer();
+    if (chrome)
+        chrome->regionLeave(region, result);
 
     if (location.flags & REGION_FLAG_FUNCTION)
     {
@@ -813,6 +1043,20 @@ TraceStorage* TraceManagerThreadLocal::getStorage() const
     return storage.get();
 }
 
+ChromeTraceBuffer* TraceManagerThreadLocal::getChromeBuffer() const
+{
+    if (chrome_buffer.empty())
+    {
+        TraceManager& manager = getTraceManager();
+        if (manager.chrome_storage)
+        {
+            cv::AutoLock l(manager.mutexCreate); // the buffers of all threads are flushed by ~TraceManager()
+            chrome_buffer.reset(new ChromeTraceBuffer(manager.chrome_storage, threadID));
+        }
+    }
+    return chrome_buffer.get();
+}
+
 
 
 static bool activated = false;
@@ -829,7 +1073,12 @@ TraceManager::TraceManager()
     activated = param_traceEnable;
 
     if (activated)
-        trace_storage.reset(new SyncTraceStorage(std::string(param_traceLocation) + ".txt"));
+    {
+        if (param_traceFormat == "chrome")
+            chrome_storage.reset(new ChromeTraceStorage(std::string(param_traceLocation) + ".json"));
+        else
+            trace_storage.reset(new SyncTraceStorage(std::string(param_traceLocation) + ".txt"));
+    }
 
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
@@ -853,15 +1102,22 @@ TraceManager::~TraceManager()
     std::vector<TraceManagerThreadLocal*> threads_ctx;
     tls.gather(threads_ctx);
     size_t totalEvents = 0, totalSkippedEvents = 0;
-    for (size_t i = 0; i < threads_ctx.size(); i++)
     {
-        TraceManagerThreadLocal* ctx = threads_ctx[i];
-        if (ctx)
+        cv::AutoLock lock(mutexCreate); // the buffers may be created by other threads meanwhile
+        for (size_t i = 0; i < threads_ctx.size(); i++)
         {
-            totalEvents += ctx->region_counter;
-            totalSkippedEvents += ctx->totalSkippedEvents;
+            TraceManagerThreadLocal* ctx = threads_ctx[i];
+            if (ctx)
+            {
+                totalEvents += ctx->region_counter;
+                totalSkippedEvents += ctx->totalSkippedEvents;
+                if (ctx->chrome_buffer)
+                    ctx->chrome_buffer->flush(); // the thread may still be running, flush() takes the buffer lock
+            }
         }
     }
+    if (chrome_storage)
+        chrome_storage->close();
     if (totalEvents || activated)
     {
         CV_LOG_INFO(NULL, "Trace: Total events: " << totalEvents);
@@ -1057,6 +1313,9 @@ void traceArg(const TraceArg& arg, const char* value)
     initTraceArg(ctx, arg);
     if (!value)
         value = "<null>";
+    ChromeTraceBuffer* chrome = ctx.getChromeBuffer();
+    if (chrome)
+        chrome->regionArg(*region, arg, value, true);
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
@@ -1072,13 +1331,14 @@ void traceArg(const TraceArg& arg, int value)
         return;
     CV_Assert(region->pImpl);
     initTraceArg(ctx, arg);
+    ChromeTraceBuffer* chrome = ctx.getChromeBuffer();
+    if (chrome)
+        chrome->regionArg(*region, arg, cv::format("%d", value).c_str(), false);
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
         __itt_metadata_add(domain, region->pImpl->itt_id, (*arg.ppExtra)->ittHandle_name, sizeof(int) == 4 ? __itt_metadata_s32 : __itt_metadata_s64, 1, &value);
     }
-#else
-    CV_UNUSED(value);
 #endif
 }
 void traceArg(const TraceArg& arg, int64 value)
@@ -1089,13 +1349,14 @@ void traceArg(const TraceArg& arg, int64 value)
         return;
     CV_Assert(region->pImpl);
     initTraceArg(ctx, arg);
+    ChromeTraceBuffer* chrome = ctx.getChromeBuffer();
+    if (chrome)
+        chrome->regionArg(*region, arg, cv::format("%lld", (long long int)value).c_str(), false);
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
         __itt_metadata_add(domain, region->pImpl->itt_id, (*arg.ppExtra)->ittHandle_name, __itt_metadata_s64, 1, &value);
     }
-#else
-    CV_UNUSED(value);
 #endif
 }
 void traceArg(const TraceArg& arg, double value)
@@ -1106,13 +1367,14 @@ void traceArg(const TraceArg& arg, double value)
         return;
     CV_Assert(region->pImpl);
     initTraceArg(ctx, arg);
+    ChromeTraceBuffer* chrome = ctx.getChromeBuffer();
+    if (chrome)
+        chrome->regionArg(*region, arg, cv::format("%.17g", value).c_str(), cvIsNaN(value) || cvIsInf(value)); // JSON has no NaN/Inf numbers
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
         __itt_metadata_add(domain, region->pImpl->itt_id, (*arg.ppExtra)->ittHandle_name, __itt_metadata_double, 1, &value);
     }
-#else
-    CV_UNUSED(value);
 #endif
 }
 
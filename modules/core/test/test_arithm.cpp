@@ -2016,3 +2016,156 @@ TEST(Core_minMaxIdx, regression_9207_2)
     EXPECT_EQ(0, maxIdx[0]);
     EXPECT_EQ(14, maxIdx[1]);
 }
+
+
+TEST(Core_Arithm, parallel_stripes_consistency)
+{
+    // big enough to be split into row stripes; the ROI is not continuous
+    Mat big1(1030, 1100, CV_8UC3), big2(big1.size(), big1.type());
+    randu(big1, 0, 256);
+    randu(big2, 0, 256);
+    Mat a8 = big1(Rect(3, 2, 1024, 1024)), b8 = big2(Rect(5, 1, 1024, 1024));
+    Mat a32, b32;
+    a8.convertTo(a32, CV_32F, 1./16, -5);
+    b8.convertTo(b32, CV_32F, 1./8, 1);
+
+    int nthreads = getNumThreads();
+    std::vector<Mat> res[2];
+    for( int k = 0; k < 2; k++ )
+    {
+        setNumThreads(k == 0 ? 4 : 1);
+        std::vector<Mat>& r = res[k];
+        r.resize(12);
+        add(a8, b8, r[0]);
+        subtract(a8, b8, r[1]);
+        absdiff(a8, b8, r[2]);
+        min(a32, b32, r[3]);
+        max(a32, b32, r[4]);
+        bitwise_xor(a8, b8, r[5]);
+        compare(a32, b32, r[6], CMP_GT);
+        multiply(a8, b8, r[7], 1./255);
+        multiply(a32, b32, r[8]);
+        addWeighted(a32, 0.3, b32, 0.7, 2, r[9]);
+        divide(a8, b8, r[10], 3);
+        divide(a32, b32, r[11]);
+    }
+    setNumThreads(nthreads);
+
+    for( size_t i = 0; i < res[0].size(); i++ )
+    {
+        ASSERT_EQ(res[1][i].size(), res[0][i].size()) << "op " << i;
+        ASSERT_EQ(res[1][i].type(), res[0][i].type()) << "op " << i;
+        EXPECT_EQ(0, cvtest::norm(res[0][i], res[1][i], NORM_INF)) << "op " << i;
+    }
+}
+
+TEST(Core_Stat, parallel_reduction_consistency)
+{
+    // large enough to be reduced by chunks in parallel, while every row is reduced serially
+    int nthreads = getNumThreads();
+    setNumThreads(4); // the default setting may disable parallel_for_ on small machines
+    Mat src(1000, 1500, CV_8UC3), mask(src.size(), CV_8UC1);
+    randu(src, 1, 255);
+    randu(mask, 0, 2);
+    src.at<Vec3b>(10, 20)[1] = 0;
+    src.at<Vec3b>(900, 20)[1] = 0;
+    src.at<Vec3b>(500, 30)[2] = 255;
+    src.at<Vec3b>(999, 30)[2] = 255;
+
+    Scalar s, ms;
+    double l1 = 0, l2sqr = 0;
+    int nz = 0, mnz = 0;
+    Mat gray = src.reshape(1);
+    for (int y = 0; y < src.rows; y++)
+    {
+        s += sum(src.row(y));
+        int rowNz = countNonZero(mask.row(y));
+        ms += mean(src.row(y), mask.row(y)) * rowNz;
+        mnz += rowNz;
+        nz += countNonZero(gray.row(y));
+        l1 += norm(src.row(y), NORM_L1);
+        l2sqr += norm(src.row(y), NORM_L2SQR, mask.row(y));
+    }
+
+    EXPECT_EQ(s, sum(src));
+    EXPECT_EQ(nz, countNonZero(gray));
+    EXPECT_EQ(l1, norm(src, NORM_L1));
+    EXPECT_EQ(l2sqr, norm(src, NORM_L2SQR, mask));
+    EXPECT_EQ(255., norm(src, NORM_INF));
+    Scalar m = mean(src, mask);
+    for (int k = 0; k < 3; k++)
+        EXPECT_NEAR(ms[k] / mnz, m[k], 1e-9);
+
+    double minVal = -1, maxVal = -1;
+    int minIdx[2] = { -1, -1 }, maxIdx[2] = { -1, -1 };
+    minMaxIdx(gray, &minVal, &maxVal, minIdx, maxIdx);
+    EXPECT_EQ(0, minVal);
+    EXPECT_EQ(255, maxVal);
+    EXPECT_EQ(10, minIdx[0]);
+    EXPECT_EQ(20*3 + 1, minIdx[1]);
+    EXPECT_EQ(500, maxIdx[0]);
+    EXPECT_EQ(30*3 + 2, maxIdx[1]);
+
+    // floating-point results do not depend on the number of threads
+    Mat fsrc(src.size(), CV_32FC3);
+    randu(fsrc, -1, 1);
+    Scalar fsum = sum(fsrc), fmean, fsdv;
+    double fnorm = norm(fsrc, NORM_L2);
+    meanStdDev(fsrc, fmean, fsdv, mask);
+
+    setNumThreads(1);
+    Scalar fsum1 = sum(fsrc), fmean1, fsdv1;
+    double fnorm1 = norm(fsrc, NORM_L2);
+    meanStdDev(fsrc, fmean1, fsdv1, mask);
+    setNumThreads(nthreads);
+
+    EXPECT_EQ(fsum, fsum1);
+    EXPECT_EQ(fnorm, fnorm1);
+    EXPECT_EQ(fmean, fmean1);
+    EXPECT_EQ(fsdv, fsdv1);
+}
+
+TEST(Core_ConvertBF16, accuracy)
+{
+    // every bfloat16 value survives the round trip, NaNs stay NaN
+    Mat all(1, 65536, CV_16U), f, back;
+    for( int i = 0; i < 65536; i++ )
+        all.at<ushort>(i) = (ushort)i;
+    convertBF16(all, f);
+    ASSERT_EQ(CV_32F, f.type());
+    convertBF16(f, back);
+    ASSERT_EQ(CV_16U, back.type());
+    for( int i = 0; i < 65536; i++ )
+    {
+        Cv32suf u;
+        u.f = f.at<float>(i);
+        ASSERT_EQ((unsigned)i << 16, u.u) << i;
+        if( cvIsNaN(u.f) )
+            EXPECT_TRUE((back.at<ushort>(i) & 0x7f80) == 0x7f80 && (back.at<ushort>(i) & 0x7f) != 0) << i;
+        else
+            EXPECT_EQ(i, back.at<ushort>(i)) << i;
+    }
+
+    // rounding to nearest even
+    const unsigned bits[] = { 0x3f800000, 0x3f808000, 0x3f818000, 0x3f808001, 0x3f807fff, 0xbf808000, 0x7f7fffff, 0x80000000 };
+    const ushort expected[] = { 0x3f80, 0x3f80, 0x3f82, 0x3f81, 0x3f80, 0xbf80, 0x7f80, 0x8000 };
+    Mat src(1, 8, CV_32F), dst;
+    for( int i = 0; i < 8; i++ )
+    {
+        Cv32suf u;
+        u.u = bits[i];
+        src.at<float>(i) = u.f;
+    }
+    convertBF16(src, dst);
+    for( int i = 0; i < 8; i++ )
+        EXPECT_EQ(expected[i], dst.at<ushort>(i)) << i;
+
+    // multi-channel, non-continuous input with a tail
+    Mat big(20, 30, CV_32FC3), dst2, ref;
+    randu(big, -1e5, 1e5);
+    Mat roi = big(Rect(1, 2, 13, 11));
+    convertBF16(roi, dst2);
+    ASSERT_EQ(CV_16UC3, dst2.type());
+    convertBF16(dst2, ref);
+    EXPECT_LE(cvtest::norm(ref, roi, NORM_INF | NORM_RELATIVE), 1./256);
+}
@@ -986,3 +986,46 @@ protected:
 
 TEST(Core_DFT, reverse) { Core_DXTReverseTest test(Core_DXTReverseTest::ModeDFT); test.safe_run(); }
 TEST(Core_DCT, reverse) { Core_DXTReverseTest test(Core_DXTReverseTest::ModeDCT); test.safe_run(); }
+
+TEST(Core_DFT, plan)
+{
+    const int flags_list[] = { 0, DFT_COMPLEX_OUTPUT, DFT_ROWS, DFT_SCALE | DFT_ROWS | DFT_COMPLEX_OUTPUT,
+                               DFT_INVERSE | DFT_SCALE, DFT_INVERSE | DFT_REAL_OUTPUT };
+    const Size sizes[] = { Size(64, 64), Size(45, 30), Size(17, 1), Size(1, 20) };
+    for( int depth = CV_32F; depth <= CV_64F; depth++ )
+        for( size_t k = 0; k < sizeof(flags_list)/sizeof(flags_list[0]); k++ )
+            for( size_t s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++ )
+            {
+                int flags = flags_list[k];
+                int cn = (flags & DFT_INVERSE) ? 2 : 1;
+                DFTPlan plan(sizes[s], CV_MAKETYPE(depth, cn), flags);
+                std::vector<Mat> src(7), dst, ref(src.size());
+                for( size_t i = 0; i < src.size(); i++ )
+                {
+                    src[i].create(sizes[s], plan.type());
+                    randu(src[i], -1, 1);
+                    dft(src[i], ref[i], flags);
+                }
+
+                plan.applyBatch(src, dst);
+                ASSERT_EQ(src.size(), dst.size());
+                for( size_t i = 0; i < src.size(); i++ )
+                {
+                    ASSERT_EQ(ref[i].type(), dst[i].type());
+                    EXPECT_EQ(0, cvtest::norm(dst[i], ref[i], NORM_INF)) << "flags=" << flags << " size=" << sizes[s];
+                }
+
+                // in-place and non-continuous arrays
+                Mat big(sizes[s].height + 2, sizes[s].width + 2, plan.type()), roi = big(Rect(1, 1, sizes[s].width, sizes[s].height));
+                Mat out, out0;
+                src[0].copyTo(roi);
+                plan.apply(roi, out);
+                dft(roi, out0, flags);
+                EXPECT_EQ(0, cvtest::norm(out, out0, NORM_INF)) << "flags=" << flags << " size=" << sizes[s];
+                if( plan.dstType() == plan.type() )
+                {
+                    plan.apply(src[1], src[1]);
+                    EXPECT_EQ(0, cvtest::norm(src[1], ref[1], NORM_INF)) << "flags=" << flags << " size=" << sizes[s];
+                }
+            }
+}
@@ -0,0 +1,226 @@
+#include "test_precomp.hpp"
+#include "test_intrin_utils.hpp"
+
+namespace cvtest { namespace hal {
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// The 256-bit types share the interface of the 128-bit ones; these checks focus on
+// the operations where the per-128-bit-lane behaviour of AVX2 would leak through.
+void test_hal_intrin_simd256()
+{
+#if CV_SIMD256
+    EXPECT_EQ(32, CV_SIMD_WIDTH);
+    EXPECT_EQ(32, (int)v_uint8::nlanes);
+    EXPECT_EQ(8, (int)v_float32::nlanes);
+
+    CV_DECL_ALIGNED(32) uchar u8[128];
+    CV_DECL_ALIGNED(32) uchar u8out[128];
+    for (int i = 0; i < 128; i++)
+        u8[i] = (uchar)(i * 7 + 3);
+
+    // load / store
+    {
+        v_uint8x32 a = v256_load_aligned(u8);
+        v_store(u8out, a);
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(u8[i], u8out[i]) << "i=" << i;
+
+        v_uint8x32 b = v256_load_low(u8);
+        v_store(u8out, b);
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(i < 16 ? u8[i] : 0, u8out[i]) << "i=" << i;
+
+        v_uint8x32 c = v256_load_halves(u8 + 64, u8);
+        v_store(u8out, c);
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(u8[i < 16 ? i + 64 : i - 16], u8out[i]) << "i=" << i;
+
+        EXPECT_EQ(u8[0], vx_load(u8).get0());
+    }
+
+    // zip, combine
+    {
+        v_uint8x32 a = v256_load(u8), b = v256_load(u8 + 32), c, d;
+        v_zip(a, b, c, d);
+        v_store(u8out, c);
+        v_store(u8out + 32, d);
+        for (int i = 0; i < 32; i++)
+        {
+            EXPECT_EQ(u8[i], u8out[i*2]) << "i=" << i;
+            EXPECT_EQ(u8[i + 32], u8out[i*2 + 1]) << "i=" << i;
+        }
+
+        v_store(u8out, v_combine_low(a, b));
+        v_store(u8out + 32, v_combine_high(a, b));
+        for (int i = 0; i < 16; i++)
+        {
+            EXPECT_EQ(u8[i], u8out[i]);
+            EXPECT_EQ(u8[i + 32], u8out[i + 16]);
+            EXPECT_EQ(u8[i + 16], u8out[i + 32]);
+            EXPECT_EQ(u8[i + 48], u8out[i + 48]);
+        }
+    }
+
+    // extract, rotate
+    {
+        v_uint8x32 a = v256_load(u8), b = v256_load(u8 + 32);
+        v_store(u8out, v_extract<5>(a, b));
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(u8[i + 5], u8out[i]) << "i=" << i;
+        v_store(u8out, v_extract<21>(a, b));
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(u8[i + 21], u8out[i]) << "i=" << i;
+
+        v_store(u8out, v_rotate_right<3>(a));
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(i + 3 < 32 ? u8[i + 3] : 0, u8out[i]) << "i=" << i;
+        v_store(u8out, v_rotate_left<19>(a));
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(i >= 19 ? u8[i - 19] : 0, u8out[i]) << "i=" << i;
+
+        CV_DECL_ALIGNED(32) int s32[16];
+        for (int i = 0; i < 16; i++)
+            s32[i] = i + 1;
+        CV_DECL_ALIGNED(32) int s32out[8];
+        v_store(s32out, v_rotate_left<3>(v256_load(s32 + 8), v256_load(s32)));
+        for (int i = 0; i < 8; i++)
+            EXPECT_EQ(s32[i + 5], s32out[i]) << "i=" << i;
+    }
+
+    // expand, pack
+    {
+        CV_DECL_ALIGNED(32) ushort u16[32];
+        CV_DECL_ALIGNED(32) ushort u16out[16];
+        for (int i = 0; i < 32; i++)
+            u16[i] = (ushort)(i * 97);
+
+        v_uint16x16 e0, e1;
+        v_expand(v256_load(u8), e0, e1);
+        v_store(u16out, e1);
+        for (int i = 0; i < 16; i++)
+            EXPECT_EQ(u8[i + 16], u16out[i]) << "i=" << i;
+        v_store(u16out, vx_load_expand(u8 + 3));
+        for (int i = 0; i < 16; i++)
+            EXPECT_EQ(u8[i + 3], u16out[i]) << "i=" << i;
+
+        v_store(u8out, v_pack(v256_load(u16), v256_load(u16 + 16)));
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(saturate_cast<uchar>(u16[i]), u8out[i]) << "i=" << i;
+
+        v_store(u8out, v_rshr_pack<2>(v256_load(u16), v256_load(u16 + 16)));
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(saturate_cast<uchar>((u16[i] + 2) >> 2), u8out[i]) << "i=" << i;
+
+        CV_DECL_ALIGNED(32) int64 s64[8] = { -1, 2, (int64)1 << 40, -5, 6, 7, -8, 9 };
+        CV_DECL_ALIGNED(32) int s32out[8];
+        v_store(s32out, v_pack(v256_load(s64), v256_load(s64 + 4)));
+        for (int i = 0; i < 8; i++)
+            EXPECT_EQ((int)s64[i], s32out[i]) << "i=" << i;
+
+        CV_DECL_ALIGNED(32) unsigned u32[8] = { 0xffffffff, 1, 2, 3, 0x80000000, 5, 6, 7 };
+        CV_DECL_ALIGNED(32) uint64 u64out[8];
+        v_uint64x4 m0, m1;
+        v_uint32x8 a = v256_load(u32);
+        v_mul_expand(a, a, m0, m1);
+        v_store(u64out, m0);
+        v_store(u64out + 4, m1);
+        for (int i = 0; i < 8; i++)
+            EXPECT_EQ((uint64)u32[i] * u32[i], u64out[i]) << "i=" << i;
+    }
+
+    // interleave
+    {
+        v_uint8x32 a, b, c, d;
+        v_load_deinterleave(u8, a, b);
+        v_store(u8out, b);
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(u8[i*2 + 1], u8out[i]) << "i=" << i;
+        v_store_interleave(u8out, a, b);
+        for (int i = 0; i < 64; i++)
+            EXPECT_EQ(u8[i], u8out[i]) << "i=" << i;
+
+        v_load_deinterleave(u8, a, b, c, d);
+        v_store(u8out, c);
+        for (int i = 0; i < 32; i++)
+            EXPECT_EQ(u8[i*4 + 2], u8out[i]) << "i=" << i;
+        v_store_interleave(u8out, a, b, c, d);
+        for (int i = 0; i < 128; i++)
+            EXPECT_EQ(u8[i], u8out[i]) << "i=" << i;
+
+        CV_DECL_ALIGNED(32) float f32[16];
+        CV_DECL_ALIGNED(32) float f32out[16];
+        for (int i = 0; i < 16; i++)
+            f32[i] = i * 0.5f;
+        v_float32x8 fa, fb;
+        v_load_deinterleave(f32, fa, fb);
+        v_store(f32out, fa);
+        for (int i = 0; i < 8; i++)
+            EXPECT_EQ(f32[i*2], f32out[i]) << "i=" << i;
+    }
+
+    // reductions, popcount, masks
+    {
+        int ref = 0;
+        for (int i = 0; i < 32; i++)
+        {
+            uchar v = u8[i];
+            for (; v; v &= v - 1)
+                ref++;
+        }
+        EXPECT_EQ(ref, (int)v_reduce_sum(v_popcount(v256_load(u8))));
+
+        CV_DECL_ALIGNED(32) short s16[16];
+        for (int i = 0; i < 16; i++)
+            s16[i] = (short)(i == 11 ? -100 : i * 3);
+        v_int16x16 a = v256_load(s16);
+        EXPECT_EQ(-100, v_reduce_min(a));
+        EXPECT_EQ(45, v_reduce_max(a));
+        EXPECT_EQ(1 << 11, v_signmask(a));
+        EXPECT_TRUE(v_check_any(a));
+        EXPECT_FALSE(v_check_all(a));
+        EXPECT_TRUE(v_check_all(a < v256_setall_s16(100)));
+
+        v_float32x8 f(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f);
+        EXPECT_EQ(36.f, v_reduce_sum(f));
+        EXPECT_EQ(8.f, v_reduce_max(f));
+        EXPECT_EQ(0x70, v_signmask((f > v256_setall_f32(4.5f)) & (f < v256_setall_f32(7.5f))));
+
+        v_float32x4 s = v_reduce_sum4(f, f * f, v256_setall_f32(1.f), v256_setzero_f32());
+        CV_DECL_ALIGNED(16) float sums[4];
+        v_store(sums, s);
+        EXPECT_EQ(36.f, sums[0]);
+        EXPECT_EQ(204.f, sums[1]);
+        EXPECT_EQ(8.f, sums[2]);
+        EXPECT_EQ(0.f, sums[3]);
+
+        v_uint32x8 u(0x80000000u, 1, 2, 3, 4, 5, 6, 7);
+        EXPECT_EQ(1, v_signmask(u > v256_setall_u32(7)));
+    }
+
+    // conversions
+    {
+        v_float64x4 d(1.4, -2.6, 3.5, 100.);
+        CV_DECL_ALIGNED(32) int s32out[8];
+        v_store(s32out, v_round(d));
+        EXPECT_EQ(1, s32out[0]);
+        EXPECT_EQ(-3, s32out[1]);
+        EXPECT_EQ(4, s32out[2]);
+        EXPECT_EQ(100, s32out[3]);
+        for (int i = 4; i < 8; i++)
+            EXPECT_EQ(0, s32out[i]);
+
+        v_store(s32out, v_floor(v_float32x8(1.5f, -1.5f, 2.f, -2.f, 0.1f, -0.1f, 7.9f, -7.9f)));
+        const int floors[] = { 1, -2, 2, -2, 0, -1, 7, -8 };
+        for (int i = 0; i < 8; i++)
+            EXPECT_EQ(floors[i], s32out[i]) << "i=" << i;
+
+        CV_DECL_ALIGNED(32) double f64out[4];
+        v_store(f64out, v_cvt_f64_high(v_int32x8(0, 1, 2, 3, 4, 5, 6, 7)));
+        for (int i = 0; i < 4; i++)
+            EXPECT_EQ(i + 4., f64out[i]);
+    }
+#endif
+}
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+}} // namespace
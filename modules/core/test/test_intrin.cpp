@@ -6,6 +6,8 @@
 #define CV_CPU_SIMD_FILENAME "test_intrin_utils.hpp"
 #define CV_CPU_DISPATCH_MODE FP16
 #include "opencv2/core/private/cv_cpu_include_simd_declarations.hpp"
+#define CV_CPU_DISPATCH_MODE AVX2
+#include "opencv2/core/private/cv_cpu_include_simd_declarations.hpp"
 
 
 using namespace cv;
@@ -241,4 +243,10 @@ TEST(hal_intrin,float16x4)
     throw SkipTestException("Unsupported hardware: FP16 is not available");
 }
 
+TEST(hal_intrin,simd256)
+{
+    CV_CPU_CALL_AVX2(test_hal_intrin_simd256, ());
+    throw SkipTestException("Unsupported hardware: AVX2 is not available");
+}
+
 }}
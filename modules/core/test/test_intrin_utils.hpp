@@ -4,6 +4,7 @@ namespace cvtest { namespace hal {
 CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
 
 void test_hal_intrin_float16x4();
+void test_hal_intrin_simd256();
 
 #ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
 
@@ -1613,3 +1613,174 @@ TEST(Core_InputOutput, FileStorage_free_file_after_exception)
     }
     ASSERT_EQ(std::remove(fileName.c_str()), 0);
 }
+
+TEST(Core_InputOutput, FileStorage_binary)
+{
+    const std::string fileName = cv::tempfile(".cvbin");
+    RNG& rng = theRNG();
+    Mat m1(37, 51, CV_32FC3), m2;
+    rng.fill(m1, RNG::UNIFORM, -100, 100);
+    int sz[] = { 3, 5, 7 };
+    Mat nd1(3, sz, CV_16S), nd2;
+    rng.fill(nd1, RNG::UNIFORM, -1000, 1000);
+    Mat roi1 = m1(Rect(3, 4, 10, 11)), roi2;
+    std::vector<int> v1, v2;
+    for (int i = 0; i < 10; i++)
+        v1.push_back(i*i - 5);
+
+    {
+        FileStorage fs(fileName, FileStorage::WRITE);
+        ASSERT_TRUE(fs.isOpened());
+        EXPECT_EQ(FileStorage::FORMAT_BINARY, fs.getFormat());
+        fs << "m" << m1 << "nd" << nd1 << "roi" << roi1;
+        fs << "i" << 42 << "d" << 0.25 << "s" << "text";
+        fs << "v" << v1;
+        fs << "map" << "{" << "a" << 1 << "seq" << "[" << 2 << 3.5 << "]" << "}";
+    }
+
+    {
+        FileStorage fs(fileName, FileStorage::READ);
+        ASSERT_TRUE(fs.isOpened());
+        fs["m"] >> m2;
+        fs["nd"] >> nd2;
+        fs["roi"] >> roi2;
+        fs["v"] >> v2;
+        EXPECT_EQ(42, (int)fs["i"]);
+        EXPECT_EQ(0.25, (double)fs["d"]);
+        EXPECT_EQ("text", (std::string)fs["s"]);
+        EXPECT_EQ(1, (int)fs["map"]["a"]);
+        EXPECT_EQ(2, (int)fs["map"]["seq"][0]);
+        EXPECT_EQ(3.5, (double)fs["map"]["seq"][1]);
+        // the matrices are aligned in the file
+        EXPECT_EQ((size_t)0, (size_t)m2.data % 64);
+    }
+    // the matrices refer to the mapped file, which stays valid after the storage is released
+    EXPECT_EQ(0, cvtest::norm(m1, m2, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(nd1, nd2, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(roi1, roi2, NORM_INF));
+    EXPECT_EQ(v1, v2);
+    m2.at<Vec3f>(0, 0) = Vec3f(1, 2, 3);
+
+    {
+        FileStorage fs(".cvbin", FileStorage::WRITE | FileStorage::MEMORY);
+        fs << "m" << m1;
+        std::string buf = fs.releaseAndGetString();
+        FileStorage fs2(buf, FileStorage::READ | FileStorage::MEMORY);
+        ASSERT_TRUE(fs2.isOpened());
+        Mat m3;
+        fs2["m"] >> m3;
+        EXPECT_EQ(0, cvtest::norm(m1, m3, NORM_INF));
+        // the size stored in the header exceeds the buffer
+        std::string truncated = buf.substr(0, buf.size() - 64);
+        EXPECT_THROW(FileStorage(truncated, FileStorage::READ | FileStorage::MEMORY), cv::Exception);
+    }
+
+    {
+        FileStorage fs(fileName, FileStorage::READ);
+        ASSERT_TRUE(fs.isOpened());
+        // the matrices read from the same node do not share the data
+        Mat a, b;
+        fs["m"] >> a;
+        a.at<Vec3f>(0, 0) = Vec3f(1, 2, 3);
+        fs["m"] >> b;
+        EXPECT_NE(a.data, b.data);
+        EXPECT_EQ(0, cvtest::norm(m1, b, NORM_INF));
+
+        // the mapped data can be accessed as a regular sequence
+        FileNode data = fs["nd"]["data"];
+        ASSERT_TRUE(data.isSeq());
+        ASSERT_EQ(nd1.total(), data.size());
+        EXPECT_EQ((int)nd1.ptr<short>()[7], (int)data[7]);
+        size_t i = 0;
+        for (FileNodeIterator it = data.begin(); it != data.end(); ++it, ++i)
+            ASSERT_EQ((int)nd1.ptr<short>()[i], (int)*it) << "i=" << i;
+        EXPECT_EQ(nd1.total(), i);
+        fs["nd"] >> nd2;
+        EXPECT_EQ(0, cvtest::norm(nd1, nd2, NORM_INF));
+    }
+    EXPECT_EQ(0, std::remove(fileName.c_str()));
+}
+
+namespace {
+struct RecordCollector : public FileNodeVisitor
+{
+    RecordCollector() : stopAt(-1), leaves(0) {}
+
+    int select(const String& key, int, int depth)
+    {
+        if( depth == 0 )
+            return key == "records" ? DESCEND : key == "skipped" ? SKIP : VISIT;
+        return VISIT;
+    }
+
+    bool visit(const FileNode& node, const String& key, int index, int depth)
+    {
+        if( depth == 0 )
+        {
+            EXPECT_EQ("title", key);
+            title = (std::string)node;
+            return true;
+        }
+        EXPECT_EQ(1, depth);
+        EXPECT_TRUE(key.empty());
+        EXPECT_EQ((int)ids.size(), index);
+        ids.push_back((int)node["id"]);
+        Mat m;
+        node["m"] >> m;
+        mats.push_back(m);
+        return index != stopAt;
+    }
+
+    void leave(const String& key, int, int depth)
+    {
+        EXPECT_EQ("records", key);
+        EXPECT_EQ(0, depth);
+        leaves++;
+    }
+
+    int stopAt, leaves;
+    std::string title;
+    std::vector<int> ids;
+    std::vector<Mat> mats;
+};
+}
+
+TEST(Core_InputOutput, FileStorage_streaming_reader)
+{
+    const char* exts[] = { ".yml", ".xml", ".json", ".cvbin" };
+    const int N = 50;
+    for( size_t i = 0; i < sizeof(exts)/sizeof(exts[0]); i++ )
+    {
+        SCOPED_TRACE(exts[i]);
+        const std::string fileName = cv::tempfile(exts[i]);
+        {
+            FileStorage fs(fileName, FileStorage::WRITE);
+            fs << "skipped" << "[" << Mat::eye(10, 10, CV_8U) << "{" << "a" << 1 << "}" << "]";
+            fs << "records" << "[";
+            for( int k = 0; k < N; k++ )
+                fs << "{" << "id" << k << "m" << Mat(2, 3, CV_32S, Scalar::all(k)) << "}";
+            fs << "]";
+            fs << "title" << "streamed";
+        }
+
+        RecordCollector all;
+        ASSERT_TRUE(readFileStorage(fileName, all));
+        EXPECT_EQ("streamed", all.title);
+        EXPECT_EQ(1, all.leaves);
+        ASSERT_EQ(N, (int)all.ids.size());
+        for( int k = 0; k < N; k++ )
+        {
+            EXPECT_EQ(k, all.ids[k]);
+            EXPECT_EQ(0, cvtest::norm(all.mats[k], Mat(2, 3, CV_32S, Scalar::all(k)), NORM_INF));
+        }
+
+        RecordCollector some;
+        some.stopAt = 9;
+        ASSERT_TRUE(readFileStorage(fileName, some));
+        EXPECT_EQ(10, (int)some.ids.size());
+        EXPECT_EQ(0, some.leaves);
+        EXPECT_TRUE(some.title.empty());
+
+        EXPECT_EQ(0, std::remove(fileName.c_str()));
+    }
+}
@@ -1,6 +1,11 @@
 #include "test_precomp.hpp"
+#include "opencv2/core/utils/pool_allocator.hpp"
+#include "opencv2/core/utils/shared_allocator.hpp"
 
 #include <map>
+#ifdef CV_CXX11
+#include <thread>
+#endif
 
 using namespace cv;
 using namespace std;
@@ -469,6 +474,78 @@ TEST(Core_PCA, accuracy)
     EXPECT_LE(err, 0) << "bad accuracy of write/load functions (YML)";
 }
 
+static Mat makeLowRankData(int N, int dims, int rank, RNG& rng)
+{
+    Mat coeffs(N, rank, CV_32F), basis(rank, dims, CV_32F), noise(N, dims, CV_32F), mean(1, dims, CV_32F);
+    rng.fill(coeffs, RNG::NORMAL, 0, 1);
+    for( int i = 0; i < rank; i++ )
+        coeffs.col(i) *= 20./(i + 1);
+    rng.fill(basis, RNG::NORMAL, 0, 1);
+    rng.fill(noise, RNG::NORMAL, 0, 0.01);
+    rng.fill(mean, RNG::UNIFORM, -5, 5);
+    return coeffs*basis + noise + repeat(mean, N, 1);
+}
+
+// checks that the subspaces spanned by the rows of two orthonormal bases are close
+static double subspaceError(const Mat& a, const Mat& b)
+{
+    return cvtest::norm(a*b.t()*b, a, NORM_INF);
+}
+
+TEST(Core_PCA, randomized)
+{
+    RNG rng(12345);
+    const int rank = 8;
+    Mat data = makeLowRankData(2000, 300, rank, rng);
+
+    PCA exact(data, noArray(), PCA::DATA_AS_ROW, rank);
+    PCA approx(data, noArray(), PCA::DATA_AS_ROW | PCA::RANDOMIZED, rank);
+
+    ASSERT_EQ(rank, approx.eigenvectors.rows);
+    EXPECT_LE(cvtest::norm(approx.mean, exact.mean, NORM_INF), 1e-4);
+    EXPECT_LE(cvtest::norm(approx.eigenvalues, exact.eigenvalues, NORM_INF | NORM_RELATIVE), 1e-3);
+    EXPECT_LE(subspaceError(exact.eigenvectors, approx.eigenvectors), 1e-3);
+
+    PCA approxCol(data.t(), noArray(), PCA::DATA_AS_COL | PCA::RANDOMIZED, rank);
+    ASSERT_EQ(Size(1, 300), approxCol.mean.size());
+    EXPECT_LE(subspaceError(exact.eigenvectors, approxCol.eigenvectors), 1e-3);
+}
+
+TEST(Core_PCA, incremental)
+{
+    RNG rng(12345);
+    const int rank = 8, N = 2000, batch = 300;
+    Mat data = makeLowRankData(N, 100, rank, rng);
+    PCA exact(data, noArray(), PCA::DATA_AS_ROW, rank);
+
+    PCA inc, incCol;
+    int64 nsamples = 0, nsamplesCol = 0;
+    for( int i = 0; i < N; i += batch )
+    {
+        Mat rows = data.rowRange(i, std::min(i + batch, N));
+        inc.update(rows, PCA::DATA_AS_ROW, nsamples, rank);
+        incCol.update(rows.t(), PCA::DATA_AS_COL, nsamplesCol, rank);
+    }
+
+    EXPECT_EQ(N, nsamples);
+    EXPECT_LE(cvtest::norm(inc.mean, exact.mean, NORM_INF), 1e-4);
+    EXPECT_LE(cvtest::norm(inc.eigenvalues, exact.eigenvalues, NORM_INF | NORM_RELATIVE), 1e-3);
+    EXPECT_LE(subspaceError(exact.eigenvectors, inc.eigenvectors), 1e-3);
+    EXPECT_LE(cvtest::norm(incCol.mean.t(), inc.mean, NORM_INF), 1e-4);
+    EXPECT_LE(subspaceError(inc.eigenvectors, incCol.eigenvectors), 1e-4);
+
+    // all components retained: the result is exact
+    Mat small(500, 10, CV_64F);
+    rng.fill(small, RNG::UNIFORM, -1, 1);
+    PCA exactAll(small, noArray(), PCA::DATA_AS_ROW), incAll(small.rowRange(0, 200), noArray(), PCA::DATA_AS_ROW);
+    int64 nsamplesAll = 200;
+    incAll.update(small.rowRange(200, 500), PCA::DATA_AS_ROW, nsamplesAll);
+    EXPECT_EQ(500, nsamplesAll);
+    EXPECT_LE(cvtest::norm(incAll.mean, exactAll.mean, NORM_INF), 1e-12);
+    EXPECT_LE(cvtest::norm(incAll.eigenvalues, exactAll.eigenvalues, NORM_INF), 1e-10);
+    EXPECT_LE(subspaceError(exactAll.eigenvectors, incAll.eigenvectors), 1e-10);
+}
+
 class Core_ArrayOpTest : public cvtest::BaseTest
 {
 public:
@@ -1163,6 +1240,92 @@ TEST(Core_Array, basic_operations) { Core_ArrayOpTest test; test.safe_run(); }
 TEST(Core_Merge, shape_operations) { Core_MergeTest test; test.safe_run(); }
 TEST(Core_Split, shape_operations) { Core_SplitTest test; test.safe_run(); }
 
+TEST(Core_Split, convert_reorder)
+{
+    RNG& rng = theRNG();
+    const int types[] = { CV_8UC3, CV_8UC4, CV_16UC2, CV_32FC3, CV_64FC1 };
+    const int ddepths[] = { CV_32F, CV_8U, CV_16S, -1 };
+    for( size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++ )
+        for( size_t d = 0; d < sizeof(ddepths)/sizeof(ddepths[0]); d++ )
+            for( int roi = 0; roi < 2; roi++ )
+            {
+                int type = types[t], cn = CV_MAT_CN(type), ddepth = ddepths[d];
+                SCOPED_TRACE(cv::format("type=%d ddepth=%d roi=%d", type, ddepth, roi));
+                Mat big(301, 1203, type), src = roi ? big(Rect(3, 1, 1100, 300)) : big;
+                rng.fill(big, RNG::UNIFORM, 0, 256);
+
+                std::vector<int> order;
+                for( int j = 0; j < std::min(cn + 1, 4); j++ )
+                    order.push_back((cn - 1 - j + cn) % cn);
+                Scalar scale(0.5, 1, 2, 1./255), shift(-10, 0, 3, 0.25);
+
+                std::vector<Mat> dst, planes;
+                splitConvert(src, dst, ddepth, order, scale, shift);
+                split(src, planes);
+                ASSERT_EQ(order.size(), dst.size());
+                for( size_t j = 0; j < order.size(); j++ )
+                {
+                    Mat ref;
+                    planes[order[j]].convertTo(ref, ddepth, scale[(int)j], shift[(int)j]);
+                    ASSERT_EQ(ref.type(), dst[j].type());
+                    EXPECT_LE(cvtest::norm(ref, dst[j], NORM_INF), 1e-5) << "j=" << j;
+                }
+
+                // the default order and no conversion is the plain split
+                splitConvert(src, dst, -1);
+                ASSERT_EQ((size_t)cn, dst.size());
+                for( int j = 0; j < cn; j++ )
+                    EXPECT_EQ(0, cvtest::norm(planes[j], dst[j], NORM_INF)) << "j=" << j;
+            }
+}
+
+TEST(Core_Merge, convert_reorder)
+{
+    RNG& rng = theRNG();
+    const int depths[] = { CV_8U, CV_16S, CV_32F };
+    for( size_t d = 0; d < sizeof(depths)/sizeof(depths[0]); d++ )
+        for( int n = 1; n <= 4; n++ )
+        {
+            int depth = depths[d];
+            SCOPED_TRACE(cv::format("depth=%d n=%d", depth, n));
+            std::vector<Mat> src(3);
+            Mat big(260, 700, depth);
+            for( int k = 0; k < 3; k++ )
+            {
+                src[k].create(250, 640 + k, depth);
+                rng.fill(src[k], RNG::UNIFORM, 0, 200);
+                src[k] = src[k].colRange(k, 640 + k);
+            }
+            src[2] = big(Rect(5, 5, 640, 250));
+            rng.fill(src[2], RNG::UNIFORM, 0, 200);
+
+            std::vector<int> order;
+            for( int j = 0; j < n; j++ )
+                order.push_back(2 - j % 3);
+            Scalar scale(1./255, 1, -1, 2), shift(0.5, 0, 100, -1);
+
+            Mat dst;
+            mergeConvert(src, dst, CV_32F, order, scale, shift);
+            ASSERT_EQ(CV_MAKETYPE(CV_32F, n), dst.type());
+            ASSERT_EQ(src[0].size(), dst.size());
+
+            std::vector<Mat> planes;
+            for( int j = 0; j < n; j++ )
+            {
+                Mat p;
+                src[order[j]].convertTo(p, CV_32F, scale[j], shift[j]);
+                planes.push_back(p);
+            }
+            Mat ref;
+            merge(planes, ref);
+            EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1e-4);
+
+            mergeConvert(src, dst, -1);
+            merge(src, ref);
+            EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+        }
+}
+
 
 TEST(Core_IOArray, submat_assignment)
 {
@@ -1754,3 +1917,204 @@ TEST(Mat_, template_based_ptr)
 }
 
 #endif
+
+TEST(Mat, pool_allocator_reuse)
+{
+    MatAllocator* pool = cv::utils::getPoolMatAllocator();
+    BufferPoolController* c = pool->getBufferPoolController();
+    c->freeAllReservedBuffers();
+
+    const uchar* data = NULL;
+    utils::PoolAllocatorStats stats0 = utils::getPoolMatAllocatorStats();
+    {
+        Mat m;
+        m.allocator = pool;
+        m.create(480, 640, CV_8UC3);
+        data = m.data;
+        m.setTo(Scalar::all(7));
+    }
+    EXPECT_GE(c->getReservedSize(), (size_t)480*640*3);
+    {
+        Mat m;
+        m.allocator = pool;
+        m.create(479, 641, CV_8UC3); // same size class
+        EXPECT_EQ(data, m.data);
+        m.setTo(Scalar::all(1));
+        EXPECT_EQ(1, m.at<Vec3b>(478, 640)[2]);
+    }
+    utils::PoolAllocatorStats stats1 = utils::getPoolMatAllocatorStats();
+    EXPECT_EQ(stats0.requests + 2, stats1.requests);
+    EXPECT_EQ(stats0.threadCacheHits + 1, stats1.threadCacheHits);
+    EXPECT_GT(stats1.hitRate(), 0.);
+
+    c->freeAllReservedBuffers();
+    EXPECT_EQ((size_t)0, c->getReservedSize());
+    EXPECT_EQ((size_t)0, utils::getPoolMatAllocatorStats().retainedBytes);
+}
+
+TEST(Mat, pool_allocator_limit)
+{
+    MatAllocator* pool = cv::utils::getPoolMatAllocator();
+    BufferPoolController* c = pool->getBufferPoolController();
+    c->freeAllReservedBuffers();
+    size_t maxReserved = c->getMaxReservedSize();
+    c->setMaxReservedSize(1024*1024);
+
+    // the thread cache has room for all the buffers, the limit is shared with the pool
+    {
+        std::vector<Mat> m(4);
+        for (size_t i = 0; i < m.size(); i++)
+        {
+            m[i].allocator = pool;
+            m[i].create(512, 1024, CV_8UC1);
+        }
+    }
+    utils::PoolAllocatorStats stats = utils::getPoolMatAllocatorStats();
+    EXPECT_EQ((size_t)1024*1024, stats.retainedBytes);
+    EXPECT_EQ((size_t)0, stats.globalPoolBytes);
+    EXPECT_EQ(stats.retainedBytes, c->getReservedSize());
+
+    // lowering the limit trims the thread caches too
+    c->setMaxReservedSize(600*1024);
+    EXPECT_EQ((size_t)512*1024, c->getReservedSize());
+    c->setMaxReservedSize(0);
+    EXPECT_EQ((size_t)0, c->getReservedSize());
+
+    c->setMaxReservedSize(maxReserved);
+    c->freeAllReservedBuffers();
+}
+
+#ifdef CV_CXX11
+TEST(Mat, pool_allocator_cross_thread)
+{
+    MatAllocator* pool = cv::utils::getPoolMatAllocator();
+    BufferPoolController* c = pool->getBufferPoolController();
+    c->freeAllReservedBuffers();
+    size_t maxReserved = c->getMaxReservedSize();
+    c->setMaxReservedSize(64*1024*1024);
+
+    // buffers are allocated and released by different threads
+    std::vector<Mat> frames(16);
+    parallel_for_(Range(0, (int)frames.size()), [&](const Range& r)
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            frames[i].allocator = pool;
+            frames[i].create(720, 1280, CV_8UC1);
+            frames[i].setTo(Scalar::all(i));
+        }
+    });
+    for (int iter = 0; iter < 3; iter++)
+    {
+        parallel_for_(Range(0, (int)frames.size()), [&](const Range& r)
+        {
+            for (int i = r.start; i < r.end; i++)
+            {
+                EXPECT_EQ(i, frames[i].at<uchar>(719, 1279));
+                frames[i].release();
+                frames[i].allocator = pool;
+                frames[i].create(720, 1280, CV_8UC1);
+                frames[i].setTo(Scalar::all(i));
+            }
+        });
+    }
+    frames.clear();
+    EXPECT_LE(utils::getPoolMatAllocatorStats().globalPoolBytes, (size_t)64*1024*1024);
+
+    c->setMaxReservedSize(0);
+    EXPECT_EQ((size_t)0, utils::getPoolMatAllocatorStats().globalPoolBytes);
+    c->setMaxReservedSize(maxReserved);
+    c->freeAllReservedBuffers();
+    EXPECT_EQ((size_t)0, c->getReservedSize());
+}
+#endif
+
+#if defined CV_CXX11 && !defined WINRT
+TEST(Mat, pool_allocator_thread_exit)
+{
+    MatAllocator* pool = cv::utils::getPoolMatAllocator();
+    BufferPoolController* c = pool->getBufferPoolController();
+    c->freeAllReservedBuffers();
+
+    const size_t frameSize = 720*1280;
+    std::thread t([&]()
+    {
+        Mat m;
+        m.allocator = pool;
+        m.create(720, 1280, CV_8UC1);
+        m.setTo(Scalar::all(3));
+    });
+    t.join();
+
+    // the cache of the exited thread has been moved into the shared pool
+    utils::PoolAllocatorStats stats0 = utils::getPoolMatAllocatorStats();
+    EXPECT_GE(stats0.globalPoolBytes, frameSize);
+    EXPECT_EQ(stats0.globalPoolBytes, stats0.retainedBytes);
+    {
+        Mat m;
+        m.allocator = pool;
+        m.create(720, 1280, CV_8UC1);
+    }
+    EXPECT_EQ(stats0.globalPoolHits + 1, utils::getPoolMatAllocatorStats().globalPoolHits);
+
+    c->freeAllReservedBuffers();
+    EXPECT_EQ((size_t)0, c->getReservedSize());
+}
+#endif
+
+#if (defined __unix__ || defined __APPLE__) && !defined __ANDROID__ && !defined __EMSCRIPTEN__
+TEST(Mat, shared_allocator_export_import)
+{
+    utils::SharedMatHandle h;
+    {
+        Mat m;
+        m.allocator = utils::getSharedMatAllocator();
+        m.create(480, 640, CV_8UC3);
+        m.setTo(Scalar(1, 2, 3));
+        h = utils::exportSharedMat(m(Rect(10, 20, 100, 50)));
+    }
+    // the segment is kept by the handle after the matrix has been released
+    Mat roi = utils::importSharedMat(h);
+    ASSERT_EQ(Size(100, 50), roi.size());
+    ASSERT_EQ(CV_8UC3, roi.type());
+    EXPECT_EQ((size_t)640*3, roi.step[0]);
+    EXPECT_EQ(Vec3b(1, 2, 3), roi.at<Vec3b>(49, 99));
+
+    // another mapping of the same memory
+    Mat roi2 = utils::importSharedMat(utils::exportSharedMat(roi));
+    EXPECT_NE(roi.data, roi2.data);
+    roi2.setTo(Scalar::all(7));
+    EXPECT_EQ(Vec3b(7, 7, 7), roi.at<Vec3b>(0, 0));
+
+    // the reference of the handle has been passed to roi, the segment is removed with the last mapping
+    utils::SharedMatHandle h2 = utils::exportSharedMat(roi);
+    roi.release();
+    roi2.release();
+    utils::releaseSharedMatHandle(h2);
+    EXPECT_ANY_THROW(utils::importSharedMat(h));
+}
+
+TEST(Mat, shared_allocator_ring)
+{
+    utils::SharedMatRing ring(2, Size(64, 48), CV_32FC1);
+    ASSERT_EQ(2, ring.frames());
+
+    Mat f0 = ring.acquire(), f1 = ring.acquire();
+    ASSERT_FALSE(f0.empty());
+    ASSERT_FALSE(f1.empty());
+    EXPECT_NE(f0.data, f1.data);
+    EXPECT_EQ(Size(64, 48), f1.size());
+    EXPECT_TRUE(ring.acquire().empty());
+
+    // a frame exported to another process is not reused until that process releases it
+    utils::SharedMatHandle h = utils::exportSharedMat(f0);
+    const uchar* data0 = f0.data;
+    f0.release();
+    EXPECT_TRUE(ring.acquire().empty());
+    Mat consumer = utils::importSharedMat(h);
+    EXPECT_TRUE(ring.acquire().empty());
+    consumer.release();
+    f0 = ring.acquire();
+    EXPECT_EQ(data0, f0.data);
+}
+#endif
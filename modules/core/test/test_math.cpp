@@ -2783,6 +2783,143 @@ TEST(Core_SVD, flt)
     EXPECT_LE(cvtest::norm(B1, B, NORM_L2 + NORM_RELATIVE), FLT_EPSILON*10);
 }
 
+TEST(Core_GEMM, large_blocked)
+{
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 16; iter++)
+    {
+        int type = iter % 2 == 0 ? CV_32F : CV_64F;
+        int flags = (iter/2) % 8;
+        // not multiples of the block sizes
+        int m = 131 + iter, n = 203 - iter, k = 389 + iter*3;
+        Mat A = (flags & GEMM_1_T) ? Mat(k, m, type) : Mat(m, k, type);
+        Mat B = (flags & GEMM_2_T) ? Mat(n, k, type) : Mat(k, n, type);
+        Mat C = (flags & GEMM_3_T) ? Mat(n, m, type) : Mat(m, n, type);
+        rng.fill(A, RNG::UNIFORM, -1, 1);
+        rng.fill(B, RNG::UNIFORM, -1, 1);
+        rng.fill(C, RNG::UNIFORM, -1, 1);
+        double alpha = 0.5 + iter, beta = iter % 3 == 0 ? 0. : -1.5;
+
+        Mat D, D0;
+        gemm(A, B, alpha, C, beta, D, flags);
+        cvtest::gemm(A, B, alpha, C, beta, D0, flags);
+        EXPECT_LE(cvtest::norm(D, D0, NORM_INF + NORM_RELATIVE), type == CV_32F ? 1e-5 : 1e-12)
+            << "type=" << type << " flags=" << flags;
+    }
+}
+
+TEST(Core_GEMM, large_blocked_inplace_accumulate)
+{
+    Mat A(300, 257, CV_32F), B(257, 199, CV_32F), D(300, 199, CV_32F);
+    randu(A, -1, 1);
+    randu(B, -1, 1);
+    randu(D, -1, 1);
+    Mat D0;
+    cvtest::gemm(A, B, 1, D, 2, D0, 0);
+    gemm(A, B, 1, D, 2, D, 0);
+    EXPECT_LE(cvtest::norm(D, D0, NORM_INF + NORM_RELATIVE), 1e-5);
+}
+
+TEST(Core_SolveBatch, accuracy)
+{
+    for( int type = CV_32F; type <= CV_64F; type++ )
+    {
+        double eps = type == CV_32F ? 1e-3 : 1e-9;
+        for( int n = 1; n <= 16; n += 3 )
+        {
+            // more right-hand sides than equations for n == 1, the last batch is partial
+            const int N = 37, k = n == 1 ? 5 : 2;
+            Mat A(N, n*n, type), B(N, n*k, type), X, Ainv, mask;
+            randu(A, -1, 1);
+            randu(B, -1, 1);
+            for( int i = 0; i < N; i++ )
+                A.row(i).reshape(1, n) += Mat::eye(n, n, type)*n;
+            // make one system singular
+            A.row(5).setTo(0);
+
+            EXPECT_EQ(1, solveBatch(A, B, X, mask));
+            EXPECT_EQ(1, invertBatch(A, Ainv));
+            ASSERT_EQ(CV_8U, mask.type());
+            for( int i = 0; i < N; i++ )
+            {
+                Mat a = A.row(i).reshape(1, n), b = B.row(i).reshape(1, n);
+                Mat x = X.row(i).reshape(1, n), ainv = Ainv.row(i).reshape(1, n), x0, ainv0;
+                if( i == 5 )
+                {
+                    EXPECT_EQ(0, mask.at<uchar>(i));
+                    EXPECT_EQ(0, countNonZero(x));
+                    EXPECT_EQ(0, countNonZero(ainv));
+                    continue;
+                }
+                EXPECT_EQ(255, mask.at<uchar>(i));
+                solve(a, b, x0, DECOMP_LU);
+                invert(a, ainv0, DECOMP_LU);
+                EXPECT_LE(cvtest::norm(x, x0, NORM_INF), eps) << "type=" << type << " n=" << n << " i=" << i;
+                EXPECT_LE(cvtest::norm(ainv, ainv0, NORM_INF), eps) << "type=" << type << " n=" << n << " i=" << i;
+            }
+        }
+    }
+}
+
+TEST(Core_SVDecompBatch, accuracy)
+{
+    for( int type = CV_32F; type <= CV_64F; type++ )
+    {
+        double eps = type == CV_32F ? 1e-4 : 1e-10;
+        const int N = 29, m = 7, n = 5;
+        Mat A(N, m*n, type), W, U, Vt;
+        randu(A, -1, 1);
+        // rank deficient matrix
+        A.row(3).reshape(1, m).col(1).copyTo(A.row(3).reshape(1, m).col(4));
+
+        SVDecompBatch(A, m, W, U, Vt);
+        ASSERT_EQ(Size(n, N), W.size());
+        ASSERT_EQ(Size(m*n, N), U.size());
+        ASSERT_EQ(Size(n*n, N), Vt.size());
+        for( int i = 0; i < N; i++ )
+        {
+            Mat a = A.row(i).reshape(1, m), w = W.row(i).reshape(1, n);
+            Mat u = U.row(i).reshape(1, m), vt = Vt.row(i).reshape(1, n), w0;
+            SVD::compute(a, w0, SVD::NO_UV);
+            EXPECT_LE(cvtest::norm(w, w0, NORM_INF), eps*10) << "type=" << type << " i=" << i;
+            EXPECT_LE(cvtest::norm(u*Mat::diag(w)*vt, a, NORM_INF), eps) << "type=" << type << " i=" << i;
+            EXPECT_LE(cvtest::norm(vt*vt.t(), Mat::eye(n, n, type), NORM_INF), eps) << "type=" << type << " i=" << i;
+            Mat wd;
+            w.convertTo(wd, CV_64F);
+            for( int j = 1; j < n; j++ )
+                EXPECT_GE(wd.at<double>(j - 1), wd.at<double>(j)) << "type=" << type << " i=" << i;
+        }
+    }
+}
+
+TEST(Core_SolveBatch, matx)
+{
+    RNG& rng = theRNG();
+    std::vector<Matx33d> a(10);
+    std::vector<Matx32d> b(10), x;
+    for( size_t i = 0; i < a.size(); i++ )
+    {
+        rng.fill(a[i], RNG::UNIFORM, -1, 1);
+        a[i] += Matx33d::eye()*3;
+        rng.fill(b[i], RNG::UNIFORM, -1, 1);
+    }
+    EXPECT_EQ(0, solveBatch(a, b, x));
+    ASSERT_EQ(a.size(), x.size());
+    for( size_t i = 0; i < a.size(); i++ )
+        EXPECT_LE(cvtest::norm(a[i]*x[i], b[i], NORM_INF), 1e-12);
+
+    std::vector<Matx33d> ainv;
+    EXPECT_EQ(0, invertBatch(a, ainv));
+    for( size_t i = 0; i < a.size(); i++ )
+        EXPECT_LE(cvtest::norm(a[i]*ainv[i], Matx33d::eye(), NORM_INF), 1e-12);
+
+    std::vector<Vec3d> w;
+    std::vector<Matx33d> u, vt;
+    SVDecompBatch(a, w, u, vt);
+    for( size_t i = 0; i < a.size(); i++ )
+        EXPECT_LE(cvtest::norm(u[i]*Matx33d::diag(w[i])*vt[i], a[i], NORM_INF), 1e-12);
+}
+
 
 // TODO: eigenvv, invsqrt, cbrt, fastarctan, (round, floor, ceil(?)),
 
@@ -2944,6 +3081,52 @@ TEST(Core_KMeans, compactness)
     }
 }
 
+TEST(Core_KMeans, hamerly_matches_lloyd)
+{
+    const int N = 5000, K = 20, dims = 8;
+    RNG& rng = theRNG();
+    Mat data(N, dims, CV_32F), initLabels(N, 1, CV_32S);
+    randu(data, -1, 1);
+    for( int i = 0; i < N; i++ )
+        initLabels.at<int>(i) = rng.uniform(0, K);
+
+    const TermCriteria crit(TermCriteria::COUNT + TermCriteria::EPS, 100, 0);
+    Mat labels0 = initLabels.clone(), labels1 = initLabels.clone(), centers0, centers1;
+    double compactness0 = kmeans(data, K, labels0, crit, 1, KMEANS_USE_INITIAL_LABELS, centers0);
+    double compactness1 = kmeans(data, K, labels1, crit, 1, KMEANS_USE_INITIAL_LABELS | KMEANS_HAMERLY, centers1);
+
+    EXPECT_EQ(0, cvtest::norm(labels0, labels1, NORM_INF));
+    EXPECT_LE(cvtest::norm(centers0, centers1, NORM_INF), 1e-5);
+    EXPECT_NEAR(compactness0, compactness1, compactness0*1e-6);
+}
+
+TEST(Core_KMeans, mini_batch)
+{
+    const int N = 20000, K = 10, dims = 4;
+    RNG& rng = theRNG();
+    Mat means(K, dims, CV_32F), data(N, dims, CV_32F);
+    randu(means, -100, 100);
+    for( int i = 0; i < N; i++ )
+    {
+        randn(data.row(i), 0, 1);
+        data.row(i) += means.row(rng.uniform(0, K));
+    }
+
+    const TermCriteria crit(TermCriteria::COUNT, 50, 0);
+    Mat labels0, labels1, centers0, centers1;
+    double compactness0 = kmeans(data, K, labels0, crit, 3, KMEANS_PP_CENTERS, centers0);
+    double compactness1 = kmeans(data, K, labels1, crit, 3, KMEANS_PP_CENTERS | KMEANS_MINI_BATCH, centers1);
+
+    ASSERT_EQ(N, labels1.rows);
+    ASSERT_EQ(K, centers1.rows);
+    EXPECT_LE(compactness1, compactness0*1.05);
+
+    double expected = 0;
+    for( int i = 0; i < N; i++ )
+        expected += normL2Sqr(data.ptr<float>(i), centers1.ptr<float>(labels1.at<int>(i)), dims);
+    EXPECT_NEAR(expected, compactness1, expected*1e-6);
+}
+
 TEST(CovariationMatrixVectorOfMat, accuracy)
 {
     unsigned int col_problem_size = 8, row_problem_size = 8, vector_size = 16;
@@ -1,4 +1,9 @@
 #include "test_precomp.hpp"
+#include "opencv2/core/utils/buffer_pool.private.hpp"
+#include "opencv2/core/utils/parallel_stats.hpp"
+#ifdef CV_CXX11
+#include <thread>
+#endif
 
 using namespace cv;
 using namespace std;
@@ -154,3 +159,334 @@ TEST(Core_Copy, repeat_regression_8972)
                          repeat(src, 5, 1, src);
                      });
 }
+
+TEST(Core_CPUBufferPool, stack_reuse)
+{
+    BufferPoolController* c = getCPUBufferPoolController();
+    size_t maxSize = c->getMaxReservedSize();
+    c->setMaxReservedSize(1024*1024);
+    c->freeAllReservedBuffers();
+
+    const void* p0 = NULL;
+    for (int iter = 0; iter < 4; iter++)
+    {
+        utils::ScratchBuffer<float> a(1000), b(5000);
+        ASSERT_TRUE((float*)a != NULL);
+        ASSERT_TRUE((float*)b != NULL);
+        EXPECT_EQ(0u, (size_t)(float*)a % CV_MALLOC_ALIGN);
+        EXPECT_EQ(0u, (size_t)(float*)b % CV_MALLOC_ALIGN);
+        EXPECT_GE((size_t)std::abs((uchar*)(float*)b - (uchar*)(float*)a), 1000*sizeof(float));
+        memset((float*)a, 0, 1000*sizeof(float));
+        memset((float*)b, 0, 5000*sizeof(float));
+        // the arena grows during the first calls, then it is reused
+        if (iter == 2)
+        {
+            p0 = (float*)a;
+        }
+        else if (iter == 3)
+        {
+            EXPECT_EQ(p0, (float*)a);
+        }
+    }
+    EXPECT_GT(c->getReservedSize(), (size_t)0);
+
+    {
+        // release out of order
+        utils::ScratchBuffer<uchar> a(100), b(200), d(300);
+        b.deallocate();
+        utils::ScratchBuffer<uchar> e(50);
+        EXPECT_GT((uchar*)e, (uchar*)d);
+        a.deallocate();
+    }
+
+    {
+        // blocks larger than the pool limit are served by the heap
+        utils::ScratchBuffer<uchar> big(2*1024*1024);
+        big[2*1024*1024 - 1] = 1;
+    }
+
+    c->freeAllReservedBuffers();
+    EXPECT_EQ((size_t)0, c->getReservedSize());
+    c->setMaxReservedSize(maxSize);
+}
+
+#ifdef CV_CXX11
+TEST(Core_CPUBufferPool, total_limit_and_thread_exit)
+{
+    BufferPoolController* c = getCPUBufferPoolController();
+    size_t maxSize = c->getMaxReservedSize();
+    c->freeAllReservedBuffers();
+    c->setMaxReservedSize(1024*1024);
+
+    {
+        // the arenas of all threads together are bounded by the limit
+        utils::ScratchBuffer<uchar> warmup(600*1024);
+    }
+    {
+        utils::ScratchBuffer<uchar> a(600*1024);
+        EXPECT_LE(c->getReservedSize(), (size_t)1024*1024);
+        std::thread t([&]()
+        {
+            for (int iter = 0; iter < 2; iter++)
+            {
+                utils::ScratchBuffer<uchar> b(600*1024);
+                b[600*1024 - 1] = 1;
+                EXPECT_LE(c->getReservedSize(), (size_t)1024*1024);
+            }
+        });
+        t.join();
+    }
+
+    // the arena of the exited thread is freed
+    c->setMaxReservedSize(4*1024*1024);
+    size_t reserved0 = c->getReservedSize();
+    std::thread t([&]()
+    {
+        for (int iter = 0; iter < 2; iter++)
+        {
+            utils::ScratchBuffer<uchar> b(1024*1024);
+            b[1024*1024 - 1] = 1;
+        }
+        EXPECT_GE(c->getReservedSize(), reserved0 + 1024*1024);
+    });
+    t.join();
+    EXPECT_EQ(reserved0, c->getReservedSize());
+
+    c->freeAllReservedBuffers();
+    EXPECT_EQ((size_t)0, c->getReservedSize());
+    c->setMaxReservedSize(maxSize);
+}
+#endif
+
+namespace {
+
+class NestedSumLoopBody : public ParallelLoopBody
+{
+public:
+    NestedSumLoopBody(Mat& _dst, bool _nested) : dst(_dst), nested(_nested) {}
+
+    void operator()(const Range& r) const
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            if (nested)
+            {
+                Mat row = dst.row(i);
+                parallel_for_(Range(0, dst.cols), NestedSumLoopBody(row, false));
+            }
+            else
+            {
+                dst.at<int>(0, i) += i + 1;
+            }
+        }
+    }
+
+protected:
+    mutable Mat dst;
+    bool nested;
+};
+
+class ThrowingLoopBody : public ParallelLoopBody
+{
+public:
+    ThrowingLoopBody(bool _stdException) : stdException(_stdException) {}
+
+    void operator()(const Range& r) const
+    {
+        if (r.start <= 50 && 50 < r.end)
+        {
+            if (stdException)
+                throw std::runtime_error("stripe 50");
+            CV_Error(Error::StsBadArg, "stripe 50");
+        }
+    }
+
+protected:
+    bool stdException;
+};
+
+class SetNumThreadsLoopBody : public ParallelLoopBody
+{
+public:
+    SetNumThreadsLoopBody(Mat& _dst, int _nthreads) : dst(_dst), nthreads(_nthreads) {}
+
+    void operator()(const Range& r) const
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            if (i == 0)
+                setNumThreads(nthreads);
+            dst.at<int>(0, i) += i + 1;
+        }
+    }
+
+protected:
+    mutable Mat dst;
+    int nthreads;
+};
+
+} // namespace
+
+TEST(Core_Parallel, nested_parallel_for)
+{
+    Mat dst(37, 1001, CV_32S, Scalar::all(0));
+    parallel_for_(Range(0, dst.rows), NestedSumLoopBody(dst, true));
+    for (int i = 0; i < dst.rows; i++)
+        for (int j = 0; j < dst.cols; j++)
+            ASSERT_EQ(j + 1, dst.at<int>(i, j)) << "i=" << i << " j=" << j;
+}
+
+TEST(Core_Parallel, exception_is_propagated)
+{
+    int nthreads = getNumThreads();
+    setNumThreads(4);
+    EXPECT_THROW(parallel_for_(Range(0, 100), ThrowingLoopBody(false)), cv::Exception);
+    try
+    {
+        parallel_for_(Range(0, 100), ThrowingLoopBody(true));
+        ADD_FAILURE() << "no exception";
+    }
+    catch (const std::exception& e)
+    {
+        EXPECT_NE(std::string::npos, std::string(e.what()).find("stripe 50")) << e.what();
+    }
+    // the pool remains usable
+    Mat dst(1, 1000, CV_32S, Scalar::all(0));
+    parallel_for_(Range(0, dst.cols), NestedSumLoopBody(dst, false));
+    EXPECT_EQ(1000, dst.at<int>(0, 999));
+    setNumThreads(nthreads);
+}
+
+TEST(Core_Parallel, set_num_threads_from_loop_body)
+{
+    const char* framework = currentParallelFramework();
+    if (!framework || std::string(framework) != "workstealing")
+        throw cvtest::SkipTestException("the thread pool can be resized from a loop body by the work-stealing backend only");
+    int nthreads = getNumThreads();
+    setNumThreads(4);
+    Mat dst(1, 1000, CV_32S, Scalar::all(0));
+    parallel_for_(Range(0, dst.cols), SetNumThreadsLoopBody(dst, 2));
+    // the new number of threads is applied by the next call
+    EXPECT_EQ(2, getNumThreads());
+    parallel_for_(Range(0, dst.cols), NestedSumLoopBody(dst, false));
+    for (int i = 0; i < dst.cols; i++)
+        ASSERT_EQ(2*(i + 1), dst.at<int>(0, i)) << "i=" << i;
+    setNumThreads(nthreads);
+}
+
+namespace {
+
+class StatsLoopBody : public ParallelLoopBody
+{
+public:
+    StatsLoopBody(Mat& _dst) : dst(_dst) {}
+
+    void operator()(const Range& r) const
+    {
+        for (int i = r.start; i < r.end; i++)
+            cv::sqrt(dst.row(i), dst.row(i));
+    }
+
+protected:
+    mutable Mat dst;
+};
+
+const utils::ParallelForStats* findParallelForSite(const std::vector<utils::ParallelForStats>& stats, const std::string& name)
+{
+    for (size_t i = 0; i < stats.size(); i++)
+        if (stats[i].site.find(name) != String::npos)
+            return &stats[i];
+    return NULL;
+}
+
+} // namespace
+
+TEST(Core_Parallel, stats_and_autotuning)
+{
+    if (!currentParallelFramework())
+        throw cvtest::SkipTestException("no parallel framework");
+    bool statsEnabled = utils::isParallelForStatsEnabled(), autoTuning = utils::isParallelForAutoTuning();
+    utils::setParallelForStatsEnabled(true);
+    utils::setParallelForAutoTuning(true);
+    utils::resetParallelForStats();
+    // the statistics are collected for the calls that run in parallel only
+    int nthreads = getNumThreads();
+    setNumThreads(4);
+
+    Mat dst(256, 1024, CV_32F, Scalar::all(1));
+    for (int iter = 0; iter < 20; iter++)
+        parallel_for_(Range(0, dst.rows), StatsLoopBody(dst));
+
+    const utils::ParallelForStats* s = findParallelForSite(utils::getParallelForStats(), "StatsLoopBody");
+    ASSERT_TRUE(s != NULL);
+    EXPECT_EQ(20, s->calls);
+    EXPECT_GT(s->stripes, 20);
+    EXPECT_GT(s->wallTime, 0.);
+    EXPECT_GT(s->busyTime, 0.);
+    EXPECT_GE(s->maxThreads, 1);
+    EXPECT_GE(s->imbalance, 1.);
+    // 6 candidates are measured on 3 calls each
+    EXPECT_GT(s->tunedStripes, 0);
+
+    utils::resetParallelForStats();
+    EXPECT_TRUE(findParallelForSite(utils::getParallelForStats(), "StatsLoopBody") == NULL);
+
+    setNumThreads(nthreads);
+    utils::setParallelForStatsEnabled(statsEnabled);
+    utils::setParallelForAutoTuning(autoTuning);
+}
+
+TEST(Core_Parallel, stats_call_sites)
+{
+    if (!currentParallelFramework())
+        throw cvtest::SkipTestException("no parallel framework");
+    bool statsEnabled = utils::isParallelForStatsEnabled();
+    utils::setParallelForStatsEnabled(true);
+    utils::resetParallelForStats();
+    int nthreads = getNumThreads();
+    setNumThreads(4);
+
+    // the same loop body type called from two places
+    Mat dst(64, 256, CV_32F, Scalar::all(1));
+    parallel_for_(Range(0, dst.rows), StatsLoopBody(dst));
+    for (int iter = 0; iter < 2; iter++)
+        parallel_for_(Range(0, dst.rows), StatsLoopBody(dst));
+    {
+        utils::ParallelForSiteName site("Core_Parallel.named_site");
+        for (int iter = 0; iter < 3; iter++)
+            parallel_for_(Range(0, dst.rows), StatsLoopBody(dst));
+    }
+
+    std::vector<utils::ParallelForStats> stats = utils::getParallelForStats();
+    std::vector<int64> calls;
+    for (size_t i = 0; i < stats.size(); i++)
+        if (stats[i].site.find("StatsLoopBody") != String::npos)
+            calls.push_back(stats[i].calls);
+    ASSERT_EQ(2u, calls.size());
+    EXPECT_EQ(1, std::min(calls[0], calls[1]));
+    EXPECT_EQ(2, std::max(calls[0], calls[1]));
+
+    const utils::ParallelForStats* named = findParallelForSite(stats, "Core_Parallel.named_site");
+    ASSERT_TRUE(named != NULL);
+    EXPECT_EQ(3, named->calls);
+
+#ifdef CV_CXX11
+    // lambdas go through the same wrapper, every call expression is a site of its own
+    utils::resetParallelForStats();
+    parallel_for_(Range(0, dst.rows), [&](const Range& r) { Mat rows = dst.rowRange(r); rows += 1; });
+    for (int iter = 0; iter < 2; iter++)
+        parallel_for_(Range(0, dst.rows), [&](const Range& r) { Mat rows = dst.rowRange(r); rows -= 1; });
+    stats = utils::getParallelForStats();
+    calls.clear();
+    for (size_t i = 0; i < stats.size(); i++)
+        if (stats[i].site.find("LambdaWrapper") != String::npos)
+            calls.push_back(stats[i].calls);
+    ASSERT_EQ(2u, calls.size());
+    EXPECT_EQ(1, std::min(calls[0], calls[1]));
+    EXPECT_EQ(2, std::max(calls[0], calls[1]));
+#endif
+
+    utils::resetParallelForStats();
+    setNumThreads(nthreads);
+    utils::setParallelForStatsEnabled(statsEnabled);
+}
@@ -1363,6 +1363,95 @@ INSTANTIATE_TEST_CASE_P(Core, sortIdx, Combine(
 ));
 
 
+TEST(Core_MatExpr, fused_linear_combination)
+{
+    RNG& rng = theRNG();
+    Size sz(641, 480);
+    const int types[] = { CV_32FC1, CV_32FC3, CV_64FC1, CV_64FC2 };
+    for( size_t k = 0; k < sizeof(types)/sizeof(types[0]); k++ )
+    {
+        int type = types[k];
+        SCOPED_TRACE(cv::format("type=%d", type));
+        Mat a(sz, type), b(sz, type), c(sz, type);
+        rng.fill(a, RNG::UNIFORM, 0, 255);
+        rng.fill(b, RNG::UNIFORM, 0, 255);
+        rng.fill(c, RNG::UNIFORM, 0, 255);
+
+        Mat ad, bd, cd;
+        a.convertTo(ad, CV_64F);
+        b.convertTo(bd, CV_64F);
+        c.convertTo(cd, CV_64F);
+
+        double eps = 1e-3;
+        Mat dst = a*0.5 + b*0.25 - c, ref;
+        Mat refd = ad*0.5 + bd*0.25;
+        refd = refd - cd;
+        refd.convertTo(ref, type);
+        ASSERT_EQ(type, dst.type());
+        EXPECT_LE(cvtest::norm(dst, ref, NORM_INF), eps);
+
+        // scaling and adding a scalar keep the node lazy;
+        // multi-channel arrays are fused only when no scalar is added
+        double delta = CV_MAT_CN(type) == 1 ? 7 : 0;
+        dst = 3*(a + b - c*0.75) + delta;
+        refd = ad + bd;
+        refd = (refd - cd*0.75)*3;
+        refd = refd + delta;
+        refd.convertTo(ref, type);
+        EXPECT_LE(cvtest::norm(dst, ref, NORM_INF), eps);
+
+        // in-place evaluation over a submatrix
+        Mat roi = c(Rect(1, 2, 300, 200));
+        refd = ad(Rect(1, 2, 300, 200)) - bd(Rect(1, 2, 300, 200)) + cd(Rect(1, 2, 300, 200));
+        refd.convertTo(ref, type);
+        roi = a(Rect(1, 2, 300, 200)) - b(Rect(1, 2, 300, 200)) + roi;
+        EXPECT_LE(cvtest::norm(roi, ref, NORM_INF), eps);
+    }
+}
+
+TEST(Core_MatExpr, integer_sums_saturate_every_operator)
+{
+    // integer expressions are not fused, the result of every operator is saturated
+    Mat a8(4, 5, CV_8UC1, Scalar(200)), b8(a8.size(), CV_8UC1, Scalar(200)), c8(a8.size(), CV_8UC1, Scalar(100));
+    Mat dst = a8 + b8 - c8;
+    EXPECT_EQ(0, cvtest::norm(dst, Mat(a8.size(), CV_8UC1, Scalar(155)), NORM_INF));
+    dst = a8 - c8 - b8 + c8;
+    EXPECT_EQ(0, cvtest::norm(dst, c8, NORM_INF));
+
+    Mat a16(4, 5, CV_16UC1, Scalar(60000)), b16(a16.size(), CV_16UC1, Scalar(30000));
+    dst = a16 + a16 - b16;
+    EXPECT_EQ(0, cvtest::norm(dst, Mat(a16.size(), CV_16UC1, Scalar(35535)), NORM_INF));
+
+    RNG& rng = theRNG();
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16UC1, CV_16SC1, CV_32SC1 };
+    for( size_t k = 0; k < sizeof(types)/sizeof(types[0]); k++ )
+    {
+        int type = types[k];
+        SCOPED_TRACE(cv::format("type=%d", type));
+        double maxval = CV_MAT_DEPTH(type) == CV_32S ? 1e9 : 65535;
+        Mat a(31, 47, type), b(a.size(), type), c(a.size(), type), t, ref;
+        rng.fill(a, RNG::UNIFORM, 0, maxval);
+        rng.fill(b, RNG::UNIFORM, 0, maxval);
+        rng.fill(c, RNG::UNIFORM, 0, maxval);
+
+        dst = a + b - c;
+        add(a, b, t);
+        subtract(t, c, ref);
+        EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF));
+
+        // the intermediate result is rounded too
+        dst = a*0.5 + b*0.5 - c;
+        addWeighted(a, 0.5, b, 0.5, 0, t);
+        subtract(t, c, ref);
+        EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF));
+
+        dst = 3*(a - b + c) + 7;
+        subtract(a, b, t);
+        addWeighted(t, 3, c, 3, 7, ref);
+        EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF));
+    }
+}
+
 TEST(Core_sortIdx, regression_8941)
 {
     cv::Mat src = (cv::Mat_<int>(3, 3) <<
@@ -1388,4 +1477,150 @@ TEST(Core_sortIdx, regression_8941)
         "expected=" << std::endl << expected;
 }
 
+TEST(Core_Sort, long_rows)
+{
+    RNG& rng = theRNG();
+    const int depths[] = { CV_8U, CV_8S, CV_16U, CV_16S, CV_32S, CV_32F, CV_64F };
+    for( size_t d = 0; d < sizeof(depths)/sizeof(depths[0]); d++ )
+    {
+        for( int order = 0; order < 2; order++ )
+        {
+            int depth = depths[d], flags = order ? SORT_EVERY_ROW + SORT_DESCENDING : SORT_EVERY_COLUMN;
+            SCOPED_TRACE(cv::format("depth=%d flags=%d", depth, flags));
+            Mat src(order ? Size(100003, 2) : Size(3, 5001), depth), srcd, dst, idx, gathered, ref;
+            rng.fill(src, RNG::UNIFORM, -1000, 1000);
+            src.convertTo(srcd, CV_64F);
+
+            cv::sort(src, dst, flags);
+            cv::sortIdx(src, idx, flags);
+            ASSERT_EQ(src.size(), dst.size());
+            ASSERT_EQ(src.size(), idx.size());
+
+            cv::sort(srcd, ref, flags);
+            gathered.create(src.size(), CV_64F);
+            for( int i = 0; i < src.rows; i++ )
+                for( int j = 0; j < src.cols; j++ )
+                {
+                    int k = idx.at<int>(i, j);
+                    gathered.at<double>(i, j) = order ? srcd.at<double>(i, k) : srcd.at<double>(k, j);
+                }
+            Mat dstd;
+            dst.convertTo(dstd, CV_64F);
+            EXPECT_EQ(0, cvtest::norm(dstd, ref, NORM_INF));
+            EXPECT_EQ(0, cvtest::norm(gathered, ref, NORM_INF));
+        }
+    }
+}
+
+struct SortLessIdx
+{
+    SortLessIdx(const std::vector<int>& _arr) : arr(_arr) {}
+    bool operator()(int a, int b) const { return arr[a] < arr[b]; }
+    const std::vector<int>& arr;
+};
+
+TEST(Core_Sort, parallel_chunks)
+{
+    // a single long line is split by the radix sort into chunks processed in parallel
+    int nthreads = getNumThreads();
+    setNumThreads(4);
+    RNG& rng = theRNG();
+    for( int order = 0; order < 2; order++ )
+    {
+        int flags = order ? SORT_EVERY_COLUMN + SORT_DESCENDING : SORT_EVERY_ROW;
+        SCOPED_TRACE(cv::format("flags=%d", flags));
+        Mat src(order ? Size(1, 300007) : Size(300007, 1), CV_32S), dst, idx;
+        rng.fill(src, RNG::UNIFORM, -5000, 5000); // many equal keys check the stability
+        cv::sort(src, dst, flags);
+        cv::sortIdx(src, idx, flags);
+
+        std::vector<int> keys(src.begin<int>(), src.end<int>()), refIdx(keys.size()), ref(keys.size());
+        for( size_t j = 0; j < refIdx.size(); j++ )
+            refIdx[j] = (int)j;
+        std::stable_sort(refIdx.begin(), refIdx.end(), SortLessIdx(keys));
+        if( order )
+            std::reverse(refIdx.begin(), refIdx.end());
+        for( size_t j = 0; j < refIdx.size(); j++ )
+            ref[j] = keys[refIdx[j]];
+
+        EXPECT_EQ(0, cvtest::norm(dst.reshape(1, 1), Mat(ref).reshape(1, 1), NORM_INF));
+        EXPECT_EQ(0, cvtest::norm(idx.reshape(1, 1), Mat(refIdx).reshape(1, 1), NORM_INF));
+    }
+    setNumThreads(nthreads);
+}
+
+struct TopKLessIdx
+{
+    TopKLessIdx(const double* _arr) : arr(_arr) {}
+    bool operator()(int a, int b) const { return arr[a] < arr[b]; }
+    const double* arr;
+};
+
+TEST(Core_TopK, accuracy)
+{
+    RNG& rng = theRNG();
+    const int depths[] = { CV_8U, CV_16S, CV_32S, CV_32F, CV_64F };
+    const Size sizes[] = { Size(7, 5), Size(1000, 17), Size(300003, 1) };
+    for( size_t d = 0; d < sizeof(depths)/sizeof(depths[0]); d++ )
+        for( size_t s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++ )
+            for( int order = 0; order < 4; order++ )
+            {
+                int depth = depths[d];
+                int flags = (order & 1 ? SORT_DESCENDING : SORT_ASCENDING) + (order & 2 ? SORT_EVERY_COLUMN : SORT_EVERY_ROW);
+                Size sz = order & 2 ? Size(sizes[s].height, sizes[s].width) : sizes[s];
+                int len = order & 2 ? sz.height : sz.width;
+                int k = std::min(len, s == 0 ? 3 : 10);
+                SCOPED_TRACE(cv::format("depth=%d size=%dx%d flags=%d k=%d", depth, sz.width, sz.height, flags, k));
+
+                Mat src(sz, depth), values, indices, idx, srcd;
+                rng.fill(src, RNG::UNIFORM, 0, 100);
+                src.convertTo(srcd, CV_64F);
+                cv::topK(src, values, indices, k, flags);
+                ASSERT_EQ(src.type(), values.type());
+                ASSERT_EQ(CV_32SC1, indices.type());
+                ASSERT_EQ(order & 2 ? Size(sz.width, k) : Size(k, sz.height), indices.size());
+
+                // stable sort of the indices gives the expected order of the ties
+                Mat lines = order & 2 ? srcd.t() : srcd;
+                if( order & 2 )
+                {
+                    values = values.t();
+                    indices = indices.t();
+                }
+                Mat valuesd;
+                values.convertTo(valuesd, CV_64F);
+                for( int i = 0; i < lines.rows; i++ )
+                {
+                    const double* ptr = lines.ptr<double>(i);
+                    std::vector<int> ref(len);
+                    for( int j = 0; j < len; j++ )
+                        ref[j] = (order & 1) ? len - 1 - j : j;
+                    std::stable_sort(ref.begin(), ref.end(), TopKLessIdx(ptr));
+                    if( order & 1 )
+                        std::reverse(ref.begin(), ref.end());
+                    for( int j = 0; j < k; j++ )
+                    {
+                        ASSERT_EQ(ref[j], indices.at<int>(i, j)) << "i=" << i << " j=" << j;
+                        ASSERT_EQ(ptr[ref[j]], valuesd.at<double>(i, j)) << "i=" << i << " j=" << j;
+                    }
+                }
+            }
+}
+
+TEST(Core_TopK, nan)
+{
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    Mat src = (Mat_<float>(1, 6) << nan, 3, nan, -1, 2, nan), values, indices;
+
+    cv::topK(src, values, indices, 2, SORT_EVERY_ROW + SORT_DESCENDING);
+    EXPECT_EQ(3.f, values.at<float>(0)); EXPECT_EQ(1, indices.at<int>(0));
+    EXPECT_EQ(2.f, values.at<float>(1)); EXPECT_EQ(4, indices.at<int>(1));
+
+    cv::topK(src, values, indices, 5, SORT_EVERY_ROW + SORT_ASCENDING);
+    int expected[] = { 3, 4, 1, 0, 2 };
+    for( int j = 0; j < 5; j++ )
+        EXPECT_EQ(expected[j], indices.at<int>(j)) << "j=" << j;
+    EXPECT_TRUE(cvIsNaN(values.at<float>(4)));
+}
+
 }} // namespace
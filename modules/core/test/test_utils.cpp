@@ -4,6 +4,10 @@
 
 #include "test_precomp.hpp"
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 using namespace cv;
 
 namespace {
@@ -264,4 +268,108 @@ TEST(AutoBuffer, allocate_test)
     EXPECT_EQ(6u, abuf.size());
 }
 
+#if defined OPENCV_TRACE && defined __linux__
+
+class TraceLoopBody : public ParallelLoopBody
+{
+public:
+    TraceLoopBody(Mat& _dst) : dst(_dst) {}
+
+    void operator()(const Range& r) const
+    {
+        CV_TRACE_REGION("TraceLoopBody");
+        for (int i = r.start; i < r.end; i++)
+            cv::sqrt(dst.row(i), dst.row(i));
+    }
+
+protected:
+    mutable Mat dst;
+};
+
+// checks that the quotes and brackets of JSON text are balanced
+static bool isBalancedJSON(const std::string& text)
+{
+    std::vector<char> stack;
+    bool inString = false;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        char c = text[i];
+        if (inString)
+        {
+            if (c == '\\')
+                i++;
+            else if (c == '"')
+                inString = false;
+            else if ((uchar)c < 0x20)
+                return false;
+        }
+        else if (c == '"')
+            inString = true;
+        else if (c == '{' || c == '[')
+            stack.push_back(c == '{' ? '}' : ']');
+        else if (c == '}' || c == ']')
+        {
+            if (stack.empty() || stack.back() != c)
+                return false;
+            stack.pop_back();
+        }
+    }
+    return !inString && stack.empty();
+}
+
+static int countSubstrings(const std::string& text, const std::string& pattern)
+{
+    int count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+        count++;
+    return count;
+}
+
+TEST(Trace, chrome_format)
+{
+    // the trace configuration is read on startup, so the traced code is run by a child process
+    if (getenv("OPENCV_TEST_TRACE_CHILD"))
+    {
+        setNumThreads(4);
+        CV_TRACE_REGION("chrome_format_test");
+        Mat dst(64, 256, CV_32F, Scalar::all(4));
+        for (int iter = 0; iter < 3; iter++)
+            parallel_for_(Range(0, dst.rows), TraceLoopBody(dst));
+        return;
+    }
+
+    char exe[4096] = {0};
+    ASSERT_GT(readlink("/proc/self/exe", exe, sizeof(exe) - 1), 0);
+    const std::string prefix = cv::tempfile("trace");
+    const std::string cmd = cv::format("OPENCV_TEST_TRACE_CHILD=1 OPENCV_TRACE=1 OPENCV_TRACE_FORMAT=chrome "
+                                       "OPENCV_TRACE_DEPTH_OPENCV=0 OPENCV_TRACE_LOCATION=%s "
+                                       "'%s' --gtest_filter=Trace.chrome_format >/dev/null 2>&1",
+                                       prefix.c_str(), exe);
+    ASSERT_EQ(0, system(cmd.c_str())) << cmd;
+
+    const std::string fileName = prefix + ".json";
+    std::ifstream f(fileName.c_str());
+    ASSERT_TRUE(f.is_open()) << fileName;
+    std::stringstream ss;
+    ss << f.rdbuf();
+    f.close();
+    std::string text = ss.str();
+    EXPECT_EQ(0, std::remove(fileName.c_str()));
+
+    ASSERT_EQ(0u, text.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"));
+    ASSERT_NE(std::string::npos, text.find("\n]}"));
+    EXPECT_TRUE(isBalancedJSON(text));
+    EXPECT_EQ(std::string::npos, text.find(",\n]"));
+    EXPECT_EQ(std::string::npos, text.find(",,"));
+    EXPECT_GE(countSubstrings(text, "\"ph\":\"M\""), 1);
+    EXPECT_EQ(1, countSubstrings(text, "\"name\":\"chrome_format_test\""));
+    EXPECT_GE(countSubstrings(text, "\"name\":\"TraceLoopBody\""), 3);
+    // every region is closed
+    EXPECT_EQ(countSubstrings(text, "\"ph\":\"B\""), countSubstrings(text, "\"ph\":\"E\""));
+    // the flow events come in pairs
+    EXPECT_EQ(countSubstrings(text, "\"ph\":\"s\""), countSubstrings(text, "\"ph\":\"f\""));
+}
+
+#endif
+
 } // namespace
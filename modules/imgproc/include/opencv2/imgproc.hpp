@@ -2888,6 +2888,38 @@ same as src. dst[1] is the next pyramid layer, a smoothed and down-sized src, an
 CV_EXPORTS void buildPyramid( InputArray src, OutputArrayOfArrays dst,
                               int maxlevel, int borderType = BORDER_DEFAULT );
 
+/** @brief Constructs the Gaussian pyramid for an image in a single pass, placing the layers in one buffer.
+
+The layers are the same as the ones computed by the function above, but they are built together:
+the rows of every layer are passed to the next layer as soon as they are computed, so the image is
+read once and the layers are consumed while they are still in the cache. Large images are
+processed in parallel horizontal bands.
+
+All the layers but dst[0] are placed in buf. The buffer is reallocated only when it is too
+small, so when the function is called for a sequence of frames of the same size, the memory is
+reused (and the layers of the previous frame are overwritten).
+@code
+    Mat buf;
+    std::vector<Mat> pyr;
+    for(;;)
+    {
+        cap >> frame;
+        cvtColor(frame, gray, COLOR_BGR2GRAY);
+        buildPyramid(gray, buf, pyr, 3);
+        ...
+    }
+@endcode
+
+@param src Source image. Check pyrDown for the list of supported types.
+@param buf Buffer for the layers. It is a single-row matrix of the src depth.
+@param dst Destination vector of maxlevel+1 images of the same type as src. dst[0] is src, the
+other layers are continuous submatrices of buf.
+@param maxlevel 0-based index of the last (the smallest) pyramid layer. It must be non-negative.
+@param borderType Pixel extrapolation method, see cv::BorderTypes (BORDER_CONSTANT isn't supported)
+ */
+CV_EXPORTS void buildPyramid( InputArray src, Mat& buf, std::vector<Mat>& dst,
+                              int maxlevel, int borderType = BORDER_DEFAULT );
+
 //! @} imgproc_filter
 
 //! @addtogroup imgproc_transform
@@ -3698,6 +3730,30 @@ CV_EXPORTS void HuMoments( const Moments& moments, double hu[7] );
 /** @overload */
 CV_EXPORTS_W void HuMoments( const Moments& m, OutputArray hu );
 
+/** @brief Calculates the moments of all the regions of a labeled image.
+
+The function computes, in a single pass over the image, the same moments as cv::moments does for
+every region \f$\texttt{labels} = l\f$, \f$0 \le l < \texttt{nlabels}\f$, e.g. for the components found
+by connectedComponentsWithStats. The rows of the image are processed in parallel. Pixels with labels
+out of the range are ignored, the moments of the labels missing from the image are zeros.
+
+The spatial moments of a region are accumulated relative to its first pixel, so the central moments
+of small regions far from the origin keep their precision.
+
+@param labels Label image of the CV_32S or CV_16U type.
+@param nlabels Number of labels, e.g. the value returned by connectedComponents.
+@param moments Output moments, moments[l] are the moments of the region labeled l.
+@param weights Optional single-channel image of the same size (8-bit, 16-bit or floating-point)
+whose pixel values weight the pixels of the regions. Without it the regions are treated as binary
+shapes, like in cv::moments with binaryImage=true.
+@param hu Optional output \f$\texttt{nlabels} \times 7\f$ matrix of the CV_64F type, the row l contains
+the Hu invariants of the region labeled l (see HuMoments).
+
+@sa moments, HuMoments, connectedComponentsWithStats
+ */
+CV_EXPORTS void labelMoments( InputArray labels, int nlabels, std::vector<Moments>& moments,
+                              InputArray weights = noArray(), OutputArray hu = noArray() );
+
 //! @} imgproc_shape
 
 //! @addtogroup imgproc_object
@@ -3744,6 +3800,86 @@ not set by default. Currently, only the TM_SQDIFF and TM_CCORR_NORMED methods ar
 CV_EXPORTS_W void matchTemplate( InputArray image, InputArray templ,
                                  OutputArray result, int method, InputArray mask = noArray() );
 
+/** @brief Matches a fixed set of templates against a sequence of images.
+
+matchTemplate computes the spectrum and the statistics of the template on every call. When the same
+templates are searched in many images, e.g. in video frames, TemplateMatcher computes them once and
+keeps them between the calls. The results are the same as the ones of matchTemplate, up to the
+floating-point rounding.
+
+Small templates are correlated with the image directly. Large ones are correlated in the frequency
+domain, by image tiles processed in parallel. When several templates are matched at once, the
+spectrum of each image tile is computed once for all of them.
+@code
+    TemplateMatcher matcher(templ, TM_CCOEFF_NORMED);
+    for(;;)
+    {
+        cap >> frame;
+        matcher.match(frame, result);
+        minMaxLoc(result, 0, &maxVal, 0, &maxLoc);
+        ...
+    }
+@endcode
+ */
+class CV_EXPORTS TemplateMatcher
+{
+public:
+    //! creates an empty matcher, use create() or createBatch() to initialize it
+    TemplateMatcher();
+
+    /** @overload
+    @param templ Searched template, see matchTemplate.
+    @param method Comparison method, see cv::TemplateMatchModes.
+    @param mask Mask of the template, see matchTemplate.
+    */
+    TemplateMatcher(InputArray templ, int method, InputArray mask = noArray());
+
+    /** @brief initializes the matcher for a single template
+
+    The parameters are the same as in the constructor.
+    */
+    void create(InputArray templ, int method, InputArray mask = noArray());
+
+    /** @brief initializes the matcher for a set of templates
+
+    @param templs Searched templates of the same type. Their sizes may be different.
+    @param method Comparison method used for all the templates.
+    @param masks Masks of the templates, one per template, or an empty array.
+    */
+    void createBatch(InputArrayOfArrays templs, int method, InputArrayOfArrays masks = noArray());
+
+    //! returns true if the matcher has not been created
+    bool empty() const;
+
+    //! comparison method the matcher is created for
+    int method() const;
+
+    //! number of the templates
+    int templates() const;
+
+    /** @brief matches the template against an image
+
+    The matcher must be created for a single template.
+    @param image Image where the search is running, of the same type as the template and not
+    smaller than the template.
+    @param result Map of comparison results, see matchTemplate.
+    */
+    void match(InputArray image, OutputArray result) const;
+
+    /** @brief matches all the templates against an image
+
+    @param image Image where the search is running, of the same type as the templates and not
+    smaller than any of them.
+    @param results Vector of the maps of comparison results, one per template.
+    */
+    void matchBatch(InputArray image, OutputArrayOfArrays results) const;
+
+    struct Impl;
+
+protected:
+    Ptr<Impl> p;
+};
+
 //! @}
 
 //! @addtogroup imgproc_shape
@@ -66,10 +66,12 @@ BaseRowFilter::~BaseRowFilter() {}
 BaseColumnFilter::BaseColumnFilter() { ksize = anchor = -1; }
 BaseColumnFilter::~BaseColumnFilter() {}
 void BaseColumnFilter::reset() {}
+Ptr<BaseColumnFilter> BaseColumnFilter::clone() const { return Ptr<BaseColumnFilter>(); }
 
 BaseFilter::BaseFilter() { ksize = Size(-1,-1); anchor = Point(-1,-1); }
 BaseFilter::~BaseFilter() {}
 void BaseFilter::reset() {}
+Ptr<BaseFilter> BaseFilter::clone() const { return Ptr<BaseFilter>(); }
 
 FilterEngine::FilterEngine()
     : srcType(-1), dstType(-1), bufType(-1), maxWidth(0), wholeSize(-1, -1), dx1(0), dx2(0),
@@ -381,12 +383,92 @@ int FilterEngine::proceed( const uchar* src, int srcstep, int count,
     return dy;
 }
 
+enum { FILTER_BAND_MIN_SIZE = 1 << 16, FILTER_BAND_MIN_ROWS = 16 };
+
+/*
+ Each worker filters its horizontal bands of dst by its own engine: the engine has its own ring buffer
+ and the copies of the filters that keep the context, the filters without the context are shared.
+ A band is just a ROI of the source image, so the rows above and below it are read from src
+ (or extrapolated at the image borders) exactly as in the case of the whole image.
+ The results are the same as the single-threaded ones, except for the floating-point box and sum filters:
+ they restart their running column sums in every band, so their results differ by the rounding errors.
+*/
+class FilterEngineBand_Invoker : public ParallelLoopBody
+{
+public:
+    FilterEngineBand_Invoker(const FilterEngine& _engine, const Mat& _src, Mat& _dst,
+                             const Size& _wsz, const Point& _ofs, int _nbands) :
+        engine(&_engine), src(&_src), dst(&_dst), wsz(_wsz), ofs(_ofs), nbands(_nbands)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        const FilterEngine& e = *engine;
+        Ptr<BaseFilter> _filter2D = e.filter2D;
+        Ptr<BaseColumnFilter> _columnFilter = e.columnFilter;
+        if( _filter2D )
+        {
+            Ptr<BaseFilter> f = _filter2D->clone();
+            if( f )
+                _filter2D = f;
+        }
+        if( _columnFilter )
+        {
+            Ptr<BaseColumnFilter> f = _columnFilter->clone();
+            if( f )
+                _columnFilter = f;
+        }
+
+        FilterEngine f(_filter2D, e.rowFilter, _columnFilter, e.srcType, e.dstType, e.bufType,
+                       e.rowBorderType, e.columnBorderType);
+        f.constBorderValue = e.constBorderValue;
+
+        int height = src->rows;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int y0 = (int)((int64)height*i/nbands), y1 = (int)((int64)height*(i + 1)/nbands);
+            Mat bsrc = src->rowRange(y0, y1), bdst = dst->rowRange(y0, y1);
+            int y = f.start(bsrc, wsz, Point(ofs.x, ofs.y + y0));
+            f.proceed(bsrc.ptr() + y*bsrc.step, (int)bsrc.step, f.endY - f.startY,
+                      bdst.ptr(), (int)bdst.step);
+        }
+    }
+
+private:
+    const FilterEngine* engine;
+    const Mat* src;
+    Mat* dst;
+    Size wsz;
+    Point ofs;
+    int nbands;
+};
+
 void FilterEngine::apply(const Mat& src, Mat& dst, const Size & wsz, const Point & ofs)
 {
     CV_INSTRUMENT_REGION()
 
     CV_Assert( src.type() == srcType && dst.type() == dstType );
 
+    // every band filters the rows of its halo once more, so there are no more bands than threads
+    int nthreads = getNumThreads();
+    int nbands = std::min((int)((int64)src.rows*src.cols/FILTER_BAND_MIN_SIZE),
+                          src.rows/std::max(ksize.height*4, (int)FILTER_BAND_MIN_ROWS));
+    nbands = std::min(nbands, nthreads);
+    if( nbands > 1 )
+    {
+        // the rows of src used by the filter, they are written by the other bands if dst overlaps them
+        const uchar* sptr0 = src.ptr() - std::min(ofs.y, anchor.y)*src.step;
+        const uchar* sptr1 = src.ptr() + (src.rows + ksize.height)*src.step;
+        const uchar* dptr0 = dst.ptr();
+        const uchar* dptr1 = dst.ptr() + dst.rows*dst.step;
+        if( sptr1 <= dptr0 || dptr1 <= sptr0 )
+        {
+            parallel_for_(Range(0, nbands), FilterEngineBand_Invoker(*this, src, dst, wsz, ofs, nbands), nbands);
+            return;
+        }
+    }
+
     int y = start(src, wsz, ofs);
     proceed(src.ptr() + y*src.step,
             (int)src.step,
@@ -3889,6 +3971,9 @@ template<typename ST, class CastOp, class VecOp> struct Filter2D : public BaseFi
         ptrs.resize( coords.size() );
     }
 
+    // ptrs is the scratch buffer of operator()
+    Ptr<BaseFilter> clone() const { return makePtr<Filter2D>(*this); }
+
     void operator()(const uchar** src, uchar* dst, int dststep, int count, int width, int cn)
     {
         KT _delta = delta;
@@ -100,6 +100,9 @@ public:
     virtual void operator()(const uchar** src, uchar* dst, int dststep, int dstcount, int width) = 0;
     //! resets the internal buffers, if any
     virtual void reset();
+    //! returns a copy of the filter to be used by another thread. The filters without the context
+    //! return an empty pointer, such a filter is shared by the threads. Must be overridden together with reset().
+    virtual Ptr<BaseColumnFilter> clone() const;
 
     int ksize;
     int anchor;
@@ -128,6 +131,8 @@ public:
     virtual void operator()(const uchar** src, uchar* dst, int dststep, int dstcount, int width, int cn) = 0;
     //! resets the internal buffers, if any
     virtual void reset();
+    //! returns a copy of the filter to be used by another thread, see BaseColumnFilter::clone()
+    virtual Ptr<BaseFilter> clone() const;
 
     Size ksize;
     Point anchor;
@@ -238,7 +243,14 @@ public:
     //! processes the next srcCount rows of the image.
     virtual int proceed(const uchar* src, int srcStep, int srcCount,
                         uchar* dst, int dstStep);
-    //! applies filter to the specified ROI of the image. if srcRoi=(0,0,-1,-1), the whole image is filtered.
+    /** @brief applies filter to the specified ROI of the image. if srcRoi=(0,0,-1,-1), the whole image is filtered.
+
+    Large images are split into horizontal bands processed in parallel, each band by its own engine
+    that reads the rows above and below the band from src, so the result does not depend on the split.
+    The exceptions are the floating-point box and sum filters: their running column sums restart in every
+    band, so the result may differ from the single-threaded one by the rounding errors.
+    If src and dst overlap, the image is processed by this engine as a whole.
+    */
     virtual void apply(const Mat& src, Mat& dst, const cv::Size &wsz, const cv::Point &ofs);
 
     //! returns true if the filter is separable
@@ -40,6 +40,7 @@
 //M*/
 #include "precomp.hpp"
 #include "opencl_kernels_imgproc.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv
 {
@@ -90,6 +91,44 @@ static void completeMomentState( Moments* moments )
 }
 
 
+// Adds the spatial moments mom (m00, m10, ..., m03) computed relative to the point (x, y)
+// to the moments m computed relative to the origin
+static void addShiftedMoments( double* m, const double* mom, double x, double y )
+{
+    double xm = x * mom[0], ym = y * mom[0];
+
+    // + m00 ( = m00' )
+    m[0] += mom[0];
+
+    // + m10 ( = m10' + x*m00' )
+    m[1] += mom[1] + xm;
+
+    // + m01 ( = m01' + y*m00' )
+    m[2] += mom[2] + ym;
+
+    // + m20 ( = m20' + 2*x*m10' + x*x*m00' )
+    m[3] += mom[3] + x * (mom[1] * 2 + xm);
+
+    // + m11 ( = m11' + x*m01' + y*m10' + x*y*m00' )
+    m[4] += mom[4] + x * (mom[2] + ym) + y * mom[1];
+
+    // + m02 ( = m02' + 2*y*m01' + y*y*m00' )
+    m[5] += mom[5] + y * (mom[2] * 2 + ym);
+
+    // + m30 ( = m30' + 3*x*m20' + 3*x*x*m10' + x*x*x*m00' )
+    m[6] += mom[6] + x * (3. * mom[3] + x * (3. * mom[1] + xm));
+
+    // + m21 ( = m21' + x*(2*m11' + 2*y*m10' + x*m01' + x*y*m00') + y*m20')
+    m[7] += mom[7] + x * (2 * (mom[4] + y * mom[1]) + x * (mom[2] + ym)) + y * mom[3];
+
+    // + m12 ( = m12' + y*(2*m11' + 2*x*m01' + y*m10' + x*y*m00') + x*m02')
+    m[8] += mom[8] + y * (2 * (mom[4] + x * mom[2]) + y * (mom[1] + xm)) + x * mom[5];
+
+    // + m03 ( = m03' + 3*y*m02' + 3*y*y*m01' + y*y*y*m00' )
+    m[9] += mom[9] + y * (3. * mom[5] + y * (3. * mom[2] + ym));
+}
+
+
 static Moments contourMoments( const Mat& contour )
 {
     Moments m;
@@ -650,6 +689,166 @@ static bool ipp_moments(Mat &src, Moments &m )
 }
 #endif
 
+
+/****************************************************************************************\
+*                                Moments of Labeled Regions                              *
+\****************************************************************************************/
+
+// spatial moments of a region computed relative to the first pixel of the region met in the stripe;
+// keeping the coordinates small preserves the precision of the central moments of small regions
+struct LabelMomentsAcc
+{
+    double m[10];
+    int x, y; // the origin, y < 0 if the region has not been met yet
+};
+
+// returns the end of the run of the label l containing x
+template<typename LT> static inline int labelRunEnd( const LT* lab, int x, int width, LT l )
+{
+    while( x < width && lab[x] == l )
+        x++;
+    return x;
+}
+
+#if CV_SIMD
+template<> inline int labelRunEnd<int>( const int* lab, int x, int width, int l )
+{
+    v_int32 vl = vx_setall_s32(l);
+    for( ; x <= width - v_int32::nlanes; x += v_int32::nlanes )
+        if( !v_check_all(vx_load(lab + x) == vl) )
+            break;
+    while( x < width && lab[x] == l )
+        x++;
+    return x;
+}
+
+template<> inline int labelRunEnd<ushort>( const ushort* lab, int x, int width, ushort l )
+{
+    v_uint16 vl = vx_setall_u16(l);
+    for( ; x <= width - v_uint16::nlanes; x += v_uint16::nlanes )
+        if( !v_check_all(vx_load(lab + x) == vl) )
+            break;
+    while( x < width && lab[x] == l )
+        x++;
+    return x;
+}
+#endif
+
+// sums of x^k, k = 1..3, over [0, n); the polynomials are valid for negative n as well
+static inline void powerSums( double n, double* f )
+{
+    f[0] = n*(n - 1)*0.5;
+    f[1] = (n - 1)*n*(2*n - 1)*(1./6);
+    f[2] = f[0]*f[0];
+}
+
+template<typename LT, typename T>
+class LabelMoments_Invoker : public ParallelLoopBody
+{
+public:
+    LabelMoments_Invoker( const Mat& _labels, const Mat& _weights, int _nlabels, int _nstripes,
+                          LabelMomentsAcc* _acc ) :
+        labels(_labels), weights(_weights), nlabels(_nlabels), nstripes(_nstripes), acc(_acc)
+    {
+    }
+
+    void operator()( const Range& range ) const
+    {
+        Size size = labels.size();
+
+        for( int s = range.start; s < range.end; s++ )
+        {
+            LabelMomentsAcc* a = acc + (size_t)s*nlabels;
+            int y0 = (int)((int64)size.height*s/nstripes), y1 = (int)((int64)size.height*(s + 1)/nstripes);
+
+            for( int y = y0; y < y1; y++ )
+            {
+                const LT* lab = labels.ptr<LT>(y);
+                const T* w = weights.empty() ? 0 : weights.ptr<T>(y);
+
+                for( int x = 0; x < size.width; )
+                {
+                    int l = lab[x];
+                    int x1 = labelRunEnd(lab, x + 1, size.width, lab[x]);
+
+                    // pixels of the labels out of range are skipped
+                    if( (unsigned)l < (unsigned)nlabels )
+                    {
+                        LabelMomentsAcc& r = a[l];
+                        if( r.y < 0 )
+                        {
+                            r.x = x;
+                            r.y = y;
+                        }
+
+                        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                        if( w )
+                        {
+                            for( int i = x; i < x1; i++ )
+                            {
+                                double p = w[i], dx = i - r.x;
+                                double xp = dx * p, xxp = xp * dx;
+
+                                s0 += p;
+                                s1 += xp;
+                                s2 += xxp;
+                                s3 += xxp * dx;
+                            }
+                        }
+                        else
+                        {
+                            double f0[3], f1[3];
+                            powerSums(x - r.x, f0);
+                            powerSums(x1 - r.x, f1);
+                            s0 = x1 - x;
+                            s1 = f1[0] - f0[0];
+                            s2 = f1[1] - f0[1];
+                            s3 = f1[2] - f0[2];
+                        }
+
+                        double dy = y - r.y, dy2 = dy * dy;
+
+                        r.m[0] += s0;       // m00
+                        r.m[1] += s1;       // m10
+                        r.m[2] += s0 * dy;  // m01
+                        r.m[3] += s2;       // m20
+                        r.m[4] += s1 * dy;  // m11
+                        r.m[5] += s0 * dy2; // m02
+                        r.m[6] += s3;       // m30
+                        r.m[7] += s2 * dy;  // m21
+                        r.m[8] += s1 * dy2; // m12
+                        r.m[9] += s0 * dy2 * dy; // m03
+                    }
+                    x = x1;
+                }
+            }
+        }
+    }
+
+private:
+    Mat labels, weights;
+    int nlabels, nstripes;
+    LabelMomentsAcc* acc;
+};
+
+template<typename LT, typename T>
+static void labelMoments_( const Mat& labels, const Mat& weights, int nlabels, int nstripes, LabelMomentsAcc* acc )
+{
+    parallel_for_(Range(0, nstripes), LabelMoments_Invoker<LT, T>(labels, weights, nlabels, nstripes, acc), nstripes);
+}
+
+typedef void (*LabelMomentsFunc)( const Mat& labels, const Mat& weights, int nlabels, int nstripes, LabelMomentsAcc* acc );
+
+template<typename LT>
+static LabelMomentsFunc getLabelMomentsFunc( int wdepth )
+{
+    return wdepth == CV_8U ? labelMoments_<LT, uchar> :
+           wdepth == CV_16U ? labelMoments_<LT, ushort> :
+           wdepth == CV_16S ? labelMoments_<LT, short> :
+           wdepth == CV_32F ? labelMoments_<LT, float> :
+           wdepth == CV_64F ? labelMoments_<LT, double> : 0;
+}
+
 }
 
 cv::Moments cv::moments( InputArray _src, bool binary )
@@ -721,39 +920,8 @@ cv::Moments cv::moments( InputArray _src, bool binary )
                     mom[k] *= s;
             }
 
-            double xm = x * mom[0], ym = y * mom[0];
-
             // accumulate moments computed in each tile
-
-            // + m00 ( = m00' )
-            m.m00 += mom[0];
-
-            // + m10 ( = m10' + x*m00' )
-            m.m10 += mom[1] + xm;
-
-            // + m01 ( = m01' + y*m00' )
-            m.m01 += mom[2] + ym;
-
-            // + m20 ( = m20' + 2*x*m10' + x*x*m00' )
-            m.m20 += mom[3] + x * (mom[1] * 2 + xm);
-
-            // + m11 ( = m11' + x*m01' + y*m10' + x*y*m00' )
-            m.m11 += mom[4] + x * (mom[2] + ym) + y * mom[1];
-
-            // + m02 ( = m02' + 2*y*m01' + y*y*m00' )
-            m.m02 += mom[5] + y * (mom[2] * 2 + ym);
-
-            // + m30 ( = m30' + 3*x*m20' + 3*x*x*m10' + x*x*x*m00' )
-            m.m30 += mom[6] + x * (3. * mom[3] + x * (3. * mom[1] + xm));
-
-            // + m21 ( = m21' + x*(2*m11' + 2*y*m10' + x*m01' + x*y*m00') + y*m20')
-            m.m21 += mom[7] + x * (2 * (mom[4] + y * mom[1]) + x * (mom[2] + ym)) + y * mom[3];
-
-            // + m12 ( = m12' + y*(2*m11' + 2*x*m01' + y*m10' + x*y*m00') + x*m02')
-            m.m12 += mom[8] + y * (2 * (mom[4] + x * mom[2]) + y * (mom[1] + xm)) + x * mom[5];
-
-            // + m03 ( = m03' + 3*y*m02' + 3*y*y*m01' + y*y*y*m00' )
-            m.m03 += mom[9] + y * (3. * mom[5] + y * (3. * mom[2] + ym));
+            addShiftedMoments( &m.m00, mom, x, y );
         }
     }
 
@@ -802,6 +970,69 @@ void cv::HuMoments( const Moments& m, OutputArray _hu )
 }
 
 
+void cv::labelMoments( InputArray _labels, int nlabels, std::vector<Moments>& mom,
+                       InputArray _weights, OutputArray _hu )
+{
+    CV_INSTRUMENT_REGION()
+
+    Mat labels = _labels.getMat(), weights = _weights.getMat();
+    int ltype = labels.type();
+    CV_Assert( labels.dims <= 2 && (ltype == CV_32S || ltype == CV_16U) && nlabels > 0 );
+    CV_Assert( weights.empty() || (weights.size() == labels.size() && weights.channels() == 1) );
+
+    int wdepth = weights.empty() ? CV_8U : weights.depth();
+    LabelMomentsFunc func = ltype == CV_32S ? getLabelMomentsFunc<int>(wdepth) : getLabelMomentsFunc<ushort>(wdepth);
+    if( !func )
+        CV_Error( CV_StsUnsupportedFormat, "" );
+
+    // every stripe has its own accumulators, they should not take more time to merge than the stripe to scan
+    Size size = labels.size();
+    int64 maxStripes = (int64)size.width*size.height/((int64)nlabels*16);
+    int nstripes = (int)std::max(std::min((int64)std::min(getNumThreads(), size.height), maxStripes), (int64)1);
+
+    std::vector<LabelMomentsAcc> acc((size_t)nstripes*nlabels);
+    for( size_t i = 0; i < acc.size(); i++ )
+    {
+        memset( acc[i].m, 0, sizeof(acc[i].m) );
+        acc[i].x = acc[i].y = -1;
+    }
+    func( labels, weights, nlabels, nstripes, &acc[0] );
+
+    mom.assign(nlabels, Moments());
+    for( int l = 0; l < nlabels; l++ )
+    {
+        LabelMomentsAcc& r = acc[l];
+        for( int s = 1; s < nstripes; s++ )
+        {
+            const LabelMomentsAcc& t = acc[(size_t)s*nlabels + l];
+            if( t.y < 0 )
+                continue;
+            if( r.y < 0 )
+                r = t;
+            else
+                addShiftedMoments( r.m, t.m, t.x - r.x, t.y - r.y );
+        }
+        if( r.y < 0 )
+            continue;
+
+        // the central moments do not depend on the origin, the spatial ones are shifted to (0, 0)
+        Moments& m = mom[l];
+        m = Moments(r.m[0], r.m[1], r.m[2], r.m[3], r.m[4], r.m[5], r.m[6], r.m[7], r.m[8], r.m[9]);
+        double* sm = &m.m00;
+        std::fill(sm, sm + 10, 0.);
+        addShiftedMoments( sm, r.m, r.x, r.y );
+    }
+
+    if( _hu.needed() )
+    {
+        _hu.create(nlabels, 7, CV_64F);
+        Mat hu = _hu.getMat();
+        for( int l = 0; l < nlabels; l++ )
+            HuMoments(mom[l], hu.ptr<double>(l));
+    }
+}
+
+
 CV_IMPL void cvMoments( const CvArr* arr, CvMoments* moments, int binary )
 {
     const IplImage* img = (const IplImage*)arr;
@@ -41,6 +41,8 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+#include "opencv2/core/utils/buffer_pool.private.hpp"
 #include <limits.h>
 #include "opencl_kernels_imgproc.hpp"
 #include <iostream>
@@ -792,6 +794,9 @@ template<class Op, class VecOp> struct MorphFilter : BaseFilter
         ptrs.resize( coords.size() );
     }
 
+    // ptrs is the scratch buffer of operator()
+    Ptr<BaseFilter> clone() const { return makePtr<MorphFilter>(*this); }
+
     void operator()(const uchar** src, uchar* dst, int dststep, int count, int width, int cn)
     {
         const Point* pt = &coords[0];
@@ -840,6 +845,24 @@ template<class Op, class VecOp> struct MorphFilter : BaseFilter
     VecOp vecOp;
 };
 
+// replaces the default border value by the value that does not affect the result of the operation
+static Scalar morphologyBorderValue(int op, int depth, const Scalar& borderValue)
+{
+    if( borderValue != morphologyDefaultBorderValue() )
+        return borderValue;
+    CV_Assert( depth == CV_8U || depth == CV_16U || depth == CV_16S ||
+               depth == CV_32F || depth == CV_64F );
+    if( op == MORPH_ERODE )
+        return Scalar::all( depth == CV_8U ? (double)UCHAR_MAX :
+                            depth == CV_16U ? (double)USHRT_MAX :
+                            depth == CV_16S ? (double)SHRT_MAX :
+                            depth == CV_32F ? (double)FLT_MAX : DBL_MAX);
+    return Scalar::all( depth == CV_8U || depth == CV_16U ?
+                            0. :
+                        depth == CV_16S ? (double)SHRT_MIN :
+                        depth == CV_32F ? (double)-FLT_MAX : -DBL_MAX);
+}
+
 }
 
 /////////////////////////////////// External Interface /////////////////////////////////////
@@ -998,23 +1021,8 @@ cv::Ptr<cv::FilterEngine> cv::createMorphologyFilter( int op, int type, InputArr
         filter2D = getMorphologyFilter(op, type, kernel, anchor);
 
     Scalar borderValue = _borderValue;
-    if( (_rowBorderType == BORDER_CONSTANT || _columnBorderType == BORDER_CONSTANT) &&
-            borderValue == morphologyDefaultBorderValue() )
-    {
-        int depth = CV_MAT_DEPTH(type);
-        CV_Assert( depth == CV_8U || depth == CV_16U || depth == CV_16S ||
-                   depth == CV_32F || depth == CV_64F );
-        if( op == MORPH_ERODE )
-            borderValue = Scalar::all( depth == CV_8U ? (double)UCHAR_MAX :
-                                       depth == CV_16U ? (double)USHRT_MAX :
-                                       depth == CV_16S ? (double)SHRT_MAX :
-                                       depth == CV_32F ? (double)FLT_MAX : DBL_MAX);
-        else
-            borderValue = Scalar::all( depth == CV_8U || depth == CV_16U ?
-                                           0. :
-                                       depth == CV_16S ? (double)SHRT_MIN :
-                                       depth == CV_32F ? (double)-FLT_MAX : -DBL_MAX);
-    }
+    if( _rowBorderType == BORDER_CONSTANT || _columnBorderType == BORDER_CONSTANT )
+        borderValue = morphologyBorderValue(op, CV_MAT_DEPTH(type), borderValue);
 
     return makePtr<FilterEngine>(filter2D, rowFilter, columnFilter,
                                  type, type, type, _rowBorderType, _columnBorderType, borderValue );
@@ -1318,6 +1326,543 @@ static bool ippMorph(int op, int src_type, int dst_type,
 
 // ===== 3. Fallback implementation
 
+/*
+ Erosion and dilation by a rectangle with the van Herk/Gil-Werman algorithm.
+
+ A rectangle is separable, and the extremum of a sliding window of ksize elements is found
+ in O(1) operations per element, whatever the window size is. The sequence is split into blocks
+ of ksize elements. For every element, two extrema are known: the suffix one (from the element
+ to the end of its block) and the prefix one (from the beginning of its block to the element).
+ Then the extremum over the window starting at i is op(suffix[i], prefix[i + ksize - 1]).
+
+ The columns are processed this way with vector operations on the whole rows. The rows are
+ processed with the scalar van Herk/Gil-Werman only for long kernels, for shorter ones the
+ vectorized MorphRowFilter is faster. The horizontally filtered rows are kept in a ring buffer
+ of 2*ksize.height rows, so the image is streamed through the filter and no intermediate image is
+ created. The filters can be chained: the output rows of one filter are the source of another,
+ which is how the compound operations of morphologyEx are computed.
+*/
+
+// the rows are processed with van Herk/Gil-Werman when the kernel row is at least MORPH_VHGW_MIN_ROW_BYTES,
+// the vectorized MorphRowFilter processes as many channels per operation as fit in a vector
+enum { MORPH_VHGW_MIN_KSIZE = 7, MORPH_VHGW_MIN_ROW_BYTES = 64, MORPH_VHGW_BAND_MIN_ROWS = 32 };
+
+// the scalar operations of the vectorized ones, the dependency chains of vhgwRow need them branchless
+struct VHGWMin
+{
+    template<typename V> V operator()(const V& a, const V& b) const { return v_min(a, b); }
+    template<typename T> struct Op { T operator()(const T a, const T b) const { return std::min(a, b); } };
+};
+struct VHGWMax
+{
+    template<typename V> V operator()(const V& a, const V& b) const { return v_max(a, b); }
+    template<typename T> struct Op { T operator()(const T a, const T b) const { return std::max(a, b); } };
+};
+struct VHGWSub
+{
+    template<typename V> V operator()(const V& a, const V& b) const { return a - b; }
+    template<typename T> struct Op { T operator()(const T a, const T b) const { return saturate_cast<T>(a - b); } };
+};
+
+template<class VecOp, typename T> static inline int vhgwOpVec(const T*, const T*, T*, int) { return 0; }
+template<class VecOp, typename T> static inline int vhgwOp2Vec(const T*, const T*, const T*, T*, T*, int) { return 0; }
+
+#if CV_SIMD
+template<class VecOp, typename T, typename V> static inline int vhgwOpVec_(const T* a, const T* b, T* d, int n)
+{
+    VecOp op;
+    int i = 0;
+    for( ; i <= n - V::nlanes; i += V::nlanes )
+        v_store(d + i, op(vx_load(a + i), vx_load(b + i)));
+    return i;
+}
+
+template<class VecOp, typename T, typename V> static inline int vhgwOp2Vec_(const T* g, const T* s, const T* h,
+                                                                            T* gd, T* d, int n)
+{
+    VecOp op;
+    int i = 0;
+    for( ; i <= n - V::nlanes; i += V::nlanes )
+    {
+        V v = op(vx_load(g + i), vx_load(s + i));
+        v_store(gd + i, v);
+        v_store(d + i, op(vx_load(h + i), v));
+    }
+    return i;
+}
+
+template<class VecOp> static inline int vhgwOpVec(const uchar* a, const uchar* b, uchar* d, int n)
+{ return vhgwOpVec_<VecOp, uchar, v_uint8>(a, b, d, n); }
+template<class VecOp> static inline int vhgwOpVec(const ushort* a, const ushort* b, ushort* d, int n)
+{ return vhgwOpVec_<VecOp, ushort, v_uint16>(a, b, d, n); }
+template<class VecOp> static inline int vhgwOpVec(const short* a, const short* b, short* d, int n)
+{ return vhgwOpVec_<VecOp, short, v_int16>(a, b, d, n); }
+template<class VecOp> static inline int vhgwOpVec(const float* a, const float* b, float* d, int n)
+{ return vhgwOpVec_<VecOp, float, v_float32>(a, b, d, n); }
+
+template<class VecOp> static inline int vhgwOp2Vec(const uchar* g, const uchar* s, const uchar* h, uchar* gd, uchar* d, int n)
+{ return vhgwOp2Vec_<VecOp, uchar, v_uint8>(g, s, h, gd, d, n); }
+template<class VecOp> static inline int vhgwOp2Vec(const ushort* g, const ushort* s, const ushort* h, ushort* gd, ushort* d, int n)
+{ return vhgwOp2Vec_<VecOp, ushort, v_uint16>(g, s, h, gd, d, n); }
+template<class VecOp> static inline int vhgwOp2Vec(const short* g, const short* s, const short* h, short* gd, short* d, int n)
+{ return vhgwOp2Vec_<VecOp, short, v_int16>(g, s, h, gd, d, n); }
+template<class VecOp> static inline int vhgwOp2Vec(const float* g, const float* s, const float* h, float* gd, float* d, int n)
+{ return vhgwOp2Vec_<VecOp, float, v_float32>(g, s, h, gd, d, n); }
+
+#if CV_SIMD_64F
+template<class VecOp> static inline int vhgwOpVec(const double* a, const double* b, double* d, int n)
+{ return vhgwOpVec_<VecOp, double, v_float64>(a, b, d, n); }
+template<class VecOp> static inline int vhgwOp2Vec(const double* g, const double* s, const double* h, double* gd, double* d, int n)
+{ return vhgwOp2Vec_<VecOp, double, v_float64>(g, s, h, gd, d, n); }
+#endif
+#endif
+
+// d = op(a, b)
+template<typename T, class Op, class VecOp> static void vhgwOp(const T* a, const T* b, T* d, int n)
+{
+    Op op;
+    int i = vhgwOpVec<VecOp>(a, b, d, n);
+    for( ; i < n; i++ )
+        d[i] = op(a[i], b[i]);
+}
+
+// gd = op(g, s), d = op(h, gd); gd may be the same as g
+template<typename T, class Op, class VecOp> static void vhgwOp2(const T* g, const T* s, const T* h, T* gd, T* d, int n)
+{
+    Op op;
+    int i = vhgwOp2Vec<VecOp>(g, s, h, gd, d, n);
+    for( ; i < n; i++ )
+    {
+        T v = op(g[i], s[i]);
+        gd[i] = v;
+        d[i] = op(h[i], v);
+    }
+}
+
+// dst[i] = op(src[i], src[i+1], ..., src[i+ksize-1]) for every channel, src has width+ksize-1 pixels
+template<typename T, class Op> static void vhgwRow(const T* src, T* dst, int width, int cn, int ksize, T* buf)
+{
+    Op op;
+    int kcn = ksize*cn, wcn = width*cn;
+    for( int b = 0; b < wcn; b += kcn )
+    {
+        const T* s = src + b;
+        const T* p = s + kcn - cn;
+        T* d = dst + b;
+        int n = std::min(kcn, wcn - b);
+
+        for( int c = 0; c < cn; c++ )
+        {
+            // suffix extrema of the block
+            int i = kcn - cn + c;
+            T m = buf[i] = s[i];
+            for( i -= cn; i >= 0; i -= cn )
+                buf[i] = m = op(s[i], m);
+            d[c] = m;
+
+            // prefix extrema of the next block
+            if( cn + c >= n )
+                continue;
+            T g = p[cn + c];
+            d[cn + c] = op(buf[cn + c], g);
+            for( i = cn*2 + c; i < n; i += cn )
+            {
+                g = op(g, p[i]);
+                d[i] = op(buf[i], g);
+            }
+        }
+    }
+}
+
+// the image filtered by MorphRectFilter
+struct MorphRectSource
+{
+    virtual ~MorphRectSource() {}
+    //! returns the pointer to the first pixel of the row y, 0 <= y < wholeSize.height
+    virtual const uchar* row(int y) = 0;
+};
+
+struct MorphRectMatSource : public MorphRectSource
+{
+    // roi is located at ofs of the whole image
+    MorphRectMatSource(const Mat& roi, Point ofs)
+    {
+        data = roi.data - ofs.x*roi.elemSize();
+        step = (ptrdiff_t)roi.step;
+        y0 = ofs.y;
+    }
+
+    const uchar* row(int y) { return data + (y - y0)*step; }
+
+    const uchar* data;
+    ptrdiff_t step;
+    int y0;
+};
+
+/*
+ Computes the rows of roi of the filtered image one by one.
+ If the source rows stay valid while the filter is used (stable), they are referenced
+ by the ring buffer when no horizontal filtering is needed, otherwise they are always copied.
+*/
+template<typename T, class Op, class VecOp> class MorphRectFilter
+{
+public:
+    MorphRectFilter(MorphRectSource* _src, bool _stable, Size _wholeSize, Rect _roi,
+                    Size _ksize, Point _anchor, int _borderType, const Scalar& borderValue,
+                    int _cn, const Ptr<BaseRowFilter>& _rowFilter) :
+        src(_src), stable(_stable), wholeSize(_wholeSize), roi(_roi), ksize(_ksize), anchor(_anchor),
+        borderType(_borderType), cn(_cn), rowFilter(_rowFilter), prefixRow(0), outY(0), nrows(0), blockY(0), blockPos(0)
+    {
+        int i, c, kh = ksize.height, extw = roi.width + ksize.width - 1;
+        rowLen = roi.width*cn;
+        ringSize = kh*2;
+        dx1 = std::max(anchor.x - roi.x, 0);
+        dx2 = std::max(ksize.width - anchor.x - 1 + roi.x + roi.width - wholeSize.width, 0);
+
+        buf.allocate(extw*cn + ksize.width*cn + rowLen*(ringSize + kh + 1) + std::max(cn, 4));
+        ext = buf;
+        rowBuf = ext + extw*cn;
+        ring = rowBuf + ksize.width*cn;
+        suffix = ring + rowLen*ringSize;
+        prefix = suffix + rowLen*(kh - 1);
+        constRow = prefix + rowLen;
+        borderVal = constRow + rowLen;
+        rows.resize(ringSize);
+        suffixRows.resize(kh);
+
+        for( c = 0; c < cn; c++ )
+            borderVal[c] = saturate_cast<T>(borderValue[c & 3]);
+        if( borderType == BORDER_CONSTANT )
+            for( i = 0; i < rowLen; i++ )
+                constRow[i] = borderVal[i % cn];
+
+        xtab.resize(dx1 + dx2);
+        for( i = 0; i < dx1; i++ )
+            xtab[i] = borderInterpolate(roi.x - anchor.x + i, wholeSize.width, borderType);
+        for( i = 0; i < dx2; i++ )
+            xtab[dx1 + i] = borderInterpolate(roi.x - anchor.x + extw - dx2 + i, wholeSize.width, borderType);
+    }
+
+    //! computes the next row of roi
+    void next(T* dst)
+    {
+        int kh = ksize.height, j = blockPos;
+        if( j == 0 )
+        {
+            int b = blockY = outY;
+            produce(b + kh - 1);
+            suffixRows[kh - 1] = rowAt(b + kh - 1);
+            for( int k = kh - 2; k >= 1; k-- )
+            {
+                T* h = suffix + (k - 1)*rowLen;
+                vhgwOp<T, Op, VecOp>(rowAt(b + k), suffixRows[k + 1], h, rowLen);
+                suffixRows[k] = h;
+            }
+            if( kh > 1 )
+                vhgwOp<T, Op, VecOp>(rowAt(b), suffixRows[1], dst, rowLen);
+            else
+                memcpy(dst, rowAt(b), rowLen*sizeof(T));
+        }
+        else
+        {
+            int t = blockY + kh + j - 1;
+            produce(t);
+            const T* s = rowAt(t);
+            if( j == 1 )
+            {
+                vhgwOp<T, Op, VecOp>(suffixRows[1], s, dst, rowLen);
+                prefixRow = s;
+            }
+            else
+            {
+                vhgwOp2<T, Op, VecOp>(prefixRow, s, suffixRows[j], prefix, dst, rowLen);
+                prefixRow = prefix;
+            }
+        }
+        outY++;
+        blockPos = j + 1 < kh ? j + 1 : 0;
+    }
+
+private:
+    const T* rowAt(int t) const { return rows[t % ringSize]; }
+
+    // filters horizontally the rows up to t-th one of the roi extended by the kernel
+    void produce(int t)
+    {
+        for( ; nrows <= t; nrows++ )
+        {
+            int y = roi.y + nrows - anchor.y;
+            if( (unsigned)y >= (unsigned)wholeSize.height )
+                y = borderInterpolate(y, wholeSize.height, borderType);
+            T* out = ring + (nrows % ringSize)*rowLen;
+            rows[nrows % ringSize] = y < 0 ? constRow : filterRow((const T*)src->row(y), out);
+        }
+    }
+
+    const T* filterRow(const T* srow, T* out)
+    {
+        const T* s = srow + (roi.x - anchor.x)*cn;
+        if( dx1 > 0 || dx2 > 0 )
+        {
+            int i, c, extw = roi.width + ksize.width - 1;
+            memcpy(ext + dx1*cn, srow + (roi.x - anchor.x + dx1)*cn, (extw - dx1 - dx2)*cn*sizeof(T));
+            for( i = 0; i < dx1 + dx2; i++ )
+            {
+                T* d = ext + (i < dx1 ? i : extw - dx1 - dx2 + i)*cn;
+                const T* v = xtab[i] >= 0 ? srow + xtab[i]*cn : borderVal;
+                for( c = 0; c < cn; c++ )
+                    d[c] = v[c];
+            }
+            s = ext;
+        }
+
+        if( ksize.width == 1 )
+        {
+            if( stable )
+                return s;
+            memcpy(out, s, rowLen*sizeof(T));
+        }
+        else if( rowFilter )
+            (*rowFilter)((const uchar*)s, (uchar*)out, roi.width, cn);
+        else
+            vhgwRow<T, Op>(s, out, roi.width, cn, ksize.width, rowBuf);
+        return out;
+    }
+
+    MorphRectSource* src;
+    bool stable;
+    Size wholeSize;
+    Rect roi;
+    Size ksize;
+    Point anchor;
+    int borderType;
+    int cn;
+    Ptr<BaseRowFilter> rowFilter;
+    int rowLen, ringSize, dx1, dx2;
+    std::vector<int> xtab;
+    utils::ScratchBuffer<T> buf;
+    T *ext, *rowBuf, *ring, *suffix, *prefix, *constRow, *borderVal;
+    std::vector<const T*> rows;
+    std::vector<const T*> suffixRows;
+    const T* prefixRow;
+    int outY, nrows, blockY, blockPos;
+};
+
+// the rows [y0, y0 + nrows) of the image computed by another filter, the last ringSize rows are accessible
+template<class Filter, typename T> struct MorphRectChainSource : public MorphRectSource
+{
+    MorphRectChainSource(Filter& _filter, int _y0, int _ringSize, int _rowLen) :
+        filter(&_filter), y0(_y0), ringSize(_ringSize), rowLen(_rowLen), nrows(0)
+    {
+        buf.allocate(ringSize*rowLen);
+    }
+
+    const uchar* row(int y)
+    {
+        y -= y0;
+        CV_DbgAssert( y >= 0 && y > nrows - ringSize );
+        for( ; nrows <= y; nrows++ )
+            filter->next(buf + (nrows % ringSize)*rowLen);
+        return (const uchar*)(buf + (y % ringSize)*rowLen);
+    }
+
+    Filter* filter;
+    int y0, ringSize, rowLen, nrows;
+    utils::ScratchBuffer<T> buf;
+};
+
+/*
+ Erosion, dilation and the compound operations of morphologyEx by a rectangle.
+ The destination is split into horizontal bands processed in parallel. The compound operations
+ chain two filters in every band, the result of the first operation is treated as an image of the
+ roi size: the rows of the band extended by the kernel are computed, the other rows are extrapolated.
+*/
+template<typename T> class MorphRect_Invoker : public ParallelLoopBody
+{
+public:
+    typedef MorphRectFilter<T, VHGWMin::Op<T>, VHGWMin> Erode;
+    typedef MorphRectFilter<T, VHGWMax::Op<T>, VHGWMax> Dilate;
+
+    MorphRect_Invoker(int _op, const Mat& _src, Mat& _dst, Size _wholeSize, Point _ofs,
+                      Size _ksize, Point _anchor, int _borderType, const Scalar& borderValue, int _nbands) :
+        op(_op), src(&_src), dst(&_dst), wholeSize(_wholeSize), ofs(_ofs), ksize(_ksize), anchor(_anchor),
+        borderType(_borderType), nbands(_nbands)
+    {
+        int type = src->type();
+        erodeBorderValue = morphologyBorderValue(MORPH_ERODE, src->depth(), borderValue);
+        dilateBorderValue = morphologyBorderValue(MORPH_DILATE, src->depth(), borderValue);
+        if( ksize.width > 1 && ksize.width*(int)src->elemSize1() < MORPH_VHGW_MIN_ROW_BYTES )
+        {
+            erodeRowFilter = getMorphologyRowFilter(MORPH_ERODE, type, ksize.width, anchor.x);
+            dilateRowFilter = getMorphologyRowFilter(MORPH_DILATE, type, ksize.width, anchor.x);
+        }
+    }
+
+    void operator()(const Range& range) const
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int y0 = (int)((int64)src->rows*i/nbands), y1 = (int)((int64)src->rows*(i + 1)/nbands);
+            switch( op )
+            {
+            case MORPH_ERODE:
+                filterBand<Erode>(y0, y1, erodeBorderValue, erodeRowFilter);
+                break;
+            case MORPH_DILATE:
+                filterBand<Dilate>(y0, y1, dilateBorderValue, dilateRowFilter);
+                break;
+            case MORPH_OPEN:
+            case MORPH_TOPHAT:
+                chainBand<Erode, Dilate>(y0, y1, erodeBorderValue, erodeRowFilter, dilateBorderValue, dilateRowFilter);
+                break;
+            case MORPH_CLOSE:
+            case MORPH_BLACKHAT:
+                chainBand<Dilate, Erode>(y0, y1, dilateBorderValue, dilateRowFilter, erodeBorderValue, erodeRowFilter);
+                break;
+            case MORPH_GRADIENT:
+                gradientBand(y0, y1);
+                break;
+            default:
+                CV_Error( CV_StsBadArg, "unknown morphological operation" );
+            }
+        }
+    }
+
+private:
+    template<class Filter> void filterBand(int y0, int y1, const Scalar& borderValue,
+                                           const Ptr<BaseRowFilter>& rowFilter) const
+    {
+        MorphRectMatSource source(*src, ofs);
+        Filter f(&source, true, wholeSize, Rect(ofs.x, ofs.y + y0, src->cols, y1 - y0),
+                 ksize, anchor, borderType, borderValue, src->channels(), rowFilter);
+        for( int y = y0; y < y1; y++ )
+            f.next(dst->ptr<T>(y));
+    }
+
+    template<class Filter1, class Filter2> void chainBand(int y0, int y1, const Scalar& borderValue1,
+                                                          const Ptr<BaseRowFilter>& rowFilter1,
+                                                          const Scalar& borderValue2,
+                                                          const Ptr<BaseRowFilter>& rowFilter2) const
+    {
+        int cn = src->channels(), width = src->cols, height = src->rows, rowLen = width*cn;
+        int m0 = std::max(y0 - anchor.y, 0), m1 = std::min(y1 + ksize.height - anchor.y - 1, height);
+
+        MorphRectMatSource source(*src, ofs);
+        Filter1 f1(&source, true, wholeSize, Rect(ofs.x, ofs.y + m0, width, m1 - m0),
+                   ksize, anchor, borderType, borderValue1, cn, rowFilter1);
+        MorphRectChainSource<Filter1, T> chain(f1, m0, ksize.height + 2, rowLen);
+        Filter2 f2(&chain, false, src->size(), Rect(0, y0, width, y1 - y0),
+                   ksize, anchor, borderType, borderValue2, cn, rowFilter2);
+
+        utils::ScratchBuffer<T> _buf(op == MORPH_TOPHAT || op == MORPH_BLACKHAT ? rowLen : 1);
+        for( int y = y0; y < y1; y++ )
+        {
+            T* d = dst->ptr<T>(y);
+            if( op == MORPH_TOPHAT )
+            {
+                f2.next(_buf);
+                vhgwOp<T, VHGWSub::Op<T>, VHGWSub>(src->ptr<T>(y), _buf, d, rowLen);
+            }
+            else if( op == MORPH_BLACKHAT )
+            {
+                f2.next(_buf);
+                vhgwOp<T, VHGWSub::Op<T>, VHGWSub>(_buf, src->ptr<T>(y), d, rowLen);
+            }
+            else
+                f2.next(d);
+        }
+    }
+
+    void gradientBand(int y0, int y1) const
+    {
+        int cn = src->channels(), rowLen = src->cols*cn;
+        Rect band(ofs.x, ofs.y + y0, src->cols, y1 - y0);
+        MorphRectMatSource source(*src, ofs);
+        Erode fe(&source, true, wholeSize, band, ksize, anchor, borderType, erodeBorderValue, cn, erodeRowFilter);
+        Dilate fd(&source, true, wholeSize, band, ksize, anchor, borderType, dilateBorderValue, cn, dilateRowFilter);
+
+        utils::ScratchBuffer<T> _buf(rowLen);
+        for( int y = y0; y < y1; y++ )
+        {
+            T* d = dst->ptr<T>(y);
+            fe.next(_buf);
+            fd.next(d);
+            vhgwOp<T, VHGWSub::Op<T>, VHGWSub>(d, _buf, d, rowLen);
+        }
+    }
+
+    int op;
+    const Mat* src;
+    Mat* dst;
+    Size wholeSize;
+    Point ofs;
+    Size ksize;
+    Point anchor;
+    int borderType;
+    int nbands;
+    Scalar erodeBorderValue, dilateBorderValue;
+    Ptr<BaseRowFilter> erodeRowFilter, dilateRowFilter;
+};
+
+static bool useMorphRect(int type, Size ksize, int borderType)
+{
+    int depth = CV_MAT_DEPTH(type);
+    return std::max(ksize.width, ksize.height) >= MORPH_VHGW_MIN_KSIZE && borderType != BORDER_WRAP &&
+           (depth == CV_8U || depth == CV_16U || depth == CV_16S || depth == CV_32F || depth == CV_64F);
+}
+
+// src is the roi of the whole image of wholeSize located at ofs
+static void morphRect(int op, const Mat& _src, Mat& dst, Size wholeSize, Point ofs,
+                      Size ksize, Point anchor, int borderType, const Scalar& borderValue)
+{
+    CV_INSTRUMENT_REGION()
+
+    Mat src = _src;
+    int depth = src.depth();
+
+    // the filter reads the source rows after the destination rows above them are written,
+    // so the source is copied together with the part of the whole image used by the filter
+    const uchar* sptr0 = src.ptr() - std::min(ofs.y, ksize.height)*src.step;
+    const uchar* sptr1 = src.ptr() + (src.rows + ksize.height)*src.step;
+    if( sptr0 < dst.ptr() + dst.rows*dst.step && dst.ptr() < sptr1 )
+    {
+        size_t esz = src.elemSize();
+        Mat whole(wholeSize, src.type(), src.data - ofs.y*src.step - ofs.x*esz, src.step);
+        Rect r(ofs.x - ksize.width, ofs.y - ksize.height, src.cols + ksize.width*2, src.rows + ksize.height*2);
+        r &= Rect(Point(), wholeSize);
+        Mat copy = whole(r).clone();
+        src = copy(Rect(ofs - r.tl(), src.size()));
+        ofs -= r.tl();
+        wholeSize = r.size();
+    }
+
+    // the compound operations filter the rows around a band twice; the halo of every band is
+    // processed once more, so there are no more bands than threads
+    int khalo = op == MORPH_ERODE || op == MORPH_DILATE ? ksize.height : ksize.height*2;
+    int nbands = std::min((int)((int64)src.rows*src.cols/(1 << 16)),
+                          src.rows/std::max(khalo*2, (int)MORPH_VHGW_BAND_MIN_ROWS));
+    nbands = std::max(std::min(nbands, getNumThreads()), 1);
+
+    if( depth == CV_8U )
+        parallel_for_(Range(0, nbands), MorphRect_Invoker<uchar>(op, src, dst, wholeSize, ofs, ksize,
+                      anchor, borderType, borderValue, nbands), nbands);
+    else if( depth == CV_16U )
+        parallel_for_(Range(0, nbands), MorphRect_Invoker<ushort>(op, src, dst, wholeSize, ofs, ksize,
+                      anchor, borderType, borderValue, nbands), nbands);
+    else if( depth == CV_16S )
+        parallel_for_(Range(0, nbands), MorphRect_Invoker<short>(op, src, dst, wholeSize, ofs, ksize,
+                      anchor, borderType, borderValue, nbands), nbands);
+    else if( depth == CV_32F )
+        parallel_for_(Range(0, nbands), MorphRect_Invoker<float>(op, src, dst, wholeSize, ofs, ksize,
+                      anchor, borderType, borderValue, nbands), nbands);
+    else if( depth == CV_64F )
+        parallel_for_(Range(0, nbands), MorphRect_Invoker<double>(op, src, dst, wholeSize, ofs, ksize,
+                      anchor, borderType, borderValue, nbands), nbands);
+    else
+        CV_Error_( CV_StsNotImplemented, ("Unsupported data type (=%d)", src.type()));
+}
+
+
 static void ocvMorph(int op, int src_type, int dst_type,
                      uchar * src_data, size_t src_step,
                      uchar * dst_data, size_t dst_step,
@@ -1331,9 +1876,17 @@ static void ocvMorph(int op, int src_type, int dst_type,
     Mat kernel(Size(kernel_width, kernel_height), kernel_type, kernel_data, kernel_step);
     Point anchor(anchor_x, anchor_y);
     Vec<double, 4> borderVal(borderValue);
-    Ptr<FilterEngine> f = createMorphologyFilter(op, src_type, kernel, anchor, borderType, borderType, borderVal);
     Mat src(Size(width, height), src_type, src_data, src_step);
     Mat dst(Size(width, height), dst_type, dst_data, dst_step);
+    if( iterations == 1 && src_type == dst_type && useMorphRect(src_type, kernel.size(), borderType) &&
+        countNonZero(kernel) == kernel.rows*kernel.cols )
+    {
+        morphRect(op, src, dst, Size(roi_width, roi_height), Point(roi_x, roi_y),
+                  kernel.size(), anchor, borderType, borderVal);
+        return;
+    }
+
+    Ptr<FilterEngine> f = createMorphologyFilter(op, src_type, kernel, anchor, borderType, borderType, borderVal);
     {
         Point ofs(roi_x, roi_y);
         Size wsz(roi_width, roi_height);
@@ -2065,6 +2618,27 @@ void cv::morphologyEx( InputArray _src, OutputArray _dst, int op,
     CV_IPP_RUN_FAST(ipp_morphologyEx(op, src, dst, kernel, anchor, iterations, borderType, borderValue));
 #endif
 
+    if( (op == MORPH_OPEN || op == MORPH_CLOSE || op == MORPH_GRADIENT ||
+         op == MORPH_TOPHAT || op == MORPH_BLACKHAT) && iterations > 0 &&
+        countNonZero(kernel) == kernel.rows*kernel.cols )
+    {
+        // the operations by a rectangle are fused, the iterations are replaced by a larger rectangle
+        Size rsize = kernel.size();
+        Point ranchor = normalizeAnchor(anchor, rsize);
+        rsize = Size(rsize.width + (iterations - 1)*(rsize.width - 1),
+                     rsize.height + (iterations - 1)*(rsize.height - 1));
+        ranchor = Point(ranchor.x*iterations, ranchor.y*iterations);
+        if( useMorphRect(src.type(), rsize, borderType & ~BORDER_ISOLATED) )
+        {
+            Point ofs;
+            Size wsz(src.cols, src.rows);
+            if( !(borderType & BORDER_ISOLATED) )
+                src.locateROI(wsz, ofs);
+            morphRect(op, src, dst, wsz, ofs, rsize, ranchor, borderType & ~BORDER_ISOLATED, borderValue);
+            return;
+        }
+    }
+
     switch( op )
     {
     case MORPH_ERODE:
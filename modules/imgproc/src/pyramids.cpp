@@ -43,7 +43,7 @@
 
 #include "precomp.hpp"
 #include "opencl_kernels_imgproc.hpp"
-
+#include "opencv2/core/utils/buffer_pool.private.hpp"
 #include "opencv2/core/openvx/ovx_defs.hpp"
 
 namespace cv
@@ -848,6 +848,94 @@ typedef PyrUpNoVec<float, float> PyrUpVec_32f;
 
 #endif
 
+// fills the tables of the horizontal pass of pyrDown, returns the number of the destination row
+// elements that do not need the border interpolation
+static int pyrDownInitTabs( int swidth, int dwidth, int cn, int borderType, int* tabL, int* tabR, int* tabM )
+{
+    const int PD_SZ = 5;
+    int k, x, width0 = std::min((swidth-PD_SZ/2-1)/2 + 1, dwidth);
+
+    for( x = 0; x <= PD_SZ+1; x++ )
+    {
+        int sx0 = borderInterpolate(x - PD_SZ/2, swidth, borderType)*cn;
+        int sx1 = borderInterpolate(x + width0*2 - PD_SZ/2, swidth, borderType)*cn;
+        for( k = 0; k < cn; k++ )
+        {
+            tabL[x*cn + k] = sx0 + k;
+            tabR[x*cn + k] = sx1 + k;
+        }
+    }
+
+    for( x = 0; x < dwidth*cn; x++ )
+        tabM[x] = (x/cn)*2*cn + x % cn;
+
+    return width0*cn;
+}
+
+// horizontal convolution and decimation of a source row
+template<typename T, typename WT> static void
+pyrDownRow_( const T* src, WT* row, const int* tabL, const int* tabR, const int* tabM,
+             int cn, int width0, int dwidth )
+{
+    int x, limit = cn;
+    const int* tab = tabL;
+
+    for( x = 0;;)
+    {
+        for( ; x < limit; x++ )
+        {
+            row[x] = src[tab[x+cn*2]]*6 + (src[tab[x+cn]] + src[tab[x+cn*3]])*4 +
+                src[tab[x]] + src[tab[x+cn*4]];
+        }
+
+        if( x == dwidth )
+            break;
+
+        if( cn == 1 )
+        {
+            for( ; x < width0; x++ )
+                row[x] = src[x*2]*6 + (src[x*2 - 1] + src[x*2 + 1])*4 +
+                    src[x*2 - 2] + src[x*2 + 2];
+        }
+        else if( cn == 3 )
+        {
+            for( ; x < width0; x += 3 )
+            {
+                const T* s = src + x*2;
+                WT t0 = s[0]*6 + (s[-3] + s[3])*4 + s[-6] + s[6];
+                WT t1 = s[1]*6 + (s[-2] + s[4])*4 + s[-5] + s[7];
+                WT t2 = s[2]*6 + (s[-1] + s[5])*4 + s[-4] + s[8];
+                row[x] = t0; row[x+1] = t1; row[x+2] = t2;
+            }
+        }
+        else if( cn == 4 )
+        {
+            for( ; x < width0; x += 4 )
+            {
+                const T* s = src + x*2;
+                WT t0 = s[0]*6 + (s[-4] + s[4])*4 + s[-8] + s[8];
+                WT t1 = s[1]*6 + (s[-3] + s[5])*4 + s[-7] + s[9];
+                row[x] = t0; row[x+1] = t1;
+                t0 = s[2]*6 + (s[-2] + s[6])*4 + s[-6] + s[10];
+                t1 = s[3]*6 + (s[-1] + s[7])*4 + s[-5] + s[11];
+                row[x+2] = t0; row[x+3] = t1;
+            }
+        }
+        else
+        {
+            for( ; x < width0; x++ )
+            {
+                int sx = tabM[x];
+                row[x] = src[sx]*6 + (src[sx - cn] + src[sx + cn])*4 +
+                    src[sx - cn*2] + src[sx + cn*2];
+            }
+        }
+
+        limit = dwidth;
+        tab = tabR - x;
+    }
+}
+
 template<class CastOp, class VecOp> void
 pyrDown_( const Mat& _src, Mat& _dst, int borderType )
 {
@@ -859,10 +947,10 @@ pyrDown_( const Mat& _src, Mat& _dst, int borderType )
     Size ssize = _src.size(), dsize = _dst.size();
     int cn = _src.channels();
     int bufstep = (int)alignSize(dsize.width*cn, 16);
-    AutoBuffer<WT> _buf(bufstep*PD_SZ + 16);
+    utils::ScratchBuffer<WT> _buf(bufstep*PD_SZ + 16);
     WT* buf = alignPtr((WT*)_buf, 16);
     int tabL[CV_CN_MAX*(PD_SZ+2)], tabR[CV_CN_MAX*(PD_SZ+2)];
-    AutoBuffer<int> _tabM(dsize.width*cn);
+    utils::ScratchBuffer<int> _tabM(dsize.width*cn);
     int* tabM = _tabM;
     WT* rows[PD_SZ];
     CastOp castOp;
@@ -871,25 +959,11 @@ pyrDown_( const Mat& _src, Mat& _dst, int borderType )
     CV_Assert( ssize.width > 0 && ssize.height > 0 &&
                std::abs(dsize.width*2 - ssize.width) <= 2 &&
                std::abs(dsize.height*2 - ssize.height) <= 2 );
-    int k, x, sy0 = -PD_SZ/2, sy = sy0, width0 = std::min((ssize.width-PD_SZ/2-1)/2 + 1, dsize.width);
-
-    for( x = 0; x <= PD_SZ+1; x++ )
-    {
-        int sx0 = borderInterpolate(x - PD_SZ/2, ssize.width, borderType)*cn;
-        int sx1 = borderInterpolate(x + width0*2 - PD_SZ/2, ssize.width, borderType)*cn;
-        for( k = 0; k < cn; k++ )
-        {
-            tabL[x*cn + k] = sx0 + k;
-            tabR[x*cn + k] = sx1 + k;
-        }
-    }
+    int k, x, sy0 = -PD_SZ/2, sy = sy0;
+    int width0 = pyrDownInitTabs(ssize.width, dsize.width, cn, borderType, tabL, tabR, tabM);
 
     ssize.width *= cn;
     dsize.width *= cn;
-    width0 *= cn;
-
-    for( x = 0; x < dsize.width; x++ )
-        tabM[x] = (x/cn)*2*cn + x % cn;
 
     for( int y = 0; y < dsize.height; y++ )
     {
@@ -901,64 +975,7 @@ pyrDown_( const Mat& _src, Mat& _dst, int borderType )
         {
             WT* row = buf + ((sy - sy0) % PD_SZ)*bufstep;
             int _sy = borderInterpolate(sy, ssize.height, borderType);
-            const T* src = _src.ptr<T>(_sy);
-            int limit = cn;
-            const int* tab = tabL;
-
-            for( x = 0;;)
-            {
-                for( ; x < limit; x++ )
-                {
-                    row[x] = src[tab[x+cn*2]]*6 + (src[tab[x+cn]] + src[tab[x+cn*3]])*4 +
-                        src[tab[x]] + src[tab[x+cn*4]];
-                }
-
-                if( x == dsize.width )
-                    break;
-
-                if( cn == 1 )
-                {
-                    for( ; x < width0; x++ )
-                        row[x] = src[x*2]*6 + (src[x*2 - 1] + src[x*2 + 1])*4 +
-                            src[x*2 - 2] + src[x*2 + 2];
-                }
-                else if( cn == 3 )
-                {
-                    for( ; x < width0; x += 3 )
-                    {
-                        const T* s = src + x*2;
-                        WT t0 = s[0]*6 + (s[-3] + s[3])*4 + s[-6] + s[6];
-                        WT t1 = s[1]*6 + (s[-2] + s[4])*4 + s[-5] + s[7];
-                        WT t2 = s[2]*6 + (s[-1] + s[5])*4 + s[-4] + s[8];
-                        row[x] = t0; row[x+1] = t1; row[x+2] = t2;
-                    }
-                }
-                else if( cn == 4 )
-                {
-                    for( ; x < width0; x += 4 )
-                    {
-                        const T* s = src + x*2;
-                        WT t0 = s[0]*6 + (s[-4] + s[4])*4 + s[-8] + s[8];
-                        WT t1 = s[1]*6 + (s[-3] + s[5])*4 + s[-7] + s[9];
-                        row[x] = t0; row[x+1] = t1;
-                        t0 = s[2]*6 + (s[-2] + s[6])*4 + s[-6] + s[10];
-                        t1 = s[3]*6 + (s[-1] + s[7])*4 + s[-5] + s[11];
-                        row[x+2] = t0; row[x+3] = t1;
-                    }
-                }
-                else
-                {
-                    for( ; x < width0; x++ )
-                    {
-                        int sx = tabM[x];
-                        row[x] = src[sx]*6 + (src[sx - cn] + src[sx + cn])*4 +
-                            src[sx - cn*2] + src[sx + cn*2];
-                    }
-                }
-
-                limit = dsize.width;
-                tab = tabR - x;
-            }
+            pyrDownRow_(_src.ptr<T>(_sy), row, tabL, tabR, tabM, cn, width0, dsize.width);
         }
 
         // do vertical convolution and decimation and write the result to the destination image
@@ -983,9 +1000,9 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
     Size ssize = _src.size(), dsize = _dst.size();
     int cn = _src.channels();
     int bufstep = (int)alignSize((dsize.width+1)*cn, 16);
-    AutoBuffer<WT> _buf(bufstep*PU_SZ + 16);
+    utils::ScratchBuffer<WT> _buf(bufstep*PU_SZ + 16);
     WT* buf = alignPtr((WT*)_buf, 16);
-    AutoBuffer<int> _dtab(ssize.width*cn);
+    utils::ScratchBuffer<int> _dtab(ssize.width*cn);
     int* dtab = _dtab;
     WT* rows[PU_SZ];
     T* dsts[2];
@@ -1077,6 +1094,164 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
     }
 }
 
+/*
+ Fused pyramid construction: the source image is streamed through all the layers at once. Every
+ layer keeps a ring of 5 horizontally filtered rows of the previous layer, and a new row of a layer
+ is passed to the next layer right away, while it is still in the cache.
+
+ The layers are split into horizontal bands processed in parallel. A band writes its own rows of
+ every layer; the rows of the neighbour bands needed by the next layer (the halo) are recomputed
+ by the band and kept in a small ring of rows.
+*/
+enum { PYR_HALO_RING = 8, PYR_BAND_MIN_AREA = 1 << 15 };
+
+template<class CastOp, class VecOp> class PyrDownFused_Invoker : public ParallelLoopBody
+{
+public:
+    typedef typename CastOp::type1 WT;
+    typedef typename CastOp::rtype T;
+
+    PyrDownFused_Invoker(Mat* _levels, int _nlevels, int _borderType, int _nbands) :
+        levels(_levels), nlevels(_nlevels), borderType(_borderType), nbands(_nbands)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        for( int b = range.start; b < range.end; b++ )
+            band(b);
+    }
+
+private:
+    struct Stage
+    {
+        int o0, o1;     // rows of the layer written by the band
+        int n0, n1;     // rows of the layer computed by the band
+        int y, sy;      // the next row of the layer and the next horizontally filtered row of the previous one
+        int dwidth, width0, bufstep;
+        int *tabL, *tabR, *tabM;
+        WT* buf;        // 5 horizontally filtered rows
+        T* halo;        // the computed rows that are not written to the layer
+    };
+
+    void band(int b) const
+    {
+        const int PD_SZ = 5;
+        int k, cn = levels[0].channels();
+        std::vector<Stage> st(nlevels + 1);
+        size_t bufsize = 0;
+
+        for( k = nlevels; k >= 1; k-- )
+        {
+            Stage& s = st[k];
+            int h = levels[k].rows;
+            s.o0 = (int)((int64)h*b/nbands);
+            s.o1 = (int)((int64)h*(b + 1)/nbands);
+            s.n0 = s.o0;
+            s.n1 = s.o1;
+            if( k < nlevels && st[k+1].n0 < st[k+1].n1 )
+            {
+                int a0 = std::max(st[k+1].n0*2 - PD_SZ/2, 0);
+                int a1 = std::min(st[k+1].n1*2 + PD_SZ/2 - 1, h);
+                s.n0 = s.o0 < s.o1 ? std::min(s.n0, a0) : a0;
+                s.n1 = s.o0 < s.o1 ? std::max(s.n1, a1) : a1;
+            }
+            s.dwidth = levels[k].cols*cn;
+            s.bufstep = (int)alignSize(s.dwidth, 16);
+            bufsize += alignSize(s.bufstep*PD_SZ*sizeof(WT), CV_MALLOC_ALIGN) +
+                       alignSize(s.dwidth*PYR_HALO_RING*sizeof(T), CV_MALLOC_ALIGN) +
+                       alignSize((cn*(PD_SZ+2)*2 + s.dwidth)*sizeof(int), CV_MALLOC_ALIGN);
+        }
+
+        utils::ScratchBuffer<uchar> _buf(bufsize + CV_MALLOC_ALIGN);
+        uchar* ptr = alignPtr((uchar*)_buf, CV_MALLOC_ALIGN);
+        for( k = 1; k <= nlevels; k++ )
+        {
+            Stage& s = st[k];
+            s.buf = (WT*)ptr;
+            ptr += alignSize(s.bufstep*PD_SZ*sizeof(WT), CV_MALLOC_ALIGN);
+            s.halo = (T*)ptr;
+            ptr += alignSize(s.dwidth*PYR_HALO_RING*sizeof(T), CV_MALLOC_ALIGN);
+            s.tabL = (int*)ptr;
+            s.tabR = s.tabL + cn*(PD_SZ+2);
+            s.tabM = s.tabR + cn*(PD_SZ+2);
+            ptr += alignSize((cn*(PD_SZ+2)*2 + s.dwidth)*sizeof(int), CV_MALLOC_ALIGN);
+            s.width0 = pyrDownInitTabs(levels[k-1].cols, levels[k].cols, cn, borderType, s.tabL, s.tabR, s.tabM);
+            s.y = s.n0;
+            s.sy = s.n0*2 - PD_SZ/2;
+        }
+
+        while( st[1].y < st[1].n1 )
+        {
+            produce(st, 1, cn);
+            pump(st, 2, cn);
+        }
+    }
+
+    // computes the rows of the layer k that can be computed from the available rows of the previous one
+    void pump(std::vector<Stage>& st, int k, int cn) const
+    {
+        if( k > nlevels )
+            return;
+        Stage& s = st[k];
+        int ready = st[k-1].y, srows = levels[k-1].rows;
+        while( s.y < s.n1 && std::min(s.y*2 + 2, srows - 1) < ready )
+        {
+            produce(st, k, cn);
+            pump(st, k + 1, cn);
+        }
+    }
+
+    const T* row(const std::vector<Stage>& st, int k, int y) const
+    {
+        if( k == 0 || (st[k].o0 <= y && y < st[k].o1) )
+            return levels[k].ptr<T>(y);
+        return st[k].halo + (y % PYR_HALO_RING)*st[k].dwidth;
+    }
+
+    void produce(std::vector<Stage>& st, int k, int cn) const
+    {
+        const int PD_SZ = 5;
+        Stage& s = st[k];
+        int x, y = s.y, sy0 = s.n0*2 - PD_SZ/2, srows = levels[k-1].rows;
+        CastOp castOp;
+        VecOp vecOp;
+        WT* rows[PD_SZ];
+
+        for( ; s.sy <= y*2 + 2; s.sy++ )
+        {
+            int _sy = borderInterpolate(s.sy, srows, borderType);
+            pyrDownRow_(row(st, k-1, _sy), s.buf + ((s.sy - sy0) % PD_SZ)*s.bufstep,
+                        s.tabL, s.tabR, s.tabM, cn, s.width0, s.dwidth);
+        }
+
+        for( x = 0; x < PD_SZ; x++ )
+            rows[x] = s.buf + ((y*2 - PD_SZ/2 + x - sy0) % PD_SZ)*s.bufstep;
+        T* dst = (T*)row(st, k, y);
+        x = vecOp(rows, dst, (int)levels[k].step, s.dwidth);
+        for( ; x < s.dwidth; x++ )
+            dst[x] = castOp(rows[2][x]*6 + (rows[1][x] + rows[3][x])*4 + rows[0][x] + rows[4][x]);
+        s.y++;
+    }
+
+    Mat* levels;
+    int nlevels;
+    int borderType;
+    int nbands;
+};
+
+template<class CastOp, class VecOp> void
+buildPyramidFused_( Mat* levels, int nlevels, int borderType, int nbands )
+{
+    PyrDownFused_Invoker<CastOp, VecOp> invoker(levels, nlevels, borderType, nbands);
+    if( nbands > 1 )
+        parallel_for_(Range(0, nbands), invoker, nbands);
+    else
+        invoker(Range(0, 1));
+}
+
+typedef void (*PyrFusedFunc)(Mat*, int, int, int);
+
 typedef void (*PyrFunc)(const Mat&, Mat&, int);
 
 #ifdef HAVE_OPENCL
@@ -1638,6 +1813,95 @@ void cv::buildPyramid( InputArray _src, OutputArrayOfArrays _dst, int maxlevel,
         pyrDown( _dst.getMatRef(i-1), _dst.getMatRef(i), Size(), borderType );
 }
 
+void cv::buildPyramid( InputArray _src, Mat& buf, std::vector<Mat>& pyr, int maxlevel, int borderType )
+{
+    CV_INSTRUMENT_REGION()
+
+    borderType &= ~BORDER_ISOLATED;
+    CV_Assert( borderType != BORDER_CONSTANT && maxlevel >= 0 );
+
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.dims <= 2 );
+    int i, depth = src.depth(), cn = src.channels();
+    size_t esz1 = src.elemSize1();
+
+    // the layers are continuous and start at the cache line boundaries of the buffer
+    std::vector<Size> sizes(maxlevel + 1);
+    std::vector<size_t> ofs(maxlevel + 1, 0);
+    size_t total = 0;
+    sizes[0] = src.size();
+    for( i = 1; i <= maxlevel; i++ )
+    {
+        sizes[i] = Size((sizes[i-1].width + 1)/2, (sizes[i-1].height + 1)/2);
+        ofs[i] = total;
+        total += alignSize((size_t)sizes[i].area()*cn, CV_MALLOC_ALIGN/esz1);
+    }
+    total += CV_MALLOC_ALIGN/esz1;
+    CV_Assert( total <= (size_t)INT_MAX );
+
+    // the source may be a layer built by the previous call
+    bool overlap = src.u && src.u == buf.u;
+    if( overlap || buf.rows != 1 || buf.type() != depth || buf.cols < (int)total )
+    {
+        buf.release();
+        buf.create(1, (int)total, depth);
+    }
+
+    size_t shift = (alignPtr(buf.ptr(), CV_MALLOC_ALIGN) - buf.ptr())/esz1;
+    pyr.resize(maxlevel + 1);
+    pyr[0] = src;
+    for( i = 1; i <= maxlevel; i++ )
+    {
+        int start = (int)(ofs[i] + shift);
+        pyr[i] = buf.colRange(start, start + sizes[i].area()*cn).reshape(cn, sizes[i].height);
+    }
+
+    PyrFusedFunc func = 0;
+    if( depth == CV_8U )
+        func = buildPyramidFused_<FixPtCast<uchar, 8>, PyrDownVec_32s8u>;
+    else if( depth == CV_16S )
+        func = buildPyramidFused_<FixPtCast<short, 8>, PyrDownVec_32s16s >;
+    else if( depth == CV_16U )
+        func = buildPyramidFused_<FixPtCast<ushort, 8>, PyrDownVec_32s16u >;
+    else if( depth == CV_32F )
+        func = buildPyramidFused_<FltCast<float, 8>, PyrDownVec_32f>;
+    else if( depth == CV_64F )
+        func = buildPyramidFused_<FltCast<double, 8>, PyrDownNoVec<double, double> >;
+    else
+        CV_Error( CV_StsUnsupportedFormat, "" );
+
+    // a wrapped row may come from the other end of the previous layer, so it can not be streamed
+    if( borderType == BORDER_WRAP )
+    {
+        for( i = 1; i <= maxlevel; i++ )
+            pyrDown( pyr[i-1], pyr[i], sizes[i], borderType );
+        return;
+    }
+
+    int nthreads = getNumThreads();
+    for( i = 0; i < maxlevel; )
+    {
+        int i1 = maxlevel, nbands = 1;
+        if( nthreads > 1 )
+        {
+            // the halo doubles with every layer, so only the large layers are split into bands,
+            // the small ones are built by another pass from the last large layer
+            i1 = i + 1;
+            while( i1 < maxlevel && sizes[i1+1].area() >= PYR_BAND_MIN_AREA )
+                i1++;
+            int halo = 3*((1 << (i1 - i - 1)) - 1);
+            nbands = std::min(nthreads, std::min(sizes[i+1].area()/65536, sizes[i+1].height/(halo*8 + 16)));
+            if( nbands <= 1 )
+            {
+                i1 = maxlevel;
+                nbands = 1;
+            }
+        }
+        func( &pyr[i], i1 - i, borderType, nbands );
+        i = i1;
+    }
+}
+
 CV_IMPL void cvPyrDown( const void* srcarr, void* dstarr, int _filter )
 {
     cv::Mat src = cv::cvarrToMat(srcarr), dst = cv::cvarrToMat(dstarr);
@@ -43,6 +43,7 @@
 
 #include "precomp.hpp"
 #include "opencv2/core/hal/intrin.hpp"
+#include "opencv2/core/utils/buffer_pool.private.hpp"
 #include "opencl_kernels_imgproc.hpp"
 
 #include "opencv2/core/openvx/ovx_defs.hpp"
@@ -196,6 +197,7 @@ struct ColumnSum :
     }
 
     virtual void reset() { sumCount = 0; }
+    virtual Ptr<BaseColumnFilter> clone() const { return makePtr<ColumnSum>(*this); }
 
     virtual void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
     {
@@ -294,6 +296,7 @@ struct ColumnSum<int, uchar> :
     }
 
     virtual void reset() { sumCount = 0; }
+    virtual Ptr<BaseColumnFilter> clone() const { return makePtr<ColumnSum>(*this); }
 
     virtual void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
     {
@@ -441,6 +444,7 @@ public BaseColumnFilter
     }
 
     virtual void reset() { sumCount = 0; }
+    virtual Ptr<BaseColumnFilter> clone() const { return makePtr<ColumnSum>(*this); }
 
     virtual void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
     {
@@ -570,6 +574,7 @@ struct ColumnSum<int, short> :
     }
 
     virtual void reset() { sumCount = 0; }
+    virtual Ptr<BaseColumnFilter> clone() const { return makePtr<ColumnSum>(*this); }
 
     virtual void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
     {
@@ -698,6 +703,7 @@ struct ColumnSum<int, ushort> :
     }
 
     virtual void reset() { sumCount = 0; }
+    virtual Ptr<BaseColumnFilter> clone() const { return makePtr<ColumnSum>(*this); }
 
     virtual void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
     {
@@ -823,6 +829,7 @@ struct ColumnSum<int, int> :
     }
 
     virtual void reset() { sumCount = 0; }
+    virtual Ptr<BaseColumnFilter> clone() const { return makePtr<ColumnSum>(*this); }
 
     virtual void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
     {
@@ -942,6 +949,7 @@ struct ColumnSum<int, float> :
     }
 
     virtual void reset() { sumCount = 0; }
+    virtual Ptr<BaseColumnFilter> clone() const { return makePtr<ColumnSum>(*this); }
 
     virtual void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
     {
@@ -2218,10 +2226,10 @@ medianBlur_8u_O1( const Mat& _src, Mat& _dst, int ksize )
 
     int STRIPE_SIZE = std::min( _dst.cols, 512/cn );
 
-    std::vector<HT> _h_coarse(1 * 16 * (STRIPE_SIZE + 2*r) * cn + 16);
-    std::vector<HT> _h_fine(16 * 16 * (STRIPE_SIZE + 2*r) * cn + 16);
-    HT* h_coarse = alignPtr(&_h_coarse[0], 16);
-    HT* h_fine = alignPtr(&_h_fine[0], 16);
+    utils::ScratchBuffer<HT> _h_coarse(1 * 16 * (STRIPE_SIZE + 2*r) * cn + 16);
+    utils::ScratchBuffer<HT> _h_fine(16 * 16 * (STRIPE_SIZE + 2*r) * cn + 16);
+    HT* h_coarse = alignPtr((HT*)_h_coarse, 16);
+    HT* h_fine = alignPtr((HT*)_h_fine, 16);
 #if CV_SIMD128
     volatile bool useSIMD = hasSIMD128();
 #endif
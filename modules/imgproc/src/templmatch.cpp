@@ -41,6 +41,7 @@
 
 #include "precomp.hpp"
 #include "opencl_kernels_imgproc.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 ////////////////////////////////////////////////// matchTemplate //////////////////////////////////////////////////////////
 
@@ -762,118 +763,37 @@ void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
     }
 }
 
-static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _result, int method, InputArray _mask )
+// statistics of a template used to turn the cross-correlation into the method values
+struct TemplateStats
 {
-    int type = _img.type(), depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
-    CV_Assert( CV_TM_SQDIFF <= method && method <= CV_TM_CCOEFF_NORMED );
-    CV_Assert( (depth == CV_8U || depth == CV_32F) && type == _templ.type() && _img.dims() <= 2 );
-
-    Mat img = _img.getMat(), templ = _templ.getMat(), mask = _mask.getMat();
-    int ttype = templ.type(), tdepth = CV_MAT_DEPTH(ttype), tcn = CV_MAT_CN(ttype);
-    int mtype = img.type(), mdepth = CV_MAT_DEPTH(type), mcn = CV_MAT_CN(mtype);
-
-    if (depth == CV_8U)
-    {
-        depth = CV_32F;
-        type = CV_MAKETYPE(CV_32F, cn);
-        img.convertTo(img, type, 1.0 / 255);
-    }
-
-    if (tdepth == CV_8U)
-    {
-        tdepth = CV_32F;
-        ttype = CV_MAKETYPE(CV_32F, tcn);
-        templ.convertTo(templ, ttype, 1.0 / 255);
-    }
+    TemplateStats() : method(CV_TM_CCORR), cn(1), templNorm(0), templSum2(0), constResult(false) {}
 
-    if (mdepth == CV_8U)
+    void compute(const Mat& templ, int _method)
     {
-        mdepth = CV_32F;
-        mtype = CV_MAKETYPE(CV_32F, mcn);
-        compare(mask, Scalar::all(0), mask, CMP_NE);
-        mask.convertTo(mask, mtype, 1.0 / 255);
-    }
-
-    Size corrSize(img.cols - templ.cols + 1, img.rows - templ.rows + 1);
-    _result.create(corrSize, CV_32F);
-    Mat result = _result.getMat();
-
-    Mat img2 = img.mul(img);
-    Mat mask2 = mask.mul(mask);
-    Mat mask_templ = templ.mul(mask);
-    Scalar templMean, templSdv;
-
-    double templSum2 = 0;
-    meanStdDev( mask_templ, templMean, templSdv );
-
-    templSum2 = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
-    templSum2 += templMean[0]*templMean[0] + templMean[1]*templMean[1] + templMean[2]*templMean[2] + templMean[3]*templMean[3];
-    templSum2 *= ((double)templ.rows * templ.cols);
-
-    if (method == CV_TM_SQDIFF)
-    {
-        Mat mask2_templ = templ.mul(mask2);
+        method = _method;
+        size = templ.size();
+        cn = templ.channels();
+        if( method == CV_TM_CCORR )
+            return;
 
-        Mat corr(corrSize, CV_32F);
-        crossCorr( img, mask2_templ, corr, corr.size(), corr.type(), Point(0,0), 0, 0 );
-        crossCorr( img2, mask, result, result.size(), result.type(), Point(0,0), 0, 0 );
+        int numType = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0 :
+                      method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED ? 1 : 2;
+        double invArea = 1./((double)templ.rows * templ.cols);
+        Scalar templSdv;
 
-        result -= corr * 2;
-        result += templSum2;
-    }
-    else if (method == CV_TM_CCORR_NORMED)
-    {
-        if (templSum2 < DBL_EPSILON)
+        if( method == CV_TM_CCOEFF )
         {
-            result = Scalar::all(1);
+            templMean = mean(templ);
             return;
         }
 
-        Mat corr(corrSize, CV_32F);
-        crossCorr( img2, mask2, corr, corr.size(), corr.type(), Point(0,0), 0, 0 );
-        crossCorr( img, mask_templ, result, result.size(), result.type(), Point(0,0), 0, 0 );
-
-        sqrt(corr, corr);
-        result = result.mul(1/corr);
-        result /= std::sqrt(templSum2);
-    }
-    else
-        CV_Error(Error::StsNotImplemented, "");
-}
-
-static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
-{
-    if( method == CV_TM_CCORR )
-        return;
-
-    int numType = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0 :
-                  method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED ? 1 : 2;
-    bool isNormed = method == CV_TM_CCORR_NORMED ||
-                    method == CV_TM_SQDIFF_NORMED ||
-                    method == CV_TM_CCOEFF_NORMED;
-
-    double invArea = 1./((double)templ.rows * templ.cols);
-
-    Mat sum, sqsum;
-    Scalar templMean, templSdv;
-    double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
-    double templNorm = 0, templSum2 = 0;
-
-    if( method == CV_TM_CCOEFF )
-    {
-        integral(img, sum, CV_64F);
-        templMean = mean(templ);
-    }
-    else
-    {
-        integral(img, sum, sqsum, CV_64F);
         meanStdDev( templ, templMean, templSdv );
 
         templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
 
         if( templNorm < DBL_EPSILON && method == CV_TM_CCOEFF_NORMED )
         {
-            result = Scalar::all(1);
+            constResult = true;
             return;
         }
 
@@ -888,26 +808,52 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
         templSum2 /= invArea;
         templNorm = std::sqrt(templNorm);
         templNorm /= std::sqrt(invArea); // care of accuracy here
+    }
 
+    int method;
+    Size size;
+    int cn;
+    Scalar templMean;
+    double templNorm, templSum2;
+    bool constResult; // the template is flat, the result is 1 everywhere
+};
+
+// converts the rows of the cross-correlation into the method values using the integrals of the image
+static void normalizeCorr( const Mat& sum, const Mat& sqsum, const TemplateStats& ts, Mat& result, const Range& rows )
+{
+    int method = ts.method, cn = ts.cn;
+    int numType = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0 :
+                  method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED ? 1 : 2;
+    bool isNormed = method == CV_TM_CCORR_NORMED ||
+                    method == CV_TM_SQDIFF_NORMED ||
+                    method == CV_TM_CCOEFF_NORMED;
+
+    double invArea = 1./((double)ts.size.height * ts.size.width);
+    const Scalar& templMean = ts.templMean;
+    double templNorm = ts.templNorm, templSum2 = ts.templSum2;
+    const double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
+
+    if( method != CV_TM_CCOEFF )
+    {
         CV_Assert(sqsum.data != NULL);
-        q0 = (double*)sqsum.data;
-        q1 = q0 + templ.cols*cn;
-        q2 = (double*)(sqsum.data + templ.rows*sqsum.step);
-        q3 = q2 + templ.cols*cn;
+        q0 = (const double*)sqsum.data;
+        q1 = q0 + ts.size.width*cn;
+        q2 = (const double*)(sqsum.data + ts.size.height*sqsum.step);
+        q3 = q2 + ts.size.width*cn;
     }
 
     CV_Assert(sum.data != NULL);
-    double* p0 = (double*)sum.data;
-    double* p1 = p0 + templ.cols*cn;
-    double* p2 = (double*)(sum.data + templ.rows*sum.step);
-    double* p3 = p2 + templ.cols*cn;
+    const double* p0 = (const double*)sum.data;
+    const double* p1 = p0 + ts.size.width*cn;
+    const double* p2 = (const double*)(sum.data + ts.size.height*sum.step);
+    const double* p3 = p2 + ts.size.width*cn;
 
     int sumstep = sum.data ? (int)(sum.step / sizeof(double)) : 0;
     int sqstep = sqsum.data ? (int)(sqsum.step / sizeof(double)) : 0;
 
     int i, j, k;
 
-    for( i = 0; i < result.rows; i++ )
+    for( i = rows.start; i < rows.end; i++ )
     {
         float* rrow = result.ptr<float>(i);
         int idx = i * sumstep;
@@ -960,6 +906,519 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
         }
     }
 }
+
+class MatchTemplateNormalize_Invoker : public ParallelLoopBody
+{
+public:
+    MatchTemplateNormalize_Invoker(const Mat& _sum, const Mat& _sqsum, const TemplateStats& _ts, Mat& _result) :
+        sum(_sum), sqsum(_sqsum), ts(_ts), result(_result)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        normalizeCorr(sum, sqsum, ts, result, range);
+    }
+
+private:
+    const Mat& sum;
+    const Mat& sqsum;
+    const TemplateStats& ts;
+    Mat& result;
+};
+
+static void normalizeCorr( const Mat& sum, const Mat& sqsum, const TemplateStats& ts, Mat& result )
+{
+    if( ts.method == CV_TM_CCORR )
+        return;
+    if( ts.constResult )
+    {
+        result = Scalar::all(1);
+        return;
+    }
+    parallel_for_(Range(0, result.rows), MatchTemplateNormalize_Invoker(sum, sqsum, ts, result),
+                  (double)result.total()/(1 << 16));
+}
+
+/*
+ TemplateMatcher computes the numerators of the methods as sums of the cross-correlations of the
+ image or its square with kernels derived from the templates:
+
+   the methods without a mask:  corr(I, T)
+   TM_SQDIFF with a mask:       corr(I^2, M) + corr(I, -2*T*M^2)
+   TM_CCORR_NORMED with a mask: corr(I, T*M) and corr(I^2, M^2)
+
+ The small kernels are applied directly. The large ones are applied by tiles in the frequency domain:
+ the spectrum of an image tile is computed once for all the kernels, the products with the kernel
+ spectra are summed over the channels and the terms, and only the sum is transformed back.
+*/
+// the smallest kernel (the area of its planes, double precision ones counted twice) applied in the frequency domain
+enum { TM_DFT_MIN_AREA = 150 };
+
+// adds the correlation of a source row with a kernel row to the accumulator row
+static void corrRowAdd( float* acc, const float* src, const float* k, int kw, int n )
+{
+    int x = 0, kx;
+#if CV_SIMD
+    for( ; x <= n - v_float32::nlanes; x += v_float32::nlanes )
+    {
+        v_float32 s = vx_load(acc + x);
+        for( kx = 0; kx < kw; kx++ )
+            s = v_muladd(vx_load(src + x + kx), vx_setall_f32(k[kx]), s);
+        v_store(acc + x, s);
+    }
+#endif
+    for( ; x < n; x++ )
+    {
+        float s = acc[x];
+        for( kx = 0; kx < kw; kx++ )
+            s += src[x + kx]*k[kx];
+        acc[x] = s;
+    }
+}
+
+static void corrRowAdd( double* acc, const double* src, const double* k, int kw, int n )
+{
+    int x = 0, kx;
+#if CV_SIMD_64F
+    for( ; x <= n - v_float64::nlanes; x += v_float64::nlanes )
+    {
+        v_float64 s = vx_load(acc + x);
+        for( kx = 0; kx < kw; kx++ )
+            s = v_muladd(vx_load(src + x + kx), vx_setall_f64(k[kx]), s);
+        v_store(acc + x, s);
+    }
+#endif
+    for( ; x < n; x++ )
+    {
+        double s = acc[x];
+        for( kx = 0; kx < kw; kx++ )
+            s += src[x + kx]*k[kx];
+        acc[x] = s;
+    }
+}
+
+} // namespace cv
+
+struct cv::TemplateMatcher::Impl
+{
+    enum { SRC_IMAGE = 0, SRC_SQR = 1 };
+
+    struct Term
+    {
+        int source;                 // SRC_IMAGE or SRC_SQR
+        int map;                    // index of the correlation map the term is added to
+        std::vector<Mat> planes;    // kernel planes of the working depth, one per channel
+        int specIdx;                // index of the first plane spectrum
+    };
+
+    struct Templ
+    {
+        Size size;
+        bool useDFT;
+        int nmaps;
+        std::vector<Term> terms;
+        TemplateStats stats;        // the methods without a mask
+        double sum2;                // squared norm of T*M
+    };
+
+    // kernel spectra and transforms for one DFT size
+    struct Spectra
+    {
+        Size dftsize;
+        std::vector<Mat> planes;
+        DFTPlan forward, inverse;
+    };
+
+    Impl() : method(CV_TM_SQDIFF), type(-1), cn(1), workDepth(CV_32F), masked(false), nspectra(0) {}
+
+    void addTerm(Templ& t, int source, int map, const Mat& kernel)
+    {
+        Term term;
+        term.source = source;
+        term.map = map;
+        split(kernel, term.planes);
+        for( int c = 0; c < cn; c++ )
+            term.planes[c].convertTo(term.planes[c], workDepth);
+        term.specIdx = -1;
+        if( t.useDFT )
+        {
+            term.specIdx = nspectra;
+            nspectra += cn;
+        }
+        t.terms.push_back(term);
+    }
+
+    void addTemplate(const Mat& templ, const Mat& _mask)
+    {
+        CV_Assert( templ.type() == type && templ.dims <= 2 && !templ.empty() );
+        Templ t;
+        t.size = templ.size();
+        t.useDFT = t.size.area()*cn*(workDepth == CV_64F ? 2 : 1) >= TM_DFT_MIN_AREA;
+        t.nmaps = 1;
+        t.sum2 = 0;
+
+        if( !masked )
+        {
+            t.stats.compute(templ, method);
+            addTerm(t, SRC_IMAGE, 0, templ);
+        }
+        else
+        {
+            CV_Assert( _mask.size() == templ.size() && _mask.channels() == cn );
+            Mat tf = templ, mask = _mask;
+            // the 8-bit data is scaled to [0, 1], the 8-bit mask is binarized
+            if( CV_MAT_DEPTH(type) == CV_8U )
+            {
+                templ.convertTo(tf, CV_MAKETYPE(CV_64F, cn), 1.0/255);
+                compare(_mask, Scalar::all(0), mask, CMP_NE);
+                mask.convertTo(mask, CV_MAKETYPE(CV_64F, cn), 1.0/255);
+            }
+            else
+            {
+                templ.convertTo(tf, CV_MAKETYPE(CV_64F, cn));
+                _mask.convertTo(mask, CV_MAKETYPE(CV_64F, cn));
+            }
+            Mat mask2 = mask.mul(mask), mask_templ = tf.mul(mask);
+            t.sum2 = norm(mask_templ, NORM_L2SQR);
+
+            if( method == CV_TM_SQDIFF )
+            {
+                addTerm(t, SRC_SQR, 0, mask);
+                addTerm(t, SRC_IMAGE, 0, tf.mul(mask2, -2));
+            }
+            else
+            {
+                t.nmaps = 2;
+                addTerm(t, SRC_IMAGE, 0, mask_templ);
+                addTerm(t, SRC_SQR, 1, mask2);
+            }
+        }
+        templs.push_back(t);
+    }
+
+    void create(const std::vector<Mat>& _templs, int _method, const std::vector<Mat>& masks)
+    {
+        CV_Assert( !_templs.empty() && (masks.empty() || masks.size() == _templs.size()) );
+        CV_Assert( CV_TM_SQDIFF <= _method && _method <= CV_TM_CCOEFF_NORMED );
+        method = _method;
+        type = _templs[0].type();
+        cn = CV_MAT_CN(type);
+        masked = !masks.empty();
+        CV_Assert( CV_MAT_DEPTH(type) == CV_8U || CV_MAT_DEPTH(type) == CV_32F );
+        if( masked && method != CV_TM_SQDIFF && method != CV_TM_CCORR_NORMED )
+            CV_Error(Error::StsNotImplemented, "Only TM_SQDIFF and TM_CCORR_NORMED methods support the mask");
+        workDepth = CV_MAT_DEPTH(type) == CV_8U && !masked ? CV_32F : CV_64F;
+
+        for( size_t i = 0; i < _templs.size(); i++ )
+            addTemplate(_templs[i], masked ? masks[i] : Mat());
+    }
+
+    Ptr<Spectra> getSpectra(Size dftsize)
+    {
+        AutoLock lock(mutex);
+        if( spectra && spectra->dftsize == dftsize )
+            return spectra;
+
+        Ptr<Spectra> s = makePtr<Spectra>();
+        s->dftsize = dftsize;
+        s->planes.resize(nspectra);
+        for( size_t i = 0; i < templs.size(); i++ )
+        {
+            const Templ& t = templs[i];
+            for( size_t j = 0; t.useDFT && j < t.terms.size(); j++ )
+                for( int c = 0; c < cn; c++ )
+                {
+                    const Mat& k = t.terms[j].planes[c];
+                    Mat& dst = s->planes[t.terms[j].specIdx + c];
+                    dst = Mat::zeros(dftsize, workDepth);
+                    k.copyTo(dst(Rect(0, 0, k.cols, k.rows)));
+                    dft(dst, dst, 0, k.rows);
+                }
+        }
+        s->forward.create(dftsize, workDepth, 0);
+        s->inverse.create(dftsize, workDepth, DFT_INVERSE + DFT_SCALE);
+        spectra = s;
+        return s;
+    }
+
+    void match(const Mat& img, std::vector<Mat>& results);
+
+    int method, type, cn, workDepth;
+    bool masked;
+    std::vector<Templ> templs;
+    int nspectra;
+    Mutex mutex;
+    Ptr<Spectra> spectra;
+};
+
+namespace cv
+{
+
+// computes the correlation maps of the large templates by tiles of the image
+class TemplateMatchDFT_Invoker : public ParallelLoopBody
+{
+public:
+    typedef TemplateMatcher::Impl Impl;
+
+    TemplateMatchDFT_Invoker(const Impl& _impl, const Impl::Spectra& _spec, const Mat& _img, double _scale,
+                             std::vector<Mat>& _maps, Size _blocksize, int _tilesX) :
+        impl(_impl), spec(_spec), img(_img), scale(_scale), maps(_maps), blocksize(_blocksize), tilesX(_tilesX)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        int cn = impl.cn;
+        Size dftsize = spec.dftsize;
+        std::vector<Mat> imgSpec(impl.masked ? cn*2 : cn);
+        Mat tile(dftsize, impl.workDepth), acc(dftsize, impl.workDepth), prod(dftsize, impl.workDepth), plane;
+
+        for( int t = range.start; t < range.end; t++ )
+        {
+            int x = (t % tilesX)*blocksize.width, y = (t / tilesX)*blocksize.height;
+            Rect r(x, y, std::min(dftsize.width, img.cols - x), std::min(dftsize.height, img.rows - y));
+            Mat src = img(r), dst = tile(Rect(0, 0, r.width, r.height));
+
+            // the spectra of the image channels, followed by the ones of their squares
+            for( int c = 0; c < cn; c++ )
+            {
+                if( r.width < dftsize.width || r.height < dftsize.height )
+                    tile = Scalar::all(0);
+                if( cn > 1 )
+                {
+                    extractChannel(src, plane, c);
+                    plane.convertTo(dst, impl.workDepth, scale);
+                }
+                else
+                    src.convertTo(dst, impl.workDepth, scale);
+                spec.forward.apply(tile, imgSpec[c], r.height);
+                if( impl.masked )
+                {
+                    multiply(dst, dst, dst);
+                    spec.forward.apply(tile, imgSpec[cn + c], r.height);
+                }
+            }
+
+            for( size_t i = 0; i < impl.templs.size(); i++ )
+            {
+                const Impl::Templ& tm = impl.templs[i];
+                Size csize = maps[i*2].size();
+                Rect cr(x, y, std::min(blocksize.width, csize.width - x), std::min(blocksize.height, csize.height - y));
+                if( !tm.useDFT || cr.width <= 0 || cr.height <= 0 )
+                    continue;
+
+                for( int m = 0; m < tm.nmaps; m++ )
+                {
+                    bool first = true;
+                    for( size_t j = 0; j < tm.terms.size(); j++ )
+                    {
+                        const Impl::Term& term = tm.terms[j];
+                        if( term.map != m )
+                            continue;
+                        for( int c = 0; c < cn; c++, first = false )
+                        {
+                            mulSpectrums(imgSpec[term.source*cn + c], spec.planes[term.specIdx + c],
+                                         first ? acc : prod, 0, true);
+                            if( !first )
+                                add(acc, prod, acc);
+                        }
+                    }
+                    spec.inverse.apply(acc, acc, cr.height);
+                    acc(Rect(0, 0, cr.width, cr.height)).convertTo(maps[i*2 + m](cr), CV_32F);
+                }
+            }
+        }
+    }
+
+private:
+    const Impl& impl;
+    const Impl::Spectra& spec;
+    const Mat& img;
+    double scale;
+    std::vector<Mat>& maps;
+    Size blocksize;
+    int tilesX;
+};
+
+// computes the correlation maps of the small templates directly
+template<typename WT> class TemplateMatchSpatial_Invoker : public ParallelLoopBody
+{
+public:
+    typedef TemplateMatcher::Impl Impl;
+
+    TemplateMatchSpatial_Invoker(const Impl& _impl, const std::vector<Mat>& _planes, std::vector<Mat>& _maps) :
+        impl(_impl), planes(_planes), maps(_maps)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        int cn = impl.cn;
+        AutoBuffer<WT> _acc(planes[0].cols*2);
+
+        for( size_t i = 0; i < impl.templs.size(); i++ )
+        {
+            const Impl::Templ& tm = impl.templs[i];
+            Size csize = maps[i*2].size();
+            if( tm.useDFT )
+                continue;
+
+            for( int y = range.start; y < std::min(range.end, csize.height); y++ )
+            {
+                WT* acc = _acc;
+                memset(acc, 0, csize.width*tm.nmaps*sizeof(acc[0]));
+
+                for( size_t j = 0; j < tm.terms.size(); j++ )
+                {
+                    const Impl::Term& term = tm.terms[j];
+                    WT* dst = acc + term.map*csize.width;
+                    for( int c = 0; c < cn; c++ )
+                    {
+                        const Mat& k = term.planes[c];
+                        const Mat& src = planes[term.source*cn + c];
+                        for( int ky = 0; ky < k.rows; ky++ )
+                            corrRowAdd(dst, src.ptr<WT>(y + ky), k.ptr<WT>(ky), k.cols, csize.width);
+                    }
+                }
+
+                for( int m = 0; m < tm.nmaps; m++ )
+                {
+                    float* mrow = maps[i*2 + m].ptr<float>(y);
+                    const WT* arow = acc + m*csize.width;
+                    for( int x = 0; x < csize.width; x++ )
+                        mrow[x] = (float)arow[x];
+                }
+            }
+        }
+    }
+
+private:
+    const Impl& impl;
+    const std::vector<Mat>& planes;
+    std::vector<Mat>& maps;
+};
+
+}
+
+void cv::TemplateMatcher::Impl::match(const Mat& img, std::vector<Mat>& results)
+{
+    const double blockScale = 4.5;
+    const int minBlockSize = 256;
+    int depth = CV_MAT_DEPTH(type);
+    size_t i, n = templs.size();
+
+    CV_Assert( img.type() == type && img.dims <= 2 );
+    for( i = 0; i < n; i++ )
+    {
+        CV_Assert( templs[i].size.width <= img.cols && templs[i].size.height <= img.rows );
+        CV_Assert( results[i].size() == Size(img.cols - templs[i].size.width + 1,
+                                             img.rows - templs[i].size.height + 1) &&
+                   results[i].type() == CV_32F );
+    }
+
+    bool useDFT = false, useSpatial = false;
+    double scale = masked && depth == CV_8U ? 1.0/255 : 1.0;
+
+    // the first map of a template is its result, the second one is temporary
+    std::vector<Mat> maps(n*2);
+    Size maxT, minT = img.size(), maxCorr;
+    int spatialRows = 0;
+    for( i = 0; i < n; i++ )
+    {
+        const Templ& t = templs[i];
+        maps[i*2] = results[i];
+        if( t.nmaps > 1 )
+            maps[i*2 + 1].create(results[i].size(), CV_32F);
+        if( t.useDFT )
+        {
+            useDFT = true;
+            maxT.width = std::max(maxT.width, t.size.width);
+            maxT.height = std::max(maxT.height, t.size.height);
+            minT.width = std::min(minT.width, t.size.width);
+            minT.height = std::min(minT.height, t.size.height);
+        }
+        else
+        {
+            useSpatial = true;
+            spatialRows = std::max(spatialRows, results[i].rows);
+        }
+    }
+
+    if( useDFT )
+    {
+        // the tiles are chosen for the largest template and cover the largest result
+        Size blocksize, dftsize;
+        maxCorr = Size(img.cols - minT.width + 1, img.rows - minT.height + 1);
+
+        blocksize.width = cvRound(maxT.width*blockScale);
+        blocksize.width = std::max( blocksize.width, minBlockSize - maxT.width + 1 );
+        blocksize.width = std::min( blocksize.width, maxCorr.width );
+        blocksize.height = cvRound(maxT.height*blockScale);
+        blocksize.height = std::max( blocksize.height, minBlockSize - maxT.height + 1 );
+        blocksize.height = std::min( blocksize.height, maxCorr.height );
+
+        dftsize.width = std::max(getOptimalDFTSize(blocksize.width + maxT.width - 1), 2);
+        dftsize.height = getOptimalDFTSize(blocksize.height + maxT.height - 1);
+        if( dftsize.width <= 0 || dftsize.height <= 0 )
+            CV_Error( CV_StsOutOfRange, "the input arrays are too big" );
+
+        blocksize.width = std::min( dftsize.width - maxT.width + 1, maxCorr.width );
+        blocksize.height = std::min( dftsize.height - maxT.height + 1, maxCorr.height );
+
+        Ptr<Spectra> spec = getSpectra(dftsize);
+        int tilesX = (maxCorr.width + blocksize.width - 1)/blocksize.width;
+        int tilesY = (maxCorr.height + blocksize.height - 1)/blocksize.height;
+        parallel_for_(Range(0, tilesX*tilesY), TemplateMatchDFT_Invoker(*this, *spec, img, scale, maps, blocksize, tilesX),
+                      tilesX*tilesY);
+    }
+
+    if( useSpatial )
+    {
+        // the image planes of the working depth, followed by their squares
+        std::vector<Mat> planes;
+        split(img, planes);
+        for( int c = 0; c < cn; c++ )
+            planes[c].convertTo(planes[c], workDepth, scale);
+        if( masked )
+            for( int c = 0; c < cn; c++ )
+                planes.push_back(planes[c].mul(planes[c]));
+
+        if( workDepth == CV_32F )
+            parallel_for_(Range(0, spatialRows), TemplateMatchSpatial_Invoker<float>(*this, planes, maps));
+        else
+            parallel_for_(Range(0, spatialRows), TemplateMatchSpatial_Invoker<double>(*this, planes, maps));
+    }
+
+    if( masked )
+    {
+        for( i = 0; i < n; i++ )
+        {
+            const Templ& t = templs[i];
+            Mat& result = results[i];
+            if( method == CV_TM_SQDIFF )
+                result += t.sum2;
+            else if( t.sum2 < DBL_EPSILON )
+                result = Scalar::all(1);
+            else
+            {
+                Mat corr = maps[i*2 + 1];
+                sqrt(corr, corr);
+                result = result.mul(1/corr);
+                result /= std::sqrt(t.sum2);
+            }
+        }
+    }
+    else if( method != CV_TM_CCORR )
+    {
+        Mat sum, sqsum;
+        if( method == CV_TM_CCOEFF )
+            integral(img, sum, CV_64F);
+        else
+            integral(img, sum, sqsum, CV_64F);
+        for( i = 0; i < n; i++ )
+            normalizeCorr(sum, sqsum, templs[i].stats, results[i]);
+    }
 }
 
 
@@ -1037,6 +1496,18 @@ static bool ipp_sqrDistance(const Mat& src, const Mat& tpl, Mat& dst)
     return status >= 0;
 }
 
+static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int )
+{
+    TemplateStats ts;
+    ts.compute(templ, method);
+    Mat sum, sqsum;
+    if( method == CV_TM_CCOEFF )
+        integral(img, sum, CV_64F);
+    else
+        integral(img, sum, sqsum, CV_64F);
+    normalizeCorr(sum, sqsum, ts, result);
+}
+
 static bool ipp_matchTemplate( Mat& img, Mat& templ, Mat& result, int method)
 {
     CV_INSTRUMENT_REGION_IPP()
@@ -1093,11 +1564,11 @@ void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result,
 
     if (!_mask.empty())
     {
-        cv::matchTemplateMask(_img, _templ, _result, method, _mask);
+        TemplateMatcher(_templ, method, _mask).match(_img, _result);
         return;
     }
 
-    int type = _img.type(), depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+    int type = _img.type(), depth = CV_MAT_DEPTH(type);
     CV_Assert( CV_TM_SQDIFF <= method && method <= CV_TM_CCOEFF_NORMED );
     CV_Assert( (depth == CV_8U || depth == CV_32F) && type == _templ.type() && _img.dims() <= 2 );
 
@@ -1125,9 +1596,82 @@ void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result,
 
     CV_IPP_RUN_FAST(ipp_matchTemplate(img, templ, result, method))
 
-    crossCorr( img, templ, result, result.size(), result.type(), Point(0,0), 0, 0);
+    TemplateMatcher(templ, method).match(img, result);
+}
+
+cv::TemplateMatcher::TemplateMatcher()
+{
+}
+
+cv::TemplateMatcher::TemplateMatcher(InputArray templ, int method, InputArray mask)
+{
+    create(templ, method, mask);
+}
+
+void cv::TemplateMatcher::create(InputArray templ, int method, InputArray mask)
+{
+    std::vector<Mat> templs(1, templ.getMat()), masks;
+    if( !mask.empty() )
+        masks.push_back(mask.getMat());
+    p = makePtr<Impl>();
+    p->create(templs, method, masks);
+}
+
+void cv::TemplateMatcher::createBatch(InputArrayOfArrays _templs, int method, InputArrayOfArrays _masks)
+{
+    std::vector<Mat> templs, masks;
+    _templs.getMatVector(templs);
+    if( !_masks.empty() )
+        _masks.getMatVector(masks);
+    p = makePtr<Impl>();
+    p->create(templs, method, masks);
+}
+
+bool cv::TemplateMatcher::empty() const
+{
+    return p.empty();
+}
+
+int cv::TemplateMatcher::method() const
+{
+    return p ? p->method : -1;
+}
 
-    common_matchTemplate(img, templ, result, method, cn);
+int cv::TemplateMatcher::templates() const
+{
+    return p ? (int)p->templs.size() : 0;
+}
+
+void cv::TemplateMatcher::match(InputArray _img, OutputArray _result) const
+{
+    CV_INSTRUMENT_REGION()
+
+    CV_Assert( !empty() && p->templs.size() == 1 );
+    Mat img = _img.getMat();
+    Size tsize = p->templs[0].size;
+    CV_Assert( tsize.width <= img.cols && tsize.height <= img.rows );
+    _result.create(img.rows - tsize.height + 1, img.cols - tsize.width + 1, CV_32F);
+    std::vector<Mat> results(1, _result.getMat());
+    p->match(img, results);
+}
+
+void cv::TemplateMatcher::matchBatch(InputArray _img, OutputArrayOfArrays _results) const
+{
+    CV_INSTRUMENT_REGION()
+
+    CV_Assert( !empty() );
+    Mat img = _img.getMat();
+    int i, n = (int)p->templs.size();
+    std::vector<Mat> results(n);
+    _results.create(n, 1, CV_32F, -1, true);
+    for( i = 0; i < n; i++ )
+    {
+        Size tsize = p->templs[i].size;
+        CV_Assert( tsize.width <= img.cols && tsize.height <= img.rows );
+        _results.create(img.rows - tsize.height + 1, img.cols - tsize.width + 1, CV_32F, i);
+        results[i] = _results.getMat(i);
+    }
+    p->match(img, results);
 }
 
 CV_IMPL void
@@ -2119,3 +2119,207 @@ TEST(Imgproc_MorphEx, hitmiss_zero_kernel)
 
     ASSERT_DOUBLE_EQ(norm(dst, src, NORM_INF), 0.);
 }
+
+static void filterBandsOutputs(const Mat& src, std::vector<Mat>& dst)
+{
+    dst.assign(7, Mat());
+    Mat roi = src(Rect(3, 5, src.cols - 10, src.rows - 12));
+    Mat kernel2D = (Mat_<float>(5, 5) << 1, 2, 0, -1, 3,  2, 0, 1, 1, -2,  0, 1, 4, 1, 0,
+                                         -2, 1, 1, 0, 2,  3, -1, 0, 2, 1) / 16;
+    GaussianBlur(src, dst[0], Size(7, 7), 1.5, 1.5, BORDER_REFLECT_101);
+    Sobel(roi, dst[1], CV_16S, 1, 1, 5, 1, 0, BORDER_REPLICATE);
+    filter2D(roi, dst[2], CV_32F, kernel2D, Point(-1, -1), 0, BORDER_CONSTANT);
+    boxFilter(roi, dst[3], -1, Size(9, 13), Point(-1, -1), true, BORDER_REFLECT);
+    sqrBoxFilter(src, dst[4], CV_32F, Size(5, 5));
+    erode(roi, dst[5], getStructuringElement(MORPH_ELLIPSE, Size(7, 9)), Point(-1, -1), 2);
+    dilate(src, dst[6], getStructuringElement(MORPH_RECT, Size(5, 5)), Point(-1, -1), 1,
+           BORDER_CONSTANT, Scalar::all(77));
+}
+
+TEST(Imgproc_FilterEngine, parallel_bands)
+{
+    Mat src(1037, 619, CV_8UC3);
+    theRNG().fill(src, RNG::UNIFORM, 0, 256);
+
+    int nthreads = getNumThreads();
+    std::vector<Mat> ref, dst;
+    setNumThreads(1);
+    filterBandsOutputs(src, ref);
+    setNumThreads(4);
+    filterBandsOutputs(src, dst);
+    setNumThreads(nthreads);
+
+    for( size_t i = 0; i < ref.size(); i++ )
+    {
+        EXPECT_EQ(0, cvtest::norm(ref[i], dst[i], NORM_INF)) << "operation " << i;
+    }
+}
+
+static void filterBandsFloatSums(const Mat& src32, const Mat& src64, std::vector<Mat>& dst)
+{
+    dst.assign(4, Mat());
+    boxFilter(src32, dst[0], -1, Size(9, 13), Point(-1, -1), true, BORDER_REFLECT);
+    sqrBoxFilter(src32, dst[1], CV_32F, Size(5, 5));
+    boxFilter(src64, dst[2], -1, Size(7, 7), Point(-1, -1), false, BORDER_REPLICATE);
+    blur(src64(Rect(3, 5, src64.cols - 10, src64.rows - 12)), dst[3], Size(15, 3));
+}
+
+TEST(Imgproc_FilterEngine, parallel_bands_float_sums)
+{
+    // the running column sums of the floating-point box filters restart in every band,
+    // so the results may differ from the single-threaded ones by the rounding errors
+    Mat src32(1037, 619, CV_32FC1), src64;
+    theRNG().fill(src32, RNG::UNIFORM, -100, 100);
+    src32.convertTo(src64, CV_64F);
+
+    int nthreads = getNumThreads();
+    std::vector<Mat> ref, dst;
+    setNumThreads(1);
+    filterBandsFloatSums(src32, src64, ref);
+    setNumThreads(4);
+    filterBandsFloatSums(src32, src64, dst);
+    setNumThreads(nthreads);
+
+    for( size_t i = 0; i < ref.size(); i++ )
+    {
+        double eps = ref[i].depth() == CV_32F ? 1e-5 : 1e-12;
+        EXPECT_LE(cvtest::norm(ref[i], dst[i], NORM_INF), eps*cvtest::norm(ref[i], NORM_INF)) << "operation " << i;
+    }
+}
+
+TEST(Imgproc_MorphEx, large_rect_kernels)
+{
+    RNG& rng = theRNG();
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16UC1, CV_16SC4, CV_32FC1, CV_64FC2 };
+    const int borders[] = { BORDER_REPLICATE, BORDER_REFLECT, BORDER_REFLECT_101, BORDER_CONSTANT };
+
+    for( int iter = 0; iter < 18; iter++ )
+    {
+        // the reference functions extrapolate the constant border of multi-channel images by (max, 0, 0, 0)
+        int type = types[iter % 6], border = borders[rng.uniform(0, CV_MAT_CN(type) == 1 ? 4 : 3)];
+        Mat src(rng.uniform(1, 120), rng.uniform(1, 120), type);
+        cvtest::randUni(rng, src, Scalar::all(0), Scalar::all(256));
+        Size ksize(rng.uniform(1, 50), rng.uniform(1, 50));
+        if( std::max(ksize.width, ksize.height) < 9 )
+            ksize.height = 9;
+        Point anchor(rng.uniform(0, ksize.width), rng.uniform(0, ksize.height));
+        // and by the neutral value only
+        Scalar borderValue = morphologyDefaultBorderValue();
+        Mat kernel = getStructuringElement(MORPH_RECT, ksize);
+
+        for( int op = MORPH_ERODE; op <= MORPH_BLACKHAT; op++ )
+        {
+            Mat dst, ref, temp;
+            morphologyEx(src, dst, op, kernel, anchor, 1, border, borderValue);
+
+            if( op == MORPH_ERODE )
+                cvtest::erode(src, ref, kernel, anchor, border, borderValue);
+            else if( op == MORPH_DILATE )
+                cvtest::dilate(src, ref, kernel, anchor, border, borderValue);
+            else if( op == MORPH_OPEN || op == MORPH_TOPHAT )
+            {
+                cvtest::erode(src, temp, kernel, anchor, border, borderValue);
+                cvtest::dilate(temp, ref, kernel, anchor, border, borderValue);
+                if( op == MORPH_TOPHAT )
+                    cvtest::add(src, 1, ref, -1, Scalar::all(0), ref, ref.type());
+            }
+            else if( op == MORPH_CLOSE || op == MORPH_BLACKHAT )
+            {
+                cvtest::dilate(src, temp, kernel, anchor, border, borderValue);
+                cvtest::erode(temp, ref, kernel, anchor, border, borderValue);
+                if( op == MORPH_BLACKHAT )
+                    cvtest::add(ref, 1, src, -1, Scalar::all(0), ref, ref.type());
+            }
+            else
+            {
+                cvtest::erode(src, temp, kernel, anchor, border, borderValue);
+                cvtest::dilate(src, ref, kernel, anchor, border, borderValue);
+                cvtest::add(ref, 1, temp, -1, Scalar::all(0), ref, ref.type());
+            }
+            double maxError = src.depth() >= CV_32F ? 1e-3 : 0;
+            EXPECT_LE(cvtest::norm(dst, ref, NORM_INF), maxError)
+                << "type=" << type << " border=" << border << " op=" << op << " size=" << src.size()
+                << " ksize=" << ksize << " anchor=" << anchor;
+
+            Mat inplace = src.clone();
+            morphologyEx(inplace, inplace, op, kernel, anchor, 1, border, borderValue);
+            EXPECT_EQ(0, cvtest::norm(dst, inplace, NORM_INF));
+        }
+    }
+}
+
+TEST(Imgproc_MorphEx, large_rect_kernels_parallel)
+{
+    // the bands of a large image overlap by the halo of the kernel; the result does not depend on the bands
+    RNG& rng = theRNG();
+    int nthreads = getNumThreads();
+    const int types[] = { CV_8UC1, CV_16SC3, CV_32FC1 };
+
+    for( int iter = 0; iter < 6; iter++ )
+    {
+        int type = types[iter % 3], iterations = iter < 3 ? 1 : 2;
+        int border = iter % 2 ? BORDER_REPLICATE : BORDER_REFLECT_101;
+        Mat whole(rng.uniform(760, 800), rng.uniform(1060, 1100), type);
+        cvtest::randUni(rng, whole, Scalar::all(0), Scalar::all(256));
+        // the rows and columns around the roi are read by the filter
+        Mat src = whole(Rect(rng.uniform(1, 40), rng.uniform(1, 40), 1000, 700));
+        Size ksize(rng.uniform(9, 25), rng.uniform(9, 25));
+        Point anchor(rng.uniform(0, ksize.width), rng.uniform(0, ksize.height));
+        Mat kernel = getStructuringElement(MORPH_RECT, ksize);
+
+        for( int op = MORPH_ERODE; op <= MORPH_BLACKHAT; op++ )
+        {
+            Mat dst, ref;
+            setNumThreads(1);
+            morphologyEx(src, ref, op, kernel, anchor, iterations, border);
+            setNumThreads(4);
+            morphologyEx(src, dst, op, kernel, anchor, iterations, border);
+            EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF))
+                << "type=" << type << " border=" << border << " op=" << op << " iterations=" << iterations
+                << " ksize=" << ksize << " anchor=" << anchor;
+        }
+    }
+    setNumThreads(nthreads);
+}
+
+TEST(Imgproc_BuildPyramid, fused)
+{
+    RNG& rng = theRNG();
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16UC1, CV_16SC4, CV_32FC1, CV_64FC2 };
+    const int borders[] = { BORDER_REPLICATE, BORDER_REFLECT, BORDER_REFLECT_101, BORDER_WRAP };
+    int nthreads = getNumThreads();
+
+    for( int iter = 0; iter < 24; iter++ )
+    {
+        // the last iterations are large enough to be split into parallel bands
+        int type = types[iter % 6], border = borders[rng.uniform(0, 4)];
+        Size size = iter < 18 ? Size(rng.uniform(1, 150), rng.uniform(1, 150)) :
+                                Size(rng.uniform(600, 900), rng.uniform(600, 900));
+        int maxlevel = rng.uniform(0, 7);
+        Mat src(size, type);
+        cvtest::randUni(rng, src, Scalar::all(-100), Scalar::all(300));
+
+        std::vector<Mat> ref, dst;
+        buildPyramid(src, ref, maxlevel, border);
+        Mat buf;
+        setNumThreads(iter % 2 ? 4 : 1);
+        buildPyramid(src, buf, dst, maxlevel, border);
+        setNumThreads(nthreads);
+
+        ASSERT_EQ(ref.size(), dst.size());
+        EXPECT_EQ(src.data, dst[0].data);
+        for( size_t i = 1; i < ref.size(); i++ )
+        {
+            ASSERT_EQ(ref[i].size(), dst[i].size());
+            ASSERT_EQ(type, dst[i].type());
+            EXPECT_TRUE(dst[i].isContinuous());
+            EXPECT_EQ(0, cvtest::norm(ref[i], dst[i], NORM_INF))
+                << "type " << type << ", border " << border << ", size " << size << ", level " << i;
+        }
+
+        // the buffer is reused for the next frame
+        uchar* bufdata = buf.data;
+        buildPyramid(src, buf, dst, maxlevel, border);
+        EXPECT_EQ(bufdata, buf.data);
+    }
+}
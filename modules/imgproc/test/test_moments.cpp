@@ -413,6 +413,59 @@ TEST(Imgproc_Moments, accuracy) { CV_MomentsTest test(false); test.safe_run(); }
 OCL_TEST(Imgproc_Moments, accuracy) { CV_MomentsTest test(true); test.safe_run(); }
 TEST(Imgproc_HuMoments, accuracy) { CV_HuMomentsTest test; test.safe_run(); }
 
+TEST(Imgproc_Moments, labels)
+{
+    RNG& rng = theRNG();
+    int nthreads = getNumThreads();
+
+    for( int iter = 0; iter < 4; iter++ )
+    {
+        Mat img(rng.uniform(100, 500), rng.uniform(100, 500), CV_8U, Scalar::all(0));
+        for( int i = 0; i < 50; i++ )
+        {
+            Point c(rng.uniform(0, img.cols), rng.uniform(0, img.rows));
+            ellipse(img, c, Size(rng.uniform(1, 30), rng.uniform(1, 30)), rng.uniform(0, 180), 0, 360, Scalar::all(255), -1);
+        }
+        Mat labels;
+        int ltype = iter % 2 ? CV_16U : CV_32S;
+        int nlabels = connectedComponents(img, labels, 8, ltype);
+
+        Mat weights(img.size(), iter < 2 ? CV_8U : CV_32F);
+        cvtest::randUni(rng, weights, Scalar::all(0), Scalar::all(100));
+
+        std::vector<Moments> m, mw;
+        Mat hu;
+        setNumThreads(iter % 2 ? 1 : 4);
+        labelMoments(labels, nlabels, m, noArray(), hu);
+        labelMoments(labels, nlabels, mw, weights);
+        setNumThreads(nthreads);
+        ASSERT_EQ((size_t)nlabels, m.size());
+        ASSERT_EQ((size_t)nlabels, mw.size());
+        ASSERT_EQ(Size(7, nlabels), hu.size());
+
+        for( int l = 0; l < nlabels; l++ )
+        {
+            Mat mask = labels == l, masked;
+            weights.copyTo(masked, mask);
+            Moments ref[] = { moments(mask, true), moments(masked) };
+            const Moments* res[] = { &m[l], &mw[l] };
+            for( int k = 0; k < 2; k++ )
+            {
+                const double* a = &ref[k].m00;
+                const double* b = &res[k]->m00;
+                // the spatial, central and normalized central moments
+                for( int j = 0; j < 24; j++ )
+                    EXPECT_LE(fabs(a[j] - b[j]), 1e-6*std::max(fabs(a[j]), 1e-3*ref[k].m00)) << "label " << l << ", moment " << j;
+            }
+
+            double hu0[7];
+            HuMoments(ref[0], hu0);
+            for( int j = 0; j < 7; j++ )
+                EXPECT_NEAR(hu0[j], hu.at<double>(l, j), 1e-6*std::max(fabs(hu0[j]), 1e-6)) << "label " << l;
+        }
+    }
+}
+
 class CV_SmallContourMomentTest : public cvtest::BaseTest
 {
 public:
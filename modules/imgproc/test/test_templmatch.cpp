@@ -334,3 +334,118 @@ void CV_TemplMatchTest::prepare_to_validation( int /*test_case_idx*/ )
 }
 
 TEST(Imgproc_MatchTemplate, accuracy) { CV_TemplMatchTest test; test.safe_run(); }
+
+// the independent reference: the masked methods are computed by the definitions used by matchTemplate,
+// the 8-bit data is scaled to [0, 1] and the 8-bit mask is binarized
+static void matchTemplateNaive( const Mat& img, const Mat& templ, const Mat& mask, int method, Mat& result )
+{
+    result.create(img.rows - templ.rows + 1, img.cols - templ.cols + 1, CV_32F);
+    if( mask.empty() )
+    {
+        CvMat _img = img, _templ = templ, _result = result;
+        cvTsMatchTemplate( &_img, &_templ, &_result, method );
+        return;
+    }
+
+    double scale = img.depth() == CV_8U ? 1./255 : 1.;
+    Mat I, T, M;
+    img.convertTo(I, CV_64F, scale);
+    templ.convertTo(T, CV_64F, scale);
+    if( mask.depth() == CV_8U )
+    {
+        cv::compare(mask, Scalar::all(0), M, CMP_NE);
+        M.convertTo(M, CV_64F, 1./255);
+    }
+    else
+        mask.convertTo(M, CV_64F);
+
+    int cn = img.channels(), w = templ.cols*cn;
+    for( int y = 0; y < result.rows; y++ )
+        for( int x = 0; x < result.cols; x++ )
+        {
+            double s = 0, isum2 = 0, tsum2 = 0;
+            for( int i = 0; i < templ.rows; i++ )
+            {
+                const double* a = I.ptr<double>(y + i) + x*cn;
+                const double* t = T.ptr<double>(i);
+                const double* m = M.ptr<double>(i);
+                for( int j = 0; j < w; j++ )
+                {
+                    if( method == CV_TM_SQDIFF )
+                        s += a[j]*a[j]*m[j] - 2*a[j]*t[j]*m[j]*m[j] + t[j]*t[j]*m[j]*m[j];
+                    else
+                    {
+                        s += a[j]*t[j]*m[j];
+                        isum2 += a[j]*a[j]*m[j]*m[j];
+                        tsum2 += t[j]*t[j]*m[j]*m[j];
+                    }
+                }
+            }
+            if( method == CV_TM_CCORR_NORMED )
+                s = tsum2 < DBL_EPSILON ? 1. : s/std::sqrt(isum2*tsum2);
+            result.at<float>(y, x) = (float)s;
+        }
+}
+
+TEST(Imgproc_MatchTemplate, matcher_batch)
+{
+    RNG& rng = theRNG();
+    int nthreads = getNumThreads();
+
+    for( int method = CV_TM_SQDIFF; method <= CV_TM_CCOEFF_NORMED; method++ )
+    for( int d = 0; d < 2; d++ )
+    for( int m = 0; m < 2; m++ )
+    {
+        int depth = d == 0 ? CV_8U : CV_32F, cn = (method + d + m) % 2 == 0 ? 3 : 1;
+        // the mask is supported by TM_SQDIFF and TM_CCORR_NORMED only
+        bool masked = m == 1;
+        if( masked && method != CV_TM_SQDIFF && method != CV_TM_CCORR_NORMED )
+            continue;
+        SCOPED_TRACE(cv::format("method=%d depth=%d cn=%d masked=%d", method, depth, cn, (int)masked));
+
+        std::vector<Mat> templs(3), masks;
+        for( size_t i = 0; i < templs.size(); i++ )
+        {
+            // both the directly applied and the frequency domain kernels
+            int maxSize = i == 0 ? 6 : 24;
+            templs[i].create(rng.uniform(1, maxSize), rng.uniform(1, maxSize), CV_MAKETYPE(depth, cn));
+            cvtest::randUni(rng, templs[i], Scalar::all(0), Scalar::all(depth == CV_8U ? 256 : 10));
+            if( masked )
+            {
+                masks.push_back(Mat(templs[i].size(), templs[i].type()));
+                cvtest::randUni(rng, masks.back(), Scalar::all(0), Scalar::all(2));
+            }
+        }
+
+        TemplateMatcher matcher;
+        matcher.createBatch(templs, method, masks);
+        ASSERT_EQ(3, matcher.templates());
+
+        // the second frame has the same size and reuses the cached spectra of the templates,
+        // they are recomputed for the third one
+        Size sz(rng.uniform(24, 200), rng.uniform(24, 200));
+        for( int k = 0; k < 3; k++ )
+        {
+            if( k == 2 )
+                sz = Size(sz.width + rng.uniform(1, 50), sz.height + rng.uniform(1, 50));
+            Mat img(sz, CV_MAKETYPE(depth, cn));
+            cvtest::randUni(rng, img, Scalar::all(0), Scalar::all(depth == CV_8U ? 256 : 10));
+
+            std::vector<Mat> results;
+            setNumThreads(k == 0 ? 1 : 4);
+            matcher.matchBatch(img, results);
+            setNumThreads(nthreads);
+            ASSERT_EQ(templs.size(), results.size());
+
+            for( size_t i = 0; i < templs.size(); i++ )
+            {
+                Mat ref;
+                matchTemplateNaive(img, templs[i], masked ? masks[i] : Mat(), method, ref);
+                ASSERT_EQ(ref.size(), results[i].size());
+                double scale = std::max(1., cvtest::norm(ref, NORM_INF));
+                EXPECT_LE(cvtest::norm(ref, results[i], NORM_INF), scale*1e-4)
+                    << "frame " << k << ", template " << i << ", " << templs[i].size();
+            }
+        }
+    }
+}